@@ -0,0 +1,121 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "BenchPlatform.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <Rendering/CubismRenderer.hpp>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace CubismBench {
+
+void* BenchAllocator::Allocate(const csmSizeType size)
+{
+    return malloc(size);
+}
+
+void BenchAllocator::Deallocate(void* memory)
+{
+    free(memory);
+}
+
+void* BenchAllocator::AllocateAligned(const csmSizeType size, const csmUint32 alignment)
+{
+    size_t offset, shift, alignedAddress;
+    void* allocation;
+    void** preamble;
+
+    offset = alignment - 1 + sizeof(void*);
+
+    allocation = Allocate(size + static_cast<csmUint32>(offset));
+
+    alignedAddress = reinterpret_cast<size_t>(allocation) + sizeof(void*);
+
+    shift = alignedAddress % alignment;
+
+    if (shift)
+    {
+        alignedAddress += (alignment - shift);
+    }
+
+    preamble = reinterpret_cast<void**>(alignedAddress);
+    preamble[-1] = allocation;
+
+    return reinterpret_cast<void*>(alignedAddress);
+}
+
+void BenchAllocator::DeallocateAligned(void* alignedMemory)
+{
+    void** preamble = static_cast<void**>(alignedMemory);
+
+    Deallocate(preamble[-1]);
+}
+
+csmByte* LoadFileAsBytes(const std::string filePath, csmSizeInt* outSize)
+{
+    FILE* file = fopen(filePath.c_str(), "rb");
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size <= 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    csmByte* buffer = static_cast<csmByte*>(malloc(size));
+
+    if (fread(buffer, 1, size, file) != static_cast<size_t>(size))
+    {
+        free(buffer);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+
+    *outSize = static_cast<csmSizeInt>(size);
+
+    return buffer;
+}
+
+void ReleaseBytes(csmByte* byteData)
+{
+    free(byteData);
+}
+
+csmUint64 GetTimeNanoseconds()
+{
+    return static_cast<csmUint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}
+
+//--------- Headless rendering ------------
+// The benchmarks run without a rendering backend, so the factory of the renderer is stubbed out.
+
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+CubismRenderer* CubismRenderer::Create()
+{
+    return NULL;
+}
+
+void CubismRenderer::StaticRelease()
+{ }
+
+}}}}
@@ -0,0 +1,52 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <ICubismAllocator.hpp>
+#include <string>
+
+namespace CubismBench {
+
+/**
+ * Allocator backed by malloc/free.
+ */
+class BenchAllocator : public Csm::ICubismAllocator
+{
+public:
+    void* Allocate(const Csm::csmSizeType size);
+    void Deallocate(void* memory);
+    void* AllocateAligned(const Csm::csmSizeType size, const Csm::csmUint32 alignment);
+    void DeallocateAligned(void* alignedMemory);
+};
+
+/**
+ * Reads a whole file.
+ *
+ * @param filePath path of the file
+ * @param outSize receives the size of the file in bytes
+ *
+ * @return contents of the file, released with ReleaseBytes(); NULL on failure
+ */
+Csm::csmByte* LoadFileAsBytes(const std::string filePath, Csm::csmSizeInt* outSize);
+
+/**
+ * Releases the bytes returned by LoadFileAsBytes().
+ *
+ * @param byteData bytes to release
+ */
+void ReleaseBytes(Csm::csmByte* byteData);
+
+/**
+ * Returns a monotonic time stamp.
+ *
+ * @return time in nanoseconds
+ */
+Csm::csmUint64 GetTimeNanoseconds();
+
+}
@@ -0,0 +1,659 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CoreStandIn.hpp"
+#include <Live2DCubismCore.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char MocMagic[8] = { 'C', 'S', 'M', 'S', 'T', 'A', 'N', 'D' };
+const unsigned int MocFormatVersion = 1;
+const int IdLength = 32;
+const int LayoutAlignment = 16;
+const float CanvasPixels = 2048.0f;
+const float PixelsPerUnit = 1024.0f;
+
+csmLogFunction LogFunction = 0;
+
+/**
+ * Contents of the moc of the stand-in.
+ */
+struct StandInMoc
+{
+    char Magic[8];
+    unsigned int FormatVersion;
+    int ParameterCount;
+    int PartCount;
+    int DrawableCount;
+    int VerticesPerSide;
+    int MaskedDrawableInterval;
+};
+
+/**
+ * Model placed in the memory given to csmInitializeModelInPlace(). The arrays follow the structure.
+ */
+struct StandInModel
+{
+    StandInMoc Shape;
+    int VertexCount;
+    int IndexCount;
+    int GridColumns;
+
+    const char** ParameterIds;
+    csmParameterType* ParameterTypes;
+    float* ParameterMinimumValues;
+    float* ParameterMaximumValues;
+    float* ParameterDefaultValues;
+    float* ParameterValues;
+    int* ParameterRepeats;
+    int* ParameterKeyCounts;
+    const float** ParameterKeyValues;
+
+    const char** PartIds;
+    float* PartOpacities;
+    int* PartParentPartIndices;
+
+    const char** DrawableIds;
+    csmFlags* DrawableConstantFlags;
+    csmFlags* DrawableDynamicFlags;
+    int* DrawableTextureIndices;
+    int* DrawableDrawOrders;
+    int* DrawableRenderOrders;
+    float* DrawableOpacities;
+    int* DrawableMaskCounts;
+    const int** DrawableMasks;
+    int* DrawableVertexCounts;
+    const csmVector2** DrawableVertexPositions;
+    const csmVector2** DrawableVertexUvs;
+    int* DrawableIndexCounts;
+    const unsigned short** DrawableIndices;
+    csmVector4* DrawableMultiplyColors;
+    csmVector4* DrawableScreenColors;
+    int* DrawableParentPartIndices;
+    float* DrawableDeformInputs;    ///< 前回の変形に使った2つの入力
+    bool IsDynamicFlagsResetPending;    ///< csmResetDrawableDynamicFlags() が呼ばれ、次の更新で変化のフラグを消す
+};
+
+/**
+ * Places the arrays of a model one after another.<br>
+ * Without a base address only the size is computed.
+ */
+class Layout
+{
+public:
+    explicit Layout(unsigned char* base)
+        : _base(base)
+        , _size(sizeof(StandInModel))
+    {
+    }
+
+    template <class T>
+    T* Take(int count)
+    {
+        _size = (_size + LayoutAlignment - 1) / LayoutAlignment * LayoutAlignment;
+        T* address = (_base != 0) ? reinterpret_cast<T*>(_base + _size) : 0;
+        _size += sizeof(T) * static_cast<unsigned int>(count);
+        return address;
+    }
+
+    unsigned int GetSize() const
+    {
+        return static_cast<unsigned int>(_size);
+    }
+
+private:
+    unsigned char* _base;
+    size_t _size;
+};
+
+void Log(const char* message)
+{
+    if (LogFunction != 0)
+    {
+        LogFunction(message);
+    }
+}
+
+bool IsValidMoc(const void* address, unsigned int size)
+{
+    if (address == 0 || size < sizeof(StandInMoc))
+    {
+        return false;
+    }
+
+    const StandInMoc* moc = static_cast<const StandInMoc*>(address);
+
+    return memcmp(moc->Magic, MocMagic, sizeof(MocMagic)) == 0
+        && moc->FormatVersion == MocFormatVersion
+        && moc->ParameterCount > 0
+        && moc->PartCount > 0
+        && moc->DrawableCount > 0
+        && moc->VerticesPerSide >= 2 && moc->VerticesPerSide <= 255
+        && moc->MaskedDrawableInterval >= 0;
+}
+
+/**
+ * Lays out a model. Sets the array pointers of the model if a base address is given.
+ *
+ * @return size of the model in bytes
+ */
+unsigned int LayOutModel(const StandInMoc& shape, unsigned char* base, StandInModel* model)
+{
+    const int parameterCount = shape.ParameterCount;
+    const int partCount = shape.PartCount;
+    const int drawableCount = shape.DrawableCount;
+    const int vertexCount = shape.VerticesPerSide * shape.VerticesPerSide;
+    const int indexCount = (shape.VerticesPerSide - 1) * (shape.VerticesPerSide - 1) * 6;
+    Layout layout(base);
+
+    model->ParameterIds = layout.Take<const char*>(parameterCount);
+    model->ParameterTypes = layout.Take<csmParameterType>(parameterCount);
+    model->ParameterMinimumValues = layout.Take<float>(parameterCount);
+    model->ParameterMaximumValues = layout.Take<float>(parameterCount);
+    model->ParameterDefaultValues = layout.Take<float>(parameterCount);
+    model->ParameterValues = layout.Take<float>(parameterCount);
+    model->ParameterRepeats = layout.Take<int>(parameterCount);
+    model->ParameterKeyCounts = layout.Take<int>(parameterCount);
+    model->ParameterKeyValues = layout.Take<const float*>(parameterCount);
+
+    model->PartIds = layout.Take<const char*>(partCount);
+    model->PartOpacities = layout.Take<float>(partCount);
+    model->PartParentPartIndices = layout.Take<int>(partCount);
+
+    model->DrawableIds = layout.Take<const char*>(drawableCount);
+    model->DrawableConstantFlags = layout.Take<csmFlags>(drawableCount);
+    model->DrawableDynamicFlags = layout.Take<csmFlags>(drawableCount);
+    model->DrawableTextureIndices = layout.Take<int>(drawableCount);
+    model->DrawableDrawOrders = layout.Take<int>(drawableCount);
+    model->DrawableRenderOrders = layout.Take<int>(drawableCount);
+    model->DrawableOpacities = layout.Take<float>(drawableCount);
+    model->DrawableMaskCounts = layout.Take<int>(drawableCount);
+    model->DrawableMasks = layout.Take<const int*>(drawableCount);
+    model->DrawableVertexCounts = layout.Take<int>(drawableCount);
+    model->DrawableVertexPositions = layout.Take<const csmVector2*>(drawableCount);
+    model->DrawableVertexUvs = layout.Take<const csmVector2*>(drawableCount);
+    model->DrawableIndexCounts = layout.Take<int>(drawableCount);
+    model->DrawableIndices = layout.Take<const unsigned short*>(drawableCount);
+    model->DrawableMultiplyColors = layout.Take<csmVector4>(drawableCount);
+    model->DrawableScreenColors = layout.Take<csmVector4>(drawableCount);
+    model->DrawableParentPartIndices = layout.Take<int>(drawableCount);
+    model->DrawableDeformInputs = layout.Take<float>(drawableCount * 2);
+
+    // 配列の中身
+    char* parameterIdChars = layout.Take<char>(parameterCount * IdLength);
+    char* partIdChars = layout.Take<char>(partCount * IdLength);
+    char* drawableIdChars = layout.Take<char>(drawableCount * IdLength);
+    float* keyValues = layout.Take<float>(parameterCount * 2);
+    int* maskIndices = layout.Take<int>(drawableCount);
+    csmVector2* positions = layout.Take<csmVector2>(drawableCount * vertexCount);
+    csmVector2* uvs = layout.Take<csmVector2>(vertexCount);
+    unsigned short* indices = layout.Take<unsigned short>(indexCount);
+
+    if (base == 0)
+    {
+        return layout.GetSize();
+    }
+
+    model->Shape = shape;
+    model->VertexCount = vertexCount;
+    model->IndexCount = indexCount;
+    model->GridColumns = static_cast<int>(ceil(sqrt(static_cast<double>(drawableCount))));
+
+    for (int i = 0; i < parameterCount; ++i)
+    {
+        char* id = parameterIdChars + i * IdLength;
+        snprintf(id, IdLength, "SyntheticParam%d", i);
+        model->ParameterIds[i] = id;
+        model->ParameterTypes[i] = csmParameterType_Normal;
+        model->ParameterMinimumValues[i] = (i % 2 == 0) ? -30.0f : -1.0f;
+        model->ParameterMaximumValues[i] = (i % 2 == 0) ? 30.0f : 1.0f;
+        model->ParameterDefaultValues[i] = 0.0f;
+        model->ParameterValues[i] = 0.0f;
+        model->ParameterRepeats[i] = 0;
+        model->ParameterKeyCounts[i] = 2;
+        keyValues[i * 2] = model->ParameterMinimumValues[i];
+        keyValues[i * 2 + 1] = model->ParameterMaximumValues[i];
+        model->ParameterKeyValues[i] = keyValues + i * 2;
+    }
+
+    for (int i = 0; i < partCount; ++i)
+    {
+        char* id = partIdChars + i * IdLength;
+        snprintf(id, IdLength, "SyntheticPart%d", i);
+        model->PartIds[i] = id;
+        model->PartOpacities[i] = 1.0f;
+        model->PartParentPartIndices[i] = (i == 0) ? -1 : (i - 1) / 4;
+    }
+
+    // 全ての描画オブジェクトは同じ格子を使う
+    const int side = shape.VerticesPerSide;
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            uvs[y * side + x].X = static_cast<float>(x) / (side - 1);
+            uvs[y * side + x].Y = static_cast<float>(y) / (side - 1);
+        }
+    }
+
+    unsigned short* index = indices;
+    for (int y = 0; y < side - 1; ++y)
+    {
+        for (int x = 0; x < side - 1; ++x)
+        {
+            const unsigned short topLeft = static_cast<unsigned short>(y * side + x);
+            const unsigned short bottomLeft = static_cast<unsigned short>(topLeft + side);
+
+            *index++ = topLeft;
+            *index++ = bottomLeft;
+            *index++ = static_cast<unsigned short>(topLeft + 1);
+            *index++ = static_cast<unsigned short>(topLeft + 1);
+            *index++ = bottomLeft;
+            *index++ = static_cast<unsigned short>(bottomLeft + 1);
+        }
+    }
+
+    for (int i = 0; i < drawableCount; ++i)
+    {
+        char* id = drawableIdChars + i * IdLength;
+        snprintf(id, IdLength, "SyntheticDrawable%d", i);
+        model->DrawableIds[i] = id;
+        model->DrawableConstantFlags[i] = 0;
+        model->DrawableDynamicFlags[i] = 0;
+        model->DrawableTextureIndices[i] = i % 2;
+        model->DrawableDrawOrders[i] = i;
+        model->DrawableRenderOrders[i] = i;
+        model->DrawableOpacities[i] = 0.0f;
+
+        const bool isMasked = shape.MaskedDrawableInterval > 0 && i > 0 && (i % shape.MaskedDrawableInterval) == shape.MaskedDrawableInterval - 1;
+        maskIndices[i] = i - 1;
+        model->DrawableMaskCounts[i] = isMasked ? 1 : 0;
+        model->DrawableMasks[i] = maskIndices + i;
+
+        model->DrawableVertexCounts[i] = vertexCount;
+        model->DrawableVertexPositions[i] = positions + i * vertexCount;
+        model->DrawableVertexUvs[i] = uvs;
+        model->DrawableIndexCounts[i] = indexCount;
+        model->DrawableIndices[i] = indices;
+
+        model->DrawableMultiplyColors[i].X = 1.0f;
+        model->DrawableMultiplyColors[i].Y = 1.0f;
+        model->DrawableMultiplyColors[i].Z = 1.0f;
+        model->DrawableMultiplyColors[i].W = 1.0f;
+        model->DrawableScreenColors[i].X = 0.0f;
+        model->DrawableScreenColors[i].Y = 0.0f;
+        model->DrawableScreenColors[i].Z = 0.0f;
+        model->DrawableScreenColors[i].W = 1.0f;
+        model->DrawableParentPartIndices[i] = i % partCount;
+    }
+
+    return layout.GetSize();
+}
+
+float GetNormalizedParameterValue(const StandInModel* model, int parameterIndex)
+{
+    const float minimum = model->ParameterMinimumValues[parameterIndex];
+    const float maximum = model->ParameterMaximumValues[parameterIndex];
+
+    return (model->ParameterValues[parameterIndex] - minimum) / (maximum - minimum) * 2.0f - 1.0f;
+}
+
+/**
+ * Deforms the drawables from the parameters and the part opacities and sets the dynamic flags.
+ *
+ * @param model model to update
+ * @param isFirstUpdate true to update every drawable regardless of its inputs
+ */
+void UpdateDrawables(StandInModel* model, bool isFirstUpdate)
+{
+    const int parameterCount = model->Shape.ParameterCount;
+    const float cell = 2.0f / model->GridColumns;
+    const float halfSize = cell * 0.6f;
+    const bool isResetPending = model->IsDynamicFlagsResetPending;
+
+    model->IsDynamicFlagsResetPending = false;
+
+    for (int d = 0; d < model->Shape.DrawableCount; ++d)
+    {
+        // 描画オブジェクトごとに2つのパラメータで変形させる
+        const float first = GetNormalizedParameterValue(model, d % parameterCount);
+        const float second = GetNormalizedParameterValue(model, (d * 7 + 3) % parameterCount);
+        float* lastInputs = model->DrawableDeformInputs + d * 2;
+        csmFlags flags = model->DrawableDynamicFlags[d];
+
+        // 前回の更新の後でリセットされていれば、変化のフラグだけを消して表示状態は残す
+        if (isResetPending)
+        {
+            flags &= csmIsVisible;
+        }
+
+        if (isFirstUpdate || first != lastInputs[0] || second != lastInputs[1])
+        {
+            const float centerX = -1.0f + (d % model->GridColumns + 0.5f) * cell;
+            const float centerY = 1.0f - (d / model->GridColumns + 0.5f) * cell;
+            const csmVector2* uvs = model->DrawableVertexUvs[d];
+            csmVector2* positions = const_cast<csmVector2*>(model->DrawableVertexPositions[d]);
+
+            for (int i = 0; i < model->VertexCount; ++i)
+            {
+                const float u = uvs[i].X - 0.5f;
+                const float v = uvs[i].Y - 0.5f;
+                const float bend = 1.0f - 4.0f * v * v;
+
+                positions[i].X = centerX + u * 2.0f * halfSize + (first * 0.1f + second * 0.05f * v) * cell * bend;
+                positions[i].Y = centerY - v * 2.0f * halfSize + (second * 0.1f + first * 0.05f * u) * cell;
+            }
+
+            lastInputs[0] = first;
+            lastInputs[1] = second;
+            flags |= csmVertexPositionsDidChange;
+        }
+
+        const float opacity = model->PartOpacities[model->DrawableParentPartIndices[d]];
+        if (isFirstUpdate || opacity != model->DrawableOpacities[d])
+        {
+            model->DrawableOpacities[d] = opacity;
+            flags |= csmOpacityDidChange;
+        }
+
+        const bool isVisible = opacity > 0.0f;
+        if (isFirstUpdate || isVisible != ((flags & csmIsVisible) != 0))
+        {
+            flags = isVisible ? (flags | csmIsVisible) : (flags & ~csmIsVisible);
+            flags |= csmVisibilityDidChange;
+        }
+
+        model->DrawableDynamicFlags[d] = flags;
+    }
+}
+
+StandInModel* ToStandIn(const csmModel* model)
+{
+    return reinterpret_cast<StandInModel*>(const_cast<csmModel*>(model));
+}
+
+}
+
+namespace CubismBench {
+
+CoreStandInOptions::CoreStandInOptions()
+    : ParameterCount(64)
+    , PartCount(16)
+    , DrawableCount(64)
+    , VerticesPerSide(16)
+    , MaskedDrawableInterval(8)
+{
+}
+
+std::vector<unsigned char> GenerateCoreStandInMoc(const CoreStandInOptions& options)
+{
+    StandInMoc moc;
+    memcpy(moc.Magic, MocMagic, sizeof(MocMagic));
+    moc.FormatVersion = MocFormatVersion;
+    moc.ParameterCount = (options.ParameterCount > 0) ? options.ParameterCount : 1;
+    moc.PartCount = (options.PartCount > 0) ? options.PartCount : 1;
+    moc.DrawableCount = (options.DrawableCount > 0) ? options.DrawableCount : 1;
+    moc.VerticesPerSide = (options.VerticesPerSide < 2) ? 2 : (options.VerticesPerSide > 255) ? 255 : options.VerticesPerSide;
+    moc.MaskedDrawableInterval = (options.MaskedDrawableInterval > 0) ? options.MaskedDrawableInterval : 0;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&moc);
+    return std::vector<unsigned char>(bytes, bytes + sizeof(moc));
+}
+
+}
+
+//--------- Live2DCubismCore.h ------------
+
+csmVersion csmCallingConvention csmGetVersion()
+{
+    return 0x05000000;
+}
+
+csmMocVersion csmCallingConvention csmGetLatestMocVersion()
+{
+    return csmMocVersion_50;
+}
+
+csmMocVersion csmCallingConvention csmGetMocVersion(const void* address, const unsigned int size)
+{
+    return IsValidMoc(address, size) ? csmMocVersion_50 : csmMocVersion_Unknown;
+}
+
+int csmCallingConvention csmHasMocConsistency(void* address, const unsigned int size)
+{
+    return IsValidMoc(address, size) ? 1 : 0;
+}
+
+csmLogFunction csmCallingConvention csmGetLogFunction()
+{
+    return LogFunction;
+}
+
+void csmCallingConvention csmSetLogFunction(csmLogFunction handler)
+{
+    LogFunction = handler;
+}
+
+csmMoc* csmCallingConvention csmReviveMocInPlace(void* address, const unsigned int size)
+{
+    if (!IsValidMoc(address, size))
+    {
+        Log("[CoreStandIn] The moc was not made by GenerateCoreStandInMoc().");
+        return 0;
+    }
+
+    return static_cast<csmMoc*>(address);
+}
+
+unsigned int csmCallingConvention csmGetSizeofModel(const csmMoc* moc)
+{
+    StandInModel measure;
+
+    return LayOutModel(*reinterpret_cast<const StandInMoc*>(moc), 0, &measure);
+}
+
+csmModel* csmCallingConvention csmInitializeModelInPlace(const csmMoc* moc, void* address, const unsigned int size)
+{
+    const StandInMoc* shape = reinterpret_cast<const StandInMoc*>(moc);
+
+    if (address == 0 || reinterpret_cast<size_t>(address) % csmAlignofModel != 0 || size < csmGetSizeofModel(moc))
+    {
+        Log("[CoreStandIn] The memory of the model is too small or misaligned.");
+        return 0;
+    }
+
+    StandInModel* model = static_cast<StandInModel*>(address);
+    LayOutModel(*shape, static_cast<unsigned char*>(address), model);
+    model->IsDynamicFlagsResetPending = false;
+    UpdateDrawables(model, true);
+
+    return reinterpret_cast<csmModel*>(model);
+}
+
+void csmCallingConvention csmUpdateModel(csmModel* model)
+{
+    UpdateDrawables(ToStandIn(model), false);
+}
+
+void csmCallingConvention csmReadCanvasInfo(const csmModel*, csmVector2* outSizeInPixels, csmVector2* outOriginInPixels, float* outPixelsPerUnit)
+{
+    outSizeInPixels->X = CanvasPixels;
+    outSizeInPixels->Y = CanvasPixels;
+    outOriginInPixels->X = CanvasPixels * 0.5f;
+    outOriginInPixels->Y = CanvasPixels * 0.5f;
+    *outPixelsPerUnit = PixelsPerUnit;
+}
+
+int csmCallingConvention csmGetParameterCount(const csmModel* model)
+{
+    return ToStandIn(model)->Shape.ParameterCount;
+}
+
+const char** csmCallingConvention csmGetParameterIds(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterIds;
+}
+
+const csmParameterType* csmCallingConvention csmGetParameterTypes(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterTypes;
+}
+
+const float* csmCallingConvention csmGetParameterMinimumValues(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterMinimumValues;
+}
+
+const float* csmCallingConvention csmGetParameterMaximumValues(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterMaximumValues;
+}
+
+const float* csmCallingConvention csmGetParameterDefaultValues(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterDefaultValues;
+}
+
+float* csmCallingConvention csmGetParameterValues(csmModel* model)
+{
+    return ToStandIn(model)->ParameterValues;
+}
+
+const int* csmCallingConvention csmGetParameterRepeats(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterRepeats;
+}
+
+const int* csmCallingConvention csmGetParameterKeyCounts(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterKeyCounts;
+}
+
+const float** csmCallingConvention csmGetParameterKeyValues(const csmModel* model)
+{
+    return ToStandIn(model)->ParameterKeyValues;
+}
+
+int csmCallingConvention csmGetPartCount(const csmModel* model)
+{
+    return ToStandIn(model)->Shape.PartCount;
+}
+
+const char** csmCallingConvention csmGetPartIds(const csmModel* model)
+{
+    return ToStandIn(model)->PartIds;
+}
+
+float* csmCallingConvention csmGetPartOpacities(csmModel* model)
+{
+    return ToStandIn(model)->PartOpacities;
+}
+
+const int* csmCallingConvention csmGetPartParentPartIndices(const csmModel* model)
+{
+    return ToStandIn(model)->PartParentPartIndices;
+}
+
+int csmCallingConvention csmGetDrawableCount(const csmModel* model)
+{
+    return ToStandIn(model)->Shape.DrawableCount;
+}
+
+const char** csmCallingConvention csmGetDrawableIds(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableIds;
+}
+
+const csmFlags* csmCallingConvention csmGetDrawableConstantFlags(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableConstantFlags;
+}
+
+const csmFlags* csmCallingConvention csmGetDrawableDynamicFlags(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableDynamicFlags;
+}
+
+const int* csmCallingConvention csmGetDrawableTextureIndices(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableTextureIndices;
+}
+
+const int* csmCallingConvention csmGetDrawableDrawOrders(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableDrawOrders;
+}
+
+const int* csmCallingConvention csmGetDrawableRenderOrders(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableRenderOrders;
+}
+
+const float* csmCallingConvention csmGetDrawableOpacities(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableOpacities;
+}
+
+const int* csmCallingConvention csmGetDrawableMaskCounts(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableMaskCounts;
+}
+
+const int** csmCallingConvention csmGetDrawableMasks(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableMasks;
+}
+
+const int* csmCallingConvention csmGetDrawableVertexCounts(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableVertexCounts;
+}
+
+const csmVector2** csmCallingConvention csmGetDrawableVertexPositions(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableVertexPositions;
+}
+
+const csmVector2** csmCallingConvention csmGetDrawableVertexUvs(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableVertexUvs;
+}
+
+const int* csmCallingConvention csmGetDrawableIndexCounts(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableIndexCounts;
+}
+
+const unsigned short** csmCallingConvention csmGetDrawableIndices(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableIndices;
+}
+
+const csmVector4* csmCallingConvention csmGetDrawableMultiplyColors(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableMultiplyColors;
+}
+
+const csmVector4* csmCallingConvention csmGetDrawableScreenColors(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableScreenColors;
+}
+
+const int* csmCallingConvention csmGetDrawableParentPartIndices(const csmModel* model)
+{
+    return ToStandIn(model)->DrawableParentPartIndices;
+}
+
+void csmCallingConvention csmResetDrawableDynamicFlags(csmModel* model)
+{
+    // CubismModel::Update() は csmUpdateModel() の直後にリセットするが、描画や当たり判定はその後で
+    // 頂点の変化のフラグを読むので、フラグは次の csmUpdateModel() まで残す
+    ToStandIn(model)->IsDynamicFlagsResetPending = true;
+}
@@ -0,0 +1,44 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace CubismBench {
+
+/**
+ * Shape of the models served by the Core stand-in.<br>
+ * Parameters are named SyntheticParam0, SyntheticParam1, ..., parts SyntheticPart0, SyntheticPart1, ...<br>
+ * and drawables SyntheticDrawable0, SyntheticDrawable1, ..., the names used by the synthetic JSON generators.
+ */
+struct CoreStandInOptions
+{
+    CoreStandInOptions();
+
+    int ParameterCount;             ///< Parameters; ranges alternate between -30..30 and -1..1
+    int PartCount;                  ///< Parts
+    int DrawableCount;              ///< Drawables, laid out on a grid over the canvas
+    int VerticesPerSide;            ///< Each drawable is a square mesh of VerticesPerSide x VerticesPerSide vertices, at most 255
+    int MaskedDrawableInterval;     ///< Every N-th drawable is clipped by the drawable before it; 0 for no clipping
+};
+
+/**
+ * Makes the moc read by the Core stand-in.
+ *
+ * The stand-in implements the Live2DCubismCore.h API on any platform. Its models deform every drawable<br>
+ * from two parameters, take the drawable opacity from the parent part and set the dynamic flags like the Core,<br>
+ * which keeps them through csmResetDrawableDynamicFlags() until the next csmUpdateModel(),<br>
+ * so the update path of the framework can run without the Core library. A real .moc3 is rejected by the stand-in.
+ *
+ * @param options shape of the model
+ *
+ * @return contents of the moc
+ */
+std::vector<unsigned char> GenerateCoreStandInMoc(const CoreStandInOptions& options);
+
+}
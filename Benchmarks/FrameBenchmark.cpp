@@ -0,0 +1,339 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "FrameBenchmark.hpp"
+#include "BenchPlatform.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <Effect/CubismPose.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/CubismExpressionMotionManager.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Rendering/CubismRenderer.hpp>
+#include <Rendering/CubismClippingManager.hpp>
+#include <Utils/CubismAllocationStats.hpp>
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Rendering;
+
+namespace CubismBench {
+
+namespace {
+
+const csmInt32 WarmUpFrameCount = 30;
+const csmFloat32 ExpressionIntervalSeconds = 3.0f;
+
+enum FrameStage
+{
+    FrameStage_Motion = 0,
+    FrameStage_Expression,
+    FrameStage_Physics,
+    FrameStage_Pose,
+    FrameStage_ModelUpdate,
+    FrameStage_Clipping,
+    FrameStage_Count
+};
+
+const csmChar* FrameStageNames[FrameStage_Count] =
+{
+    "frame_motion",
+    "frame_expression",
+    "frame_physics",
+    "frame_pose",
+    "frame_model_update",
+    "frame_clipping",
+};
+
+/**
+ * Render target of the headless clipping manager. Masks are laid out but never drawn.
+ */
+struct HeadlessOffscreenSurface
+{
+};
+
+class HeadlessClippingContext;
+
+/**
+ * Clipping manager that only computes the bounds and matrices of the masks.
+ */
+class HeadlessClippingManager : public CubismClippingManager<HeadlessClippingContext, HeadlessOffscreenSurface>
+{
+};
+
+/**
+ * Clipping context of HeadlessClippingManager.
+ */
+class HeadlessClippingContext : public CubismClippingContext
+{
+public:
+    HeadlessClippingContext(CubismClippingManager<HeadlessClippingContext, HeadlessOffscreenSurface>* manager, CubismModel&,
+                            const csmInt32* clippingDrawableIndices, csmInt32 clipCount)
+        : CubismClippingContext(clippingDrawableIndices, clipCount)
+        , _owner(manager)
+    {
+    }
+
+    CubismClippingManager<HeadlessClippingContext, HeadlessOffscreenSurface>* GetClippingManager()
+    {
+        return _owner;
+    }
+
+private:
+    CubismClippingManager<HeadlessClippingContext, HeadlessOffscreenSurface>* _owner;
+};
+
+/**
+ * Model updated like the user model of the samples, without a renderer.
+ */
+class HeadlessModel : public CubismUserModel
+{
+public:
+    HeadlessModel()
+        : _clippingManager(NULL)
+        , _expressionIndex(0)
+        , _expressionTimeSeconds(0.0f)
+    {
+    }
+
+    virtual ~HeadlessModel()
+    {
+        _expressionManager->StopAllMotions();
+
+        for (csmUint32 i = 0; i < _expressions.GetSize(); ++i)
+        {
+            ACubismMotion::Delete(_expressions[i]);
+        }
+
+        CSM_DELETE(_clippingManager);
+    }
+
+    csmBool Setup(const csmByte* mocBuffer, csmSizeInt mocSize, const SyntheticModelOptions& fileOptions, csmInt32 modelIndex)
+    {
+        LoadModel(mocBuffer, mocSize);
+
+        if (_model == NULL)
+        {
+            return false;
+        }
+
+        SyntheticModelOptions options = fileOptions;
+        options.Seed = fileOptions.Seed + static_cast<csmUint32>(modelIndex);
+        SetModelIds(_model, options);
+
+        const std::string motionJson = GenerateMotionJson(options);
+        ACubismMotion* motion = LoadMotion(reinterpret_cast<const csmByte*>(motionJson.data()), static_cast<csmSizeInt>(motionJson.size()), "synthetic");
+        if (motion == NULL)
+        {
+            return false;
+        }
+        motion->SetLoop(true);
+        _motionManager->StartMotionPriority(motion, true, 1);
+
+        for (csmInt32 i = 0; i < options.ExpressionCount; ++i)
+        {
+            const std::string expressionJson = GenerateExpressionJson(options, i);
+            ACubismMotion* expression = LoadExpression(reinterpret_cast<const csmByte*>(expressionJson.data()), static_cast<csmSizeInt>(expressionJson.size()), "synthetic");
+            if (expression != NULL)
+            {
+                _expressions.PushBack(expression);
+            }
+        }
+
+        // モデルごとに表情を切り替える時刻をずらす
+        _expressionTimeSeconds = ExpressionIntervalSeconds * modelIndex / 7.0f;
+        if (_expressions.GetSize() > 0)
+        {
+            _expressionManager->StartMotion(_expressions[0], false);
+        }
+
+        const std::string physicsJson = GeneratePhysicsJson(options);
+        LoadPhysics(reinterpret_cast<const csmByte*>(physicsJson.data()), static_cast<csmSizeInt>(physicsJson.size()));
+
+        const std::string poseJson = GeneratePoseJson(options);
+        LoadPose(reinterpret_cast<const csmByte*>(poseJson.data()), static_cast<csmSizeInt>(poseJson.size()));
+
+        _clippingManager = CSM_NEW HeadlessClippingManager();
+        _clippingManager->Initialize(*_model, 1);
+
+        return _physics != NULL && _pose != NULL;
+    }
+
+    /**
+     * Updates the model and adds the time of each stage.
+     */
+    void Update(csmFloat32 deltaTimeSeconds, csmUint64* stageNanoseconds)
+    {
+        const csmUint64 begin = GetTimeNanoseconds();
+
+        _model->LoadParameters();
+        _motionManager->UpdateMotion(_model, deltaTimeSeconds);
+        _model->SaveParameters();
+        const csmUint64 motionEnd = GetTimeNanoseconds();
+
+        _expressionTimeSeconds += deltaTimeSeconds;
+        if (_expressionTimeSeconds >= ExpressionIntervalSeconds && _expressions.GetSize() > 0)
+        {
+            _expressionTimeSeconds -= ExpressionIntervalSeconds;
+            _expressionIndex = (_expressionIndex + 1) % _expressions.GetSize();
+            _expressionManager->StartMotion(_expressions[_expressionIndex], false);
+        }
+        _expressionManager->UpdateMotion(_model, deltaTimeSeconds);
+        const csmUint64 expressionEnd = GetTimeNanoseconds();
+
+        _physics->Evaluate(_model, deltaTimeSeconds);
+        const csmUint64 physicsEnd = GetTimeNanoseconds();
+
+        _pose->UpdateParameters(_model, deltaTimeSeconds);
+        const csmUint64 poseEnd = GetTimeNanoseconds();
+
+        _model->Update();
+        const csmUint64 modelEnd = GetTimeNanoseconds();
+
+        _clippingManager->SetupMatrixForHighPrecision(*_model, false);
+        const csmUint64 clippingEnd = GetTimeNanoseconds();
+
+        stageNanoseconds[FrameStage_Motion] += motionEnd - begin;
+        stageNanoseconds[FrameStage_Expression] += expressionEnd - motionEnd;
+        stageNanoseconds[FrameStage_Physics] += physicsEnd - expressionEnd;
+        stageNanoseconds[FrameStage_Pose] += poseEnd - physicsEnd;
+        stageNanoseconds[FrameStage_ModelUpdate] += modelEnd - poseEnd;
+        stageNanoseconds[FrameStage_Clipping] += clippingEnd - modelEnd;
+    }
+
+private:
+    HeadlessClippingManager* _clippingManager;
+    csmVector<ACubismMotion*> _expressions;
+    csmUint32 _expressionIndex;
+    csmFloat32 _expressionTimeSeconds;
+};
+
+MicroBenchmarkResult MakeResult(const csmChar* name, std::vector<double>& samples, csmInt32 modelCount)
+{
+    std::sort(samples.begin(), samples.end());
+
+    const size_t count = samples.size();
+    MicroBenchmarkResult result;
+    result.Name = name;
+    result.IterationsPerRepeat = static_cast<csmUint64>(modelCount);
+    result.RepeatCount = static_cast<csmInt32>(count);
+    result.MedianNanoseconds = (count % 2 != 0) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) * 0.5;
+    result.MinimumNanoseconds = samples[0];
+    result.MaximumNanoseconds = samples[count - 1];
+    result.BytesPerOperation = 0;
+
+    return result;
+}
+
+}
+
+FrameBenchmarkOptions::FrameBenchmarkOptions()
+    : ModelCount(8)
+    , FrameCount(600)
+    , FrameRate(60.0f)
+{
+}
+
+csmBool RunFrameBenchmark(const csmByte* mocBuffer, csmSizeInt mocSize, const FrameBenchmarkOptions& options,
+                          std::vector<MicroBenchmarkResult>& outResults)
+{
+    const csmInt32 modelCount = (options.ModelCount > 0) ? options.ModelCount : 1;
+    const csmInt32 frameCount = (options.FrameCount > 0) ? options.FrameCount : 1;
+    const csmFloat32 deltaTimeSeconds = 1.0f / options.FrameRate;
+    csmVector<HeadlessModel*> models;
+    csmBool result = true;
+
+    for (csmInt32 i = 0; i < modelCount; ++i)
+    {
+        HeadlessModel* model = CSM_NEW HeadlessModel();
+        models.PushBack(model);
+
+        if (!model->Setup(mocBuffer, mocSize, options.Model, i))
+        {
+            fprintf(stderr, "frame benchmark: failed to load model %d\n", i);
+            result = false;
+            break;
+        }
+    }
+
+    if (result)
+    {
+        std::vector<double> stageSamples[FrameStage_Count];
+        std::vector<double> totalSamples;
+        csmUint64 stageNanoseconds[FrameStage_Count];
+        CubismAllocationSnapshot runBegin;
+        CubismAllocationSnapshot frameBegin;
+        CubismAllocationSnapshot frameEnd;
+        CubismAllocationSnapshot frameDifference;
+        csmUint64 maximumFrameAllocationCount = 0;
+
+        for (csmInt32 frame = -WarmUpFrameCount; frame < frameCount; ++frame)
+        {
+            for (csmInt32 s = 0; s < FrameStage_Count; ++s)
+            {
+                stageNanoseconds[s] = 0;
+            }
+
+            if (frame == 0)
+            {
+                CubismAllocationStats::ResetPeak();
+                CubismAllocationStats::GetSnapshot(runBegin);
+            }
+            CubismAllocationStats::GetSnapshot(frameBegin);
+
+            const csmUint64 begin = GetTimeNanoseconds();
+
+            for (csmUint32 i = 0; i < models.GetSize(); ++i)
+            {
+                models[i]->Update(deltaTimeSeconds, stageNanoseconds);
+            }
+
+            const csmUint64 end = GetTimeNanoseconds();
+
+            if (frame < 0)
+            {
+                continue;
+            }
+
+            CubismAllocationStats::GetSnapshot(frameEnd);
+            CubismAllocationStats::GetDifference(frameBegin, frameEnd, frameDifference);
+            maximumFrameAllocationCount = std::max(maximumFrameAllocationCount, frameDifference.AllocationCount);
+
+            for (csmInt32 s = 0; s < FrameStage_Count; ++s)
+            {
+                stageSamples[s].push_back(static_cast<double>(stageNanoseconds[s]));
+            }
+            totalSamples.push_back(static_cast<double>(end - begin));
+        }
+
+        for (csmInt32 s = 0; s < FrameStage_Count; ++s)
+        {
+            outResults.push_back(MakeResult(FrameStageNames[s], stageSamples[s], modelCount));
+        }
+        outResults.push_back(MakeResult("frame_total", totalSamples, modelCount));
+
+        // 定常状態のフレームは確保しないはずなので、確保があれば報告する
+        if (CubismAllocationStats::IsEnabled())
+        {
+            CubismAllocationStats::GetDifference(runBegin, frameEnd, frameDifference);
+            fprintf(stderr, "frame benchmark: %llu allocations (at most %llu in a frame) and %llu copies in %d frames; peak live bytes %llu\n",
+                    static_cast<unsigned long long>(frameDifference.AllocationCount),
+                    static_cast<unsigned long long>(maximumFrameAllocationCount),
+                    static_cast<unsigned long long>(frameDifference.CopyCount), frameCount,
+                    static_cast<unsigned long long>(frameDifference.PeakLiveBytes));
+        }
+    }
+
+    for (csmUint32 i = 0; i < models.GetSize(); ++i)
+    {
+        CSM_DELETE(models[i]);
+    }
+
+    return result;
+}
+
+}
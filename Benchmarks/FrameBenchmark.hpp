@@ -0,0 +1,50 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <vector>
+#include "MicroBenchmarks.hpp"
+#include "SyntheticJson.hpp"
+
+namespace CubismBench {
+
+/**
+ * Settings of the frame benchmark.
+ */
+struct FrameBenchmarkOptions
+{
+    FrameBenchmarkOptions();
+
+    Csm::csmInt32 ModelCount;           ///< Models updated every frame
+    Csm::csmInt32 FrameCount;           ///< Frames measured after the warm-up
+    Csm::csmFloat32 FrameRate;          ///< Frame rate at which the updates are simulated
+    SyntheticModelOptions Model;        ///< Size of the generated motion, physics, expression and pose files
+};
+
+/**
+ * Runs the CPU side of the frame for several models without a renderer.<br>
+ * Each model is updated like CubismUserModel in the samples: motion, expression, physics, pose, the model<br>
+ * and the bounds of its clipping masks. The files of each model are generated with a different seed.
+ *
+ * Results are the time of each stage per frame, summed over the models, named frame_motion, frame_expression,<br>
+ * frame_physics, frame_pose, frame_model_update, frame_clipping and frame_total. The median, minimum and<br>
+ * maximum are taken over the frames. When the framework counts allocations (CSM_ALLOCATION_STATS), the allocations<br>
+ * and copies of the measured frames are reported on stderr.
+ *
+ * @param mocBuffer contents of the .moc3 shared by the models; a moc of the Core stand-in also works
+ * @param mocSize size of the moc in bytes
+ * @param options settings of the run
+ * @param outResults receives the results
+ *
+ * @return true if the models could be loaded; otherwise false.
+ */
+Csm::csmBool RunFrameBenchmark(const Csm::csmByte* mocBuffer, Csm::csmSizeInt mocSize, const FrameBenchmarkOptions& options,
+                               std::vector<MicroBenchmarkResult>& outResults);
+
+}
@@ -0,0 +1,218 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "MatrixBenchmark.hpp"
+#include "BenchPlatform.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <Math/CubismMatrix44.hpp>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace CubismBench {
+
+namespace {
+
+const csmInt32 MultiplyRepeatCount = 1000000;
+const csmInt32 InvertRepeatCount = 1000000;
+const csmInt32 TransformRepeatCount = 200;
+
+/**
+ * Multiplication as implemented before the SIMD version.
+ */
+void ReferenceMultiply(const csmFloat32* a, const csmFloat32* b, csmFloat32* dst)
+{
+    csmFloat32 c[16] = {
+                        0.0f, 0.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f,
+                        0.0f, 0.0f, 0.0f, 0.0f
+                        };
+
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        for (csmInt32 j = 0; j < 4; ++j)
+        {
+            for (csmInt32 k = 0; k < 4; ++k)
+            {
+                c[j + i * 4] += a[k + i * 4] * b[j + k * 4];
+            }
+        }
+    }
+
+    for (csmInt32 i = 0; i < 16; ++i)
+    {
+        dst[i] = c[i];
+    }
+}
+
+/**
+ * Point transformation as done by callers before TransformPoints(): one coordinate at a time.
+ */
+void ReferenceTransformPoints(CubismMatrix44& matrix, const csmFloat32* src, csmFloat32* dst, csmInt32 pointCount)
+{
+    for (csmInt32 i = 0; i < pointCount; ++i)
+    {
+        dst[i * 2] = matrix.TransformX(src[i * 2]);
+        dst[i * 2 + 1] = matrix.TransformY(src[i * 2 + 1]);
+    }
+}
+
+csmFloat32 Random(csmFloat32 min, csmFloat32 max)
+{
+    return min + (max - min) * (static_cast<csmFloat32>(rand()) / RAND_MAX);
+}
+
+/**
+ * Makes a matrix with scale, rotation and translation.
+ */
+void MakeAffineMatrix(csmFloat32* m, csmFloat32 maxAngle, csmFloat32 minScale, csmFloat32 maxScale)
+{
+    const csmFloat32 angle = Random(-maxAngle, maxAngle);
+    const csmFloat32 sx = Random(minScale, maxScale);
+    const csmFloat32 sy = Random(minScale, maxScale);
+
+    for (csmInt32 i = 0; i < 16; ++i)
+    {
+        m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+
+    m[0] = cosf(angle) * sx;
+    m[1] = sinf(angle) * sy;
+    m[4] = -sinf(angle) * sx;
+    m[5] = cosf(angle) * sy;
+    m[12] = Random(-2.0f, 2.0f);
+    m[13] = Random(-2.0f, 2.0f);
+}
+
+csmFloat32 MaxDifference(const csmFloat32* a, const csmFloat32* b, csmInt32 count)
+{
+    csmFloat32 result = 0.0f;
+
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        const csmFloat32 d = fabsf(a[i] - b[i]);
+        result = (d > result) ? d : result;
+    }
+
+    return result;
+}
+
+}
+
+csmBool RunMatrixBenchmark(csmInt32 pointCount)
+{
+    if (pointCount <= 0)
+    {
+        printf("matrix: the point count must be positive\n");
+        return false;
+    }
+
+    srand(1);
+
+    // 連続して掛けても発散しないように、繰り返し用の行列は回転と平行移動だけにする
+    csmFloat32 a[16], b[16], rotationA[16], rotationB[16];
+    MakeAffineMatrix(a, 3.0f, 0.2f, 4.0f);
+    MakeAffineMatrix(b, 3.0f, 0.2f, 4.0f);
+    MakeAffineMatrix(rotationA, 3.0f, 1.0f, 1.0f);
+    MakeAffineMatrix(rotationB, 3.0f, 1.0f, 1.0f);
+
+    // 乗算。結果を次の入力に戻して、呼び出しを省略させない
+    csmFloat32 reference[16], result[16];
+    ReferenceMultiply(a, b, reference);
+    CubismMatrix44::Multiply(a, b, result);
+    const csmFloat32 multiplyError = MaxDifference(reference, result, 16);
+
+    csmFloat32 chain[16];
+    ReferenceMultiply(rotationA, rotationB, chain);
+    csmUint64 begin = GetTimeNanoseconds();
+    for (csmInt32 i = 0; i < MultiplyRepeatCount; ++i)
+    {
+        ReferenceMultiply(rotationA, chain, chain);
+        ReferenceMultiply(rotationB, chain, chain);
+    }
+    const double referenceMultiplyNanoseconds = static_cast<double>(GetTimeNanoseconds() - begin) / (MultiplyRepeatCount * 2);
+    const csmFloat32 referenceChecksum = chain[0];
+
+    ReferenceMultiply(rotationA, rotationB, chain);
+    begin = GetTimeNanoseconds();
+    for (csmInt32 i = 0; i < MultiplyRepeatCount; ++i)
+    {
+        CubismMatrix44::Multiply(rotationA, chain, chain);
+        CubismMatrix44::Multiply(rotationB, chain, chain);
+    }
+    const double multiplyNanoseconds = static_cast<double>(GetTimeNanoseconds() - begin) / (MultiplyRepeatCount * 2);
+    const csmFloat32 checksum = chain[0];
+
+    // 逆行列。元の行列との積が単位行列になるかを確かめる
+    csmFloat32 inverse[16], identity[16];
+    const csmBool isInverted = CubismMatrix44::Invert(result, inverse);
+    CubismMatrix44::Multiply(result, inverse, identity);
+    csmFloat32 expectedIdentity[16];
+    for (csmInt32 i = 0; i < 16; ++i)
+    {
+        expectedIdentity[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+    const csmFloat32 invertError = MaxDifference(identity, expectedIdentity, 16);
+
+    csmFloat32 invertChecksum = 0.0f;
+    begin = GetTimeNanoseconds();
+    for (csmInt32 i = 0; i < InvertRepeatCount; ++i)
+    {
+        CubismMatrix44::Invert(result, inverse);
+        invertChecksum += inverse[i & 15];
+    }
+    const double invertNanoseconds = static_cast<double>(GetTimeNanoseconds() - begin) / InvertRepeatCount;
+
+    // 頂点の変換。TransformX()/TransformY() は回転を扱わないので、モデル行列と同じく拡大と平行移動だけの行列で比べる
+    CubismMatrix44 modelMatrix;
+    modelMatrix.Scale(Random(0.2f, 4.0f), Random(0.2f, 4.0f));
+    modelMatrix.Translate(Random(-2.0f, 2.0f), Random(-2.0f, 2.0f));
+    csmFloat32* points = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * pointCount * 2));
+    csmFloat32* referencePoints = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * pointCount * 2));
+    csmFloat32* transformedPoints = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * pointCount * 2));
+
+    for (csmInt32 i = 0; i < pointCount * 2; ++i)
+    {
+        points[i] = Random(-1.0f, 1.0f);
+    }
+
+    begin = GetTimeNanoseconds();
+    for (csmInt32 i = 0; i < TransformRepeatCount; ++i)
+    {
+        ReferenceTransformPoints(modelMatrix, points, referencePoints, pointCount);
+    }
+    const double referenceTransformNanoseconds = static_cast<double>(GetTimeNanoseconds() - begin) / (static_cast<double>(TransformRepeatCount) * pointCount);
+
+    begin = GetTimeNanoseconds();
+    for (csmInt32 i = 0; i < TransformRepeatCount; ++i)
+    {
+        modelMatrix.TransformPoints(points, transformedPoints, pointCount);
+    }
+    const double transformNanoseconds = static_cast<double>(GetTimeNanoseconds() - begin) / (static_cast<double>(TransformRepeatCount) * pointCount);
+
+    const csmFloat32 transformError = MaxDifference(referencePoints, transformedPoints, pointCount * 2);
+
+    printf("matrix\n");
+    printf("  multiply        reference %.2f ns, simd %.2f ns (x%.2f), max difference %g\n",
+           referenceMultiplyNanoseconds, multiplyNanoseconds,
+           (multiplyNanoseconds > 0.0) ? referenceMultiplyNanoseconds / multiplyNanoseconds : 0.0, multiplyError);
+    printf("  invert          %.2f ns, max |M * inverse(M) - I| %g\n", invertNanoseconds, invertError);
+    printf("  transform       %d points, reference %.3f ns, simd %.3f ns per point (x%.2f), max difference %g\n",
+           pointCount, referenceTransformNanoseconds, transformNanoseconds,
+           (transformNanoseconds > 0.0) ? referenceTransformNanoseconds / transformNanoseconds : 0.0, transformError);
+    printf("  checksum        %g / %g / %g\n", referenceChecksum, checksum, invertChecksum);
+
+    CSM_FREE(transformedPoints);
+    CSM_FREE(referencePoints);
+    CSM_FREE(points);
+
+    return isInverted && multiplyError == 0.0f && transformError == 0.0f && invertError < 1e-4f;
+}
+
+}
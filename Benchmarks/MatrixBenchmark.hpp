@@ -0,0 +1,24 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+namespace CubismBench {
+
+/**
+ * Compares CubismMatrix44 against the previous scalar implementation.<br>
+ * Prints the time of matrix multiplication, inversion and point transformation, and the difference of the results.
+ *
+ * @param pointCount number of points transformed per call of TransformPoints()
+ *
+ * @return true if the results match the scalar implementation; otherwise false.
+ */
+Csm::csmBool RunMatrixBenchmark(Csm::csmInt32 pointCount);
+
+}
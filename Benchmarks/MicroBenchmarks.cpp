@@ -0,0 +1,453 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "MicroBenchmarks.hpp"
+#include "BenchPlatform.hpp"
+#include <algorithm>
+#include <cstring>
+#include <Effect/CubismPose.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Motion/CubismExpressionMotion.hpp>
+#include <Motion/CubismExpressionMotionManager.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Type/csmMap.hpp>
+#include <Type/csmString.hpp>
+#include <Type/csmVector.hpp>
+#include <Utils/CubismJson.hpp>
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Utils;
+
+namespace CubismBench {
+
+namespace {
+
+const csmFloat32 FrameSeconds = 1.0f / 60.0f;
+const csmInt32 ContainerElementCount = 1024;
+const csmInt32 MapKeyCount = 64;
+const csmInt32 StringPieceCount = 64;
+const csmUint64 MaximumIterations = 1ull << 30;
+
+// 結果を捨てる処理が最適化で消されないように書き込む先
+volatile csmUint64 Sink = 0;
+
+typedef void (*OperationFunction)(void* context);
+
+struct BufferContext
+{
+    const csmByte* Buffer;
+    csmSizeInt Size;
+};
+
+struct ModelContext
+{
+    CubismModel* Model;
+    CubismMotionManager* Motions;
+    CubismExpressionMotionManager* Expressions;
+    CubismPhysics* Physics;
+    CubismPose* Pose;
+};
+
+struct IdContext
+{
+    csmVector<csmString> Names;
+};
+
+/**
+ * Times the operations and collects the results of the selected benchmarks.
+ */
+class Runner
+{
+public:
+    Runner(const MicroBenchmarkOptions& options, std::vector<MicroBenchmarkResult>& results)
+        : _options(options)
+        , _results(results)
+    {
+    }
+
+    csmBool IsSelected(const csmChar* name) const
+    {
+        return _options.Filter.empty() || _options.Filter == "all" || strstr(name, _options.Filter.c_str()) != NULL;
+    }
+
+    void Measure(const csmChar* name, OperationFunction operation, void* context, csmUint64 bytesPerOperation)
+    {
+        if (!IsSelected(name))
+        {
+            return;
+        }
+
+        const csmInt32 repeatCount = (_options.RepeatCount > 0) ? _options.RepeatCount : 1;
+        const csmUint64 batchNanoseconds = static_cast<csmUint64>(_options.MinimumSeconds * 1.0e9f / repeatCount);
+
+        // 初回の確保やキャッシュの影響を除く
+        operation(context);
+
+        // 1回のバッチが目標時間に届くまで反復回数を倍にする
+        csmUint64 iterations = 1;
+        while (iterations < MaximumIterations && RunBatch(operation, context, iterations) < batchNanoseconds)
+        {
+            iterations *= 2;
+        }
+
+        std::vector<double> samples;
+        samples.reserve(repeatCount);
+
+        for (csmInt32 i = 0; i < repeatCount; ++i)
+        {
+            samples.push_back(static_cast<double>(RunBatch(operation, context, iterations)) / iterations);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        MicroBenchmarkResult result;
+        result.Name = name;
+        result.IterationsPerRepeat = iterations;
+        result.RepeatCount = repeatCount;
+        result.MedianNanoseconds = (repeatCount % 2 != 0)
+                                 ? samples[repeatCount / 2]
+                                 : (samples[repeatCount / 2 - 1] + samples[repeatCount / 2]) * 0.5;
+        result.MinimumNanoseconds = samples[0];
+        result.MaximumNanoseconds = samples[repeatCount - 1];
+        result.BytesPerOperation = bytesPerOperation;
+        _results.push_back(result);
+    }
+
+private:
+    static csmUint64 RunBatch(OperationFunction operation, void* context, csmUint64 iterations)
+    {
+        const csmUint64 begin = GetTimeNanoseconds();
+
+        for (csmUint64 i = 0; i < iterations; ++i)
+        {
+            operation(context);
+        }
+
+        return GetTimeNanoseconds() - begin;
+    }
+
+    const MicroBenchmarkOptions& _options;
+    std::vector<MicroBenchmarkResult>& _results;
+};
+
+void ParseJson(void* context)
+{
+    const BufferContext* buffer = static_cast<const BufferContext*>(context);
+    CubismJson* json = CubismJson::Create(buffer->Buffer, buffer->Size);
+    Sink += (json != NULL) ? 1 : 0;
+    CubismJson::Delete(json);
+}
+
+void LoadMotion(void* context)
+{
+    const BufferContext* buffer = static_cast<const BufferContext*>(context);
+    CubismMotion* motion = CubismMotion::Create(buffer->Buffer, buffer->Size);
+    Sink += (motion != NULL) ? 1 : 0;
+    ACubismMotion::Delete(motion);
+}
+
+void LoadPhysics(void* context)
+{
+    const BufferContext* buffer = static_cast<const BufferContext*>(context);
+    CubismPhysics* physics = CubismPhysics::Create(buffer->Buffer, buffer->Size);
+    Sink += (physics != NULL) ? 1 : 0;
+    CubismPhysics::Delete(physics);
+}
+
+void UpdateMotion(void* context)
+{
+    ModelContext* model = static_cast<ModelContext*>(context);
+    Sink += model->Motions->UpdateMotion(model->Model, FrameSeconds) ? 1 : 0;
+}
+
+void UpdateExpressions(void* context)
+{
+    ModelContext* model = static_cast<ModelContext*>(context);
+    Sink += model->Expressions->UpdateMotion(model->Model, FrameSeconds) ? 1 : 0;
+}
+
+void EvaluatePhysics(void* context)
+{
+    ModelContext* model = static_cast<ModelContext*>(context);
+    model->Physics->Evaluate(model->Model, FrameSeconds);
+}
+
+void UpdatePose(void* context)
+{
+    ModelContext* model = static_cast<ModelContext*>(context);
+    model->Pose->UpdateParameters(model->Model, FrameSeconds);
+}
+
+void PushBackVector(void*)
+{
+    csmVector<csmInt32> values;
+
+    for (csmInt32 i = 0; i < ContainerElementCount; ++i)
+    {
+        values.PushBack(i);
+    }
+
+    Sink += values[ContainerElementCount - 1];
+}
+
+void InsertAndFindMap(void*)
+{
+    csmMap<csmInt32, csmInt32> map;
+
+    for (csmInt32 i = 0; i < MapKeyCount; ++i)
+    {
+        map[i * 7] = i;
+    }
+
+    csmInt32 sum = 0;
+    for (csmInt32 i = 0; i < MapKeyCount; ++i)
+    {
+        sum += map.IsExist(i * 7) ? map[i * 7] : 0;
+    }
+
+    Sink += sum;
+}
+
+void AppendString(void*)
+{
+    csmString text;
+
+    for (csmInt32 i = 0; i < StringPieceCount; ++i)
+    {
+        text += "SyntheticParam";
+    }
+
+    Sink += text.GetLength();
+}
+
+void CopyAndCompareString(void* context)
+{
+    const IdContext* ids = static_cast<const IdContext*>(context);
+    csmInt32 matches = 0;
+
+    for (csmUint32 i = 0; i < ids->Names.GetSize(); ++i)
+    {
+        const csmString copy = ids->Names[i];
+        matches += (copy == ids->Names[ids->Names.GetSize() - 1 - i]) ? 1 : 0;
+    }
+
+    Sink += matches;
+}
+
+void GetIds(void* context)
+{
+    const IdContext* ids = static_cast<const IdContext*>(context);
+    CubismIdManager* idManager = CubismFramework::GetIdManager();
+    csmUint64 sum = 0;
+
+    for (csmUint32 i = 0; i < ids->Names.GetSize(); ++i)
+    {
+        sum += reinterpret_cast<csmUint64>(idManager->GetId(ids->Names[i].GetRawString()));
+    }
+
+    Sink += sum;
+}
+
+BufferContext ToBuffer(const std::string& text)
+{
+    BufferContext buffer;
+    buffer.Buffer = reinterpret_cast<const csmByte*>(text.data());
+    buffer.Size = static_cast<csmSizeInt>(text.size());
+    return buffer;
+}
+
+/**
+ * Benchmarks that need a model: motion, expression, physics and pose updates.
+ */
+csmBool RunModelBenchmarks(const MicroBenchmarkOptions& options, Runner& runner)
+{
+    if (!runner.IsSelected("motion_update") && !runner.IsSelected("expression_blend")
+        && !runner.IsSelected("physics_evaluate") && !runner.IsSelected("pose_update"))
+    {
+        return true;
+    }
+
+    if (options.MocBuffer == NULL)
+    {
+        fprintf(stderr, "model benchmarks skipped: no moc3 file\n");
+        return true;
+    }
+
+    CubismMoc* moc = CubismMoc::Create(options.MocBuffer, options.MocSize);
+
+    if (moc == NULL)
+    {
+        fprintf(stderr, "model benchmarks skipped: failed to load the moc3 file\n");
+        return false;
+    }
+
+    ModelContext context;
+    context.Model = moc->CreateModel();
+
+    if (context.Model == NULL)
+    {
+        fprintf(stderr, "model benchmarks skipped: failed to create the model\n");
+        CubismMoc::Delete(moc);
+        return false;
+    }
+
+    SyntheticModelOptions modelOptions = options.Model;
+    SetModelIds(context.Model, modelOptions);
+
+    const std::string motionJson = GenerateMotionJson(modelOptions);
+    const BufferContext motionBuffer = ToBuffer(motionJson);
+    CubismMotion* motion = CubismMotion::Create(motionBuffer.Buffer, motionBuffer.Size);
+    motion->SetLoop(true);
+
+    context.Motions = CSM_NEW CubismMotionManager();
+    context.Motions->StartMotionPriority(motion, true, 1);
+
+    context.Expressions = CSM_NEW CubismExpressionMotionManager();
+    for (csmInt32 i = 0; i < options.Model.ExpressionCount; ++i)
+    {
+        const std::string expressionJson = GenerateExpressionJson(modelOptions, i);
+        const BufferContext expressionBuffer = ToBuffer(expressionJson);
+        CubismExpressionMotion* expression = CubismExpressionMotion::Create(expressionBuffer.Buffer, expressionBuffer.Size);
+        context.Expressions->StartMotion(expression, true);
+    }
+
+    const std::string physicsJson = GeneratePhysicsJson(modelOptions);
+    const BufferContext physicsBuffer = ToBuffer(physicsJson);
+    context.Physics = CubismPhysics::Create(physicsBuffer.Buffer, physicsBuffer.Size);
+
+    const std::string poseJson = GeneratePoseJson(modelOptions);
+    const BufferContext poseBuffer = ToBuffer(poseJson);
+    context.Pose = CubismPose::Create(poseBuffer.Buffer, poseBuffer.Size);
+
+    runner.Measure("motion_update", UpdateMotion, &context, 0);
+    runner.Measure("expression_blend", UpdateExpressions, &context, 0);
+    runner.Measure("physics_evaluate", EvaluatePhysics, &context, 0);
+    runner.Measure("pose_update", UpdatePose, &context, 0);
+
+    CubismPose::Delete(context.Pose);
+    CubismPhysics::Delete(context.Physics);
+    CSM_DELETE(context.Expressions);
+    CSM_DELETE(context.Motions);
+    moc->DeleteModel(context.Model);
+    CubismMoc::Delete(moc);
+
+    return true;
+}
+
+}
+
+MicroBenchmarkOptions::MicroBenchmarkOptions()
+    : Filter("all")
+    , MocBuffer(NULL)
+    , MocSize(0)
+    , MinimumSeconds(0.5f)
+    , RepeatCount(5)
+{
+}
+
+csmBool RunMicroBenchmarks(const MicroBenchmarkOptions& options, std::vector<MicroBenchmarkResult>& outResults)
+{
+    Runner runner(options, outResults);
+    const std::string motionJson = GenerateMotionJson(options.Model);
+    const std::string physicsJson = GeneratePhysicsJson(options.Model);
+    BufferContext motionBuffer = ToBuffer(motionJson);
+    BufferContext physicsBuffer = ToBuffer(physicsJson);
+
+    runner.Measure("json_parse_motion", ParseJson, &motionBuffer, motionBuffer.Size);
+    runner.Measure("json_parse_physics", ParseJson, &physicsBuffer, physicsBuffer.Size);
+    runner.Measure("motion_load", LoadMotion, &motionBuffer, motionBuffer.Size);
+    runner.Measure("physics_load", LoadPhysics, &physicsBuffer, physicsBuffer.Size);
+
+    const csmBool modelResult = RunModelBenchmarks(options, runner);
+
+    runner.Measure("vector_push_back_1024", PushBackVector, NULL, 0);
+    runner.Measure("map_insert_find_64", InsertAndFindMap, NULL, 0);
+    runner.Measure("string_append_64", AppendString, NULL, 0);
+
+    {
+        IdContext ids;
+        csmChar name[64];
+        const csmInt32 parameterCount = (options.Model.ParameterCount > 0) ? options.Model.ParameterCount : 1;
+
+        for (csmInt32 i = 0; i < parameterCount; ++i)
+        {
+            snprintf(name, sizeof(name), "SyntheticParam%d", i);
+            ids.Names.PushBack(csmString(name));
+            CubismFramework::GetIdManager()->GetId(name);
+        }
+
+        runner.Measure("string_copy_compare", CopyAndCompareString, &ids, 0);
+        runner.Measure("id_manager_get_id", GetIds, &ids, 0);
+    }
+
+    return modelResult;
+}
+
+void WriteMicroBenchmarkResults(const std::vector<MicroBenchmarkResult>& results, const MicroBenchmarkOptions& options,
+                                MicroBenchmarkFormat format, FILE* file)
+{
+    const SyntheticModelOptions& model = options.Model;
+
+    switch (format)
+    {
+    case MicroBenchmarkFormat_Json:
+        fprintf(file, "{\n  \"options\": {\"parameters\": %d, \"curves\": %d, \"segments_per_curve\": %d, \"physics_settings\": %d, "
+                      "\"expressions\": %d, \"pose_groups\": %d, \"seed\": %u, \"repeats\": %d},\n  \"benchmarks\": [\n",
+                model.ParameterCount, model.CurveCount, model.SegmentsPerCurve, model.PhysicsSettingCount,
+                model.ExpressionCount, model.PoseGroupCount, model.Seed, options.RepeatCount);
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const MicroBenchmarkResult& result = results[i];
+            fprintf(file, "    {\"name\": \"%s\", \"median_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, \"iterations\": %llu, \"repeats\": %d, \"bytes_per_op\": %llu}%s\n",
+                    result.Name.c_str(), result.MedianNanoseconds, result.MinimumNanoseconds, result.MaximumNanoseconds,
+                    static_cast<unsigned long long>(result.IterationsPerRepeat), result.RepeatCount,
+                    static_cast<unsigned long long>(result.BytesPerOperation), (i + 1 < results.size()) ? "," : "");
+        }
+
+        fprintf(file, "  ]\n}\n");
+        break;
+
+    case MicroBenchmarkFormat_Csv:
+        fprintf(file, "name,median_ns,min_ns,max_ns,iterations,repeats,bytes_per_op\n");
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const MicroBenchmarkResult& result = results[i];
+            fprintf(file, "%s,%.3f,%.3f,%.3f,%llu,%d,%llu\n",
+                    result.Name.c_str(), result.MedianNanoseconds, result.MinimumNanoseconds, result.MaximumNanoseconds,
+                    static_cast<unsigned long long>(result.IterationsPerRepeat), result.RepeatCount,
+                    static_cast<unsigned long long>(result.BytesPerOperation));
+        }
+        break;
+
+    default:
+        fprintf(file, "%-24s %14s %14s %14s %12s\n", "benchmark", "median ns/op", "min ns/op", "max ns/op", "MB/s");
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const MicroBenchmarkResult& result = results[i];
+            fprintf(file, "%-24s %14.1f %14.1f %14.1f", result.Name.c_str(), result.MedianNanoseconds, result.MinimumNanoseconds, result.MaximumNanoseconds);
+
+            if (result.BytesPerOperation > 0 && result.MedianNanoseconds > 0.0)
+            {
+                fprintf(file, " %12.1f\n", result.BytesPerOperation * 1000.0 / result.MedianNanoseconds);
+            }
+            else
+            {
+                fprintf(file, " %12s\n", "-");
+            }
+        }
+        break;
+    }
+}
+
+}
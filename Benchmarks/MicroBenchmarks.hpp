@@ -0,0 +1,79 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "SyntheticJson.hpp"
+
+namespace CubismBench {
+
+/**
+ * Output format of the results.
+ */
+enum MicroBenchmarkFormat
+{
+    MicroBenchmarkFormat_Text = 0,  ///< Aligned table for reading
+    MicroBenchmarkFormat_Json,      ///< JSON object for regression tracking
+    MicroBenchmarkFormat_Csv        ///< One line per benchmark with a header
+};
+
+/**
+ * Settings of a run.
+ */
+struct MicroBenchmarkOptions
+{
+    MicroBenchmarkOptions();
+
+    std::string Filter;                 ///< Runs the benchmarks whose name contains this text; "all" runs every benchmark
+    const Csm::csmByte* MocBuffer;      ///< Contents of a .moc3 used by the benchmarks that need a model; NULL skips them
+    Csm::csmSizeInt MocSize;            ///< Size of MocBuffer in bytes
+    SyntheticModelOptions Model;        ///< Size of the generated motion, physics, expression and pose files
+    Csm::csmFloat32 MinimumSeconds;     ///< Time spent measuring each benchmark, split over the repeats
+    Csm::csmInt32 RepeatCount;          ///< Number of timed batches; the median and minimum are reported
+};
+
+/**
+ * Result of a benchmark.
+ */
+struct MicroBenchmarkResult
+{
+    std::string Name;                       ///< Name of the benchmark
+    Csm::csmUint64 IterationsPerRepeat;     ///< Operations timed in each batch
+    Csm::csmInt32 RepeatCount;              ///< Number of batches
+    double MedianNanoseconds;               ///< Median time per operation
+    double MinimumNanoseconds;              ///< Fastest time per operation
+    double MaximumNanoseconds;              ///< Slowest time per operation
+    Csm::csmUint64 BytesPerOperation;       ///< Input bytes processed per operation; 0 if not meaningful
+};
+
+/**
+ * Runs the microbenchmarks of the framework.<br>
+ * Covers JSON parsing, motion curves, expressions, physics, pose, containers and ID interning.
+ *
+ * @param options settings of the run
+ * @param outResults receives the results in the order they ran
+ *
+ * @return true if every selected benchmark ran; otherwise false.
+ */
+Csm::csmBool RunMicroBenchmarks(const MicroBenchmarkOptions& options, std::vector<MicroBenchmarkResult>& outResults);
+
+/**
+ * Writes the results of RunMicroBenchmarks().
+ *
+ * @param results results to write
+ * @param options settings the results were measured with
+ * @param format output format
+ * @param file destination
+ */
+void WriteMicroBenchmarkResults(const std::vector<MicroBenchmarkResult>& results, const MicroBenchmarkOptions& options,
+                                MicroBenchmarkFormat format, FILE* file);
+
+}
@@ -0,0 +1,107 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "MotionBakeBenchmark.hpp"
+#include "BenchPlatform.hpp"
+#include <cstdio>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionInternal.hpp>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace CubismBench {
+
+namespace {
+
+const csmInt32 PlaybackRepeatCount = 20;
+
+/**
+ * Plays the motion at a fixed frame rate and returns the average time per frame.
+ */
+csmFloat32 MeasureFrameNanoseconds(const CubismMotion* motion, csmFloat32 frameRate, csmFloat32* values, csmFloat32* checksum)
+{
+    const csmFloat32 duration = motion->GetMotionData()->Duration;
+    const csmInt32 frameCount = static_cast<csmInt32>(duration * frameRate) + 1;
+    csmFloat32 sum = 0.0f;
+
+    const csmUint64 begin = GetTimeNanoseconds();
+
+    for (csmInt32 repeat = 0; repeat < PlaybackRepeatCount; ++repeat)
+    {
+        for (csmInt32 frame = 0; frame < frameCount; ++frame)
+        {
+            motion->EvaluateCurves(frame / frameRate, values);
+            sum += values[0];
+        }
+    }
+
+    const csmUint64 end = GetTimeNanoseconds();
+
+    *checksum = sum;
+
+    return static_cast<csmFloat32>(end - begin) / (PlaybackRepeatCount * frameCount);
+}
+
+}
+
+csmBool RunMotionBakeBenchmark(const csmChar* name, const csmByte* buffer, csmSizeInt size,
+                               csmFloat32 frameRate, csmInt32 samplesPerFrame)
+{
+    CubismMotion* motion = CubismMotion::Create(buffer, size);
+
+    if (motion == NULL)
+    {
+        printf("%s: failed to parse the motion\n", name);
+        return false;
+    }
+
+    const CubismMotionData* data = motion->GetMotionData();
+
+    if (data->CurveCount == 0)
+    {
+        printf("%s: no curves\n", name);
+        ACubismMotion::Delete(motion);
+        return false;
+    }
+
+    const csmSizeInt analyticBytes = data->Curves.GetSize() * sizeof(CubismMotionCurve)
+                                   + data->Segments.GetSize() * sizeof(CubismMotionSegment)
+                                   + data->Points.GetSize() * sizeof(CubismMotionPoint);
+
+    csmFloat32* values = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * data->CurveCount));
+    csmFloat32 analyticChecksum, bakedChecksum;
+
+    const csmFloat32 analyticNanoseconds = MeasureFrameNanoseconds(motion, frameRate, values, &analyticChecksum);
+
+    const csmUint64 bakeBegin = GetTimeNanoseconds();
+    motion->Bake(samplesPerFrame);
+    const csmUint64 bakeEnd = GetTimeNanoseconds();
+
+    const csmFloat32 bakedNanoseconds = MeasureFrameNanoseconds(motion, frameRate, values, &bakedChecksum);
+    const CubismMotion::BakeReport report = motion->GetBakeReport();
+
+    printf("%s\n", name);
+    printf("  curves          %d (%d baked, %d analytic), %d segments, %d points\n",
+           data->CurveCount, report.BakedCurveCount, report.AnalyticCurveCount,
+           data->Segments.GetSize(), data->Points.GetSize());
+    printf("  memory          analytic %u bytes, baked %u bytes (%d samples per curve)\n",
+           analyticBytes, report.TableBytes, report.SampleCount);
+    printf("  bake            %.3f ms\n", (bakeEnd - bakeBegin) / 1000000.0);
+    printf("  frame @%.0ffps   analytic %.1f ns, baked %.1f ns (x%.2f)\n",
+           frameRate, analyticNanoseconds, bakedNanoseconds,
+           (bakedNanoseconds > 0.0f) ? analyticNanoseconds / bakedNanoseconds : 0.0f);
+    printf("  error           max %g (curve %d), mean %g\n",
+           report.MaxError, report.MaxErrorCurveIndex, report.MeanError);
+    printf("  checksum        %g / %g\n", analyticChecksum, bakedChecksum);
+
+    CSM_FREE(values);
+    ACubismMotion::Delete(motion);
+
+    return true;
+}
+
+}
@@ -0,0 +1,29 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+namespace CubismBench {
+
+/**
+ * Compares analytic and baked evaluation of a motion.<br>
+ * Prints the memory used by both representations, the evaluation time per frame and the baking error.
+ *
+ * @param name name printed with the results
+ * @param buffer contents of the motion3.json
+ * @param size size of the buffer in bytes
+ * @param frameRate frame rate at which playback is simulated
+ * @param samplesPerFrame samples per source frame passed to CubismMotion::Bake()
+ *
+ * @return true if the motion could be benchmarked; otherwise false.
+ */
+Csm::csmBool RunMotionBakeBenchmark(const Csm::csmChar* name, const Csm::csmByte* buffer, Csm::csmSizeInt size,
+                                    Csm::csmFloat32 frameRate, Csm::csmInt32 samplesPerFrame);
+
+}
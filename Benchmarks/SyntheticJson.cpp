@@ -0,0 +1,263 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "SyntheticJson.hpp"
+#include <Id/CubismId.hpp>
+#include <cstdarg>
+#include <cstdio>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace CubismBench {
+
+namespace {
+
+/**
+ * Deterministic generator of the values (xorshift32).
+ */
+class Random
+{
+public:
+    explicit Random(csmUint32 seed)
+        : _state(seed != 0 ? seed : 1)
+    {
+    }
+
+    csmFloat32 Next(csmFloat32 minimum, csmFloat32 maximum)
+    {
+        _state ^= _state << 13;
+        _state ^= _state >> 17;
+        _state ^= _state << 5;
+        return minimum + (maximum - minimum) * static_cast<csmFloat32>(_state & 0xFFFFFF) / static_cast<csmFloat32>(0xFFFFFF);
+    }
+
+private:
+    csmUint32 _state;
+};
+
+// CubismJson は指数表記を読まず、数値の直後に改行か , を要求する。
+// 数値は固定小数点で書き、閉じ括弧の前では改行する
+void Append(std::string& text, const csmChar* format, ...)
+{
+    csmChar buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    text += buffer;
+}
+
+csmInt32 Max(csmInt32 value, csmInt32 minimum)
+{
+    return (value > minimum) ? value : minimum;
+}
+
+std::string GetId(const std::vector<std::string>& ids, const csmChar* syntheticPrefix, csmInt32 index)
+{
+    if (!ids.empty())
+    {
+        return ids[index % ids.size()];
+    }
+
+    csmChar buffer[64];
+    snprintf(buffer, sizeof(buffer), "%s%d", syntheticPrefix, index);
+    return buffer;
+}
+
+std::string GetParameterId(const SyntheticModelOptions& options, csmInt32 index)
+{
+    return GetId(options.ParameterIds, "SyntheticParam", index % Max(options.ParameterCount, 1));
+}
+
+}
+
+SyntheticModelOptions::SyntheticModelOptions()
+    : ParameterCount(64)
+    , CurveCount(64)
+    , SegmentsPerCurve(32)
+    , MotionDuration(10.0f)
+    , PhysicsSettingCount(16)
+    , PhysicsInputsPerSetting(4)
+    , PhysicsVerticesPerSetting(4)
+    , PhysicsOutputsPerSetting(3)
+    , ExpressionCount(4)
+    , ExpressionParameterCount(16)
+    , PoseGroupCount(4)
+    , PartsPerPoseGroup(3)
+    , Seed(1)
+{
+}
+
+void SetModelIds(CubismModel* model, SyntheticModelOptions& options)
+{
+    options.ParameterIds.clear();
+    options.PartIds.clear();
+
+    for (csmInt32 i = 0; i < model->GetParameterCount(); ++i)
+    {
+        options.ParameterIds.push_back(model->GetParameterId(i)->GetString().GetRawString());
+    }
+
+    for (csmInt32 i = 0; i < model->GetPartCount(); ++i)
+    {
+        options.PartIds.push_back(model->GetPartId(i)->GetString().GetRawString());
+    }
+}
+
+std::string GenerateMotionJson(const SyntheticModelOptions& options)
+{
+    Random random(options.Seed);
+    const csmInt32 curveCount = Max(options.CurveCount, 1);
+    const csmInt32 segmentCount = Max(options.SegmentsPerCurve, 1);
+    const csmFloat32 step = options.MotionDuration / segmentCount;
+
+    // 線形とベジェを交互に並べる。ベジェは制御点を含めて3点を使う
+    const csmInt32 bezierCount = segmentCount / 2;
+    const csmInt32 linearCount = segmentCount - bezierCount;
+    const csmInt32 pointsPerCurve = 1 + linearCount + bezierCount * 3;
+
+    std::string json;
+    json.reserve(static_cast<size_t>(curveCount) * pointsPerCurve * 24 + 256);
+
+    Append(json, "{\"Version\":3,\"Meta\":{\"Duration\":%.4f,\"Fps\":30.0,\"Loop\":true,\"AreBeziersRestricted\":true,", options.MotionDuration);
+    Append(json, "\"CurveCount\":%d,\"TotalSegmentCount\":%d,\"TotalPointCount\":%d,\"UserDataCount\":0,\"TotalUserDataSize\":0\n},",
+           curveCount, curveCount * segmentCount, curveCount * pointsPerCurve);
+    json += "\"Curves\":[";
+
+    for (csmInt32 c = 0; c < curveCount; ++c)
+    {
+        Append(json, "%s{\"Target\":\"Parameter\",\"Id\":\"%s\",\"Segments\":[0,%.4f", (c > 0) ? "," : "", GetParameterId(options, c).c_str(), random.Next(-1.0f, 1.0f));
+
+        for (csmInt32 s = 0; s < segmentCount; ++s)
+        {
+            const csmFloat32 begin = step * s;
+            const csmFloat32 end = (s == segmentCount - 1) ? options.MotionDuration : step * (s + 1);
+
+            if (s % 2 == 0)
+            {
+                Append(json, ",0,%.4f,%.4f", end, random.Next(-1.0f, 1.0f));
+            }
+            else
+            {
+                Append(json, ",1,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f",
+                       begin + (end - begin) / 3.0f, random.Next(-1.0f, 1.0f),
+                       begin + (end - begin) * 2.0f / 3.0f, random.Next(-1.0f, 1.0f),
+                       end, random.Next(-1.0f, 1.0f));
+            }
+        }
+
+        json += "\n]\n}";
+    }
+
+    json += "\n]\n}";
+
+    return json;
+}
+
+std::string GeneratePhysicsJson(const SyntheticModelOptions& options)
+{
+    Random random(options.Seed);
+    const csmInt32 settingCount = Max(options.PhysicsSettingCount, 1);
+    const csmInt32 inputCount = Max(options.PhysicsInputsPerSetting, 1);
+    const csmInt32 vertexCount = Max(options.PhysicsVerticesPerSetting, 2);
+    const csmInt32 outputCount = Max(options.PhysicsOutputsPerSetting, 1);
+    const csmInt32 parameterCount = Max(options.ParameterCount, 1);
+    const csmChar* inputTypes[] = { "X", "Y", "Angle" };
+
+    std::string json;
+
+    Append(json, "{\"Version\":3,\"Meta\":{\"PhysicsSettingCount\":%d,\"TotalInputCount\":%d,\"TotalOutputCount\":%d,\"VertexCount\":%d,",
+           settingCount, settingCount * inputCount, settingCount * outputCount, settingCount * vertexCount);
+    json += "\"Fps\":60.0,\"EffectiveForces\":{\"Gravity\":{\"X\":0,\"Y\":-1\n},\"Wind\":{\"X\":0,\"Y\":0\n}\n}\n},";
+    json += "\"PhysicsSettings\":[";
+
+    for (csmInt32 s = 0; s < settingCount; ++s)
+    {
+        Append(json, "%s{\"Id\":\"PhysicsSetting%d\",\"Input\":[", (s > 0) ? "," : "", s + 1);
+
+        for (csmInt32 i = 0; i < inputCount; ++i)
+        {
+            Append(json, "%s{\"Source\":{\"Target\":\"Parameter\",\"Id\":\"%s\"\n},\"Weight\":%.4f,\"Type\":\"%s\",\"Reflect\":false\n}",
+                   (i > 0) ? "," : "", GetParameterId(options, s * inputCount + i).c_str(), random.Next(10.0f, 100.0f), inputTypes[i % 3]);
+        }
+
+        json += "\n],\"Output\":[";
+
+        for (csmInt32 o = 0; o < outputCount; ++o)
+        {
+            // 出力は入力と別のパラメータに書き込む
+            Append(json, "%s{\"Destination\":{\"Target\":\"Parameter\",\"Id\":\"%s\"\n},\"VertexIndex\":%d,\"Scale\":%.4f,\"Weight\":100,\"Type\":\"Angle\",\"Reflect\":false\n}",
+                   (o > 0) ? "," : "", GetParameterId(options, parameterCount - 1 - (s * outputCount + o) % parameterCount).c_str(), 1 + o % (vertexCount - 1), random.Next(1.0f, 20.0f));
+        }
+
+        json += "\n],\"Vertices\":[";
+
+        for (csmInt32 v = 0; v < vertexCount; ++v)
+        {
+            Append(json, "%s{\"Position\":{\"X\":0,\"Y\":%d\n},\"Mobility\":%.4f,\"Delay\":%.4f,\"Acceleration\":%.4f,\"Radius\":%d\n}",
+                   (v > 0) ? "," : "", v * 10, random.Next(0.8f, 1.0f), random.Next(0.6f, 1.0f), random.Next(1.0f, 2.0f), (v > 0) ? 10 : 0);
+        }
+
+        json += "\n],\"Normalization\":{\"Position\":{\"Minimum\":-10,\"Default\":0,\"Maximum\":10\n},\"Angle\":{\"Minimum\":-10,\"Default\":0,\"Maximum\":10\n}\n}\n}";
+    }
+
+    json += "\n]\n}";
+
+    return json;
+}
+
+std::string GenerateExpressionJson(const SyntheticModelOptions& options, csmInt32 expressionIndex)
+{
+    Random random(options.Seed + static_cast<csmUint32>(expressionIndex) * 7919);
+    const csmInt32 expressionParameterCount = Max(options.ExpressionParameterCount, 1);
+    const csmChar* blends[] = { "Add", "Multiply", "Overwrite" };
+
+    std::string json;
+
+    json += "{\"Type\":\"Live2D Expression\",\"FadeInTime\":0.5,\"FadeOutTime\":0.5,\"Parameters\":[";
+
+    for (csmInt32 i = 0; i < expressionParameterCount; ++i)
+    {
+        const csmChar* blend = blends[(i + expressionIndex) % 3];
+        const csmFloat32 value = (blend == blends[1]) ? random.Next(0.5f, 1.5f) : random.Next(-1.0f, 1.0f);
+
+        Append(json, "%s{\"Id\":\"%s\",\"Value\":%.4f,\"Blend\":\"%s\"\n}",
+               (i > 0) ? "," : "", GetParameterId(options, expressionIndex * 5 + i).c_str(), value, blend);
+    }
+
+    json += "\n]\n}";
+
+    return json;
+}
+
+std::string GeneratePoseJson(const SyntheticModelOptions& options)
+{
+    const csmInt32 groupCount = Max(options.PoseGroupCount, 1);
+    const csmInt32 partCount = Max(options.PartsPerPoseGroup, 2);
+
+    std::string json;
+
+    json += "{\"Type\":\"Live2D Pose\",\"FadeInTime\":0.5,\"Groups\":[";
+
+    for (csmInt32 g = 0; g < groupCount; ++g)
+    {
+        json += (g > 0) ? ",[" : "[";
+
+        for (csmInt32 p = 0; p < partCount; ++p)
+        {
+            Append(json, "%s{\"Id\":\"%s\",\"Link\":[\n]\n}", (p > 0) ? "," : "", GetId(options.PartIds, "SyntheticPart", g * partCount + p).c_str());
+        }
+
+        json += "\n]";
+    }
+
+    json += "\n]\n}";
+
+    return json;
+}
+
+}
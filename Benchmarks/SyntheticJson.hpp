@@ -0,0 +1,90 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Model/CubismModel.hpp>
+#include <string>
+#include <vector>
+
+namespace CubismBench {
+
+/**
+ * Size of the generated model files.<br>
+ * Parameters are named SyntheticParam0, SyntheticParam1, ... and parts SyntheticPart0, SyntheticPart1, ...<br>
+ * unless the IDs of a model are given.
+ */
+struct SyntheticModelOptions
+{
+    SyntheticModelOptions();
+
+    Csm::csmInt32 ParameterCount;               ///< Number of distinct parameter IDs that the files refer to
+    Csm::csmInt32 CurveCount;                   ///< Parameter curves of the motion
+    Csm::csmInt32 SegmentsPerCurve;             ///< Segments of each curve; alternates linear and bezier
+    Csm::csmFloat32 MotionDuration;             ///< Length of the motion in seconds
+    Csm::csmInt32 PhysicsSettingCount;          ///< Physics sub-rigs
+    Csm::csmInt32 PhysicsInputsPerSetting;      ///< Inputs of each sub-rig
+    Csm::csmInt32 PhysicsVerticesPerSetting;    ///< Pendulum vertices of each sub-rig
+    Csm::csmInt32 PhysicsOutputsPerSetting;     ///< Outputs of each sub-rig
+    Csm::csmInt32 ExpressionCount;              ///< Expressions generated
+    Csm::csmInt32 ExpressionParameterCount;     ///< Parameters of each expression
+    Csm::csmInt32 PoseGroupCount;               ///< Pose groups
+    Csm::csmInt32 PartsPerPoseGroup;            ///< Parts of each pose group
+    Csm::csmUint32 Seed;                        ///< Seed of the values; the same options give the same files
+    std::vector<std::string> ParameterIds;      ///< IDs used instead of the synthetic parameter names, in turn; empty to use the synthetic names
+    std::vector<std::string> PartIds;           ///< IDs used instead of the synthetic part names, in turn; empty to use the synthetic names
+};
+
+/**
+ * Makes the generated files refer to the parameters and parts of a model.<br>
+ * Use this before generating files for a real model: the framework adds dummy entries for unknown IDs,<br>
+ * and the physics reads the ranges of its parameters from the Core arrays.
+ *
+ * @param model model whose IDs are used
+ * @param options receives the IDs
+ */
+void SetModelIds(Live2D::Cubism::Framework::CubismModel* model, SyntheticModelOptions& options);
+
+/**
+ * Generates a motion3.json with parameter curves.
+ *
+ * @param options size of the motion
+ *
+ * @return contents of the file
+ */
+std::string GenerateMotionJson(const SyntheticModelOptions& options);
+
+/**
+ * Generates a physics3.json.
+ *
+ * @param options size of the rig
+ *
+ * @return contents of the file
+ */
+std::string GeneratePhysicsJson(const SyntheticModelOptions& options);
+
+/**
+ * Generates an exp3.json. Each expression uses different parameters and blend modes.
+ *
+ * @param options size of the expression
+ * @param expressionIndex index of the expression, from 0 to options.ExpressionCount - 1
+ *
+ * @return contents of the file
+ */
+std::string GenerateExpressionJson(const SyntheticModelOptions& options, Csm::csmInt32 expressionIndex);
+
+/**
+ * Generates a pose3.json.
+ *
+ * @param options size of the pose
+ *
+ * @return contents of the file
+ */
+std::string GeneratePoseJson(const SyntheticModelOptions& options);
+
+}
@@ -0,0 +1,305 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "BenchPlatform.hpp"
+#include "MotionBakeBenchmark.hpp"
+#include "MatrixBenchmark.hpp"
+#include "MicroBenchmarks.hpp"
+#include "FrameBenchmark.hpp"
+#ifdef CUBISM_BENCH_CORE_STAND_IN
+#include "CoreStandIn.hpp"
+#endif
+
+using namespace Live2D::Cubism::Framework;
+
+namespace {
+
+void PrintLog(const csmChar* message)
+{
+    fprintf(stderr, "%s", message);
+}
+
+void PrintUsage()
+{
+    printf("usage: cubism_bench [--fps N] [--samples-per-frame N] [--matrix POINTS] [motion3.json...]\n");
+    printf("       cubism_bench --micro all|FILTER [--moc FILE] [--format text|json|csv] [--output FILE]\n");
+    printf("                    [--min-time SECONDS] [--repeats N] [--parameters N] [--curves N] [--segments N]\n");
+    printf("                    [--physics-settings N] [--expressions N] [--seed N]\n");
+    printf("       cubism_bench --models N [--frames N] [--fps N] [--moc FILE] [--format text|json|csv] [--output FILE]\n");
+#ifdef CUBISM_BENCH_CORE_STAND_IN
+    printf("Without --moc, a model of the Core stand-in is used:\n");
+    printf("       [--drawables N] [--parts N] [--vertices-per-side N] [--masked-interval N]\n");
+#endif
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    csmFloat32 frameRate = 60.0f;
+    csmInt32 samplesPerFrame = 2;
+    csmInt32 matrixPointCount = 0;
+    csmInt32 firstFile = 1;
+    CubismBench::MicroBenchmarkOptions microOptions;
+    CubismBench::MicroBenchmarkFormat microFormat = CubismBench::MicroBenchmarkFormat_Text;
+    csmBool runsMicroBenchmarks = false;
+    CubismBench::FrameBenchmarkOptions frameOptions;
+    frameOptions.ModelCount = 0;
+#ifdef CUBISM_BENCH_CORE_STAND_IN
+    CubismBench::CoreStandInOptions standInOptions;
+#endif
+    const csmChar* mocPath = NULL;
+    const csmChar* outputPath = NULL;
+
+    for (; firstFile < argc && strncmp(argv[firstFile], "--", 2) == 0; firstFile += 2)
+    {
+        if (firstFile + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        if (strcmp(argv[firstFile], "--fps") == 0)
+        {
+            frameRate = static_cast<csmFloat32>(atof(argv[firstFile + 1]));
+        }
+        else if (strcmp(argv[firstFile], "--samples-per-frame") == 0)
+        {
+            samplesPerFrame = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--matrix") == 0)
+        {
+            matrixPointCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--micro") == 0)
+        {
+            runsMicroBenchmarks = true;
+            microOptions.Filter = argv[firstFile + 1];
+        }
+        else if (strcmp(argv[firstFile], "--moc") == 0)
+        {
+            mocPath = argv[firstFile + 1];
+        }
+        else if (strcmp(argv[firstFile], "--format") == 0)
+        {
+            if (strcmp(argv[firstFile + 1], "json") == 0)
+            {
+                microFormat = CubismBench::MicroBenchmarkFormat_Json;
+            }
+            else if (strcmp(argv[firstFile + 1], "csv") == 0)
+            {
+                microFormat = CubismBench::MicroBenchmarkFormat_Csv;
+            }
+            else if (strcmp(argv[firstFile + 1], "text") == 0)
+            {
+                microFormat = CubismBench::MicroBenchmarkFormat_Text;
+            }
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[firstFile], "--output") == 0)
+        {
+            outputPath = argv[firstFile + 1];
+        }
+        else if (strcmp(argv[firstFile], "--min-time") == 0)
+        {
+            microOptions.MinimumSeconds = static_cast<csmFloat32>(atof(argv[firstFile + 1]));
+        }
+        else if (strcmp(argv[firstFile], "--repeats") == 0)
+        {
+            microOptions.RepeatCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--parameters") == 0)
+        {
+            microOptions.Model.ParameterCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--curves") == 0)
+        {
+            microOptions.Model.CurveCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--segments") == 0)
+        {
+            microOptions.Model.SegmentsPerCurve = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--physics-settings") == 0)
+        {
+            microOptions.Model.PhysicsSettingCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--expressions") == 0)
+        {
+            microOptions.Model.ExpressionCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--seed") == 0)
+        {
+            microOptions.Model.Seed = static_cast<csmUint32>(strtoul(argv[firstFile + 1], NULL, 10));
+        }
+        else if (strcmp(argv[firstFile], "--models") == 0)
+        {
+            frameOptions.ModelCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--frames") == 0)
+        {
+            frameOptions.FrameCount = atoi(argv[firstFile + 1]);
+        }
+#ifdef CUBISM_BENCH_CORE_STAND_IN
+        else if (strcmp(argv[firstFile], "--drawables") == 0)
+        {
+            standInOptions.DrawableCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--parts") == 0)
+        {
+            standInOptions.PartCount = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--vertices-per-side") == 0)
+        {
+            standInOptions.VerticesPerSide = atoi(argv[firstFile + 1]);
+        }
+        else if (strcmp(argv[firstFile], "--masked-interval") == 0)
+        {
+            standInOptions.MaskedDrawableInterval = atoi(argv[firstFile + 1]);
+        }
+#endif
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if ((firstFile >= argc && matrixPointCount <= 0 && !runsMicroBenchmarks && frameOptions.ModelCount <= 0) || frameRate <= 0.0f)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    CubismBench::BenchAllocator allocator;
+    CubismFramework::Option option;
+    option.LogFunction = PrintLog;
+    option.LoggingLevel = CubismFramework::Option::LogLevel_Warning;
+    option.LoadFileFunction = CubismBench::LoadFileAsBytes;
+    option.ReleaseBytesFunction = CubismBench::ReleaseBytes;
+
+    CubismFramework::StartUp(&allocator, &option);
+    CubismFramework::Initialize();
+
+    int result = 0;
+
+    if (matrixPointCount > 0 && !CubismBench::RunMatrixBenchmark(matrixPointCount))
+    {
+        result = 1;
+    }
+
+    if (runsMicroBenchmarks || frameOptions.ModelCount > 0)
+    {
+        csmSizeInt mocSize = 0;
+        csmByte* mocBuffer = NULL;
+
+        if (mocPath != NULL)
+        {
+            mocBuffer = CubismBench::LoadFileAsBytes(mocPath, &mocSize);
+
+            if (mocBuffer == NULL)
+            {
+                printf("%s: cannot read the file\n", mocPath);
+                result = 1;
+            }
+        }
+
+#ifdef CUBISM_BENCH_CORE_STAND_IN
+        std::vector<unsigned char> standInMoc;
+
+        if (mocPath == NULL)
+        {
+            standInOptions.ParameterCount = microOptions.Model.ParameterCount;
+            standInMoc = CubismBench::GenerateCoreStandInMoc(standInOptions);
+            mocSize = static_cast<csmSizeInt>(standInMoc.size());
+        }
+
+        const csmByte* sharedMoc = (mocPath == NULL) ? &standInMoc[0] : mocBuffer;
+#else
+        const csmByte* sharedMoc = mocBuffer;
+#endif
+
+        microOptions.MocBuffer = sharedMoc;
+        microOptions.MocSize = mocSize;
+
+        std::vector<CubismBench::MicroBenchmarkResult> microResults;
+
+        if (runsMicroBenchmarks && !CubismBench::RunMicroBenchmarks(microOptions, microResults))
+        {
+            result = 1;
+        }
+
+        if (frameOptions.ModelCount > 0)
+        {
+            frameOptions.FrameRate = frameRate;
+            frameOptions.Model = microOptions.Model;
+
+            if (sharedMoc == NULL)
+            {
+                printf("frame benchmark: no moc3 file\n");
+                result = 1;
+            }
+            else if (!CubismBench::RunFrameBenchmark(sharedMoc, mocSize, frameOptions, microResults))
+            {
+                result = 1;
+            }
+        }
+
+        FILE* output = (outputPath != NULL) ? fopen(outputPath, "w") : stdout;
+
+        if (output == NULL)
+        {
+            printf("%s: cannot write the file\n", outputPath);
+            result = 1;
+        }
+        else
+        {
+            CubismBench::WriteMicroBenchmarkResults(microResults, microOptions, microFormat, output);
+
+            if (output != stdout)
+            {
+                fclose(output);
+            }
+        }
+
+        if (mocBuffer != NULL)
+        {
+            CubismBench::ReleaseBytes(mocBuffer);
+        }
+    }
+
+    for (csmInt32 i = firstFile; i < argc; ++i)
+    {
+        csmSizeInt size;
+        csmByte* buffer = CubismBench::LoadFileAsBytes(argv[i], &size);
+
+        if (buffer == NULL)
+        {
+            printf("%s: cannot read the file\n", argv[i]);
+            result = 1;
+            continue;
+        }
+
+        if (!CubismBench::RunMotionBakeBenchmark(argv[i], buffer, size, frameRate, samplesPerFrame))
+        {
+            result = 1;
+        }
+
+        CubismBench::ReleaseBytes(buffer);
+    }
+
+    CubismFramework::Dispose();
+
+    return result;
+}
@@ -0,0 +1,23 @@
+//
+//  Live2DCubism+Internal.h
+//  Cubism
+//
+//  Created by Meng on 2025/8/26.
+//
+
+#pragma once
+
+#import "Live2DCubism.h"
+#import <Foundation/Foundation.h>
+#import <Utils/CubismPoolAllocator.hpp>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface Live2DCubism(Internal)
+
+/// 框架使用的内存分配器，模型从其中创建各自的 arena
+@property (nonatomic, readonly) Csm::CubismPoolAllocator *allocator;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -7,18 +7,20 @@
 
 #import "CubismFramework.hpp"
 #import "Live2DCubism.h"
-#import "Platform/PlatformAllocator.h"
+#import "Live2DCubism+Internal.h"
 #import "Platform/PlatformConfig.h"
 #import "Platform/PlatformOption.h"
 #import <Rendering/Metal/CubismRenderingInstanceSingleton_Metal.h>
+#import <Utils/CubismPoolAllocator.hpp>
 #import <string.h>
 
 using namespace std;
 using namespace Live2D::Cubism::Framework;
 
-@interface Live2DCubism()
+@interface Live2DCubism() {
+    Csm::CubismPoolAllocator _allocator;
+}
 
-@property (nonatomic) PlatformAllocator allocator;
 @property (nonatomic) Csm::CubismFramework::Option option;
 
 @end
@@ -58,6 +60,10 @@ using namespace Live2D::Cubism::Framework;
     [single setMTLDevice:PlatformConfig.MTLDevice];
 }
 
+- (Csm::CubismPoolAllocator *)allocator {
+    return &_allocator;
+}
+
 - (void)stop {
     Csm::CubismFramework::Dispose();
     Csm::CubismFramework::CleanUp();
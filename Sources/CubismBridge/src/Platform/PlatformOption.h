@@ -26,6 +26,18 @@ public:
      */
     static void ReleaseBytes(Csm::csmByte* byteData);
 
+    /**
+     * @brief 以内存映射方式读取文件，不复制文件内容
+     * @note 返回的内存按页对齐且可写。映射为私有映射，写入只复制被写入的页面，不会写回文件。
+     *       设置了 loadFileHandler 时无法直接映射，复制到匿名映射中。须用 UnmapFile 释放。
+     */
+    static Csm::csmByte* MapFile(const std::string filePath, Csm::csmSizeInt* outSize);
+
+    /**
+     * @brief 释放 MapFile 映射的内存
+     */
+    static void UnmapFile(Csm::csmByte* address, Csm::csmSizeInt size);
+
     /**
      * 输出日志
      */
@@ -11,6 +11,9 @@
 #import <stdlib.h>
 #import <stdarg.h>
 #import <sys/stat.h>
+#import <sys/mman.h>
+#import <fcntl.h>
+#import <unistd.h>
 #import <iostream>
 #import <fstream>
 #import "PlatformConfig.h"
@@ -26,8 +29,8 @@ csmByte* PlatformOption::LoadFileAsBytes(const string filePath, csmSizeInt* outS
     if (PlatformConfig.loadFileHandler) {
         data = PlatformConfig.loadFileHandler(nsFilePath);
     } else {
-        // fallback load
-        NSData *data = [NSData dataWithContentsOfFile:nsFilePath];
+        // fallback load。映射读取，复制到返回的缓冲区时才读入内存
+        data = [NSData dataWithContentsOfFile:nsFilePath options:NSDataReadingMappedIfSafe error:nil];
     }
 
     if (data == nil) {
@@ -52,6 +55,69 @@ void PlatformOption::ReleaseBytes(csmByte* byteData) {
     free(byteData);
 }
 
+csmByte* PlatformOption::MapFile(const string filePath, csmSizeInt* outSize) {
+    // 由应用提供文件内容时无法映射文件，复制到匿名映射中以便统一用 UnmapFile 释放
+    if (PlatformConfig.loadFileHandler) {
+        void *address = MAP_FAILED;
+        NSUInteger length = 0;
+
+        // 返回前释放 NSData，复活时内存中只留映射的一份
+        @autoreleasepool {
+            NSString *nsFilePath = [NSString stringWithCString:filePath.c_str() encoding:NSUTF8StringEncoding];
+            NSData *data = PlatformConfig.loadFileHandler(nsFilePath);
+            if (data == nil || data.length == 0) {
+                _PrintLog("File load failed : %s", filePath.c_str());
+                return NULL;
+            }
+
+            length = data.length;
+            address = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+            if (address != MAP_FAILED) {
+                memcpy(address, data.bytes, length);
+            }
+        }
+
+        if (address == MAP_FAILED) {
+            _PrintLog("File map failed : %s", filePath.c_str());
+            return NULL;
+        }
+
+        *outSize = static_cast<Csm::csmSizeInt>(length);
+        return static_cast<Csm::csmByte*>(address);
+    }
+
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        _PrintLog("File load failed : %s", filePath.c_str());
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        _PrintLog("File is loaded but file size is zero : %s", filePath.c_str());
+        return NULL;
+    }
+
+    // 私有映射：写入的页面按需复制，不会写回文件
+    void *address = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED) {
+        _PrintLog("File map failed : %s", filePath.c_str());
+        return NULL;
+    }
+
+    *outSize = static_cast<Csm::csmSizeInt>(st.st_size);
+    return static_cast<Csm::csmByte*>(address);
+}
+
+void PlatformOption::UnmapFile(csmByte* address, csmSizeInt size) {
+    if (address != NULL) {
+        munmap(address, size);
+    }
+}
+
 void PlatformOption::_PrintLog(const csmChar* format, ...) {
     va_list args;
     Csm::csmChar buf[256];
@@ -17,6 +17,15 @@ typedef void (^Live2DCubismMotionFinishedCallback)(NSString *motionGroup, NSInte
 /// 动作播放开始回调
 typedef void (^Live2DCubismMotionBeganCallback)(NSString *motionGroup, NSInteger motionIndex);
 
+/// 口型同步估计的元音
+typedef NS_ENUM(NSInteger, Live2DLipSyncVowel) {
+    Live2DLipSyncVowelA = 0,
+    Live2DLipSyncVowelI,
+    Live2DLipSyncVowelU,
+    Live2DLipSyncVowelE,
+    Live2DLipSyncVowelO,
+};
+
 @interface Live2DUserModel : NSObject
 
 @property (nonatomic, readonly) Live2DModelSetting *setting;
@@ -32,8 +41,36 @@ typedef void (^Live2DCubismMotionBeganCallback)(NSString *motionGroup, NSInteger
 /// 模型矩阵
 @property (nonatomic, readonly) void *modelMatrix;
 
+/// 模型占用的内存（字节），包括纹理
+@property (nonatomic, readonly) NSUInteger memoryFootprint;
+
+/// 参数未变化而跳过了模型更新和顶点上传时为 YES
+@property (nonatomic, readonly, getter=isSleeping) BOOL sleeping;
+
+/// 模型进入或退出休眠时调用，在 update 中执行
+@property (nonatomic, copy, nullable) void (^sleepStateChangedHandler)(BOOL isSleeping);
+
+/// 是否记录每帧各阶段的耗时。一帧从 update 开始，到 drawWithMatrix: 结束
+/// 框架需要以 CSM_PROFILING 编译才会计时，否则只记录帧的起止时间
+@property (nonatomic, getter=isProfilingEnabled) BOOL profilingEnabled;
+
 - (instancetype)init NS_UNAVAILABLE;
-- (nullable instancetype)initWithHomeDir:(NSString *)homeDir error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+- (nullable instancetype)initWithHomeDir:(NSString *)homeDir error:(NSError **)error;
+
+/// 以内存预算加载模型。超出预算后的动作组推迟到首次播放时加载
+/// @param homeDir 模型目录
+/// @param memoryBudget 内存预算（字节），0 表示不限制
+/// @param error 错误信息
+- (nullable instancetype)initWithHomeDir:(NSString *)homeDir memoryBudget:(NSUInteger)memoryBudget error:(NSError **)error NS_DESIGNATED_INITIALIZER;
+
+/// 按子系统统计的内存占用（字节），键为 Moc、Model、Motion、Texture 等
+- (NSDictionary<NSString *, NSNumber *> *)memoryReport;
+
+/// 最近各帧的平均值。阶段（Motion、Physics、Draw 等）为毫秒，计数（DrawablesDrawn 等）为每帧次数
+- (NSDictionary<NSString *, NSNumber *> *)averageFrameProfile;
+
+/// 以 Chrome trace-event JSON 导出记录的帧和阶段，可用 chrome://tracing 或 Perfetto 打开
+- (nullable NSString *)profileChromeTrace;
 
 /// 重新构建渲染器
 - (void)reloadRenderer;
@@ -41,6 +78,11 @@ typedef void (^Live2DCubismMotionBeganCallback)(NSString *motionGroup, NSInteger
 /// 更新模型。根据模型参数决定绘制状态
 - (void)update;
 
+/// 根据模型在屏幕上的大小选择动作的细节等级（LOD），应在 `update` 之前调用
+/// @param pixelsPerUnit 视图空间中每单位对应的屏幕像素数
+/// @param onScreen 模型是否在屏幕内，NO 时冻结物理计算
+- (void)updateLevelOfDetailWithPixelsPerUnit:(CGFloat)pixelsPerUnit onScreen:(BOOL)onScreen;
+
 /// 绘制模型。传递模型绘制空间的 View-Projection 矩阵
 /// @param matrix View-Projection矩阵 (4x4 浮点数组)
 // TODO:
@@ -52,7 +94,7 @@ typedef void (^Live2DCubismMotionBeganCallback)(NSString *motionGroup, NSInteger
 /// @param priority 优先级
 /// @param finishedHandler 动作播放结束时回调
 /// @param beganHandler 动作播放开始时回调
-/// @return 返回开始的动作标识号，失败时返回-1
+/// @return 返回开始的动作标识号，动作仍在后台读取时返回0（读取完成后开始播放），失败时返回-1
 - (NSInteger)startMotionWithGroup:(NSString *)group
                             index:(NSInteger)index
                          priority:(NSInteger)priority
@@ -84,6 +126,32 @@ typedef void (^Live2DCubismMotionBeganCallback)(NSString *motionGroup, NSInteger
 /// @return 是否碰撞
 - (BOOL)hitTestWithHitAreaName:(NSString *)hitAreaName x:(CGFloat)x y:(CGFloat)y;
 
+/// 精确碰撞判定测试。判断坐标是否在指定ID的网格三角形内，比矩形判定更准确
+/// @param hitAreaName 要测试碰撞判定的目标ID
+/// @param x 要判定的X坐标
+/// @param y 要判定的Y坐标
+/// @return 是否碰撞
+- (BOOL)meshHitTestWithHitAreaName:(NSString *)hitAreaName x:(CGFloat)x y:(CGFloat)y;
+
+/// 开始用音频驱动口型同步
+/// @param sampleRate 之后追加的样本的采样率
+- (void)startLipSyncWithSampleRate:(double)sampleRate;
+
+/// 停止口型同步并丢弃未处理的样本
+- (void)stopLipSync;
+
+/// 追加口型同步用的 PCM 样本。可在音频线程调用，释放模型前需停止调用
+/// @param samples 交错排列的浮点样本，范围 [-1, 1]
+/// @param frameCount 帧数
+/// @param channelCount 声道数，多声道会混合为单声道
+/// @return 写入的帧数，缓冲区满时丢弃其余部分
+- (NSInteger)appendLipSyncSamples:(const float *)samples frameCount:(NSInteger)frameCount channelCount:(NSInteger)channelCount;
+
+/// 当前元音的权重，已按张嘴程度缩放
+/// @param vowel 元音
+/// @return 0 到 1 的值
+- (CGFloat)lipSyncVowelValue:(Live2DLipSyncVowel)vowel;
+
 /// 检查 .moc3 文件的完整性
 /// @param mocFileName MOC3文件名
 /// @return 若MOC3完整则返回YES，否则返回NO
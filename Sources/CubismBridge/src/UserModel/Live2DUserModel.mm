@@ -5,6 +5,7 @@
 //  Created by Meng on 2025/8/30.
 //
 
+#import "Live2DCubism+Internal.h"
 #import "Live2DModelSetting+Internal.h"
 #import "Live2DModelSetting.h"
 #import "Live2DUserModel+Internal.h"
@@ -18,21 +19,75 @@
 #import <CubismModelSettingJson.hpp>
 #import <Effect/CubismBreath.hpp>
 #import <Effect/CubismEyeBlink.hpp>
+#import <Effect/CubismLipSyncAnalyzer.hpp>
 #import <Effect/CubismPose.hpp>
 #import <Id/CubismIdManager.hpp>
 #import <Math/CubismMatrix44.hpp>
+#import <Model/CubismMocCache.hpp>
 #import <Metal/Metal.h>
 #import <Motion/CubismMotion.hpp>
+#import <Motion/CubismMotionDataCache.hpp>
+#import <Motion/CubismMotionInternal.hpp>
+#import <Motion/CubismMotionLoader.hpp>
 #import <Motion/CubismMotionQueueEntry.hpp>
 #import <Physics/CubismPhysics.hpp>
 #import <Rendering/Metal/CubismRenderer_Metal.hpp>
 #import <Rendering/Metal/CubismRenderingInstanceSingleton_Metal.h>
 #import <Type/csmString.hpp>
+#import <Utils/CubismMemoryTracker.hpp>
 #import <Utils/CubismString.hpp>
 
 using namespace Live2D::Cubism::Framework;
 using namespace Live2D::Cubism::Framework::DefaultParameterId;
 
+/// 后台读取中的动作或表情
+struct Live2DPendingLoad {
+    CubismMotionLoadHandle *handle; ///< 读取请求
+    csmString name;                 ///< 动作名（例如 idle_0）或表情名
+    csmString group;                ///< 动作组名，表情为空
+    csmInt32 index;                 ///< 组内编号，表情为 -1
+    csmSizeType bytes;              ///< 文件大小，读取完成前用于估算内存预算
+};
+
+/// 动作管理器在读取完成后调用，创建等待播放的动作
+static ACubismMotion *Live2DCreateLoadedMotion(CubismMotionLoadHandle *handle, void *userData);
+
+/// 模型进入或退出休眠时调用
+static void Live2DSleepStateChanged(CubismModel *model, csmBool isSleeping, void *userData);
+
+/// 释放映射的 MOC 文件
+static void Live2DReleaseMappedMoc(void *address, csmSizeInt size, void *userData) {
+    PlatformOption::UnmapFile(static_cast<csmByte *>(address), size);
+}
+
+/// 获取共享的 MOC，首次请求时映射文件、检查一致性并在映射的内存上直接复活
+/// @param path MOC 文件路径
+/// @return 增加了引用的 MOC，失败时返回NULL
+static CubismMoc *Live2DAcquireSharedMoc(const csmString &path) {
+    CubismMocCache *cache = CubismFramework::GetMocCache();
+
+    // 已复活的 MOC 不再读取文件
+    CubismMoc *moc = cache->Find(path.GetRawString(), true);
+    if (moc != NULL) {
+        return moc;
+    }
+
+    csmSizeInt size;
+    csmByte *memory = PlatformOption::MapFile(path.GetRawString(), &size);
+    if (memory == NULL) {
+        return NULL;
+    }
+
+    // 内容相同的 MOC 已缓存时，映射会被立即释放
+    moc = cache->AcquireInPlace(path.GetRawString(), memory, size, Live2DReleaseMappedMoc, NULL, true);
+    if (moc == NULL) {
+        PlatformOption::UnmapFile(memory, size);
+        return NULL;
+    }
+
+    return moc;
+}
+
 @interface Live2DUserModel()
 
 @property (nonatomic, readwrite) CGFloat opacity;
@@ -47,6 +102,8 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 @property (nonatomic, assign) Csm::csmVector<Csm::CubismIdHandle> eyeBlinkIds;
 /// 口型同步参数
 @property (nonatomic, assign) Csm::csmVector<Csm::CubismIdHandle> lipSyncIds;
+/// 由音频计算口型的分析器，音频线程写入样本
+@property (nonatomic, assign) Csm::CubismLipSyncAnalyzer *lipSyncAnalyzer;
 
 /// 碰撞区域
 @property (nonatomic, assign) Csm::csmVector<Csm::csmRectF> hitArea;
@@ -79,6 +136,19 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 /// 已加载纹理
 @property (nonatomic) NSMutableArray<Live2DTexture *> *textures;
 
+/// 因超出内存预算而推迟到首次播放时加载的动作组
+@property (nonatomic) NSMutableSet<NSString *> *deferredMotionGroups;
+
+/// 后台读取中的动作和表情
+@property (nonatomic, assign) Csm::csmVector<Live2DPendingLoad *> pendingLoads;
+/// 等待读取完成后播放的动作所在的组和编号
+@property (nonatomic, assign) Csm::csmString pendingStartGroup;
+@property (nonatomic, assign) Csm::csmInt32 pendingStartIndex;
+/// 读取完成后设置的表情名
+@property (nonatomic, assign) Csm::csmString pendingExpressionName;
+
+- (Csm::ACubismMotion *)createMotionWithLoadHandle:(Csm::CubismMotionLoadHandle *)handle;
+
 @end
 
 @implementation Live2DUserModel
@@ -86,6 +156,10 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 #pragma mark - Initialization
 
 - (nullable instancetype)initWithHomeDir:(NSString *)homeDir error:(NSError **)error {
+    return [self initWithHomeDir:homeDir memoryBudget:0 error:error];
+}
+
+- (nullable instancetype)initWithHomeDir:(NSString *)homeDir memoryBudget:(NSUInteger)memoryBudget error:(NSError **)error {
     self = [super init];
     if (self) {
         _userTimeSeconds = 0.0f;
@@ -103,6 +177,10 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 
         // 创建 UserModel 实例
         _userModel = new Live2D::Cubism::Live2DCubismUserModel();
+        _userModel->SetMemoryBudget(memoryBudget);
+        // 模型的数据放在独立的 arena 中，释放模型时一次性归还
+        _userModel->UseArena([Live2DCubism shared].allocator);
+        _deferredMotionGroups = [NSMutableSet set];
 
         // 初始化设置
         _setting = [[Live2DModelSetting alloc] initWithHomeDir:homeDir error:error];
@@ -122,6 +200,9 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
         if (!loadTextureResult || (error && *error)) {
             return nil;
         }
+
+        // 加载动作。放在纹理之后，以便按实际内存判断预算
+        [self loadMotions];
     }
     return self;
 }
@@ -131,6 +212,9 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 }
 
 - (void)cleanup {
+    // 取消后台读取
+    [self releasePendingLoads];
+
     // 释放所有动作和表情
     [self releaseMotions];
     [self releaseExpressions];
@@ -147,17 +231,30 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     // 销毁渲染缓冲区
     _renderBuffer.DestroyOffscreenSurface();
 
+    // 释放口型分析器，调用方需先停止音频线程
+    if (_lipSyncAnalyzer) {
+        CubismLipSyncAnalyzer::Delete(_lipSyncAnalyzer);
+        _lipSyncAnalyzer = NULL;
+    }
+
     // 释放 UserModel
     if (_userModel) {
         delete _userModel;
         _userModel = nullptr;
     }
+
+    // 释放不再使用的 MOC 映射和动作数据
+    CubismFramework::GetMocCache()->Purge();
+    CubismFramework::GetMotionDataCache()->Purge();
 }
 
 #pragma mark - Model Loading
 
 /// 加载模型数据
 - (BOOL)loadModelWithError:(NSError **)error {
+    // 眨眼、呼吸等框架外创建的数据也计入该模型
+    CubismMemoryScope memoryScope(_userModel->GetMemoryAccount(), CubismMemoryCategory_Other);
+
     _userModel->SetInitialized(false);
     _userModel->SetUpdating(true);
 
@@ -167,8 +264,8 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
         return NO;
     }
 
-    // 加载动作和表情
-    [self loadMotionsAndExpressions];
+    // 加载表情
+    [self loadExpressions];
     // 加载物理和姿势文件
     [self loadPhyicsAndPose];
     // 加载用户数据
@@ -181,6 +278,9 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     // 加载布局
     [self loadLayout];
 
+    // 加载时一次性计算参数影响范围，避免播放时在 UpdateLod 中分帧计算
+    _userModel->PrepareLod();
+
     // 停止播放所有动作
     _userModel->GetMotionManager()->StopAllMotions();
 
@@ -193,13 +293,18 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 
 /// 加载 Cubism 模型
 - (BOOL)loadCubismModelWithError:(NSError **)error {
-    csmByte* buffer;
-    csmSizeInt size;
-
     csmString cPath = [_setting.modelFilePath cStringUsingEncoding:NSUTF8StringEncoding];
-    buffer = PlatformOption::LoadFileAsBytes(cPath.GetRawString(), &size);
-    _userModel->LoadModel(buffer, size, false); // TODO
-    PlatformOption::ReleaseBytes(buffer);
+
+    // 同一 MOC 的模型共享映射，每个模型只分配自己的模型缓冲区
+    CubismMoc *moc = NULL;
+    {
+        CubismMemoryScope memoryScope(_userModel->GetMemoryAccount(), CubismMemoryCategory_Moc);
+        moc = Live2DAcquireSharedMoc(cPath);
+    }
+    if (moc != NULL) {
+        _userModel->LoadModel(moc);
+        moc->Release();
+    }
 
     if (_userModel->GetMoc() == NULL || _userModel->GetModel() == NULL) {
         if (error) {
@@ -208,66 +313,216 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
         return NO;
     }
 
+    _userModel->GetModel()->SetSleepStateChangedHandler(Live2DSleepStateChanged, (__bridge void *)self);
+
     return YES;
 }
 
-/// 加载动作和表情
-- (void)loadMotionsAndExpressions {
-    csmByte* buffer;
+/// 从共享缓存获取动作数据，首次请求时读取并解析文件
+/// @param path 动作文件路径
+/// @return 增加了引用的动作数据，失败时返回NULL
+- (CubismMotionData *)acquireMotionDataWithPath:(const csmString &)path {
+    CubismMotionDataCache *cache = CubismFramework::GetMotionDataCache();
+
+    // 已解析的动作数据在所有模型之间共享
+    CubismMotionData *motionData = cache->Find(path.GetRawString());
+    if (motionData != NULL) {
+        return motionData;
+    }
+
     csmSizeInt size;
+    csmByte *buffer = PlatformOption::LoadFileAsBytes(path.GetRawString(), &size);
+    if (buffer == NULL) {
+        return NULL;
+    }
 
-    // 加载动作
+    // 共享的动作数据计入首次解析它的模型
+    CubismMemoryScope memoryScope(_userModel->GetMemoryAccount(), CubismMemoryCategory_Motion);
+    motionData = cache->Acquire(path.GetRawString(), buffer, size);
+    PlatformOption::ReleaseBytes(buffer);
+
+    return motionData;
+}
+
+/// 请求读取动作。设置了内存预算时，超出预算后的动作组推迟到首次播放时读取
+- (void)loadMotions {
     for (csmInt32 i = 0; i < _setting.modelSetting->GetMotionGroupCount(); i++) {
         const csmChar* group = _setting.modelSetting->GetMotionGroupName(i);
-        const csmInt32 motionCount = _setting.modelSetting->GetMotionCount(group);
 
-        for (csmInt32 i = 0; i < motionCount; i++) {
-            // 例如 idle_0
-            csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, i);
-            csmString path = self.setting.modelSetting->GetMotionFileName(group, i);
-            path = csmString(_setting.homeDir.UTF8String) + path;
+        // 排队中的读取要在读取线程上才计入内存账户，因此按文件大小先行计入
+        if (_userModel->IsOverMemoryBudget([self pendingLoadBytes])) {
+            [_deferredMotionGroups addObject:[NSString stringWithUTF8String:group]];
+            continue;
+        }
 
-            buffer = PlatformOption::LoadFileAsBytes(path.GetRawString(), &size);
-            auto motion = _userModel->LoadMotion(buffer,
-                                                 size,
-                                                 name.GetRawString(),
-                                                 NULL,
-                                                 NULL,
-                                                 _setting.modelSetting,
-                                                 group,
-                                                 i
-                                                 );
-            PlatformOption::ReleaseBytes(buffer);
-
-            if (motion) {
-                if (_motions[name] != NULL) {
-                    ACubismMotion::Delete(_motions[name]);
-                }
-                _motions[name] = motion;
-            }
+        [self loadMotionGroup:group];
+    }
+}
+
+/// 请求在后台读取动作组，读取完成后在 update 中创建动作
+/// @param group 动作组名
+- (void)loadMotionGroup:(const csmChar *)group {
+    CubismMotionLoader *loader = CubismFramework::GetMotionLoader();
+    const csmInt32 motionCount = _setting.modelSetting->GetMotionCount(group);
+
+    // 待机动作组优先读取，其余动作可能永远不会播放
+    const CubismMotionLoadPriority priority = (strcasecmp(group, "idle") == 0) ? CubismMotionLoadPriority_High : CubismMotionLoadPriority_Low;
+
+    for (csmInt32 i = 0; i < motionCount; i++) {
+        // 例如 idle_0
+        csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, i);
+        if ((_motions.IsExist(name) && _motions[name] != NULL) || [self pendingLoadWithName:name isExpression:NO] != NULL) {
+            continue;
+        }
+
+        csmString path = self.setting.modelSetting->GetMotionFileName(group, i);
+        path = csmString(_setting.homeDir.UTF8String) + path;
+
+        Live2DPendingLoad *load = new Live2DPendingLoad();
+        load->handle = loader->RequestMotion(path.GetRawString(), priority, _userModel->GetMemoryAccount());
+        load->name = name;
+        load->group = group;
+        load->index = i;
+        load->bytes = [self fileSizeWithPath:path];
+        _pendingLoads.PushBack(load);
+    }
+}
+
+/// 获取文件大小
+/// @param path 文件路径
+/// @return 文件大小，无法获取时返回0
+- (csmSizeType)fileSizeWithPath:(const csmString &)path {
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[NSString stringWithUTF8String:path.GetRawString()] error:nil];
+    return (attributes != nil) ? static_cast<csmSizeType>(attributes.fileSize) : 0;
+}
+
+/// 尚未读取完成的请求的文件大小合计
+/// @return 字节数
+- (csmSizeType)pendingLoadBytes {
+    csmSizeType bytes = 0;
+    for (csmUint32 i = 0; i < _pendingLoads.GetSize(); i++) {
+        if (!_pendingLoads[i]->handle->IsDone()) {
+            bytes += _pendingLoads[i]->bytes;
         }
     }
+    return bytes;
+}
+
+/// 请求在后台读取表情
+- (void)loadExpressions {
+    CubismMotionLoader *loader = CubismFramework::GetMotionLoader();
 
-    // 加载表情
     for (NSString *expressionName in _setting.expressionFilePaths.allKeys) {
         NSString *expressionFilePath = _setting.expressionFilePaths[expressionName];
         csmString cName = [expressionName cStringUsingEncoding:NSUTF8StringEncoding];
         csmString cPath = [expressionFilePath cStringUsingEncoding:NSUTF8StringEncoding];
 
-        csmByte* buffer;
-        csmSizeInt size;
-        buffer = PlatformOption::LoadFileAsBytes(cPath.GetRawString(), &size);
-        ACubismMotion* motion = _userModel->LoadExpression(buffer, size, cName.GetRawString());
-        PlatformOption::ReleaseBytes(buffer);
+        Live2DPendingLoad *load = new Live2DPendingLoad();
+        load->handle = loader->RequestExpression(cPath.GetRawString(), CubismMotionLoadPriority_Normal, _userModel->GetMemoryAccount());
+        load->name = cName;
+        load->index = -1;
+        load->bytes = [self fileSizeWithPath:cPath];
+        _pendingLoads.PushBack(load);
+    }
+}
 
-        if (motion) {
-            if (_expressions[cName] != NULL) {
-                ACubismMotion::Delete(_expressions[cName]);
-                _expressions[cName] = NULL;
+/// 查找后台读取中的动作或表情
+/// @param name 动作名或表情名
+/// @param isExpression 是否为表情
+/// @return 读取请求，没有时返回NULL
+- (Live2DPendingLoad *)pendingLoadWithName:(const csmString &)name isExpression:(BOOL)isExpression {
+    for (csmUint32 i = 0; i < _pendingLoads.GetSize(); i++) {
+        Live2DPendingLoad *load = _pendingLoads[i];
+        if ((load->index < 0) == (isExpression == YES) && load->name == name) {
+            return load;
+        }
+    }
+    return NULL;
+}
+
+/// 收取后台读取完成的动作和表情
+- (void)collectLoadedMotions {
+    for (csmInt32 i = (csmInt32)_pendingLoads.GetSize() - 1; i >= 0; i--) {
+        Live2DPendingLoad *load = _pendingLoads[i];
+        if (!load->handle->IsDone()) {
+            continue;
+        }
+
+        if (load->index < 0) {
+            ACubismMotion *expression = load->handle->TakeExpression();
+            if (expression) {
+                if (_expressions.IsExist(load->name) && _expressions[load->name] != NULL) {
+                    ACubismMotion::Delete(_expressions[load->name]);
+                }
+                _expressions[load->name] = expression;
+
+                // 读取中被指定的表情
+                if (load->name == _pendingExpressionName) {
+                    _pendingExpressionName = "";
+                    _userModel->GetExpressionManager()->StartMotion(expression, false);
+                }
             }
-            _expressions[cName] = motion;
+        } else {
+            CubismMotionData *motionData = load->handle->AcquireMotionData();
+            if (motionData != NULL) {
+                ACubismMotion *motion = _userModel->LoadMotion(motionData,
+                                                               load->name.GetRawString(),
+                                                               NULL,
+                                                               NULL,
+                                                               _setting.modelSetting,
+                                                               load->group.GetRawString(),
+                                                               load->index
+                                                               );
+                motionData->Release();
+
+                if (motion) {
+                    static_cast<CubismMotion *>(motion)->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+
+                    if (_motions.IsExist(load->name) && _motions[load->name] != NULL) {
+                        ACubismMotion::Delete(_motions[load->name]);
+                    }
+                    _motions[load->name] = motion;
+                }
+            }
+        }
+
+        load->handle->Release();
+        delete load;
+        _pendingLoads.Remove(i);
+    }
+}
+
+/// 取消并释放所有读取请求
+- (void)releasePendingLoads {
+    CubismMotionLoader *loader = CubismFramework::GetMotionLoader();
+
+    for (csmUint32 i = 0; i < _pendingLoads.GetSize(); i++) {
+        if (loader) {
+            loader->Cancel(_pendingLoads[i]->handle);
         }
+        _pendingLoads[i]->handle->Release();
+        delete _pendingLoads[i];
     }
+    _pendingLoads.Clear();
+}
+
+/// 用读取完成的动作数据创建等待播放的动作
+/// @param handle 读取请求
+/// @return 播放结束时由动作管理器删除的动作
+- (ACubismMotion *)createMotionWithLoadHandle:(CubismMotionLoadHandle *)handle {
+    CubismMotionData *motionData = handle->AcquireMotionData();
+    if (motionData == NULL) {
+        return NULL;
+    }
+
+    CubismMotion *motion = static_cast<CubismMotion *>(_userModel->LoadMotion(motionData, NULL, NULL, NULL, _setting.modelSetting, _pendingStartGroup.GetRawString(), _pendingStartIndex));
+    motionData->Release();
+
+    if (motion) {
+        motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
+    }
+
+    return motion;
 }
 
 /// 加载物理和姿势文件
@@ -327,11 +582,8 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
         }
     }
 
-    // set motion effect
-    for (auto it = _motions.Begin(); it != _motions.End(); ++it) {
-        CubismMotion *motion = static_cast<CubismMotion *>(it->Second);
-        motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-    }
+    // 口型分析器。采样率在开始口型同步时设置
+    _lipSyncAnalyzer = CubismLipSyncAnalyzer::Create(44100.0f);
 }
 
 /// 加载呼吸数据
@@ -363,6 +615,7 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     auto renderer = _userModel->GetRenderer<Rendering::CubismRenderer_Metal>();
 
     NSMutableArray<Live2DTexture *> *textures = [NSMutableArray array];
+    csmSizeType textureBytes = 0;
     for (csmUint32 index = 0; index < _setting.textureFilePaths.count; index++) {
         NSString *textureFilePath = _setting.textureFilePaths[index];
         Live2DTexture *texture = [[Live2DTexture alloc] initWithTextureFilePath:textureFilePath error:nil];
@@ -372,8 +625,10 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 
         [textures addObject:texture];
         renderer->BindTexture(index, texture.texture);
+        textureBytes += texture.texture.allocatedSize;
     }
     _textures = textures;
+    _userModel->GetMemoryAccount()->SetExternalBytes(CubismMemoryCategory_Texture, textureBytes);
 
     // 无纹理加载成功
     if (_textures.count <= 0) {
@@ -436,6 +691,13 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     CubismModel *model = _userModel->GetModel();
     CubismMotionManager *motionManager = _userModel->GetMotionManager();
 
+    // 性能记录：一帧从更新开始，到绘制结束
+    CubismProfile *profile = _userModel->GetProfile();
+    CubismProfileScope profileScope(profile);
+    if (profile != NULL) {
+        profile->BeginFrame();
+    }
+
     const csmFloat32 deltaTimeSeconds = 0.016f; // 假设60FPS
     _userTimeSeconds += deltaTimeSeconds;
 
@@ -447,8 +709,11 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     csmBool motionUpdated = false;
 
     //-----------------------------------------------------------------
+    // 收取后台读取完成的动作和表情
+    [self collectLoadedMotions];
+
     model->LoadParameters(); // 加载上次保存的状态
-    if (motionManager->IsFinished()) {
+    if (motionManager->IsFinished() && !motionManager->HasPendingMotion()) {
         // 若没有动作播放，则从待机动作中随机播放一个
         [self startRandomMotionWithGroup:@"idle" priority:1 finishedHandler:nil beganHandler:nil];
     } else {
@@ -490,17 +755,17 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
         _userModel->GetBreath()->UpdateParameters(model, deltaTimeSeconds);
     }
 
-    // 物理计算
-    if (_userModel->GetPhysics() != NULL) {
+    // 物理计算（LOD冻结时跳过）
+    if (_userModel->GetPhysics() != NULL && !_userModel->IsPhysicsFrozen()) {
         _userModel->GetPhysics()->Evaluate(model, deltaTimeSeconds);
     }
 
     // 唇形同步
-    if (_userModel->GetLipSync()) {
-        csmFloat32 value = 0;
-        // 这里应该实现从系统获取音量的逻辑，例如：
-        // AVAudioSession *audioSession = [AVAudioSession sharedInstance];
-        // value = audioSession.outputVolume;
+    if (_userModel->GetLipSync() && _lipSyncAnalyzer != NULL) {
+        // 按模型的时间消费音频线程写入的样本
+        _lipSyncAnalyzer->Update(deltaTimeSeconds);
+        csmFloat32 value = _lipSyncAnalyzer->GetMouthOpenValue();
+        _userModel->SetLastLipSyncValue(value);
         for (csmUint32 i = 0; i < _lipSyncIds.GetSize(); ++i) {
             model->AddParameterValue(_lipSyncIds[i], value, 0.8f);
         }
@@ -511,7 +776,68 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
         _userModel->GetPose()->UpdateParameters(model, deltaTimeSeconds);
     }
 
-    model->Update();
+    // 参数与上次更新相同时跳过模型更新，渲染器也会跳过顶点上传
+    model->UpdateIfChanged();
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)memoryReport {
+    if (!_userModel) {
+        return @{};
+    }
+
+    const CubismMemoryReport report = _userModel->GetMemoryReport();
+    NSMutableDictionary<NSString *, NSNumber *> *result = [NSMutableDictionary dictionary];
+    for (csmInt32 i = 0; i < CubismMemoryCategory_Count; i++) {
+        NSString *name = [NSString stringWithUTF8String:CubismMemoryAccount::GetCategoryName((CubismMemoryCategory)i)];
+        result[name] = @(report.Bytes[i]);
+    }
+    return result;
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)averageFrameProfile {
+    if (!_userModel || _userModel->GetProfile() == NULL) {
+        return @{};
+    }
+
+    CubismProfileFrame average;
+    _userModel->GetProfile()->GetAverage(average);
+
+    NSMutableDictionary<NSString *, NSNumber *> *result = [NSMutableDictionary dictionary];
+    for (csmInt32 i = 0; i < CubismProfileStage_Count; i++) {
+        NSString *name = [NSString stringWithUTF8String:CubismProfile::GetStageName((CubismProfileStage)i)];
+        result[name] = @(average.StageNanoseconds[i] / 1000000.0);
+    }
+    for (csmInt32 i = 0; i < CubismProfileCounter_Count; i++) {
+        NSString *name = [NSString stringWithUTF8String:CubismProfile::GetCounterName((CubismProfileCounter)i)];
+        result[name] = @(average.Counters[i]);
+    }
+    return result;
+}
+
+- (nullable NSString *)profileChromeTrace {
+    if (!_userModel || _userModel->GetProfile() == NULL) {
+        return nil;
+    }
+
+    csmString json;
+    _userModel->GetProfile()->WriteChromeTrace(json);
+    return [NSString stringWithUTF8String:json.GetRawString()];
+}
+
+- (NSUInteger)memoryFootprint {
+    if (!_userModel) {
+        return 0;
+    }
+
+    return _userModel->GetMemoryReport().TotalBytes;
+}
+
+- (void)updateLevelOfDetailWithPixelsPerUnit:(CGFloat)pixelsPerUnit onScreen:(BOOL)onScreen {
+    if (!_userModel) {
+        return;
+    }
+
+    _userModel->UpdateLod((csmFloat32)pixelsPerUnit, onScreen);
 }
 
 - (void)drawWithMatrix:(float[16])matrix {
@@ -525,11 +851,18 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     // 乘以模型矩阵，将模型变换应用到视图投影矩阵
     cubismMatrix.MultiplyByMatrix(_userModel->GetModelMatrix());
 
+    CubismProfile *profile = _userModel->GetProfile();
+    CubismProfileScope profileScope(profile);
+
     auto renderer = _userModel->GetRenderer<Rendering::CubismRenderer_Metal>();
     if (renderer) {
         renderer->SetMvpMatrix(&cubismMatrix);
         renderer->DrawModel();
     }
+
+    if (profile != NULL) {
+        profile->EndFrame();
+    }
 }
 
 - (NSInteger)startMotionWithGroup:(NSString *)group
@@ -554,21 +887,38 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     CubismMotion* motion = static_cast<CubismMotion*>(_motions[name.GetRawString()]);
     csmBool autoDelete = false;
 
+    // 因预算推迟的动作组在首次播放时请求读取
+    if (motion == NULL && [_deferredMotionGroups containsObject:group]) {
+        [_deferredMotionGroups removeObject:group];
+        [self loadMotionGroup:[group cStringUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    // 仍在读取中的动作提高读取优先级，读取完成后由动作管理器开始播放
+    Live2DPendingLoad *pendingLoad = (motion == NULL) ? [self pendingLoadWithName:name isExpression:NO] : NULL;
+    if (pendingLoad != NULL) {
+        CubismFramework::GetMotionLoader()->SetPriority(pendingLoad->handle, CubismMotionLoadPriority_High);
+
+        _pendingStartGroup = pendingLoad->group;
+        _pendingStartIndex = pendingLoad->index;
+
+        const csmBool accepted = _userModel->GetMotionManager()->StartMotionPriority(pendingLoad->handle, (csmInt32)priority, Live2DCreateLoadedMotion, (__bridge void *)self);
+        return accepted ? 0 : -1;
+    }
+
     if (motion == NULL) {
         csmString path = fileName;
         path = csmString(_setting.homeDir.UTF8String) + path;
 
-        csmByte* buffer;
-        csmSizeInt size;
-        buffer = PlatformOption::LoadFileAsBytes(path.GetRawString(), &size);
-        motion = static_cast<CubismMotion*>(_userModel->LoadMotion(buffer, size, NULL, NULL, NULL, self.setting.modelSetting, [group cStringUsingEncoding:NSUTF8StringEncoding], (csmInt32)index));
+        CubismMotionData *motionData = [self acquireMotionDataWithPath:path];
+        if (motionData != NULL) {
+            motion = static_cast<CubismMotion*>(_userModel->LoadMotion(motionData, NULL, NULL, NULL, self.setting.modelSetting, [group cStringUsingEncoding:NSUTF8StringEncoding], (csmInt32)index));
+            motionData->Release();
+        }
 
         if (motion) {
             motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
             autoDelete = true; // 終了時にメモリから削除
         }
-
-        PlatformOption::ReleaseBytes(buffer);
     } else {
         // 设置回调
         if (beganHandler) {
@@ -598,9 +948,19 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 }
 
 - (void)setExpression:(NSString *)expressionID {
-    ACubismMotion* motion = _expressions[[expressionID cStringUsingEncoding:NSUTF8StringEncoding]];
+    csmString name = [expressionID cStringUsingEncoding:NSUTF8StringEncoding];
+    ACubismMotion* motion = _expressions.IsExist(name) ? _expressions[name] : NULL;
     if (motion != NULL) {
+        _pendingExpressionName = "";
         _userModel->GetExpressionManager()->StartMotion(motion, false);
+        return;
+    }
+
+    // 仍在读取中的表情在读取完成后设置
+    Live2DPendingLoad *pendingLoad = [self pendingLoadWithName:name isExpression:YES];
+    if (pendingLoad != NULL) {
+        CubismFramework::GetMotionLoader()->SetPriority(pendingLoad->handle, CubismMotionLoadPriority_High);
+        _pendingExpressionName = name;
     }
 }
 
@@ -623,32 +983,51 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
 }
 
 - (BOOL)hitTestWithHitAreaName:(NSString *)hitAreaName x:(CGFloat)x y:(CGFloat)y {
+    const CubismIdHandle drawID = [self hitTestDrawableIdWithHitAreaName:hitAreaName];
+    if (drawID == NULL) {
+        return false;
+    }
+    return _userModel->IsHit(drawID, (csmFloat32)x, (csmFloat32)y);
+}
+
+- (BOOL)meshHitTestWithHitAreaName:(NSString *)hitAreaName x:(CGFloat)x y:(CGFloat)y {
+    const CubismIdHandle drawID = [self hitTestDrawableIdWithHitAreaName:hitAreaName];
+    if (drawID == NULL) {
+        return false;
+    }
+    return _userModel->IsHitMesh(drawID, (csmFloat32)x, (csmFloat32)y);
+}
+
+/// 返回碰撞判定区域对应的绘制对象ID。透明或不存在时返回NULL
+- (CubismIdHandle)hitTestDrawableIdWithHitAreaName:(NSString *)hitAreaName {
     // 若透明则无判定
     if (_internalOpacity < 1) {
-        return false;
+        return NULL;
     }
     const csmInt32 count = _setting.modelSetting->GetHitAreasCount();
     for (csmInt32 i = 0; i < count; i++) {
         if (strcmp(_setting.modelSetting->GetHitAreaName(i), [hitAreaName cStringUsingEncoding:NSUTF8StringEncoding]) == 0) {
-            const CubismIdHandle drawID = self.setting.modelSetting->GetHitAreaId(i);
-            return _userModel->IsHit(drawID, (csmFloat32)x, (csmFloat32)y);
+            return self.setting.modelSetting->GetHitAreaId(i);
         }
     }
-    return false; // 若不存在则返回false
+    return NULL; // 若不存在则返回NULL
 }
 
 - (BOOL)hasMocConsistencyFromFile:(NSString *)mocFileName {
     csmString path = [mocFileName cStringUsingEncoding:NSUTF8StringEncoding];
     path = csmString(_setting.homeDir.UTF8String) + path;
 
-    csmByte* buffer;
     csmSizeInt size;
 
-    buffer = PlatformOption::LoadFileAsBytes(path.GetRawString(), &size);
+    // 映射的内存按页对齐，确认时不需要复制
+    csmByte* buffer = PlatformOption::MapFile(path.GetRawString(), &size);
+    if (buffer == NULL) {
+        return NO;
+    }
 
     csmBool consistency = CubismMoc::HasMocConsistencyFromUnrevivedMoc(buffer, size);
 
-    PlatformOption::ReleaseBytes(buffer);
+    PlatformOption::UnmapFile(buffer, size);
 
     return consistency ? YES : NO;
 }
@@ -657,6 +1036,36 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     CubismLogInfo("%s is fired on Live2DUserModel!!", [eventValue cStringUsingEncoding:NSUTF8StringEncoding]);
 }
 
+- (void)startLipSyncWithSampleRate:(double)sampleRate {
+    if (_lipSyncAnalyzer == NULL) {
+        return;
+    }
+    _lipSyncAnalyzer->SetSampleRate(static_cast<csmFloat32>(sampleRate));
+    _userModel->SetLipSync(true);
+}
+
+- (void)stopLipSync {
+    if (_lipSyncAnalyzer == NULL) {
+        return;
+    }
+    _userModel->SetLipSync(false);
+    _lipSyncAnalyzer->Reset();
+}
+
+- (NSInteger)appendLipSyncSamples:(const float *)samples frameCount:(NSInteger)frameCount channelCount:(NSInteger)channelCount {
+    if (_lipSyncAnalyzer == NULL) {
+        return 0;
+    }
+    return _lipSyncAnalyzer->PushSamples(samples, static_cast<csmInt32>(frameCount), static_cast<csmInt32>(channelCount));
+}
+
+- (CGFloat)lipSyncVowelValue:(Live2DLipSyncVowel)vowel {
+    if (_lipSyncAnalyzer == NULL) {
+        return 0.0f;
+    }
+    return _lipSyncAnalyzer->GetVowelValue(static_cast<CubismLipSyncVowel>(vowel));
+}
+
 #pragma mark - Property Accessors
 
 - (CGFloat)opacity {
@@ -683,4 +1092,36 @@ using namespace Live2D::Cubism::Framework::DefaultParameterId;
     return _userModel ? _userModel->GetModelMatrix() : nullptr;
 }
 
+- (BOOL)isProfilingEnabled {
+    return (_userModel && _userModel->GetProfile() != NULL) ? YES : NO;
+}
+
+- (void)setProfilingEnabled:(BOOL)profilingEnabled {
+    if (!_userModel) {
+        return;
+    }
+
+    _userModel->SetProfilingEnabled(profilingEnabled ? true : false);
+    if (_userModel->GetProfile() != NULL) {
+        // 导出的记录中以模型目录名区分各模型
+        _userModel->GetProfile()->SetName(_setting.homeDir.lastPathComponent.UTF8String);
+    }
+}
+
+- (BOOL)isSleeping {
+    return (_userModel && _userModel->GetModel()->IsSleeping()) ? YES : NO;
+}
+
 @end
+
+static ACubismMotion *Live2DCreateLoadedMotion(CubismMotionLoadHandle *handle, void *userData) {
+    Live2DUserModel *model = (__bridge Live2DUserModel *)userData;
+    return [model createMotionWithLoadHandle:handle];
+}
+
+static void Live2DSleepStateChanged(CubismModel *model, csmBool isSleeping, void *userData) {
+    Live2DUserModel *userModel = (__bridge Live2DUserModel *)userData;
+    if (userModel.sleepStateChangedHandler) {
+        userModel.sleepStateChangedHandler(isSleeping ? YES : NO);
+    }
+}
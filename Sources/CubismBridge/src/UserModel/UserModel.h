@@ -147,6 +147,24 @@ private:
      */
     void PreloadMotionGroup(const Csm::csmChar* group);
 
+    /**
+     * @brief   拼接模型目录与文件名，得到资源路径。<br>
+     *           只分配一次内存。
+     *
+     * @param[in]   fileName  模型设置中记录的文件名
+     * @return          资源路径
+     */
+    Csm::csmString MakeAssetPath(const Csm::csmStringView& fileName) const;
+
+    /**
+     * @brief   从共享缓存获取动作数据。<br>
+     *           首次请求时读取并解析文件，之后所有模型共享同一份数据。
+     *
+     * @param[in]   path  动作文件路径
+     * @return          增加了引用的动作数据。失败时返回NULL
+     */
+    Csm::CubismMotionData* AcquireMotionData(const Csm::csmString& path);
+
     /**
      * @brief   根据组名批量释放动作数据。<br>
      *           动作数据名称由 ModelSetting 内部获取。
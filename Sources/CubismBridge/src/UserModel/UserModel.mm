@@ -15,10 +15,13 @@
 #import <CubismModelSettingJson.hpp>
 #import <Id/CubismIdManager.hpp>
 #import <Motion/CubismMotion.hpp>
+#import <Motion/CubismMotionDataCache.hpp>
+#import <Motion/CubismMotionInternal.hpp>
 #import <Motion/CubismMotionQueueEntry.hpp>
 #import <Physics/CubismPhysics.hpp>
 #import <Rendering/Metal/CubismRenderer_Metal.hpp>
 #import <Utils/CubismString.hpp>
+#import <Type/csmStringBuilder.hpp>
 #import "Platform/PlatformConfig.h"
 #import "Platform/PlatformOption.h"
 
@@ -74,8 +77,7 @@ UserModel::~UserModel() {
         }
 
         // 从纹理管理类中删除模型纹理
-        csmString texturePath = _modelSetting->GetTextureFileName(modelTextureNumber);
-        texturePath = _modelHomeDir + texturePath;
+        csmString texturePath = MakeAssetPath(_modelSetting->GetTextureFileName(modelTextureNumber));
 //        [textureManager releaseTextureByName:texturePath.GetRawString()];
     }
 
@@ -108,6 +110,12 @@ void UserModel::LoadAssets(const csmChar* dir, const csmChar* fileName) {
     SetupTextures();
 }
 
+csmString UserModel::MakeAssetPath(const csmStringView& fileName) const {
+    csmStringBuilder builder(_modelHomeDir.GetLength() + fileName.GetLength());
+    builder.Append(_modelHomeDir).Append(fileName);
+    return builder.ToString();
+}
+
 
 void UserModel::SetupModel(ICubismModelSetting* setting) {
     _updating = true;
@@ -120,8 +128,7 @@ void UserModel::SetupModel(ICubismModelSetting* setting) {
 
     // Cubism模型
     if (strcmp(_modelSetting->GetModelFileName(), "") != 0) {
-        csmString path = _modelSetting->GetModelFileName();
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(_modelSetting->GetModelFileName());
 
         if (_debugMode) {
             PlatformOption::_PrintLog("[APP]create model: %s", setting->GetModelFileName());
@@ -137,8 +144,7 @@ void UserModel::SetupModel(ICubismModelSetting* setting) {
         const csmInt32 count = _modelSetting->GetExpressionCount();
         for (csmInt32 i = 0; i < count; i++) {
             csmString name = _modelSetting->GetExpressionName(i);
-            csmString path = _modelSetting->GetExpressionFileName(i);
-            path = _modelHomeDir + path;
+            csmString path = MakeAssetPath(_modelSetting->GetExpressionFileName(i));
 
             buffer = CreateBuffer(path.GetRawString(), &size);
             ACubismMotion* motion = LoadExpression(buffer, size, name.GetRawString());
@@ -158,8 +164,7 @@ void UserModel::SetupModel(ICubismModelSetting* setting) {
 
     // 物理
     if (strcmp(_modelSetting->GetPhysicsFileName(), "") != 0) {
-        csmString path = _modelSetting->GetPhysicsFileName();
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(_modelSetting->GetPhysicsFileName());
 
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadPhysics(buffer, size);
@@ -168,8 +173,7 @@ void UserModel::SetupModel(ICubismModelSetting* setting) {
 
     // 姿势
     if (strcmp(_modelSetting->GetPoseFileName(), "") != 0) {
-        csmString path = _modelSetting->GetPoseFileName();
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(_modelSetting->GetPoseFileName());
 
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadPose(buffer, size);
@@ -198,8 +202,7 @@ void UserModel::SetupModel(ICubismModelSetting* setting) {
 
     // 用户数据
     if (strcmp(_modelSetting->GetUserDataFile(), "") != 0) {
-        csmString path = _modelSetting->GetUserDataFile();
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(_modelSetting->GetUserDataFile());
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadUserData(buffer, size);
         DeleteBuffer(buffer, path.GetRawString());
@@ -250,17 +253,19 @@ void UserModel::PreloadMotionGroup(const csmChar* group) {
     for (csmInt32 i = 0; i < count; i++) {
         // 例如 idle_0
         csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, i);
-        csmString path = _modelSetting->GetMotionFileName(group, i);
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(_modelSetting->GetMotionFileName(group, i));
 
         if (_debugMode) {
             PlatformOption::_PrintLog("[APP]load motion: %s => [%s_%d] ", path.GetRawString(), group, i);
         }
 
-        csmByte* buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        CubismMotion* tmpMotion = static_cast<CubismMotion*>(LoadMotion(buffer, size, name.GetRawString(), NULL, NULL, _modelSetting, group, i));
+        CubismMotionData* motionData = AcquireMotionData(path);
+        if (motionData == NULL) {
+            continue;
+        }
+
+        CubismMotion* tmpMotion = static_cast<CubismMotion*>(LoadMotion(motionData, name.GetRawString(), NULL, NULL, _modelSetting, group, i));
+        motionData->Release();
 
         if (tmpMotion) {
             tmpMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
@@ -270,9 +275,28 @@ void UserModel::PreloadMotionGroup(const csmChar* group) {
             }
             _motions[name] = tmpMotion;
         }
+    }
+}
 
-        DeleteBuffer(buffer, path.GetRawString());
+CubismMotionData* UserModel::AcquireMotionData(const csmString& path) {
+    CubismMotionDataCache* cache = CubismFramework::GetMotionDataCache();
+
+    // 已解析的动作数据在所有模型之间共享
+    CubismMotionData* motionData = cache->Find(path.GetRawString());
+    if (motionData != NULL) {
+        return motionData;
+    }
+
+    csmSizeInt size;
+    csmByte* buffer = CreateBuffer(path.GetRawString(), &size);
+    if (buffer == NULL) {
+        return NULL;
     }
+
+    motionData = cache->Acquire(path.GetRawString(), buffer, size, _motionConsistency);
+    DeleteBuffer(buffer, path.GetRawString());
+
+    return motionData;
 }
 
 void UserModel::ReleaseMotionGroup(const csmChar* group) const {
@@ -281,8 +305,7 @@ void UserModel::ReleaseMotionGroup(const csmChar* group) const {
         csmString voice = _modelSetting->GetMotionSoundFileName(group, i);
         if (strcmp(voice.GetRawString(), "") != 0)
         {
-            csmString path = voice;
-            path = _modelHomeDir + path;
+            csmString path = MakeAssetPath(voice);
         }
     }
 }
@@ -316,7 +339,6 @@ void UserModel::Update() {
 
     //-----------------------------------------------------------------
     _model->LoadParameters(); // 加载上次保存的状态
-    _model->LoadParameters(); // 加载上次保存的状态
     if (_motionManager->IsFinished()) {
         // 若没有动作播放，则从待机动作中随机播放一个
         // TODO
@@ -361,7 +383,7 @@ void UserModel::Update() {
     }
 
     // 物理运算设置
-    if (_physics != NULL) {
+    if (_physics != NULL && !IsPhysicsFrozen()) {
         _physics->Evaluate(_model, deltaTimeSeconds);
     }
 
@@ -401,20 +423,18 @@ CubismMotionQueueEntryHandle UserModel::StartMotion(const csmChar* group, csmInt
     csmBool autoDelete = false;
 
     if (motion == NULL) {
-        csmString path = fileName;
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(fileName);
 
-        csmByte* buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        motion = static_cast<CubismMotion*>(LoadMotion(buffer, size, NULL, onFinishedMotionHandler, NULL, _modelSetting, group, no));
+        CubismMotionData* motionData = AcquireMotionData(path);
+        if (motionData != NULL) {
+            motion = static_cast<CubismMotion*>(LoadMotion(motionData, NULL, onFinishedMotionHandler, NULL, _modelSetting, group, no));
+            motionData->Release();
+        }
 
         if (motion) {
             motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
             autoDelete = true; // 終了時にメモリから削除
         }
-
-        DeleteBuffer(buffer, path.GetRawString());
     } else {
         motion->SetBeganMotionHandler(onBeganMotionHandler);
         motion->SetFinishedMotionHandler(onFinishedMotionHandler);
@@ -423,8 +443,7 @@ CubismMotionQueueEntryHandle UserModel::StartMotion(const csmChar* group, csmInt
     //voice
     csmString voice = _modelSetting->GetMotionSoundFileName(group, no);
     if (strcmp(voice.GetRawString(), "") != 0) {
-        csmString path = voice;
-        path = _modelHomeDir + path;
+        csmString path = MakeAssetPath(voice);
     }
 
     if (_debugMode) {
@@ -528,8 +547,7 @@ void UserModel::SetupTextures() {
         }
 
         // 加载到Metal纹理
-        csmString texturePath = _modelSetting->GetTextureFileName(modelTextureNumber);
-        texturePath = _modelHomeDir + texturePath;
+        csmString texturePath = MakeAssetPath(_modelSetting->GetTextureFileName(modelTextureNumber));
 
         // TODO
 //        AppDelegate *delegate = (AppDelegate *) [[UIApplication sharedApplication] delegate];
@@ -561,8 +579,7 @@ csmBool UserModel::HasMocConsistencyFromFile(const csmChar* mocFileName) {
     csmByte* buffer;
     csmSizeInt size;
 
-    csmString path = mocFileName;
-    path = _modelHomeDir + path;
+    csmString path = MakeAssetPath(mocFileName);
 
     buffer = CreateBuffer(path.GetRawString(), &size);
 
@@ -9,7 +9,14 @@
 #include "Utils/CubismDebug.hpp"
 #include "Utils/CubismJson.hpp"
 #include "Id/CubismIdManager.hpp"
+#include "Motion/CubismMotionDataCache.hpp"
+#include "Motion/CubismMotionLoader.hpp"
+#include "Model/CubismMocCache.hpp"
+#include "Utils/CubismThreadPool.hpp"
+#include "Utils/CubismMemoryTracker.hpp"
+#include "Utils/CubismAllocationStats.hpp"
 #include "Rendering/CubismRenderer.hpp"
+#include <mutex>
 
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
@@ -34,6 +41,32 @@ csmBool                           s_isInitialized = false;
 ICubismAllocator*                 s_allocator = NULL;
 const CubismFramework::Option*    s_option = NULL;
 CubismIdManager*                  s_cubismIdManager = NULL;
+CubismMotionDataCache*            s_motionDataCache = NULL;
+CubismThreadPool*                 s_threadPool = NULL;
+CubismMotionLoader*               s_motionLoader = NULL;
+CubismMocCache*                   s_mocCache = NULL;
+std::mutex                        s_threadsMutex;       ///< Guards the creation of s_threadPool and s_motionLoader
+
+/// Upper bound of the worker threads of the shared thread pool.
+const csmUint32 MaxWorkerThreadCount = 3;
+
+/// Upper bound of the worker threads of the motion loader.
+const csmUint32 MaxMotionLoaderThreadCount = 2;
+
+/**
+ * Number of worker threads for the shared thread pool.
+ */
+csmUint32 GetWorkerThreadCount()
+{
+    // 呼び出しスレッドも処理に加わるため、ワーカーは論理コア数より1つ少なくする
+    csmUint32 workerCount = std::thread::hardware_concurrency();
+    workerCount = (workerCount > 1) ? workerCount - 1 : 0;
+    if (workerCount > MaxWorkerThreadCount)
+    {
+        workerCount = MaxWorkerThreadCount;
+    }
+    return workerCount;
+}
 
 }
 
@@ -42,6 +75,45 @@ inline ICubismAllocator* GetAllocator()
     return s_allocator;
 }
 
+// CSM_MEMORY_TRACKING が有効な場合は、確保したブロックの前にタグを置いてモデルごとの使用量に計上する
+inline void* AllocateFromAllocator(csmSizeType size)
+{
+#ifdef CSM_MEMORY_TRACKING
+    const csmSizeType offset = CubismMemoryTracker::GetOffset(0);
+    return CubismMemoryTracker::Attach(GetAllocator()->Allocate(size + offset), size, offset);
+#else
+    return GetAllocator()->Allocate(size);
+#endif
+}
+
+inline void* AllocateAlignedFromAllocator(csmSizeType size, csmUint32 alignment)
+{
+#ifdef CSM_MEMORY_TRACKING
+    const csmSizeType offset = CubismMemoryTracker::GetOffset(alignment);
+    return CubismMemoryTracker::Attach(GetAllocator()->AllocateAligned(size + offset, alignment), size, offset);
+#else
+    return GetAllocator()->AllocateAligned(size, alignment);
+#endif
+}
+
+inline void DeallocateToAllocator(void* address)
+{
+#ifdef CSM_MEMORY_TRACKING
+    GetAllocator()->Deallocate(CubismMemoryTracker::Detach(address));
+#else
+    GetAllocator()->Deallocate(address);
+#endif
+}
+
+inline void DeallocateAlignedToAllocator(void* address)
+{
+#ifdef CSM_MEMORY_TRACKING
+    GetAllocator()->DeallocateAligned(CubismMemoryTracker::Detach(address));
+#else
+    GetAllocator()->DeallocateAligned(address);
+#endif
+}
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
 namespace {
@@ -100,6 +172,10 @@ void CubismFramework::CleanUp()
     s_allocator = NULL;
     s_option = NULL;
     s_cubismIdManager = NULL;
+    s_motionDataCache = NULL;
+    s_threadPool = NULL;
+    s_motionLoader = NULL;
+    s_mocCache = NULL;
 #ifdef CSM_DEBUG_MEMORY_LEAKING
     s_allocationList = NULL;
 #endif
@@ -137,6 +213,12 @@ void CubismFramework::Initialize()
 
     s_cubismIdManager = CSM_NEW CubismIdManager();
 
+    s_motionDataCache = CSM_NEW CubismMotionDataCache();
+
+    s_mocCache = CSM_NEW CubismMocCache();
+
+    // スレッドプールとモーションローダーは最初に使われたときに作り、使わないアプリではスレッドを起こさない
+
     s_isInitialized = true;
 
     CubismLogInfo("CubismFramework::Initialize() is complete.");
@@ -159,9 +241,29 @@ void CubismFramework::Dispose()
         return;
     }
 
+    // 読み込み中のワーカーはJSONの静的な値、キャッシュ、IDを使うので最初に止める
+    if (s_motionLoader != NULL)
+    {
+        CubismMotionLoader::Delete(s_motionLoader);
+        s_motionLoader = NULL;
+    }
+
     //---- static 解放 ----
     Utils::Value::StaticReleaseNotForClientCall();
 
+    CSM_DELETE(s_motionDataCache);
+    s_motionDataCache = NULL;
+
+    // モデルが使用中のMOCはキャッシュの参照を外すだけで、モデルの解放時に削除される
+    CSM_DELETE(s_mocCache);
+    s_mocCache = NULL;
+
+    if (s_threadPool != NULL)
+    {
+        CubismThreadPool::Delete(s_threadPool);
+        s_threadPool = NULL;
+    }
+
     CSM_DELETE(s_cubismIdManager);
 
     //レンダラの静的リソース（シェーダプログラム他）を解放する
@@ -183,6 +285,10 @@ void CubismFramework::Dispose()
 
 #endif
 
+#ifdef CSM_ALLOCATION_STATS
+    CubismAllocationStats::LogLiveCallSites();
+#endif
+
     s_isInitialized = false;
 
     CubismLogInfo("CubismFramework::Dispose() is complete.");
@@ -228,32 +334,85 @@ CubismIdManager* CubismFramework::GetIdManager()
     return s_cubismIdManager;
 }
 
-#ifdef CSM_DEBUG_MEMORY_LEAKING
+CubismMotionDataCache* CubismFramework::GetMotionDataCache()
+{
+    return s_motionDataCache;
+}
+
+CubismThreadPool* CubismFramework::GetThreadPool()
+{
+    std::lock_guard<std::mutex> lock(s_threadsMutex);
+
+    if (s_threadPool == NULL && s_isInitialized)
+    {
+        // 全モデルで共有するので、最初に使ったモデルには計上しない
+        CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
+        s_threadPool = CubismThreadPool::Create(static_cast<csmInt32>(GetWorkerThreadCount()));
+    }
+
+    return s_threadPool;
+}
+
+CubismMotionLoader* CubismFramework::GetMotionLoader()
+{
+    std::lock_guard<std::mutex> lock(s_threadsMutex);
+
+    if (s_motionLoader == NULL && s_isInitialized)
+    {
+        // 読み込みは描画と並行して行うので、共有プールとは別のスレッドで処理する
+        const csmUint32 workerCount = GetWorkerThreadCount();
+        CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
+        s_motionLoader = CubismMotionLoader::Create(static_cast<csmInt32>(workerCount < MaxMotionLoaderThreadCount ? workerCount : MaxMotionLoaderThreadCount));
+    }
+
+    return s_motionLoader;
+}
+
+CubismMocCache* CubismFramework::GetMocCache()
+{
+    return s_mocCache;
+}
+
+#ifdef CSM_ALLOCATION_CALL_SITES
 
 void* CubismFramework::Allocate(csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
 {
-    void* address = GetAllocator()->Allocate(size);
+#ifdef CSM_ALLOCATION_STATS
+    const csmSizeType offset = CubismAllocationStats::GetOffset(0);
+    void* address = CubismAllocationStats::Attach(AllocateFromAllocator(size + offset), size, offset, fileName, lineNumber);
+#else
+    void* address = AllocateFromAllocator(size);
+#endif
 
+#ifdef CSM_DEBUG_MEMORY_LEAKING
     CubismLogVerbose("CubismFramework::Allocate(0x%p, %dbytes) %s(%d)", address, size, fileName, lineNumber);
 
     if (s_allocationList)
     {
         s_allocationList->push_back(address);
     }
+#endif
 
     return address;
 }
 
 void* CubismFramework::AllocateAligned(csmSizeType size, csmUint32 alignment, const csmChar* fileName, csmInt32 lineNumber)
 {
-    void* address = GetAllocator()->AllocateAligned(size, alignment);
+#ifdef CSM_ALLOCATION_STATS
+    const csmSizeType offset = CubismAllocationStats::GetOffset(alignment);
+    void* address = CubismAllocationStats::Attach(AllocateAlignedFromAllocator(size + offset, alignment), size, offset, fileName, lineNumber);
+#else
+    void* address = AllocateAlignedFromAllocator(size, alignment);
+#endif
 
+#ifdef CSM_DEBUG_MEMORY_LEAKING
     CubismLogVerbose("CubismFramework::AllocateAligned(0x%p, a:%d, %dbytes) %s(%d)", address, alignment, size, fileName, lineNumber);
 
     if (s_allocationList)
     {
         s_allocationList->push_back(address);
     }
+#endif
 
     return address;
 }
@@ -265,6 +424,7 @@ void CubismFramework::Deallocate(void* address, const csmChar* fileName, csmInt3
         return;
     }
 
+#ifdef CSM_DEBUG_MEMORY_LEAKING
     CubismLogVerbose("CubismFramework::Deallocate(0x%p) %s(%d)", address, fileName, lineNumber);
 
     if (s_allocationList)
@@ -280,8 +440,17 @@ void CubismFramework::Deallocate(void* address, const csmChar* fileName, csmInt3
             break;
         }
     }
+#else
+    // 呼び出し元はリーク検出のログにだけ使う
+    (void)fileName;
+    (void)lineNumber;
+#endif
 
-    GetAllocator()->Deallocate(address);
+#ifdef CSM_ALLOCATION_STATS
+    DeallocateToAllocator(CubismAllocationStats::Detach(address));
+#else
+    DeallocateToAllocator(address);
+#endif
 }
 
 void CubismFramework::DeallocateAligned(void* address, const csmChar* fileName, csmInt32 lineNumber)
@@ -291,6 +460,7 @@ void CubismFramework::DeallocateAligned(void* address, const csmChar* fileName,
         return;
     }
 
+#ifdef CSM_DEBUG_MEMORY_LEAKING
     CubismLogVerbose("CubismFramework::DeallocateAligned(0x%p) %s(%d)", address, fileName, lineNumber);
 
     if (s_allocationList)
@@ -306,20 +476,29 @@ void CubismFramework::DeallocateAligned(void* address, const csmChar* fileName,
             break;
         }
     }
+#else
+    // 呼び出し元はリーク検出のログにだけ使う
+    (void)fileName;
+    (void)lineNumber;
+#endif
 
-    GetAllocator()->DeallocateAligned(address);
+#ifdef CSM_ALLOCATION_STATS
+    DeallocateAlignedToAllocator(CubismAllocationStats::Detach(address));
+#else
+    DeallocateAlignedToAllocator(address);
+#endif
 }
 
 #else
 
 void* CubismFramework::Allocate(csmSizeType size)
 {
-    return GetAllocator()->Allocate(size);
+    return AllocateFromAllocator(size);
 }
 
 void* CubismFramework::AllocateAligned(csmSizeType size, csmUint32 alignment)
 {
-    return GetAllocator()->AllocateAligned(size, alignment);
+    return AllocateAlignedFromAllocator(size, alignment);
 }
 
 void CubismFramework::Deallocate(void* address)
@@ -329,7 +508,7 @@ void CubismFramework::Deallocate(void* address)
         return;
     }
 
-    GetAllocator()->Deallocate(address);
+    DeallocateToAllocator(address);
 }
 
 void CubismFramework::DeallocateAligned(void* address)
@@ -339,7 +518,7 @@ void CubismFramework::DeallocateAligned(void* address)
         return;
     }
 
-    GetAllocator()->DeallocateAligned(address);
+    DeallocateAlignedToAllocator(address);
 }
 
 #endif
@@ -347,7 +526,7 @@ void CubismFramework::DeallocateAligned(void* address)
 }}}
 //--------- LIVE2D NAMESPACE ------------
 
-#ifdef CSM_DEBUG_MEMORY_LEAKING
+#ifdef CSM_ALLOCATION_CALL_SITES
 
 void* operator new(Live2D::Cubism::Framework::csmSizeType size, Live2D::Cubism::Framework::CubismAllocationTag tag, const Live2D::Cubism::Framework::csmChar* fileName, Live2D::Cubism::Framework::csmInt32 lineNumber)
 {
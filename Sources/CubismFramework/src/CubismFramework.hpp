@@ -48,11 +48,16 @@ static CubismAllocationAlignedTag GloabalAlignedTag;
 
 }}}
 
+// The source file and line of each allocation are passed to the allocator when they are needed.
+#if defined(CSM_DEBUG_MEMORY_LEAKING) || defined(CSM_ALLOCATION_STATS)
+#define CSM_ALLOCATION_CALL_SITES
+#endif
+
 // Macros for memory allocation.
-#ifdef CSM_DEBUG_MEMORY_LEAKING
+#ifdef CSM_ALLOCATION_CALL_SITES
 
 // For debugging.
-// Tracks / Detects the memory leaking.
+// Tracks / Detects the memory leaking and counts the allocations of each call site.
 
 void* operator new (Live2D::Cubism::Framework::csmSizeType size, Live2D::Cubism::Framework::CubismAllocationTag tag, const Live2D::Cubism::Framework::csmChar* fileName, Live2D::Cubism::Framework::csmInt32 lineNumber);
 void* operator new (Live2D::Cubism::Framework::csmSizeType size, Live2D::Cubism::Framework::csmUint32 alignment, Live2D::Cubism::Framework::CubismAllocationAlignedTag tag, const Live2D::Cubism::Framework::csmChar* fileName, Live2D::Cubism::Framework::csmInt32 lineNumber);
@@ -128,6 +133,10 @@ void CsmDelete(T* address)
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismIdManager;
+class CubismMotionDataCache;
+class CubismThreadPool;
+class CubismMotionLoader;
+class CubismMocCache;
 
 }}}
 
@@ -341,7 +350,45 @@ public:
      */
     static CubismIdManager* GetIdManager();
 
-#ifdef CSM_DEBUG_MEMORY_LEAKING
+    /**
+     * Returns the instance of CubismMotionDataCache.
+     *
+     * @note Motion data acquired through this cache is shared by every model playing the same motion file.
+     *
+     * @return Instance of CubismMotionDataCache.
+     */
+    static CubismMotionDataCache* GetMotionDataCache();
+
+    /**
+     * Returns the instance of CubismThreadPool.
+     *
+     * @note The pool is shared by the framework for data-parallel work such as physics sub-rigs.<br>
+     *       It is made on the first call after Initialize(), so applications that never need it start no threads.
+     *
+     * @return Instance of CubismThreadPool; NULL if the framework is not initialized.
+     */
+    static CubismThreadPool* GetThreadPool();
+
+    /**
+     * Returns the instance of CubismMotionLoader.
+     *
+     * @note The loader decodes motion and expression files on its own background threads.<br>
+     *       It is made on the first call after Initialize(), so applications that never need it start no threads.
+     *
+     * @return Instance of CubismMotionLoader; NULL if the framework is not initialized.
+     */
+    static CubismMotionLoader* GetMotionLoader();
+
+    /**
+     * Returns the instance of CubismMocCache.
+     *
+     * @note The cache shares revived MOC data between models created from the same MOC file.
+     *
+     * @return Instance of CubismMocCache.
+     */
+    static CubismMocCache* GetMocCache();
+
+#ifdef CSM_ALLOCATION_CALL_SITES
 
     /**
      * (For debugging) Allocates the memory.
@@ -24,6 +24,30 @@
  */
 // #define CSM_DEBUG_MEMORY_LEAKING
 
+/**
+ * Tags every allocation of Cubism Framework so that CubismUserModel::GetMemoryReport() can break<br>
+ * the memory of a model down by subsystem.
+ *
+ * @note Each allocation grows by a 16-byte tag, or by its alignment if that is larger.
+ */
+// #define CSM_MEMORY_TRACKING
+
+/**
+ * Times the stages of the update and render pipeline into the CubismProfile of each model.
+ *
+ * @note Without it, CSM_PROFILE_STAGE() and CSM_PROFILE_COUNT() expand to nothing.
+ */
+// #define CSM_PROFILING
+
+/**
+ * Counts the allocations of Cubism Framework by call site and the copies of csmVector and csmString,<br>
+ * so that CubismAllocationStats can snapshot them per frame and CubismNoAllocationScope can prove<br>
+ * that a scope does not allocate.
+ *
+ * @note Each allocation grows by a 16-byte header, or by its alignment if that is larger.
+ */
+// #define CSM_ALLOCATION_STATS
+
 
 /**
  * A set of macros to configure the logging level forcefully.
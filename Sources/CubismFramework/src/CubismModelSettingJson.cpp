@@ -228,38 +228,20 @@ const csmChar* CubismModelSettingJson::GetTextureDirectory()
         return "";
     }
 
-    csmVector<csmString> splitPathBuffer;
-    csmVector<csmChar> charBuffer;
-    const csmChar* rawString = (*_jsonValue[FrequentNode_Textures])[0].GetRawString();
-    csmInt32 rawStringSize = (*_jsonValue[FrequentNode_Textures])[0].GetString().GetLength();
-    for (csmInt32 i = 0; i < rawStringSize; i++)
+    // 最後の/より前をディレクトリとする。返すポインタが有効であるようにメンバに保持する
+    const csmStringView texturePath((*_jsonValue[FrequentNode_Textures])[0].GetString());
+    const csmInt32 separatorIndex = texturePath.FindLast('/');
+
+    if (separatorIndex < 0)
     {
-        // /を含んでいる場合splitする
-        if (rawString[i] == '/')
-        {
-            csmString str = csmString(charBuffer.GetPtr());
-            splitPathBuffer.PushBack(str);
-            charBuffer.Clear();
-        }
-        // 一文字ずつVector配列に格納する
-        else
-        {
-            charBuffer.PushBack(static_cast<csmChar>(rawString[i] & 0xFF));
-        }
+        _textureDirectory.Clear();
     }
-
-    csmInt32 arrayLength = splitPathBuffer.GetSize();
-    csmString textureDirectoryStr = csmString();
-    for(csmInt32 i = 0; i < arrayLength; i++)
+    else
     {
-        textureDirectoryStr = textureDirectoryStr + splitPathBuffer[i];
-        if(i < arrayLength - 1)
-        {
-            textureDirectoryStr = textureDirectoryStr + "/";
-        }
+        _textureDirectory = csmString(texturePath.Substring(0, separatorIndex));
     }
 
-    return textureDirectoryStr.GetRawString();
+    return _textureDirectory.GetRawString();
 }
 
 const csmChar* CubismModelSettingJson::GetTextureFileName(csmInt32 index)
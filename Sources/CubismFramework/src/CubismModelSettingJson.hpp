@@ -389,5 +389,8 @@ protected:
 
     /** Cache of JSON nodes */
     csmVector<Utils::Value*>    _jsonValue;
+
+    /** String returned by GetTextureDirectory() */
+    csmString                   _textureDirectory;
 };
 }}}
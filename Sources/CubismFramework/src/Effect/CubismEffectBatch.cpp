@@ -0,0 +1,560 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismEffectBatch.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include "Effect/CubismEyeBlink.hpp"
+#include "Math/CubismMath.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSM_EFFECTBATCH_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSM_EFFECTBATCH_USE_NEON
+#endif
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+// CubismEyeBlink と同じ既定値
+const csmFloat32 DefaultBlinkingInterval = 4.0f;
+const csmFloat32 DefaultClosingSeconds = 0.1f;
+const csmFloat32 DefaultClosedSeconds = 0.05f;
+const csmFloat32 DefaultOpeningSeconds = 0.15f;
+const csmBool EyeCloseIfZero = true;
+
+// CubismTargetPoint と同じ定数
+const csmInt32 TargetFrameRate = 30;
+const csmFloat32 TargetEpsilon = 0.01f;
+
+// sin(x) のテイラー展開の係数。[-Pi/2, Pi/2] で誤差は 1e-7 程度
+const csmFloat32 SinC3 = -1.0f / 6.0f;
+const csmFloat32 SinC5 = 1.0f / 120.0f;
+const csmFloat32 SinC7 = -1.0f / 5040.0f;
+const csmFloat32 SinC9 = 1.0f / 362880.0f;
+const csmFloat32 SinC11 = -1.0f / 39916800.0f;
+
+/**
+ * sin(2 * Pi * phase) を返す。phaseの単位は周期
+ */
+inline csmFloat32 SinCycle(csmFloat32 phase)
+{
+    // 最も近い整数を引いて[-0.5, 0.5]周期にし、[-Pi/2, Pi/2]に折り返す
+    const csmFloat32 r = phase - floorf(phase + 0.5f);
+    csmFloat32 x = r * 2.0f * CubismMath::Pi;
+
+    if (x > 0.5f * CubismMath::Pi)
+    {
+        x = CubismMath::Pi - x;
+    }
+    else if (x < -0.5f * CubismMath::Pi)
+    {
+        x = -CubismMath::Pi - x;
+    }
+
+    const csmFloat32 x2 = x * x;
+    return x * (1.0f + x2 * (SinC3 + x2 * (SinC5 + x2 * (SinC7 + x2 * (SinC9 + x2 * SinC11)))));
+}
+
+/**
+ * values[i] = offsets[i] + peaks[i] * sin(2 * Pi * values[i]) を計算する
+ */
+void CalculateBreathValues(csmFloat32* values, const csmFloat32* offsets, const csmFloat32* peaks, csmInt32 count)
+{
+    csmInt32 i = 0;
+
+#if defined(CSM_EFFECTBATCH_USE_SSE2)
+    const __m128 twoPi = _mm_set1_ps(2.0f * CubismMath::Pi);
+    const __m128 pi = _mm_set1_ps(CubismMath::Pi);
+    const __m128 halfPi = _mm_set1_ps(0.5f * CubismMath::Pi);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 phase = _mm_loadu_ps(values + i);
+        const __m128 r = _mm_sub_ps(phase, _mm_cvtepi32_ps(_mm_cvtps_epi32(phase)));
+        __m128 x = _mm_mul_ps(r, twoPi);
+
+        // |x| > Pi/2 なら sign(x) * Pi - x に折り返す
+        const __m128 sign = _mm_and_ps(x, signMask);
+        const __m128 isOutside = _mm_cmpgt_ps(_mm_andnot_ps(signMask, x), halfPi);
+        const __m128 folded = _mm_sub_ps(_mm_or_ps(pi, sign), x);
+        x = _mm_or_ps(_mm_and_ps(isOutside, folded), _mm_andnot_ps(isOutside, x));
+
+        const __m128 x2 = _mm_mul_ps(x, x);
+        __m128 p = _mm_add_ps(_mm_mul_ps(x2, _mm_set1_ps(SinC11)), _mm_set1_ps(SinC9));
+        p = _mm_add_ps(_mm_mul_ps(x2, p), _mm_set1_ps(SinC7));
+        p = _mm_add_ps(_mm_mul_ps(x2, p), _mm_set1_ps(SinC5));
+        p = _mm_add_ps(_mm_mul_ps(x2, p), _mm_set1_ps(SinC3));
+        p = _mm_add_ps(_mm_mul_ps(x2, p), one);
+        const __m128 s = _mm_mul_ps(x, p);
+
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(offsets + i), _mm_mul_ps(_mm_loadu_ps(peaks + i), s)));
+    }
+#elif defined(CSM_EFFECTBATCH_USE_NEON)
+    const float32x4_t twoPi = vdupq_n_f32(2.0f * CubismMath::Pi);
+    const float32x4_t pi = vdupq_n_f32(CubismMath::Pi);
+    const float32x4_t negativePi = vdupq_n_f32(-CubismMath::Pi);
+    const float32x4_t halfPi = vdupq_n_f32(0.5f * CubismMath::Pi);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t negativeHalf = vdupq_n_f32(-0.5f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        // 切り捨て変換しかないので、符号に合わせて0.5を足して最も近い整数にする
+        const float32x4_t phase = vld1q_f32(values + i);
+        const uint32x4_t isNegativePhase = vcltq_f32(phase, zero);
+        const float32x4_t rounded = vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(phase, vbslq_f32(isNegativePhase, negativeHalf, half))));
+        float32x4_t x = vmulq_f32(vsubq_f32(phase, rounded), twoPi);
+
+        const uint32x4_t isOutside = vcgtq_f32(vabsq_f32(x), halfPi);
+        const float32x4_t folded = vsubq_f32(vbslq_f32(vcltq_f32(x, zero), negativePi, pi), x);
+        x = vbslq_f32(isOutside, folded, x);
+
+        const float32x4_t x2 = vmulq_f32(x, x);
+        float32x4_t p = vmlaq_f32(vdupq_n_f32(SinC9), x2, vdupq_n_f32(SinC11));
+        p = vmlaq_f32(vdupq_n_f32(SinC7), x2, p);
+        p = vmlaq_f32(vdupq_n_f32(SinC5), x2, p);
+        p = vmlaq_f32(vdupq_n_f32(SinC3), x2, p);
+        p = vmlaq_f32(one, x2, p);
+        const float32x4_t s = vmulq_f32(x, p);
+
+        vst1q_f32(values + i, vmlaq_f32(vld1q_f32(offsets + i), vld1q_f32(peaks + i), s));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] = offsets[i] + peaks[i] * SinCycle(values[i]);
+    }
+}
+}
+
+CubismEffectBatch* CubismEffectBatch::Create()
+{
+    return CSM_NEW CubismEffectBatch();
+}
+
+void CubismEffectBatch::Delete(CubismEffectBatch* instance)
+{
+    CSM_DELETE_SELF(CubismEffectBatch, instance);
+}
+
+CubismEffectBatch::CubismEffectBatch()
+{ }
+
+CubismEffectBatch::~CubismEffectBatch()
+{ }
+
+csmInt32 CubismEffectBatch::AddModel(CubismModel* model)
+{
+    csmInt32 slot;
+
+    if (_freeSlots.GetSize() > 0)
+    {
+        slot = _freeSlots[_freeSlots.GetSize() - 1];
+        _freeSlots.Remove(_freeSlots.GetSize() - 1);
+    }
+    else
+    {
+        slot = _models.GetSize();
+        _models.PushBack(NULL);
+        _breathTimes.PushBack(0.0f);
+        _blinkStates.PushBack(0);
+        _blinkUserTimes.PushBack(0.0f);
+        _blinkStateStartTimes.PushBack(0.0f);
+        _blinkNextTimes.PushBack(0.0f);
+        _blinkIntervals.PushBack(0.0f);
+        _blinkClosingSeconds.PushBack(0.0f);
+        _blinkClosedSeconds.PushBack(0.0f);
+        _blinkOpeningSeconds.PushBack(0.0f);
+        _blinkValues.PushBack(0.0f);
+        _isBlinkEnabled.PushBack(false);
+        _faceTargetXs.PushBack(0.0f);
+        _faceTargetYs.PushBack(0.0f);
+        _faceXs.PushBack(0.0f);
+        _faceYs.PushBack(0.0f);
+        _faceVXs.PushBack(0.0f);
+        _faceVYs.PushBack(0.0f);
+        _targetLastTimes.PushBack(0.0f);
+        _targetUserTimes.PushBack(0.0f);
+    }
+
+    _models[slot] = model;
+    _breathTimes[slot] = 0.0f;
+    _blinkStates[slot] = CubismEyeBlink::EyeState_First;
+    _blinkUserTimes[slot] = 0.0f;
+    _blinkStateStartTimes[slot] = 0.0f;
+    _blinkNextTimes[slot] = 0.0f;
+    _blinkIntervals[slot] = DefaultBlinkingInterval;
+    _blinkClosingSeconds[slot] = DefaultClosingSeconds;
+    _blinkClosedSeconds[slot] = DefaultClosedSeconds;
+    _blinkOpeningSeconds[slot] = DefaultOpeningSeconds;
+    _blinkValues[slot] = 1.0f;
+    _isBlinkEnabled[slot] = true;
+    _faceTargetXs[slot] = 0.0f;
+    _faceTargetYs[slot] = 0.0f;
+    _faceXs[slot] = 0.0f;
+    _faceYs[slot] = 0.0f;
+    _faceVXs[slot] = 0.0f;
+    _faceVYs[slot] = 0.0f;
+    _targetLastTimes[slot] = 0.0f;
+    _targetUserTimes[slot] = 0.0f;
+
+    return slot;
+}
+
+void CubismEffectBatch::RemoveModel(csmInt32 slot)
+{
+    if (slot < 0 || slot >= static_cast<csmInt32>(_models.GetSize()) || _models[slot] == NULL)
+    {
+        return;
+    }
+
+    RemoveBreathEntries(slot);
+    RemoveEyeBlinkEntries(slot);
+
+    _models[slot] = NULL;
+    _freeSlots.PushBack(slot);
+}
+
+csmInt32 CubismEffectBatch::GetModelCount() const
+{
+    return _models.GetSize() - _freeSlots.GetSize();
+}
+
+void CubismEffectBatch::SetBreathParameters(csmInt32 slot, const csmVector<CubismBreath::BreathParameterData>& breathParameters)
+{
+    CSM_ASSERT(0 <= slot && slot < static_cast<csmInt32>(_models.GetSize()) && _models[slot] != NULL);
+
+    RemoveBreathEntries(slot);
+
+    for (csmUint32 i = 0; i < breathParameters.GetSize(); ++i)
+    {
+        const CubismBreath::BreathParameterData& data = breathParameters[i];
+
+        // IDは追加時に一度だけインデックスに解決する
+        _breathSlots.PushBack(slot);
+        _breathParameterIndices.PushBack(_models[slot]->GetParameterIndex(data.ParameterId));
+        _breathOffsets.PushBack(data.Offset);
+        _breathPeaks.PushBack(data.Peak);
+        _breathFrequencies.PushBack(1.0f / data.Cycle);
+        _breathWeights.PushBack(data.Weight);
+    }
+
+    // SIMDで4個ずつ読めるように作業領域を余分に確保する
+    _breathValues.UpdateSize((_breathSlots.GetSize() + 3) & ~3u, 0.0f);
+}
+
+void CubismEffectBatch::SetEyeBlinkParameterIds(csmInt32 slot, const csmVector<CubismIdHandle>& parameterIds)
+{
+    CSM_ASSERT(0 <= slot && slot < static_cast<csmInt32>(_models.GetSize()) && _models[slot] != NULL);
+
+    RemoveEyeBlinkEntries(slot);
+
+    for (csmUint32 i = 0; i < parameterIds.GetSize(); ++i)
+    {
+        _blinkSlots.PushBack(slot);
+        _blinkParameterIndices.PushBack(_models[slot]->GetParameterIndex(parameterIds[i]));
+    }
+}
+
+void CubismEffectBatch::SetEyeBlinkInterval(csmInt32 slot, csmFloat32 blinkingInterval)
+{
+    _blinkIntervals[slot] = blinkingInterval;
+}
+
+void CubismEffectBatch::SetEyeBlinkSettings(csmInt32 slot, csmFloat32 closing, csmFloat32 closed, csmFloat32 opening)
+{
+    _blinkClosingSeconds[slot] = closing;
+    _blinkClosedSeconds[slot] = closed;
+    _blinkOpeningSeconds[slot] = opening;
+}
+
+void CubismEffectBatch::SetEyeBlinkEnabled(csmInt32 slot, csmBool enabled)
+{
+    _isBlinkEnabled[slot] = enabled;
+}
+
+void CubismEffectBatch::SetTargetPoint(csmInt32 slot, csmFloat32 x, csmFloat32 y)
+{
+    _faceTargetXs[slot] = x;
+    _faceTargetYs[slot] = y;
+}
+
+csmFloat32 CubismEffectBatch::GetTargetPointX(csmInt32 slot) const
+{
+    return _faceXs[slot];
+}
+
+csmFloat32 CubismEffectBatch::GetTargetPointY(csmInt32 slot) const
+{
+    return _faceYs[slot];
+}
+
+void CubismEffectBatch::UpdateBreath(csmFloat32 deltaTimeSeconds)
+{
+    const csmInt32 slotCount = _models.GetSize();
+    const csmInt32 entryCount = _breathSlots.GetSize();
+
+    if (entryCount == 0)
+    {
+        return;
+    }
+
+    for (csmInt32 i = 0; i < slotCount; ++i)
+    {
+        _breathTimes[i] += deltaTimeSeconds;
+    }
+
+    // 位相を周期単位で求め、まとめて正弦波を計算する
+    // sinf(2 * Pi * time / cycle) と同じ値になる
+    csmFloat32* values = _breathValues.GetPtr();
+    const csmInt32* slots = _breathSlots.GetPtr();
+    const csmFloat32* frequencies = _breathFrequencies.GetPtr();
+    const csmFloat32* times = _breathTimes.GetPtr();
+
+    for (csmInt32 i = 0; i < entryCount; ++i)
+    {
+        values[i] = times[slots[i]] * frequencies[i];
+    }
+
+    CalculateBreathValues(values, _breathOffsets.GetPtr(), _breathPeaks.GetPtr(), entryCount);
+
+    const csmInt32* parameterIndices = _breathParameterIndices.GetPtr();
+    const csmFloat32* weights = _breathWeights.GetPtr();
+
+    for (csmInt32 i = 0; i < entryCount; ++i)
+    {
+        _models[slots[i]]->AddParameterValue(parameterIndices[i], values[i], weights[i]);
+    }
+}
+
+void CubismEffectBatch::UpdateEyeBlink(csmFloat32 deltaTimeSeconds)
+{
+    const csmInt32 slotCount = _models.GetSize();
+
+    // 状態遷移は CubismEyeBlink::UpdateParameters() と同じ
+    for (csmInt32 i = 0; i < slotCount; ++i)
+    {
+        if (_models[i] == NULL || !_isBlinkEnabled[i])
+        {
+            continue;
+        }
+
+        const csmFloat32 userTime = _blinkUserTimes[i] + deltaTimeSeconds;
+        _blinkUserTimes[i] = userTime;
+
+        csmFloat32 parameterValue;
+        csmFloat32 t;
+
+        switch (_blinkStates[i])
+        {
+        case CubismEyeBlink::EyeState_Closing:
+            t = ((userTime - _blinkStateStartTimes[i]) / _blinkClosingSeconds[i]);
+
+            if (t >= 1.0f)
+            {
+                t = 1.0f;
+                _blinkStates[i] = CubismEyeBlink::EyeState_Closed;
+                _blinkStateStartTimes[i] = userTime;
+            }
+
+            parameterValue = 1.0f - t;
+
+            break;
+        case CubismEyeBlink::EyeState_Closed:
+            t = ((userTime - _blinkStateStartTimes[i]) / _blinkClosedSeconds[i]);
+
+            if (t >= 1.0f)
+            {
+                _blinkStates[i] = CubismEyeBlink::EyeState_Opening;
+                _blinkStateStartTimes[i] = userTime;
+            }
+
+            parameterValue = 0.0f;
+
+            break;
+        case CubismEyeBlink::EyeState_Opening:
+            t = ((userTime - _blinkStateStartTimes[i]) / _blinkOpeningSeconds[i]);
+
+            if (t >= 1.0f)
+            {
+                t = 1.0f;
+                _blinkStates[i] = CubismEyeBlink::EyeState_Interval;
+                _blinkNextTimes[i] = userTime + (static_cast<csmFloat32>(rand()) / RAND_MAX) * (2.0f * _blinkIntervals[i] - 1.0f);
+            }
+
+            parameterValue = t;
+
+            break;
+        case CubismEyeBlink::EyeState_Interval:
+            if (_blinkNextTimes[i] < userTime)
+            {
+                _blinkStates[i] = CubismEyeBlink::EyeState_Closing;
+                _blinkStateStartTimes[i] = userTime;
+            }
+
+            parameterValue = 1.0f;
+
+            break;
+        case CubismEyeBlink::EyeState_First:
+        default:
+            _blinkStates[i] = CubismEyeBlink::EyeState_Interval;
+            _blinkNextTimes[i] = userTime + (static_cast<csmFloat32>(rand()) / RAND_MAX) * (2.0f * _blinkIntervals[i] - 1.0f);
+
+            parameterValue = 1.0f;
+
+            break;
+        }
+
+        _blinkValues[i] = EyeCloseIfZero ? parameterValue : -parameterValue;
+    }
+
+    const csmInt32 entryCount = _blinkSlots.GetSize();
+
+    for (csmInt32 i = 0; i < entryCount; ++i)
+    {
+        const csmInt32 slot = _blinkSlots[i];
+
+        if (_isBlinkEnabled[slot])
+        {
+            _models[slot]->SetParameterValue(_blinkParameterIndices[i], _blinkValues[slot]);
+        }
+    }
+}
+
+void CubismEffectBatch::UpdateTargetPoints(csmFloat32 deltaTimeSeconds)
+{
+    // 計算は CubismTargetPoint::Update() と同じ
+    const csmFloat32 FaceParamMaxV = 40.0 / 10.0f;
+    const csmFloat32 MaxV = FaceParamMaxV * 1.0f / static_cast<csmFloat32>(TargetFrameRate);
+    const csmFloat32 TimeToMaxSpeed = 0.15f;
+    const csmFloat32 FrameToMaxSpeed = TimeToMaxSpeed * static_cast<csmFloat32>(TargetFrameRate);
+
+    const csmInt32 slotCount = _models.GetSize();
+
+    for (csmInt32 i = 0; i < slotCount; ++i)
+    {
+        if (_models[i] == NULL)
+        {
+            continue;
+        }
+
+        const csmFloat32 userTime = _targetUserTimes[i] + deltaTimeSeconds;
+        _targetUserTimes[i] = userTime;
+
+        if (_targetLastTimes[i] == 0.0f)
+        {
+            _targetLastTimes[i] = userTime;
+            continue;
+        }
+
+        const csmFloat32 deltaTimeWeight = (userTime - _targetLastTimes[i]) * static_cast<csmFloat32>(TargetFrameRate);
+        _targetLastTimes[i] = userTime;
+
+        const csmFloat32 MaxA = deltaTimeWeight * MaxV / FrameToMaxSpeed;
+
+        const csmFloat32 dx = _faceTargetXs[i] - _faceXs[i];
+        const csmFloat32 dy = _faceTargetYs[i] - _faceYs[i];
+
+        if (CubismMath::AbsF(dx) <= TargetEpsilon && CubismMath::AbsF(dy) <= TargetEpsilon)
+        {
+            continue;
+        }
+
+        const csmFloat32 d = CubismMath::SqrtF((dx * dx) + (dy * dy));
+
+        const csmFloat32 vx = MaxV * dx / d;
+        const csmFloat32 vy = MaxV * dy / d;
+
+        csmFloat32 ax = vx - _faceVXs[i];
+        csmFloat32 ay = vy - _faceVYs[i];
+
+        const csmFloat32 a = CubismMath::SqrtF((ax * ax) + (ay * ay));
+
+        if (a < -MaxA || a > MaxA)
+        {
+            ax *= MaxA / a;
+            ay *= MaxA / a;
+        }
+
+        csmFloat32 faceVX = _faceVXs[i] + ax;
+        csmFloat32 faceVY = _faceVYs[i] + ay;
+
+        const csmFloat32 maxV = 0.5f * (CubismMath::SqrtF((MaxA * MaxA) + 16.0f * MaxA * d - 8.0f * MaxA * d) - MaxA);
+        const csmFloat32 curV = CubismMath::SqrtF((faceVX * faceVX) + (faceVY * faceVY));
+
+        if (curV > maxV)
+        {
+            faceVX *= maxV / curV;
+            faceVY *= maxV / curV;
+        }
+
+        _faceVXs[i] = faceVX;
+        _faceVYs[i] = faceVY;
+        _faceXs[i] += faceVX;
+        _faceYs[i] += faceVY;
+    }
+}
+
+void CubismEffectBatch::RemoveBreathEntries(csmInt32 slot)
+{
+    const csmInt32 entryCount = _breathSlots.GetSize();
+    csmInt32 count = 0;
+
+    for (csmInt32 i = 0; i < entryCount; ++i)
+    {
+        if (_breathSlots[i] == slot)
+        {
+            continue;
+        }
+
+        _breathSlots[count] = _breathSlots[i];
+        _breathParameterIndices[count] = _breathParameterIndices[i];
+        _breathOffsets[count] = _breathOffsets[i];
+        _breathPeaks[count] = _breathPeaks[i];
+        _breathFrequencies[count] = _breathFrequencies[i];
+        _breathWeights[count] = _breathWeights[i];
+        ++count;
+    }
+
+    _breathSlots.UpdateSize(count);
+    _breathParameterIndices.UpdateSize(count);
+    _breathOffsets.UpdateSize(count);
+    _breathPeaks.UpdateSize(count);
+    _breathFrequencies.UpdateSize(count);
+    _breathWeights.UpdateSize(count);
+}
+
+void CubismEffectBatch::RemoveEyeBlinkEntries(csmInt32 slot)
+{
+    const csmInt32 entryCount = _blinkSlots.GetSize();
+    csmInt32 count = 0;
+
+    for (csmInt32 i = 0; i < entryCount; ++i)
+    {
+        if (_blinkSlots[i] == slot)
+        {
+            continue;
+        }
+
+        _blinkSlots[count] = _blinkSlots[i];
+        _blinkParameterIndices[count] = _blinkParameterIndices[i];
+        ++count;
+    }
+
+    _blinkSlots.UpdateSize(count);
+    _blinkParameterIndices.UpdateSize(count);
+}
+
+}}}
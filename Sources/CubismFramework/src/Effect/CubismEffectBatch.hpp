@@ -0,0 +1,202 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "Model/CubismModel.hpp"
+#include "Effect/CubismBreath.hpp"
+#include "Id/CubismId.hpp"
+#include "Type/csmVector.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Updates breath, eye blink and target point of many models at once
+ *
+ * Does the same work as CubismBreath, CubismEyeBlink and CubismTargetPoint, but keeps the state of all models<br>
+ * in contiguous arrays and writes the parameters through resolved indices. Each effect has its own update<br>
+ * function so that it can be called at the same point of the update order as the single-model class.
+ */
+class CubismEffectBatch
+{
+public:
+    /**
+     * Makes an instance of CubismEffectBatch.
+     *
+     * @return Made instance of CubismEffectBatch
+     */
+    static CubismEffectBatch* Create();
+
+    /**
+     * Destroys an instance of CubismEffectBatch.
+     *
+     * @param instance Instance of CubismEffectBatch to destroy
+     */
+    static void Delete(CubismEffectBatch* instance);
+
+    /**
+     * Adds a model to the batch.
+     *
+     * @param model Model whose parameters are updated
+     *
+     * @return Slot of the model; valid until RemoveModel()
+     *
+     * @note The model has no effect until breath parameters or eye blink parameters are set.
+     */
+    csmInt32 AddModel(CubismModel* model);
+
+    /**
+     * Removes a model from the batch. The slot is reused by a later AddModel().
+     *
+     * @param slot Slot returned by AddModel()
+     */
+    void RemoveModel(csmInt32 slot);
+
+    /**
+     * Returns the number of models in the batch.
+     *
+     * @return Number of models
+     */
+    csmInt32 GetModelCount() const;
+
+    /**
+     * Sets the parameters of breathing of a model.
+     *
+     * @param slot Slot of the model
+     * @param breathParameters Breath parameters, same as CubismBreath::SetParameters()
+     */
+    void SetBreathParameters(csmInt32 slot, const csmVector<CubismBreath::BreathParameterData>& breathParameters);
+
+    /**
+     * Sets the eye blink parameters of a model.
+     *
+     * @param slot Slot of the model
+     * @param parameterIds IDs of the parameters to blink
+     */
+    void SetEyeBlinkParameterIds(csmInt32 slot, const csmVector<CubismIdHandle>& parameterIds);
+
+    /**
+     * Sets the blinking interval of a model.
+     *
+     * @param slot Slot of the model
+     * @param blinkingInterval Blinking interval in seconds
+     */
+    void SetEyeBlinkInterval(csmInt32 slot, csmFloat32 blinkingInterval);
+
+    /**
+     * Sets the blinking motion settings of a model.
+     *
+     * @param slot Slot of the model
+     * @param closing Time to close the eyelids in seconds
+     * @param closed Time to keep the eyelids closed in seconds
+     * @param opening Time to open the eyelids in seconds
+     */
+    void SetEyeBlinkSettings(csmInt32 slot, csmFloat32 closing, csmFloat32 closed, csmFloat32 opening);
+
+    /**
+     * Enables or disables blinking of a model.
+     *
+     * @param slot Slot of the model
+     * @param enabled false to skip the model in UpdateEyeBlink(), as when a motion is playing
+     *
+     * @note The blinking time of a disabled model does not advance, as when CubismEyeBlink::UpdateParameters() is not called.
+     */
+    void SetEyeBlinkEnabled(csmInt32 slot, csmBool enabled);
+
+    /**
+     * Sets the target direction of a model.
+     *
+     * @param slot Slot of the model
+     * @param x Direction value along the X-axis (-1.0 to 1.0)
+     * @param y Direction value along the Y-axis (-1.0 to 1.0)
+     */
+    void SetTargetPoint(csmInt32 slot, csmFloat32 x, csmFloat32 y);
+
+    /**
+     * Returns the face direction of a model along the X-axis.
+     *
+     * @param slot Slot of the model
+     *
+     * @return Direction value of the face along the X-axis (-1.0 to 1.0)
+     */
+    csmFloat32 GetTargetPointX(csmInt32 slot) const;
+
+    /**
+     * Returns the face direction of a model along the Y-axis.
+     *
+     * @param slot Slot of the model
+     *
+     * @return Direction value of the face along the Y-axis (-1.0 to 1.0)
+     */
+    csmFloat32 GetTargetPointY(csmInt32 slot) const;
+
+    /**
+     * Updates the breath parameters of all models. Same as CubismBreath::UpdateParameters() for each model.
+     *
+     * @param deltaTimeSeconds Time step in seconds
+     */
+    void UpdateBreath(csmFloat32 deltaTimeSeconds);
+
+    /**
+     * Updates the eye blink parameters of all enabled models. Same as CubismEyeBlink::UpdateParameters() for each model.
+     *
+     * @param deltaTimeSeconds Time step in seconds
+     */
+    void UpdateEyeBlink(csmFloat32 deltaTimeSeconds);
+
+    /**
+     * Updates the face direction of all models. Same as CubismTargetPoint::Update() for each model.
+     *
+     * @param deltaTimeSeconds Time step in seconds
+     */
+    void UpdateTargetPoints(csmFloat32 deltaTimeSeconds);
+
+private:
+    CubismEffectBatch();
+
+    virtual ~CubismEffectBatch();
+
+    void RemoveBreathEntries(csmInt32 slot);
+
+    void RemoveEyeBlinkEntries(csmInt32 slot);
+
+    // モデルごとの状態。インデックスはスロット
+    csmVector<CubismModel*> _models;                    ///< Model of each slot; NULL if the slot is free
+    csmVector<csmInt32> _freeSlots;                     ///< Slots to reuse
+    csmVector<csmFloat32> _breathTimes;                 ///< Elapsed time of breathing
+    csmVector<csmInt32> _blinkStates;                   ///< CubismEyeBlink::EyeState of each slot
+    csmVector<csmFloat32> _blinkUserTimes;
+    csmVector<csmFloat32> _blinkStateStartTimes;
+    csmVector<csmFloat32> _blinkNextTimes;
+    csmVector<csmFloat32> _blinkIntervals;
+    csmVector<csmFloat32> _blinkClosingSeconds;
+    csmVector<csmFloat32> _blinkClosedSeconds;
+    csmVector<csmFloat32> _blinkOpeningSeconds;
+    csmVector<csmFloat32> _blinkValues;                 ///< Eye blink value of the current update
+    csmVector<csmBool> _isBlinkEnabled;
+    csmVector<csmFloat32> _faceTargetXs;
+    csmVector<csmFloat32> _faceTargetYs;
+    csmVector<csmFloat32> _faceXs;
+    csmVector<csmFloat32> _faceYs;
+    csmVector<csmFloat32> _faceVXs;
+    csmVector<csmFloat32> _faceVYs;
+    csmVector<csmFloat32> _targetLastTimes;
+    csmVector<csmFloat32> _targetUserTimes;
+
+    // 全モデルのパラメータを一列に並べたもの
+    csmVector<csmInt32> _breathSlots;                   ///< Slot of each breath parameter
+    csmVector<csmInt32> _breathParameterIndices;
+    csmVector<csmFloat32> _breathOffsets;
+    csmVector<csmFloat32> _breathPeaks;
+    csmVector<csmFloat32> _breathFrequencies;           ///< Reciprocal of the cycle
+    csmVector<csmFloat32> _breathWeights;
+    csmVector<csmFloat32> _breathValues;                ///< Work buffer for the phases and values; padded to a multiple of 4
+    csmVector<csmInt32> _blinkSlots;                    ///< Slot of each eye blink parameter
+    csmVector<csmInt32> _blinkParameterIndices;
+};
+
+}}}
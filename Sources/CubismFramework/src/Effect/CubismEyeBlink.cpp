@@ -41,6 +41,7 @@ CubismEyeBlink::CubismEyeBlink(ICubismModelSetting* modelSetting)
         return;
     }
 
+    _parameterIds.PrepareCapacity(modelSetting->GetEyeBlinkParameterCount());
     for (csmInt32 i = 0; i < modelSetting->GetEyeBlinkParameterCount(); ++i)
     {
         _parameterIds.PushBack(modelSetting->GetEyeBlinkParameterId(i));
@@ -0,0 +1,704 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismLipSyncAnalyzer.hpp"
+#include <math.h>
+#include <string.h>
+#include "Math/CubismMath.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSM_LIPSYNC_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSM_LIPSYNC_USE_NEON
+#endif
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+const csmFloat32 DefaultWindowTime = 0.05f;
+const csmFloat32 DefaultNoiseFloor = 0.01f;
+const csmFloat32 DefaultGain = 6.0f;
+const csmFloat32 DefaultAttackTime = 0.03f;
+const csmFloat32 DefaultReleaseTime = 0.12f;
+const csmUint32 MinimumRingCapacity = 1024;
+const csmInt32 SilenceBlockLength = 256;
+
+// フォルマント帯域の中心周波数。F1の低/高、F2の低/高に対応する
+const csmFloat32 BandCenterFrequencies[4] = { 300.0f, 700.0f, 1200.0f, 2400.0f };
+const csmFloat32 BandQuality = 1.4f;
+
+// 母音ごとの帯域の重み（大まかな推定）
+const csmFloat32 VowelBandWeights[CubismLipSyncVowel_Count][4] =
+{
+    { 0.0f, 1.0f, 0.8f, 0.0f },     // a: F1高 F2中
+    { 1.0f, 0.0f, 0.0f, 1.0f },     // i: F1低 F2高
+    { 1.0f, 0.2f, 0.6f, 0.0f },     // u: F1低 F2低
+    { 0.3f, 0.8f, 0.0f, 0.9f },     // e: F1中 F2高
+    { 0.6f, 1.0f, 0.2f, 0.0f },     // o: F1中 F2低
+};
+
+const csmFloat32 ZeroSamples[SilenceBlockLength] = { 0.0f };
+
+csmFloat32 WeightedSumOfSquares(const csmFloat32* samples, const csmFloat32* weights, csmInt32 count)
+{
+    csmInt32 i = 0;
+    csmFloat32 sum = 0.0f;
+
+#if defined(CSM_LIPSYNC_USE_SSE2)
+    __m128 accumulator = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 s = _mm_loadu_ps(samples + i);
+        accumulator = _mm_add_ps(accumulator, _mm_mul_ps(_mm_mul_ps(s, s), _mm_loadu_ps(weights + i)));
+    }
+    csmFloat32 lanes[4];
+    _mm_storeu_ps(lanes, accumulator);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(CSM_LIPSYNC_USE_NEON)
+    float32x4_t accumulator = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t s = vld1q_f32(samples + i);
+        accumulator = vmlaq_f32(accumulator, vmulq_f32(s, s), vld1q_f32(weights + i));
+    }
+    csmFloat32 lanes[4];
+    vst1q_f32(lanes, accumulator);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    for (; i < count; ++i)
+    {
+        sum += samples[i] * samples[i] * weights[i];
+    }
+
+    return sum;
+}
+
+inline csmFloat32 ToSample(csmFloat32 value)
+{
+    return value;
+}
+
+inline csmFloat32 ToSample(csmInt16 value)
+{
+    return static_cast<csmFloat32>(value) * (1.0f / 32768.0f);
+}
+
+template <typename T>
+void StoreFrames(csmFloat32* ring, csmUint32 mask, csmUint32 writeIndex, const T* samples, csmInt32 frameCount, csmInt32 channelCount)
+{
+    const csmFloat32 scale = 1.0f / static_cast<csmFloat32>(channelCount);
+
+    for (csmInt32 frame = 0; frame < frameCount; ++frame)
+    {
+        const T* source = samples + frame * channelCount;
+        csmFloat32 value = ToSample(source[0]);
+
+        for (csmInt32 channel = 1; channel < channelCount; ++channel)
+        {
+            value += ToSample(source[channel]);
+        }
+
+        ring[(writeIndex + frame) & mask] = value * scale;
+    }
+}
+
+inline csmFloat32 Smooth(csmFloat32 current, csmFloat32 target, csmFloat32 deltaTimeSeconds, csmFloat32 attackTime, csmFloat32 releaseTime)
+{
+    const csmFloat32 timeConstant = (target > current) ? attackTime : releaseTime;
+
+    if (timeConstant <= 0.0f)
+    {
+        return target;
+    }
+
+    return current + (target - current) * (1.0f - expf(-deltaTimeSeconds / timeConstant));
+}
+
+inline csmUint16 ReadUint16(const csmByte* p)
+{
+    return static_cast<csmUint16>(p[0] | (p[1] << 8));
+}
+
+inline csmUint32 ReadUint32(const csmByte* p)
+{
+    return static_cast<csmUint32>(p[0]) | (static_cast<csmUint32>(p[1]) << 8)
+         | (static_cast<csmUint32>(p[2]) << 16) | (static_cast<csmUint32>(p[3]) << 24);
+}
+}
+
+CubismLipSyncAnalyzer* CubismLipSyncAnalyzer::Create(csmFloat32 sampleRate, csmFloat32 bufferSeconds)
+{
+    return CSM_NEW CubismLipSyncAnalyzer(sampleRate, bufferSeconds);
+}
+
+void CubismLipSyncAnalyzer::Delete(CubismLipSyncAnalyzer* instance)
+{
+    CSM_DELETE_SELF(CubismLipSyncAnalyzer, instance);
+}
+
+CubismLipSyncAnalyzer::CubismLipSyncAnalyzer(csmFloat32 sampleRate, csmFloat32 bufferSeconds)
+    : _sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f)
+    , _ringBuffer(NULL)
+    , _ringMask(0)
+    , _writeIndex(0)
+    , _readIndex(0)
+    , _droppedFrameCount(0)
+    , _windowTime(DefaultWindowTime)
+    , _window(NULL)
+    , _windowWeights(NULL)
+    , _windowLength(0)
+    , _windowWeightSum(0.0f)
+    , _noiseFloor(DefaultNoiseFloor)
+    , _gain(DefaultGain)
+    , _attackTime(DefaultAttackTime)
+    , _releaseTime(DefaultReleaseTime)
+    , _isFormantAnalysisEnabled(true)
+{
+    // 添字の差で読み書きの位置を求めるため、容量は2の累乗にする
+    const csmFloat32 requested = _sampleRate * (bufferSeconds > 0.0f ? bufferSeconds : 0.0f);
+    csmUint32 capacity = MinimumRingCapacity;
+    while (static_cast<csmFloat32>(capacity) < requested && capacity < 0x40000000u)
+    {
+        capacity <<= 1;
+    }
+
+    _ringBuffer = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * capacity));
+    _ringMask = capacity - 1;
+
+    SetupWindow();
+    Reset();
+}
+
+CubismLipSyncAnalyzer::~CubismLipSyncAnalyzer()
+{
+    CSM_FREE(_ringBuffer);
+    CSM_FREE(_window);
+    CSM_FREE(_windowWeights);
+}
+
+csmInt32 CubismLipSyncAnalyzer::PushSamples(const csmFloat32* samples, csmInt32 frameCount, csmInt32 channelCount)
+{
+    if (samples == NULL || frameCount <= 0 || channelCount <= 0)
+    {
+        return 0;
+    }
+
+    const csmUint32 writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    const csmUint32 readIndex = _readIndex.load(std::memory_order_acquire);
+    const csmUint32 freeCount = (_ringMask + 1) - (writeIndex - readIndex);
+    const csmInt32 storeCount = (static_cast<csmUint32>(frameCount) > freeCount) ? static_cast<csmInt32>(freeCount) : frameCount;
+
+    if (channelCount == 1)
+    {
+        // モノラルは折り返しの前後で2回コピーするだけ
+        const csmUint32 begin = writeIndex & _ringMask;
+        const csmUint32 firstCount = (static_cast<csmUint32>(storeCount) < _ringMask + 1 - begin) ? static_cast<csmUint32>(storeCount) : _ringMask + 1 - begin;
+        memcpy(_ringBuffer + begin, samples, sizeof(csmFloat32) * firstCount);
+        memcpy(_ringBuffer, samples + firstCount, sizeof(csmFloat32) * (storeCount - firstCount));
+    }
+    else
+    {
+        StoreFrames(_ringBuffer, _ringMask, writeIndex, samples, storeCount, channelCount);
+    }
+
+    _writeIndex.store(writeIndex + storeCount, std::memory_order_release);
+
+    if (storeCount < frameCount)
+    {
+        _droppedFrameCount.fetch_add(static_cast<csmUint32>(frameCount - storeCount), std::memory_order_relaxed);
+    }
+
+    return storeCount;
+}
+
+csmInt32 CubismLipSyncAnalyzer::PushSamples(const csmInt16* samples, csmInt32 frameCount, csmInt32 channelCount)
+{
+    if (samples == NULL || frameCount <= 0 || channelCount <= 0)
+    {
+        return 0;
+    }
+
+    const csmUint32 writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    const csmUint32 readIndex = _readIndex.load(std::memory_order_acquire);
+    const csmUint32 freeCount = (_ringMask + 1) - (writeIndex - readIndex);
+    const csmInt32 storeCount = (static_cast<csmUint32>(frameCount) > freeCount) ? static_cast<csmInt32>(freeCount) : frameCount;
+
+    StoreFrames(_ringBuffer, _ringMask, writeIndex, samples, storeCount, channelCount);
+
+    _writeIndex.store(writeIndex + storeCount, std::memory_order_release);
+
+    if (storeCount < frameCount)
+    {
+        _droppedFrameCount.fetch_add(static_cast<csmUint32>(frameCount - storeCount), std::memory_order_relaxed);
+    }
+
+    return storeCount;
+}
+
+void CubismLipSyncAnalyzer::Update(csmFloat32 deltaTimeSeconds)
+{
+    if (deltaTimeSeconds < 0.0f)
+    {
+        deltaTimeSeconds = 0.0f;
+    }
+
+    // モデルの時間に合わせて消費するサンプル数を決める。端数は次の更新に繰り越す
+    _sampleDebt += deltaTimeSeconds * _sampleRate;
+    const csmInt32 dueCount = static_cast<csmInt32>(_sampleDebt);
+    _sampleDebt -= static_cast<csmFloat32>(dueCount);
+
+    const csmUint32 readIndex = _readIndex.load(std::memory_order_relaxed);
+    const csmUint32 writeIndex = _writeIndex.load(std::memory_order_acquire);
+    const csmInt32 availableCount = static_cast<csmInt32>(writeIndex - readIndex);
+
+    csmInt32 consumeCount = (availableCount < dueCount) ? availableCount : dueCount;
+
+    // 音声が先行している場合は、遅延が1ウィンドウ以内に収まるまで読み進める
+    if (availableCount - consumeCount > _windowLength)
+    {
+        consumeCount = availableCount - _windowLength;
+    }
+
+    const csmUint32 begin = readIndex & _ringMask;
+    const csmInt32 firstCount = (static_cast<csmUint32>(consumeCount) < _ringMask + 1 - begin) ? consumeCount : static_cast<csmInt32>(_ringMask + 1 - begin);
+    ProcessSamples(_ringBuffer + begin, firstCount);
+    ProcessSamples(_ringBuffer, consumeCount - firstCount);
+
+    _readIndex.store(readIndex + consumeCount, std::memory_order_release);
+
+    csmInt32 processedCount = consumeCount;
+
+    // 届く間隔の揺れは待ち、1ウィンドウ以上途切れたら無音として扱う
+    if (consumeCount < dueCount)
+    {
+        _starvedSampleCount += dueCount - consumeCount;
+
+        if (_starvedSampleCount > _windowLength)
+        {
+            ProcessSilence(dueCount - consumeCount);
+            processedCount = dueCount;
+        }
+    }
+    else
+    {
+        _starvedSampleCount = 0;
+    }
+
+    UpdateValues(deltaTimeSeconds, processedCount);
+}
+
+void CubismLipSyncAnalyzer::Reset()
+{
+    _readIndex.store(_writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+
+    memset(_window, 0, sizeof(csmFloat32) * _windowLength);
+    SetupBandFilters();
+
+    _sampleDebt = 0.0f;
+    _starvedSampleCount = 0;
+    _rms = 0.0f;
+    _mouthOpen = 0.0f;
+
+    for (csmInt32 i = 0; i < CubismLipSyncVowel_Count; ++i)
+    {
+        _vowels[i] = 0.0f;
+    }
+}
+
+csmFloat32 CubismLipSyncAnalyzer::GetMouthOpenValue() const
+{
+    return _mouthOpen;
+}
+
+csmFloat32 CubismLipSyncAnalyzer::GetVowelValue(CubismLipSyncVowel vowel) const
+{
+    if (vowel < 0 || vowel >= CubismLipSyncVowel_Count)
+    {
+        return 0.0f;
+    }
+
+    return _vowels[vowel];
+}
+
+csmFloat32 CubismLipSyncAnalyzer::GetRms() const
+{
+    return _rms;
+}
+
+csmUint32 CubismLipSyncAnalyzer::GetDroppedFrameCount() const
+{
+    return _droppedFrameCount.load(std::memory_order_relaxed);
+}
+
+void CubismLipSyncAnalyzer::SetSampleRate(csmFloat32 sampleRate)
+{
+    if (sampleRate <= 0.0f)
+    {
+        return;
+    }
+
+    _sampleRate = sampleRate;
+    SetupWindow();
+    Reset();
+}
+
+csmFloat32 CubismLipSyncAnalyzer::GetSampleRate() const
+{
+    return _sampleRate;
+}
+
+void CubismLipSyncAnalyzer::SetWindowTime(csmFloat32 seconds)
+{
+    if (seconds <= 0.0f)
+    {
+        return;
+    }
+
+    _windowTime = seconds;
+    SetupWindow();
+}
+
+void CubismLipSyncAnalyzer::SetLevelMapping(csmFloat32 noiseFloor, csmFloat32 gain)
+{
+    _noiseFloor = noiseFloor;
+    _gain = gain;
+}
+
+void CubismLipSyncAnalyzer::SetSmoothingTime(csmFloat32 attackSeconds, csmFloat32 releaseSeconds)
+{
+    _attackTime = attackSeconds;
+    _releaseTime = releaseSeconds;
+}
+
+void CubismLipSyncAnalyzer::SetFormantAnalysisEnabled(csmBool enabled)
+{
+    _isFormantAnalysisEnabled = enabled;
+}
+
+csmBool CubismLipSyncAnalyzer::DecodeWav(const csmByte* buffer, csmSizeInt size, WavData* outWav)
+{
+    if (buffer == NULL || outWav == NULL || size < 12 || memcmp(buffer, "RIFF", 4) != 0 || memcmp(buffer + 8, "WAVE", 4) != 0)
+    {
+        return false;
+    }
+
+    csmUint16 format = 0;
+    csmUint16 channelCount = 0;
+    csmUint32 sampleRate = 0;
+    csmUint16 bitsPerSample = 0;
+    const csmByte* data = NULL;
+    csmUint32 dataSize = 0;
+
+    csmSizeInt offset = 12;
+    while (offset + 8 <= size)
+    {
+        const csmByte* chunkId = buffer + offset;
+        const csmSizeInt body = offset + 8;
+        csmUint32 chunkSize = ReadUint32(buffer + offset + 4);
+
+        // 途中で切れたファイルは読める分だけ使う
+        if (chunkSize > size - body)
+        {
+            chunkSize = size - body;
+        }
+
+        if (memcmp(chunkId, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            format = ReadUint16(buffer + body);
+            channelCount = ReadUint16(buffer + body + 2);
+            sampleRate = ReadUint32(buffer + body + 4);
+            bitsPerSample = ReadUint16(buffer + body + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE はサブフォーマットの先頭2バイトが形式
+            if (format == 0xFFFE && chunkSize >= 26)
+            {
+                format = ReadUint16(buffer + body + 24);
+            }
+        }
+        else if (memcmp(chunkId, "data", 4) == 0)
+        {
+            data = buffer + body;
+            dataSize = chunkSize;
+        }
+
+        offset = body + chunkSize + (chunkSize & 1);
+    }
+
+    const csmBool isPcm = (format == 1) && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    const csmBool isFloat = (format == 3) && (bitsPerSample == 32);
+
+    if (data == NULL || channelCount == 0 || sampleRate == 0 || (!isPcm && !isFloat))
+    {
+        return false;
+    }
+
+    const csmUint32 bytesPerSample = bitsPerSample / 8;
+    const csmUint32 frameCount = dataSize / (bytesPerSample * channelCount);
+    const csmUint32 sampleCount = frameCount * channelCount;
+
+    outWav->SampleRate = sampleRate;
+    outWav->ChannelCount = channelCount;
+    outWav->Samples.Clear();
+    outWav->Samples.UpdateSize(static_cast<csmInt32>(sampleCount), 0.0f, false);
+
+    csmFloat32* samples = outWav->Samples.GetPtr();
+    for (csmUint32 i = 0; i < sampleCount; ++i)
+    {
+        const csmByte* p = data + i * bytesPerSample;
+
+        if (isFloat)
+        {
+            const csmUint32 bits = ReadUint32(p);
+            memcpy(&samples[i], &bits, sizeof(csmFloat32));
+            continue;
+        }
+
+        switch (bitsPerSample)
+        {
+        case 8:
+            samples[i] = (static_cast<csmFloat32>(p[0]) - 128.0f) * (1.0f / 128.0f);
+            break;
+        case 16:
+            samples[i] = static_cast<csmFloat32>(static_cast<csmInt16>(ReadUint16(p))) * (1.0f / 32768.0f);
+            break;
+        case 24:
+        {
+            // 上位バイトに詰めてから算術シフトで符号を広げる
+            const csmUint32 packed = (static_cast<csmUint32>(p[0]) << 8) | (static_cast<csmUint32>(p[1]) << 16) | (static_cast<csmUint32>(p[2]) << 24);
+            samples[i] = static_cast<csmFloat32>(static_cast<csmInt32>(packed) >> 8) * (1.0f / 8388608.0f);
+            break;
+        }
+        default:
+            samples[i] = static_cast<csmFloat32>(static_cast<csmInt32>(ReadUint32(p))) * (1.0f / 2147483648.0f);
+            break;
+        }
+    }
+
+    return true;
+}
+
+void CubismLipSyncAnalyzer::SetupWindow()
+{
+    CSM_FREE(_window);
+    CSM_FREE(_windowWeights);
+
+    _windowLength = static_cast<csmInt32>(_windowTime * _sampleRate + 0.5f);
+    if (_windowLength < 4)
+    {
+        _windowLength = 4;
+    }
+
+    _window = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * _windowLength));
+    _windowWeights = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * _windowLength));
+    memset(_window, 0, sizeof(csmFloat32) * _windowLength);
+
+    // 端の重みが0にならないよう、サンプルの中心でハン窓を評価する
+    _windowWeightSum = 0.0f;
+    for (csmInt32 i = 0; i < _windowLength; ++i)
+    {
+        _windowWeights[i] = 0.5f - 0.5f * cosf(2.0f * CubismMath::Pi * (static_cast<csmFloat32>(i) + 0.5f) / static_cast<csmFloat32>(_windowLength));
+        _windowWeightSum += _windowWeights[i];
+    }
+}
+
+void CubismLipSyncAnalyzer::SetupBandFilters()
+{
+    // RBJのバンドパス（ピークゲイン0dB）。b1は0、b2は-b0になる
+    for (csmInt32 band = 0; band < 4; ++band)
+    {
+        csmFloat32 frequency = BandCenterFrequencies[band];
+        if (frequency > _sampleRate * 0.45f)
+        {
+            frequency = _sampleRate * 0.45f;
+        }
+
+        const csmFloat32 omega = 2.0f * CubismMath::Pi * frequency / _sampleRate;
+        const csmFloat32 alpha = sinf(omega) / (2.0f * BandQuality);
+        const csmFloat32 a0 = 1.0f + alpha;
+
+        _bandGain[band] = alpha / a0;
+        _bandFeedback1[band] = -2.0f * cosf(omega) / a0;
+        _bandFeedback2[band] = (1.0f - alpha) / a0;
+        _bandOutput1[band] = 0.0f;
+        _bandOutput2[band] = 0.0f;
+        _bandEnergy[band] = 0.0f;
+    }
+
+    _bandInput1 = 0.0f;
+    _bandInput2 = 0.0f;
+}
+
+void CubismLipSyncAnalyzer::ProcessSamples(const csmFloat32* samples, csmInt32 count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // ウィンドウには最新のサンプルだけを残す
+    if (count >= _windowLength)
+    {
+        memcpy(_window, samples + count - _windowLength, sizeof(csmFloat32) * _windowLength);
+    }
+    else
+    {
+        memmove(_window, _window + count, sizeof(csmFloat32) * (_windowLength - count));
+        memcpy(_window + _windowLength - count, samples, sizeof(csmFloat32) * count);
+    }
+
+    if (!_isFormantAnalysisEnabled)
+    {
+        return;
+    }
+
+    // 入力は全帯域で共通なので、4つの帯域を1レジスタの各レーンで同時に計算する
+    csmFloat32 input1 = _bandInput1;
+    csmFloat32 input2 = _bandInput2;
+
+#if defined(CSM_LIPSYNC_USE_SSE2)
+    const __m128 gain = _mm_loadu_ps(_bandGain);
+    const __m128 feedback1 = _mm_loadu_ps(_bandFeedback1);
+    const __m128 feedback2 = _mm_loadu_ps(_bandFeedback2);
+    __m128 output1 = _mm_loadu_ps(_bandOutput1);
+    __m128 output2 = _mm_loadu_ps(_bandOutput2);
+    __m128 energy = _mm_loadu_ps(_bandEnergy);
+
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        const csmFloat32 input = samples[i];
+        const __m128 output = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(gain, _mm_set1_ps(input - input2)),
+                                                    _mm_mul_ps(feedback1, output1)),
+                                         _mm_mul_ps(feedback2, output2));
+        energy = _mm_add_ps(energy, _mm_mul_ps(output, output));
+        output2 = output1;
+        output1 = output;
+        input2 = input1;
+        input1 = input;
+    }
+
+    _mm_storeu_ps(_bandOutput1, output1);
+    _mm_storeu_ps(_bandOutput2, output2);
+    _mm_storeu_ps(_bandEnergy, energy);
+#elif defined(CSM_LIPSYNC_USE_NEON)
+    const float32x4_t gain = vld1q_f32(_bandGain);
+    const float32x4_t feedback1 = vld1q_f32(_bandFeedback1);
+    const float32x4_t feedback2 = vld1q_f32(_bandFeedback2);
+    float32x4_t output1 = vld1q_f32(_bandOutput1);
+    float32x4_t output2 = vld1q_f32(_bandOutput2);
+    float32x4_t energy = vld1q_f32(_bandEnergy);
+
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        const csmFloat32 input = samples[i];
+        const float32x4_t output = vmlsq_f32(vmlsq_f32(vmulq_n_f32(gain, input - input2), feedback1, output1), feedback2, output2);
+        energy = vmlaq_f32(energy, output, output);
+        output2 = output1;
+        output1 = output;
+        input2 = input1;
+        input1 = input;
+    }
+
+    vst1q_f32(_bandOutput1, output1);
+    vst1q_f32(_bandOutput2, output2);
+    vst1q_f32(_bandEnergy, energy);
+#else
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        const csmFloat32 input = samples[i];
+
+        for (csmInt32 band = 0; band < 4; ++band)
+        {
+            const csmFloat32 output = _bandGain[band] * (input - input2) - _bandFeedback1[band] * _bandOutput1[band] - _bandFeedback2[band] * _bandOutput2[band];
+            _bandEnergy[band] += output * output;
+            _bandOutput2[band] = _bandOutput1[band];
+            _bandOutput1[band] = output;
+        }
+
+        input2 = input1;
+        input1 = input;
+    }
+#endif
+
+    _bandInput1 = input1;
+    _bandInput2 = input2;
+}
+
+void CubismLipSyncAnalyzer::ProcessSilence(csmInt32 count)
+{
+    while (count > 0)
+    {
+        const csmInt32 blockLength = (count < SilenceBlockLength) ? count : SilenceBlockLength;
+        ProcessSamples(ZeroSamples, blockLength);
+        count -= blockLength;
+    }
+}
+
+void CubismLipSyncAnalyzer::UpdateValues(csmFloat32 deltaTimeSeconds, csmInt32 processedCount)
+{
+    _rms = sqrtf(WeightedSumOfSquares(_window, _windowWeights, _windowLength) / _windowWeightSum);
+
+    const csmFloat32 targetOpen = CubismMath::RangeF((_rms - _noiseFloor) * _gain, 0.0f, 1.0f);
+    _mouthOpen = Smooth(_mouthOpen, targetOpen, deltaTimeSeconds, _attackTime, _releaseTime);
+
+    if (!_isFormantAnalysisEnabled)
+    {
+        for (csmInt32 i = 0; i < CubismLipSyncVowel_Count; ++i)
+        {
+            _vowels[i] = 0.0f;
+        }
+        return;
+    }
+
+    // 新しいサンプルがなければ帯域のエネルギーは変わらない
+    if (processedCount <= 0)
+    {
+        return;
+    }
+
+    csmFloat32 totalEnergy = 0.0f;
+    for (csmInt32 band = 0; band < 4; ++band)
+    {
+        totalEnergy += _bandEnergy[band];
+    }
+
+    csmFloat32 scores[CubismLipSyncVowel_Count];
+    csmFloat32 scoreSum = 0.0f;
+
+    for (csmInt32 i = 0; i < CubismLipSyncVowel_Count; ++i)
+    {
+        csmFloat32 score = 0.0f;
+
+        if (totalEnergy > 0.0f)
+        {
+            for (csmInt32 band = 0; band < 4; ++band)
+            {
+                score += VowelBandWeights[i][band] * _bandEnergy[band];
+            }
+            score /= totalEnergy;
+        }
+
+        // 二乗して最も近い母音を際立たせる
+        scores[i] = score * score;
+        scoreSum += scores[i];
+    }
+
+    for (csmInt32 i = 0; i < CubismLipSyncVowel_Count; ++i)
+    {
+        const csmFloat32 target = (scoreSum > 0.0f) ? targetOpen * scores[i] / scoreSum : 0.0f;
+        _vowels[i] = Smooth(_vowels[i], target, deltaTimeSeconds, _attackTime, _releaseTime);
+    }
+
+    for (csmInt32 band = 0; band < 4; ++band)
+    {
+        _bandEnergy[band] = 0.0f;
+    }
+}
+
+}}}
@@ -0,0 +1,258 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+#include <atomic>
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Vowels estimated by CubismLipSyncAnalyzer
+ */
+enum CubismLipSyncVowel
+{
+    CubismLipSyncVowel_A = 0,   ///< "a"
+    CubismLipSyncVowel_I,       ///< "i"
+    CubismLipSyncVowel_U,       ///< "u"
+    CubismLipSyncVowel_E,       ///< "e"
+    CubismLipSyncVowel_O,       ///< "o"
+    CubismLipSyncVowel_Count    ///< Number of vowels
+};
+
+/**
+ * Computes lip sync values from streaming PCM audio.
+ *
+ * @note Samples are pushed from the audio thread into a lock-free single-producer ring buffer,<br>
+ *       and consumed by Update() on the thread that updates the model, at the pace of the model clock.<br>
+ *       The mouth opening comes from the windowed RMS, and the vowels from the energies of four formant bands.
+ */
+class CubismLipSyncAnalyzer
+{
+public:
+    /**
+     * Decoded WAV file
+     */
+    struct WavData
+    {
+        WavData()
+            : SampleRate(0)
+            , ChannelCount(0)
+        { }
+
+        csmUint32 SampleRate;               ///< Sample rate in Hz
+        csmInt32 ChannelCount;              ///< Number of channels
+        csmVector<csmFloat32> Samples;      ///< Interleaved samples in [-1, 1]
+    };
+
+    /**
+     * Makes an instance of CubismLipSyncAnalyzer.
+     *
+     * @param sampleRate sample rate of the pushed samples in Hz
+     * @param bufferSeconds length of audio the ring buffer can hold, in seconds
+     *
+     * @return Made instance of CubismLipSyncAnalyzer
+     */
+    static CubismLipSyncAnalyzer* Create(csmFloat32 sampleRate, csmFloat32 bufferSeconds = 0.5f);
+
+    /**
+     * Destroys an instance of CubismLipSyncAnalyzer.
+     *
+     * @param instance Instance of CubismLipSyncAnalyzer to destroy
+     *
+     * @note The audio thread must have stopped pushing samples.
+     */
+    static void Delete(CubismLipSyncAnalyzer* instance);
+
+    /**
+     * Pushes samples. Can be called from the audio thread.
+     *
+     * @param samples interleaved samples in [-1, 1]
+     * @param frameCount number of frames
+     * @param channelCount number of channels; channels are mixed down to mono
+     *
+     * @return number of frames stored; the rest is dropped when the buffer is full
+     */
+    csmInt32 PushSamples(const csmFloat32* samples, csmInt32 frameCount, csmInt32 channelCount);
+
+    /**
+     * Pushes 16-bit samples. Can be called from the audio thread.
+     *
+     * @param samples interleaved 16-bit samples
+     * @param frameCount number of frames
+     * @param channelCount number of channels; channels are mixed down to mono
+     *
+     * @return number of frames stored; the rest is dropped when the buffer is full
+     */
+    csmInt32 PushSamples(const csmInt16* samples, csmInt32 frameCount, csmInt32 channelCount);
+
+    /**
+     * Consumes the samples for the elapsed time and updates the values.
+     *
+     * @param deltaTimeSeconds elapsed time in seconds
+     *
+     * @note When the audio runs ahead of the model clock, the backlog is consumed down to one window.<br>
+     *       When no audio arrives for longer than one window, the stream is treated as silence.
+     */
+    void Update(csmFloat32 deltaTimeSeconds);
+
+    /**
+     * Discards the buffered samples and clears the values.
+     *
+     * @note Call from the thread that calls Update().
+     */
+    void Reset();
+
+    /**
+     * Returns the smoothed opening of the mouth.
+     *
+     * @return value in [0, 1]
+     */
+    csmFloat32 GetMouthOpenValue() const;
+
+    /**
+     * Returns the smoothed weight of a vowel.
+     *
+     * @param vowel vowel
+     *
+     * @return value in [0, 1], scaled by the opening of the mouth; 0 when the formant analysis is disabled
+     */
+    csmFloat32 GetVowelValue(CubismLipSyncVowel vowel) const;
+
+    /**
+     * Returns the windowed RMS of the latest update, before smoothing.
+     *
+     * @return RMS
+     */
+    csmFloat32 GetRms() const;
+
+    /**
+     * Returns the number of frames dropped because the buffer was full.
+     *
+     * @return number of frames
+     */
+    csmUint32 GetDroppedFrameCount() const;
+
+    /**
+     * Sets the sample rate of the pushed samples and resets the analyzer.
+     *
+     * @param sampleRate sample rate in Hz
+     *
+     * @note Call from the thread that calls Update().
+     */
+    void SetSampleRate(csmFloat32 sampleRate);
+
+    /**
+     * Returns the sample rate.
+     *
+     * @return sample rate in Hz
+     */
+    csmFloat32 GetSampleRate() const;
+
+    /**
+     * Sets the length of the RMS window.
+     *
+     * @param seconds length in seconds; the default is 0.05 seconds
+     *
+     * @note Call from the thread that calls Update().
+     */
+    void SetWindowTime(csmFloat32 seconds);
+
+    /**
+     * Sets the mapping from RMS to the opening of the mouth.
+     *
+     * @param noiseFloor RMS below which the mouth is closed
+     * @param gain scale applied to the RMS above the noise floor
+     */
+    void SetLevelMapping(csmFloat32 noiseFloor, csmFloat32 gain);
+
+    /**
+     * Sets the smoothing time constants.
+     *
+     * @param attackSeconds time constant while the value rises
+     * @param releaseSeconds time constant while the value falls
+     */
+    void SetSmoothingTime(csmFloat32 attackSeconds, csmFloat32 releaseSeconds);
+
+    /**
+     * Enables or disables the formant analysis.
+     *
+     * @param enabled true to estimate the vowels
+     */
+    void SetFormantAnalysisEnabled(csmBool enabled);
+
+    /**
+     * Decodes a WAV file for offline analysis.
+     *
+     * @param buffer buffer containing the WAV file
+     * @param size size of the buffer in bytes
+     * @param outWav decoded samples
+     *
+     * @return true if decoded
+     *
+     * @note Supports 8, 16, 24 and 32-bit integer PCM and 32-bit float PCM.
+     */
+    static csmBool DecodeWav(const csmByte* buffer, csmSizeInt size, WavData* outWav);
+
+private:
+    CubismLipSyncAnalyzer(csmFloat32 sampleRate, csmFloat32 bufferSeconds);
+
+    virtual ~CubismLipSyncAnalyzer();
+
+    CubismLipSyncAnalyzer(const CubismLipSyncAnalyzer&);
+    CubismLipSyncAnalyzer& operator=(const CubismLipSyncAnalyzer&);
+
+    void SetupWindow();
+
+    void SetupBandFilters();
+
+    void ProcessSamples(const csmFloat32* samples, csmInt32 count);
+
+    void ProcessSilence(csmInt32 count);
+
+    void UpdateValues(csmFloat32 deltaTimeSeconds, csmInt32 processedCount);
+
+    csmFloat32 _sampleRate;
+
+    csmFloat32* _ringBuffer;                    ///< Mono samples written by the audio thread
+    csmUint32 _ringMask;                        ///< Capacity of the ring buffer minus one; the capacity is a power of two
+    std::atomic<csmUint32> _writeIndex;         ///< Written by the producer only
+    std::atomic<csmUint32> _readIndex;          ///< Written by the consumer only
+    std::atomic<csmUint32> _droppedFrameCount;
+
+    csmFloat32 _windowTime;
+    csmFloat32* _window;                        ///< Latest samples, oldest first
+    csmFloat32* _windowWeights;                 ///< Hann window
+    csmInt32 _windowLength;
+    csmFloat32 _windowWeightSum;
+
+    csmFloat32 _sampleDebt;                     ///< Fraction of a sample carried to the next update
+    csmInt32 _starvedSampleCount;               ///< Samples missed in a row
+
+    csmFloat32 _bandGain[4];                    ///< Band-pass coefficients, one band per lane
+    csmFloat32 _bandFeedback1[4];
+    csmFloat32 _bandFeedback2[4];
+    csmFloat32 _bandOutput1[4];                 ///< Filter state
+    csmFloat32 _bandOutput2[4];
+    csmFloat32 _bandInput1;
+    csmFloat32 _bandInput2;
+    csmFloat32 _bandEnergy[4];                  ///< Energy accumulated since the last update
+
+    csmFloat32 _noiseFloor;
+    csmFloat32 _gain;
+    csmFloat32 _attackTime;
+    csmFloat32 _releaseTime;
+    csmBool _isFormantAnalysisEnabled;
+
+    csmFloat32 _rms;
+    csmFloat32 _mouthOpen;
+    csmFloat32 _vowels[CubismLipSyncVowel_Count];
+};
+
+}}}
@@ -7,6 +7,7 @@
 
 #include "CubismPose.hpp"
 #include "Id/CubismIdManager.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 using namespace Live2D::Cubism::Framework;
 
@@ -21,6 +22,29 @@ const csmChar*   FadeIn = "FadeInTime";
 const csmChar*   Link   = "Link";
 const csmChar*   Groups = "Groups";
 const csmChar*   Id     = "Id";
+
+// モデルにないパーツやパラメータだけ、モデルの非存在リストを経由する
+inline csmFloat32 GetPartOpacityValue(CubismModel* model, const csmFloat32* partOpacities, csmInt32 partCount, csmInt32 partIndex)
+{
+    return (0 <= partIndex && partIndex < partCount) ? partOpacities[partIndex] : model->GetPartOpacity(partIndex);
+}
+
+inline void SetPartOpacityValue(CubismModel* model, csmFloat32* partOpacities, csmInt32 partCount, csmInt32 partIndex, csmFloat32 opacity)
+{
+    if (0 <= partIndex && partIndex < partCount)
+    {
+        partOpacities[partIndex] = opacity;
+    }
+    else
+    {
+        model->SetPartOpacity(partIndex, opacity);
+    }
+}
+
+inline csmFloat32 GetParameterValue(CubismModel* model, const csmFloat32* parameterValues, csmInt32 parameterCount, csmInt32 parameterIndex)
+{
+    return (0 <= parameterIndex && parameterIndex < parameterCount) ? parameterValues[parameterIndex] : model->GetParameterValue(parameterIndex);
+}
 }
 
 CubismPose::PartData::PartData()
@@ -63,6 +87,8 @@ void CubismPose::PartData::Initialize(CubismModel* model)
 
 CubismPose::CubismPose() : _fadeTimeSeconds(DefaultFadeInSeconds)
                          , _lastModel(NULL)
+                         , _modelPartCount(0)
+                         , _modelParameterCount(0)
 { }
 
 CubismPose::~CubismPose()
@@ -92,6 +118,7 @@ CubismPose* CubismPose::Create(const csmByte* pose3json, csmSizeInt size)
     // パーツグループ
     Utils::Value&      poseListInfo = root[Groups];
     const csmInt32     poseCount = poseListInfo.GetSize();
+    ret->_partGroupCounts.PrepareCapacity(poseCount);
 
     for (csmInt32 poseIndex = 0; poseIndex < poseCount; ++poseIndex)
     {
@@ -112,6 +139,7 @@ CubismPose* CubismPose::Create(const csmByte* pose3json, csmSizeInt size)
             {
                 Utils::Value&   linkListInfo = partInfo[Link];
                 const csmInt32        linkCount = linkListInfo.GetSize();
+                partData.Link.PrepareCapacity(linkCount);
 
                 for (csmInt32 linkIndex = 0; linkIndex < linkCount; ++linkIndex)
                 {
@@ -176,39 +204,95 @@ void CubismPose::Reset(CubismModel* model)
 
     }
 
+    BuildIndexTables(model);
 }
 
-void CubismPose::CopyPartOpacities(CubismModel* model)
+void CubismPose::BuildIndexTables(CubismModel* model)
 {
-    for (csmUint32 groupIndex = 0; groupIndex < _partGroups.GetSize(); ++groupIndex)
+    _modelPartCount = model->GetPartCount();
+    _modelParameterCount = model->GetParameterCount();
+
+    _groupBeginIndices.Clear();
+    _partIndices.Clear();
+    _parameterIndices.Clear();
+    _linkSourceIndices.Clear();
+    _linkPartIndices.Clear();
+    _lastParameterValues.Clear();
+    _lastPartOpacities.Clear();
+    _isGroupSettled.Clear();
+
+    csmInt32 beginIndex = 0;
+
+    for (csmUint32 i = 0; i < _partGroupCounts.GetSize(); ++i)
+    {
+        _groupBeginIndices.PushBack(beginIndex);
+        _isGroupSettled.PushBack(false);
+        beginIndex += _partGroupCounts[i];
+    }
+
+    _groupBeginIndices.PushBack(beginIndex);
+
+    for (csmUint32 i = 0; i < _partGroups.GetSize(); ++i)
     {
-        PartData& partData = _partGroups[groupIndex];
+        const PartData& partData = _partGroups[i];
 
-        if (partData.Link.GetSize() == 0)
+        _partIndices.PushBack(partData.PartIndex);
+        _parameterIndices.PushBack(partData.ParameterIndex);
+        _lastParameterValues.PushBack(0.0f);
+        _lastPartOpacities.PushBack(0.0f);
+
+        if (partData.PartIndex < 0)
         {
-            continue; // 連動するパラメータはない
+            continue; // リンクは初期化されていない
         }
 
-        const csmInt32    partIndex = _partGroups[groupIndex].PartIndex;
-        const csmFloat32  opacity = model->GetPartOpacity(partIndex);
-
         for (csmUint32 linkIndex = 0; linkIndex < partData.Link.GetSize(); ++linkIndex)
         {
-            PartData&   linkPart = partData.Link[linkIndex];
-            const csmInt32    linkPartIndex = linkPart.PartIndex;
-
-            if (linkPartIndex < 0)
+            if (partData.Link[linkIndex].PartIndex < 0)
             {
                 continue;
             }
 
-            model->SetPartOpacity(linkPartIndex, opacity);
+            _linkSourceIndices.PushBack(static_cast<csmInt32>(i));
+            _linkPartIndices.PushBack(partData.Link[linkIndex].PartIndex);
         }
     }
 }
 
-void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt32 beginIndex, csmInt32 partGroupCount)
+void CubismPose::CopyPartOpacities(CubismModel* model, csmFloat32* partOpacities)
+{
+    // 連動するパーツはグループの計算結果をそのまま写す
+    for (csmUint32 i = 0; i < _linkPartIndices.GetSize(); ++i)
+    {
+        SetPartOpacityValue(model, partOpacities, _modelPartCount, _linkPartIndices[i], _lastPartOpacities[_linkSourceIndices[i]]);
+    }
+}
+
+void CubismPose::DoFade(CubismModel* model, csmFloat32* partOpacities, const csmFloat32* parameterValues, csmFloat32 deltaTimeSeconds, csmInt32 groupIndex)
 {
+    const csmInt32 beginIndex = _groupBeginIndices[groupIndex];
+    const csmInt32 endIndex = _groupBeginIndices[groupIndex + 1];
+
+    // 前回フェードが終わっていて、パラメータも不透明度も変わっていなければ結果も同じ
+    if (_isGroupSettled[groupIndex])
+    {
+        csmInt32 i = beginIndex;
+
+        for (; i < endIndex; ++i)
+        {
+            if (GetParameterValue(model, parameterValues, _modelParameterCount, _parameterIndices[i]) != _lastParameterValues[i]
+                || GetPartOpacityValue(model, partOpacities, _modelPartCount, _partIndices[i]) != _lastPartOpacities[i])
+            {
+                break;
+            }
+        }
+
+        if (i == endIndex)
+        {
+            return;
+        }
+    }
+
     csmInt32    visiblePartIndex = -1;
     csmFloat32  newOpacity = 1.0f;
 
@@ -216,34 +300,32 @@ void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt3
     const csmFloat32 BackOpacityThreshold = 0.15f;
 
     // 現在、表示状態になっているパーツを取得
-    for (csmInt32 i = beginIndex; i < beginIndex + partGroupCount; ++i)
+    for (csmInt32 i = beginIndex; i < endIndex; ++i)
     {
-        const csmInt32 partIndex = _partGroups[i].PartIndex;
-        const csmInt32 paramIndex = _partGroups[i].ParameterIndex;
+        const csmFloat32 parameterValue = GetParameterValue(model, parameterValues, _modelParameterCount, _parameterIndices[i]);
+        _lastParameterValues[i] = parameterValue;
 
-        if (model->GetParameterValue(paramIndex) > Epsilon)
+        // 2つ目以降の表示パーツは無視する
+        if (parameterValue <= Epsilon || visiblePartIndex >= 0)
         {
-            if (visiblePartIndex >= 0)
-            {
-                break;
-            }
+            continue;
+        }
 
-            visiblePartIndex = i;
-            if (_fadeTimeSeconds == 0.0f)
-            {
-                newOpacity = 1.0f;
-                continue;
-            }
+        visiblePartIndex = i;
+        if (_fadeTimeSeconds == 0.0f)
+        {
+            newOpacity = 1.0f;
+            continue;
+        }
 
-            newOpacity = model->GetPartOpacity(partIndex);
+        newOpacity = GetPartOpacityValue(model, partOpacities, _modelPartCount, _partIndices[i]);
 
-            // 新しい不透明度を計算
-            newOpacity += (deltaTimeSeconds / _fadeTimeSeconds);
+        // 新しい不透明度を計算
+        newOpacity += (deltaTimeSeconds / _fadeTimeSeconds);
 
-            if (newOpacity > 1.0f)
-            {
-                newOpacity = 1.0f;
-            }
+        if (newOpacity > 1.0f)
+        {
+            newOpacity = 1.0f;
         }
     }
 
@@ -253,51 +335,52 @@ void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt3
         newOpacity = 1.0f;
     }
 
-    //  表示パーツ、非表示パーツの不透明度を設定する
-    for (csmInt32 i = beginIndex; i < beginIndex + partGroupCount; ++i)
+    // 非表示パーツの不透明度の上限はグループで共通
+    csmFloat32 a1;          // 計算によって求められる不透明度
+
+    if (newOpacity < Phi)
+    {
+        a1 = newOpacity * (Phi - 1) / Phi + 1.0f; // (0,1),(phi,phi)を通る直線式
+    }
+    else
     {
-        const csmInt32 partsIndex = _partGroups[i].PartIndex;
+        a1 = (1 - newOpacity) * Phi / (1.0f - Phi); // (1,0),(phi,phi)を通る直線式
+    }
 
-        //  表示パーツの設定
-        if (visiblePartIndex == i)
-        {
-            model->SetPartOpacity(partsIndex, newOpacity); // 先に設定
-        }
-        // 非表示パーツの設定
-        else
-        {
-            csmFloat32 opacity = model->GetPartOpacity(partsIndex);
-            csmFloat32 a1;          // 計算によって求められる不透明度
+    // 背景の見える割合を制限する場合
+    const csmFloat32 backOpacity = (1.0f - a1) * (1.0f - newOpacity);
 
-            if (newOpacity < Phi)
-            {
-                a1 = newOpacity * (Phi - 1) / Phi + 1.0f; // (0,1),(phi,phi)を通る直線式
-            }
-            else
-            {
-                a1 = (1 - newOpacity) * Phi / (1.0f - Phi); // (1,0),(phi,phi)を通る直線式
-            }
+    if (backOpacity > BackOpacityThreshold)
+    {
+        a1 = 1.0f - BackOpacityThreshold / (1.0f - newOpacity);
+    }
 
-            // 背景の見える割合を制限する場合
-            const csmFloat32 backOpacity = (1.0f - a1) * (1.0f - newOpacity);
+    //  表示パーツ、非表示パーツの不透明度を設定する
+    csmBool isSettled = (newOpacity >= 1.0f);
 
-            if (backOpacity > BackOpacityThreshold)
-            {
-                a1 = 1.0f - BackOpacityThreshold / (1.0f - newOpacity);
-            }
+    for (csmInt32 i = beginIndex; i < endIndex; ++i)
+    {
+        const csmFloat32 opacity = GetPartOpacityValue(model, partOpacities, _modelPartCount, _partIndices[i]);
 
-            if (opacity > a1)
-            {
-                opacity = a1; // 計算の不透明度よりも大きければ（濃ければ）不透明度を上げる
-            }
+        // 表示パーツは新しい値、非表示パーツは計算の不透明度よりも大きければ（濃ければ）下げる
+        const csmFloat32 result = (i == visiblePartIndex) ? newOpacity : (opacity > a1 ? a1 : opacity);
 
-            model->SetPartOpacity(partsIndex, opacity);
+        if (result != opacity)
+        {
+            SetPartOpacityValue(model, partOpacities, _modelPartCount, _partIndices[i], result);
+            isSettled = false;
         }
+
+        _lastPartOpacities[i] = result;
     }
+
+    _isGroupSettled[groupIndex] = isSettled;
 }
 
 void CubismPose::UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSeconds)
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_Pose);
+
     // 前回のモデルと同じではないときは初期化が必要
     if (model != _lastModel)
     {
@@ -313,18 +396,16 @@ void CubismPose::UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSecond
         deltaTimeSeconds = 0.0f;
     }
 
-    csmInt32 beginIndex = 0;
+    // パーツとパラメータはコアの配列を直接読み書きする
+    csmFloat32* partOpacities = Core::csmGetPartOpacities(model->GetModel());
+    const csmFloat32* parameterValues = Core::csmGetParameterValues(model->GetModel());
 
-    for (csmUint32 i = 0; i < _partGroupCounts.GetSize(); i++)
+    for (csmUint32 i = 0; i < _partGroupCounts.GetSize(); ++i)
     {
-        const csmInt32 partGroupCount = _partGroupCounts[i];
-
-        DoFade(model, deltaTimeSeconds, beginIndex, partGroupCount);
-
-        beginIndex += partGroupCount;
+        DoFade(model, partOpacities, parameterValues, deltaTimeSeconds, static_cast<csmInt32>(i));
     }
 
-    CopyPartOpacities(model);
+    CopyPartOpacities(model, partOpacities);
 }
 
 }}}
@@ -94,14 +94,30 @@ private:
 
     virtual ~CubismPose();
 
-    void                CopyPartOpacities(CubismModel* model);
+    void                BuildIndexTables(CubismModel* model);
 
-    void                DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt32 beginIndex, csmInt32 partGroupCount);
+    void                CopyPartOpacities(CubismModel* model, csmFloat32* partOpacities);
+
+    void                DoFade(CubismModel* model, csmFloat32* partOpacities, const csmFloat32* parameterValues, csmFloat32 deltaTimeSeconds, csmInt32 groupIndex);
 
     csmVector<PartData>             _partGroups;
     csmVector<csmInt32>             _partGroupCounts;
     csmFloat32                      _fadeTimeSeconds;
     CubismModel*                    _lastModel;
+
+    // Reset() で作る平坦な索引表。要素の並びは _partGroups と同じ
+    csmVector<csmInt32>             _groupBeginIndices;         ///< Index of the first part of each group, plus the total count at the end
+    csmVector<csmInt32>             _partIndices;               ///< Part index of each part
+    csmVector<csmInt32>             _parameterIndices;          ///< Parameter index of each part
+    csmVector<csmInt32>             _linkSourceIndices;         ///< Part of _partIndices whose opacity each link copies
+    csmVector<csmInt32>             _linkPartIndices;           ///< Part index of each link
+    csmInt32                        _modelPartCount;            ///< Indices from here on are parts missing from the model
+    csmInt32                        _modelParameterCount;       ///< Indices from here on are parameters missing from the model
+
+    // 前回の結果。入力が変わらず、フェードも終わっているグループは計算を省く
+    csmVector<csmFloat32>           _lastParameterValues;
+    csmVector<csmFloat32>           _lastPartOpacities;
+    csmVector<csmBool>              _isGroupSettled;
 };
 
 }}}
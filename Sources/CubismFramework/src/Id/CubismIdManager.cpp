@@ -7,6 +7,7 @@
 
 #include "CubismIdManager.hpp"
 #include "CubismId.hpp"
+#include "Utils/CubismMemoryTracker.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -53,6 +54,7 @@ csmBool CubismIdManager::IsExist(const csmString& id) const
 }
 csmBool CubismIdManager::IsExist(const csmChar* id) const
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     return (FindId(id) != NULL);
 }
 
@@ -60,11 +62,15 @@ const CubismId* CubismIdManager::RegisterId(const csmChar* id)
 {
     CubismId* result = NULL;
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     if ((result = FindId(id)) != NULL)
     {
         return result;
     }
 
+    // IDは全モデルで共有するので、読み込み中のモデルには計上しない
+    CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
     result = CSM_NEW CubismId(id);
     _ids.PushBack(result);
 
@@ -78,9 +84,12 @@ const CubismId* CubismIdManager::RegisterId(const csmString& id)
 
 CubismId* CubismIdManager::FindId(const csmChar* id) const
 {
+    // キーのハッシュ値は一度だけ計算し、登録済みのIDのハッシュ値と比べて異なるものを先に除外する
+    const csmStringView key(id);
+
     for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
     {
-        if (_ids[i]->GetString() == id)
+        if (_ids[i]->GetString() == key)
         {
             return _ids[i];
         }
@@ -10,6 +10,7 @@
 #include "Type/CubismBasicType.hpp"
 #include "Type/csmString.hpp"
 #include "Type/csmVector.hpp"
+#include <mutex>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -17,6 +18,8 @@ struct CubismId;
 
 /**
  * Handles ID names.
+ *
+ * @note All methods are thread-safe so that motions and expressions can be parsed on background threads.
  */
 class CubismIdManager
 {
@@ -112,6 +115,7 @@ private:
     CubismId* FindId(const csmChar* id) const;
 
     csmVector<CubismId*> _ids;
+    mutable std::mutex _mutex;      ///< Guards the registered IDs
 };
 
 }}}
@@ -8,11 +8,158 @@
 #include "CubismMath.hpp"
 #include "Utils/CubismDebug.hpp"
 
+// テーブル版の三角関数は結果がCPUやコンパイラに依存しないよう、積和演算の融合を禁止する（GCCはCMakeLists.txtで-ffp-contract=offを指定する）
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
 namespace Live2D {namespace Cubism {namespace Framework {
 
 const csmFloat32 CubismMath::Pi = 3.1415926535897932384626433832795f;
 const csmFloat32 CubismMath::Epsilon = 0.00001f;
 
+namespace {
+
+/// Number of table steps in a quarter turn.
+const csmInt32 TrigTableQuarterSize = 256;
+
+/// Number of table steps in a full turn.
+const csmInt32 TrigTableFullSize = TrigTableQuarterSize * 4;
+
+/// Table steps per radian.
+const csmFloat32 TrigTableStepsPerRadian = 162.974655f;
+
+/// Half of Pi.
+const csmFloat32 HalfPi = 1.57079637f;
+
+/// sin(i * (Pi / 2) / TrigTableQuarterSize)
+const csmFloat32 SinTable[TrigTableQuarterSize + 1] =
+{
+    0.0f, 0.00613588467f, 0.0122715384f, 0.0184067301f, 0.024541229f, 0.030674804f, 0.0368072242f, 0.0429382585f,
+    0.0490676761f, 0.0551952459f, 0.061320737f, 0.0674439222f, 0.0735645667f, 0.0796824396f, 0.0857973099f, 0.0919089541f,
+    0.0980171412f, 0.104121633f, 0.110222206f, 0.116318628f, 0.122410677f, 0.128498107f, 0.134580702f, 0.140658244f,
+    0.146730468f, 0.152797192f, 0.15885815f, 0.164913118f, 0.170961887f, 0.177004218f, 0.183039889f, 0.18906866f,
+    0.195090324f, 0.201104641f, 0.207111374f, 0.213110313f, 0.219101235f, 0.225083917f, 0.231058106f, 0.237023607f,
+    0.242980182f, 0.248927608f, 0.254865646f, 0.260794103f, 0.266712755f, 0.272621363f, 0.27851969f, 0.284407526f,
+    0.290284663f, 0.296150893f, 0.302005947f, 0.307849646f, 0.313681751f, 0.319502026f, 0.32531029f, 0.331106305f,
+    0.336889863f, 0.342660725f, 0.348418683f, 0.354163527f, 0.359895051f, 0.365612984f, 0.371317208f, 0.377007425f,
+    0.382683426f, 0.388345033f, 0.393992037f, 0.399624199f, 0.405241311f, 0.410843164f, 0.416429549f, 0.422000259f,
+    0.427555084f, 0.433093816f, 0.438616246f, 0.444122136f, 0.449611336f, 0.455083579f, 0.460538715f, 0.465976506f,
+    0.471396744f, 0.47679922f, 0.482183784f, 0.487550169f, 0.492898196f, 0.498227656f, 0.50353837f, 0.50883013f,
+    0.514102757f, 0.519356012f, 0.524589658f, 0.529803634f, 0.534997642f, 0.540171444f, 0.545324981f, 0.550457954f,
+    0.555570245f, 0.560661554f, 0.565731823f, 0.570780754f, 0.575808167f, 0.580813944f, 0.585797846f, 0.590759695f,
+    0.59569931f, 0.600616455f, 0.605511069f, 0.610382795f, 0.615231574f, 0.620057225f, 0.624859512f, 0.629638255f,
+    0.634393275f, 0.639124453f, 0.643831551f, 0.64851439f, 0.653172851f, 0.657806695f, 0.662415802f, 0.666999936f,
+    0.671558976f, 0.676092684f, 0.680601001f, 0.685083687f, 0.689540565f, 0.693971455f, 0.698376238f, 0.702754736f,
+    0.707106769f, 0.711432219f, 0.715730846f, 0.720002532f, 0.724247098f, 0.728464365f, 0.732654274f, 0.736816585f,
+    0.740951121f, 0.745057762f, 0.749136388f, 0.753186822f, 0.757208824f, 0.761202395f, 0.765167236f, 0.769103348f,
+    0.773010433f, 0.77688849f, 0.780737221f, 0.784556568f, 0.78834641f, 0.792106569f, 0.795836926f, 0.799537241f,
+    0.803207517f, 0.806847572f, 0.81045717f, 0.81403631f, 0.817584813f, 0.8211025f, 0.824589312f, 0.82804507f,
+    0.831469595f, 0.834862888f, 0.838224709f, 0.841554999f, 0.84485358f, 0.848120332f, 0.851355195f, 0.854557991f,
+    0.857728601f, 0.860866964f, 0.863972843f, 0.867046237f, 0.870086968f, 0.873094976f, 0.876070082f, 0.879012227f,
+    0.881921291f, 0.884797096f, 0.887639642f, 0.890448749f, 0.893224299f, 0.895966232f, 0.898674488f, 0.901348829f,
+    0.903989315f, 0.906595707f, 0.909168005f, 0.91170603f, 0.914209783f, 0.916679084f, 0.919113874f, 0.921514034f,
+    0.923879504f, 0.926210225f, 0.928506076f, 0.93076694f, 0.932992816f, 0.935183525f, 0.937339008f, 0.939459205f,
+    0.941544056f, 0.943593442f, 0.945607305f, 0.947585583f, 0.949528158f, 0.95143503f, 0.953306019f, 0.955141187f,
+    0.956940353f, 0.958703458f, 0.960430503f, 0.962121427f, 0.963776052f, 0.965394437f, 0.966976464f, 0.968522072f,
+    0.970031261f, 0.971503913f, 0.972939968f, 0.974339366f, 0.975702107f, 0.977028131f, 0.97831738f, 0.979569793f,
+    0.980785251f, 0.981963873f, 0.983105481f, 0.984210074f, 0.985277653f, 0.986308098f, 0.987301409f, 0.988257587f,
+    0.989176512f, 0.990058184f, 0.990902662f, 0.991709769f, 0.992479563f, 0.993211925f, 0.993906975f, 0.994564593f,
+    0.99518472f, 0.995767415f, 0.996312618f, 0.996820271f, 0.997290432f, 0.997723043f, 0.998118103f, 0.998475552f,
+    0.99879545f, 0.999077737f, 0.999322355f, 0.999529421f, 0.999698818f, 0.999830604f, 0.999924719f, 0.999981165f,
+    1.0f
+};
+
+/// atan(i / TrigTableQuarterSize)
+const csmFloat32 AtanTable[TrigTableQuarterSize + 1] =
+{
+    0.0f, 0.00390623021f, 0.00781234121f, 0.0117182136f, 0.0156237287f, 0.0195287671f, 0.0234332103f, 0.0273369383f,
+    0.0312398337f, 0.0351417772f, 0.0390426517f, 0.042942334f, 0.0468407124f, 0.0507376678f, 0.054633081f, 0.0585268326f,
+    0.062418811f, 0.0663088933f, 0.0701969713f, 0.0740829259f, 0.0779666305f, 0.0818479881f, 0.0857268721f, 0.0896031782f,
+    0.0934767798f, 0.0973475724f, 0.101215445f, 0.105080277f, 0.108941957f, 0.112800382f, 0.116655439f, 0.120507009f,
+    0.124354996f, 0.128199279f, 0.132039756f, 0.135876328f, 0.139708877f, 0.143537298f, 0.147361487f, 0.151181325f,
+    0.154996738f, 0.158807606f, 0.162613824f, 0.166415304f, 0.170211926f, 0.174003601f, 0.177790225f, 0.181571707f,
+    0.185347944f, 0.189118847f, 0.192884311f, 0.196644247f, 0.200398549f, 0.204147145f, 0.207889929f, 0.211626813f,
+    0.215357706f, 0.219082505f, 0.222801149f, 0.226513535f, 0.230219588f, 0.233919203f, 0.237612307f, 0.241298825f,
+    0.244978666f, 0.248651743f, 0.252317995f, 0.255977303f, 0.259629637f, 0.263274878f, 0.266912997f, 0.270543873f,
+    0.274167448f, 0.277783662f, 0.281392425f, 0.284993678f, 0.288587362f, 0.292173386f, 0.295751691f, 0.299322188f,
+    0.302884877f, 0.306439608f, 0.309986383f, 0.31352511f, 0.317055762f, 0.320578218f, 0.324092478f, 0.327598453f,
+    0.331096083f, 0.334585309f, 0.338066131f, 0.341538429f, 0.345002174f, 0.348457336f, 0.351903826f, 0.355341613f,
+    0.358770669f, 0.362190932f, 0.365602344f, 0.369004846f, 0.372398436f, 0.375783056f, 0.379158676f, 0.382525206f,
+    0.385882676f, 0.389230996f, 0.392570138f, 0.395900071f, 0.399220765f, 0.40253219f, 0.405834287f, 0.409127057f,
+    0.412410438f, 0.415684432f, 0.418948978f, 0.422204047f, 0.42544964f, 0.428685695f, 0.431912243f, 0.435129195f,
+    0.438336551f, 0.441534311f, 0.444722414f, 0.447900891f, 0.451069653f, 0.454228729f, 0.457378089f, 0.460517734f,
+    0.463647604f, 0.466767728f, 0.469878048f, 0.472978592f, 0.476069331f, 0.479150236f, 0.482221335f, 0.48528257f,
+    0.488333941f, 0.491375476f, 0.494407147f, 0.497428924f, 0.500440836f, 0.503442824f, 0.506434917f, 0.509417176f,
+    0.512389481f, 0.515351892f, 0.518304348f, 0.52124697f, 0.524179637f, 0.527102411f, 0.53001523f, 0.532918215f,
+    0.535811245f, 0.538694382f, 0.541567624f, 0.544430912f, 0.547284365f, 0.550127923f, 0.552961588f, 0.555785418f,
+    0.558599293f, 0.561403394f, 0.5641976f, 0.566981912f, 0.569756448f, 0.57252115f, 0.575276017f, 0.578021109f,
+    0.580756366f, 0.583481848f, 0.586197555f, 0.588903487f, 0.591599703f, 0.594286203f, 0.596962929f, 0.599629998f,
+    0.602287352f, 0.60493505f, 0.607573032f, 0.610201418f, 0.612820208f, 0.615429342f, 0.618028939f, 0.62061888f,
+    0.623199344f, 0.625770211f, 0.628331602f, 0.630883455f, 0.633425891f, 0.63595885f, 0.638482332f, 0.640996397f,
+    0.643501103f, 0.645996451f, 0.648482382f, 0.650959015f, 0.653426349f, 0.655884385f, 0.658333123f, 0.660772681f,
+    0.663203001f, 0.665624142f, 0.668036044f, 0.670438886f, 0.672832549f, 0.675217152f, 0.677592635f, 0.679959118f,
+    0.682316542f, 0.684665024f, 0.687004507f, 0.689334989f, 0.691656649f, 0.693969369f, 0.696273208f, 0.698568225f,
+    0.700854421f, 0.703131795f, 0.705400467f, 0.707660377f, 0.709911644f, 0.71215415f, 0.714388072f, 0.716613352f,
+    0.718829989f, 0.721038103f, 0.723237693f, 0.72542876f, 0.727611303f, 0.729785442f, 0.731951177f, 0.734108508f,
+    0.736257434f, 0.738398015f, 0.740530312f, 0.742654383f, 0.74477011f, 0.74687767f, 0.748977005f, 0.751068234f,
+    0.753151298f, 0.755226254f, 0.757293105f, 0.759351969f, 0.761402786f, 0.763445616f, 0.765480459f, 0.767507434f,
+    0.769526482f, 0.771537662f, 0.773541033f, 0.775536537f, 0.777524292f, 0.779504299f, 0.781476617f, 0.783441246f,
+    0.785398185f
+};
+
+csmFloat32 LookupSin(csmFloat32 steps)
+{
+    if (!isfinite(steps))
+    {
+        return NAN;
+    }
+
+    steps -= floorf(steps / static_cast<csmFloat32>(TrigTableFullSize)) * static_cast<csmFloat32>(TrigTableFullSize);
+
+    const csmInt32 index = static_cast<csmInt32>(steps);
+    const csmFloat32 fraction = steps - static_cast<csmFloat32>(index);
+    const csmInt32 quadrant = (index / TrigTableQuarterSize) & 3;
+    const csmInt32 offset = index % TrigTableQuarterSize;
+
+    csmFloat32 from;
+    csmFloat32 to;
+
+    if (quadrant == 0 || quadrant == 2)
+    {
+        from = SinTable[offset];
+        to = SinTable[offset + 1];
+    }
+    else
+    {
+        from = SinTable[TrigTableQuarterSize - offset];
+        to = SinTable[TrigTableQuarterSize - offset - 1];
+    }
+
+    const csmFloat32 delta = (to - from) * fraction;
+    const csmFloat32 value = from + delta;
+
+    return (quadrant < 2) ? value : -value;
+}
+
+csmFloat32 LookupAtan(csmFloat32 ratio)
+{
+    const csmFloat32 steps = ratio * static_cast<csmFloat32>(TrigTableQuarterSize);
+    const csmInt32 index = static_cast<csmInt32>(steps);
+
+    if (index >= TrigTableQuarterSize)
+    {
+        return AtanTable[TrigTableQuarterSize];
+    }
+
+    const csmFloat32 fraction = steps - static_cast<csmFloat32>(index);
+    const csmFloat32 delta = (AtanTable[index + 1] - AtanTable[index]) * fraction;
+
+    return AtanTable[index] + delta;
+}
+
+}
+
 csmInt32 CubismMath::Clamp(csmInt32 val, csmInt32 min, csmInt32 max)
 {
     if (val < min)
@@ -101,6 +248,79 @@ CubismVector2 CubismMath::RadianToDirection(csmFloat32 totalAngle)
     return ret;
 }
 
+csmFloat32 CubismMath::TableSinF(csmFloat32 x)
+{
+    return LookupSin(x * TrigTableStepsPerRadian);
+}
+
+csmFloat32 CubismMath::TableCosF(csmFloat32 x)
+{
+    return LookupSin(x * TrigTableStepsPerRadian + static_cast<csmFloat32>(TrigTableQuarterSize));
+}
+
+csmFloat32 CubismMath::TableAtan2F(csmFloat32 y, csmFloat32 x)
+{
+    const csmFloat32 absX = AbsF(x);
+    const csmFloat32 absY = AbsF(y);
+    csmFloat32 ret;
+
+    if (absX == 0.0f && absY == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    // 1/8周に畳み込んでテーブルを引く
+    if (absY <= absX)
+    {
+        ret = LookupAtan(absY / absX);
+    }
+    else
+    {
+        ret = HalfPi - LookupAtan(absX / absY);
+    }
+
+    if (x < 0.0f)
+    {
+        ret = Pi - ret;
+    }
+
+    return (y < 0.0f) ? -ret : ret;
+}
+
+csmFloat32 CubismMath::TableDirectionToRadian(CubismVector2 from, CubismVector2 to)
+{
+    csmFloat32 q1;
+    csmFloat32 q2;
+    csmFloat32 ret;
+
+    q1 = TableAtan2F(to.Y, to.X);
+    q2 = TableAtan2F(from.Y, from.X);
+
+    ret = q1 - q2;
+
+    while (ret < -Pi)
+    {
+        ret += Pi * 2.0f;
+    }
+
+    while (ret > Pi)
+    {
+        ret -= Pi * 2.0f;
+    }
+
+    return ret;
+}
+
+CubismVector2 CubismMath::TableRadianToDirection(csmFloat32 totalAngle)
+{
+    CubismVector2 ret;
+
+    ret.X = TableSinF(totalAngle);
+    ret.Y = TableCosF(totalAngle);
+
+    return ret;
+}
+
 csmFloat32 CubismMath::QuadraticEquation(csmFloat32 a, csmFloat32 b, csmFloat32 c)
 {
     if (CubismMath::AbsF(a) < CubismMath::Epsilon)
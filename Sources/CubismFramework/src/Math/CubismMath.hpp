@@ -196,6 +196,60 @@ public:
      */
     static CubismVector2 RadianToDirection(csmFloat32 totalAngle);
 
+    /**
+     * Returns the value of the sine function looked up from a table.
+     *
+     * @param x Angle value in radians [rad]
+     *
+     * @return Value of the sine function sin(x)
+     *
+     * @note The result depends only on IEEE 754 single precision arithmetic,<br>
+     *       so it is identical on every CPU and compiler unlike SinF().
+     */
+    static csmFloat32 TableSinF(csmFloat32 x);
+
+    /**
+     * Returns the value of the cosine function looked up from a table.
+     *
+     * @param x Angle value in radians [rad]
+     *
+     * @return Value of the cosine function cos(x)
+     *
+     * @note The result is reproducible in the same way as TableSinF().
+     */
+    static csmFloat32 TableCosF(csmFloat32 x);
+
+    /**
+     * Returns the arc tangent of y / x looked up from a table.
+     *
+     * @param y Y component
+     * @param x X component
+     *
+     * @return Angle in radians in the range [-Pi, Pi]
+     *
+     * @note The result is reproducible in the same way as TableSinF().
+     */
+    static csmFloat32 TableAtan2F(csmFloat32 y, csmFloat32 x);
+
+    /**
+     * Calculates the angle between two vectors with TableAtan2F().
+     *
+     * @param from Starting vector
+     * @param to Ending vector
+     *
+     * @return Angle in radians [rad]
+     */
+    static csmFloat32 TableDirectionToRadian(CubismVector2 from, CubismVector2 to);
+
+    /**
+     * Calculates the direction vector from an angle with TableSinF() and TableCosF().
+     *
+     * @param totalAngle Angle in radians [rad]
+     *
+     * @return Direction vector
+     */
+    static CubismVector2 TableRadianToDirection(csmFloat32 totalAngle);
+
     /**
      * Finds the solution of a quadratic equation when the cubic coefficient of the cubic equation is zero.<br>
      *          a * x^2 + b * x + c = 0
@@ -7,6 +7,14 @@
 
 #include "CubismMatrix44.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CSM_MATRIX44_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSM_MATRIX44_USE_NEON
+#endif
+
 namespace Live2D { namespace Cubism { namespace Framework {
 CubismMatrix44::CubismMatrix44()
 {
@@ -33,24 +41,63 @@ csmFloat32* CubismMatrix44::GetArray()
     return _tr;
 }
 
-void CubismMatrix44::Multiply(csmFloat32* a, csmFloat32* b, csmFloat32* dst)
+void CubismMatrix44::Multiply(const csmFloat32* a, const csmFloat32* b, csmFloat32* dst)
 {
-    csmFloat32 c[16] = {
-                        0.0f, 0.0f, 0.0f, 0.0f,
-                        0.0f, 0.0f, 0.0f, 0.0f,
-                        0.0f, 0.0f, 0.0f, 0.0f,
-                        0.0f, 0.0f, 0.0f, 0.0f
-                        };
-    csmInt32 n = 4;
-
-    for (csmInt32 i = 0; i < n; ++i)
+    // dst が a や b と同じ配列でもよいように、すべて読み込んでから書き込む
+    // 各要素は k = 0 から順に加算するので、どの実装でも同じ結果になる
+#if defined(CSM_MATRIX44_USE_SSE2)
+    const __m128 b0 = _mm_loadu_ps(b);
+    const __m128 b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8);
+    const __m128 b3 = _mm_loadu_ps(b + 12);
+    __m128 rows[4] = { _mm_loadu_ps(a), _mm_loadu_ps(a + 4), _mm_loadu_ps(a + 8), _mm_loadu_ps(a + 12) };
+
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        const __m128 row = rows[i];
+        __m128 c = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        c = _mm_add_ps(c, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        c = _mm_add_ps(c, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        c = _mm_add_ps(c, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        rows[i] = c;
+    }
+
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        _mm_storeu_ps(dst + i * 4, rows[i]);
+    }
+#elif defined(CSM_MATRIX44_USE_NEON)
+    const float32x4_t b0 = vld1q_f32(b);
+    const float32x4_t b1 = vld1q_f32(b + 4);
+    const float32x4_t b2 = vld1q_f32(b + 8);
+    const float32x4_t b3 = vld1q_f32(b + 12);
+    float32x4_t rows[4] = { vld1q_f32(a), vld1q_f32(a + 4), vld1q_f32(a + 8), vld1q_f32(a + 12) };
+
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        const float32x2_t low = vget_low_f32(rows[i]);
+        const float32x2_t high = vget_high_f32(rows[i]);
+        float32x4_t c = vmulq_lane_f32(b0, low, 0);
+        c = vaddq_f32(c, vmulq_lane_f32(b1, low, 1));
+        c = vaddq_f32(c, vmulq_lane_f32(b2, high, 0));
+        c = vaddq_f32(c, vmulq_lane_f32(b3, high, 1));
+        rows[i] = c;
+    }
+
+    for (csmInt32 i = 0; i < 4; ++i)
     {
-        for (csmInt32 j = 0; j < n; ++j)
+        vst1q_f32(dst + i * 4, rows[i]);
+    }
+#else
+    csmFloat32 c[16];
+
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        const csmFloat32* row = a + i * 4;
+
+        for (csmInt32 j = 0; j < 4; ++j)
         {
-            for (csmInt32 k = 0; k < n; ++k)
-            {
-                c[j + i * 4] += a[k + i * 4] * b[j + k * 4];
-            }
+            c[j + i * 4] = row[0] * b[j] + row[1] * b[j + 4] + row[2] * b[j + 8] + row[3] * b[j + 12];
         }
     }
 
@@ -58,6 +105,105 @@ void CubismMatrix44::Multiply(csmFloat32* a, csmFloat32* b, csmFloat32* dst)
     {
         dst[i] = c[i];
     }
+#endif
+}
+
+csmBool CubismMatrix44::Invert(const csmFloat32* src, csmFloat32* dst)
+{
+    // 上2行と下2行の2x2小行列式から余因子を求める
+    const csmFloat32 a00 = src[0], a01 = src[1], a02 = src[2], a03 = src[3];
+    const csmFloat32 a10 = src[4], a11 = src[5], a12 = src[6], a13 = src[7];
+    const csmFloat32 a20 = src[8], a21 = src[9], a22 = src[10], a23 = src[11];
+    const csmFloat32 a30 = src[12], a31 = src[13], a32 = src[14], a33 = src[15];
+
+    const csmFloat32 b00 = a00 * a11 - a01 * a10;
+    const csmFloat32 b01 = a00 * a12 - a02 * a10;
+    const csmFloat32 b02 = a00 * a13 - a03 * a10;
+    const csmFloat32 b03 = a01 * a12 - a02 * a11;
+    const csmFloat32 b04 = a01 * a13 - a03 * a11;
+    const csmFloat32 b05 = a02 * a13 - a03 * a12;
+    const csmFloat32 b06 = a20 * a31 - a21 * a30;
+    const csmFloat32 b07 = a20 * a32 - a22 * a30;
+    const csmFloat32 b08 = a20 * a33 - a23 * a30;
+    const csmFloat32 b09 = a21 * a32 - a22 * a31;
+    const csmFloat32 b10 = a21 * a33 - a23 * a31;
+    const csmFloat32 b11 = a22 * a33 - a23 * a32;
+
+    const csmFloat32 det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+
+    if (det == 0.0f)
+    {
+        for (csmInt32 i = 0; i < 16; ++i)
+        {
+            dst[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        }
+        return false;
+    }
+
+    const csmFloat32 invDet = 1.0f / det;
+
+    dst[0] = (a11 * b11 - a12 * b10 + a13 * b09) * invDet;
+    dst[1] = (a02 * b10 - a01 * b11 - a03 * b09) * invDet;
+    dst[2] = (a31 * b05 - a32 * b04 + a33 * b03) * invDet;
+    dst[3] = (a22 * b04 - a21 * b05 - a23 * b03) * invDet;
+    dst[4] = (a12 * b08 - a10 * b11 - a13 * b07) * invDet;
+    dst[5] = (a00 * b11 - a02 * b08 + a03 * b07) * invDet;
+    dst[6] = (a32 * b02 - a30 * b05 - a33 * b01) * invDet;
+    dst[7] = (a20 * b05 - a22 * b02 + a23 * b01) * invDet;
+    dst[8] = (a10 * b10 - a11 * b08 + a13 * b06) * invDet;
+    dst[9] = (a01 * b08 - a00 * b10 - a03 * b06) * invDet;
+    dst[10] = (a30 * b04 - a31 * b02 + a33 * b00) * invDet;
+    dst[11] = (a21 * b02 - a20 * b04 - a23 * b00) * invDet;
+    dst[12] = (a11 * b07 - a10 * b09 - a12 * b06) * invDet;
+    dst[13] = (a00 * b09 - a01 * b07 + a02 * b06) * invDet;
+    dst[14] = (a31 * b01 - a30 * b03 - a32 * b00) * invDet;
+    dst[15] = (a20 * b03 - a21 * b01 + a22 * b00) * invDet;
+
+    return true;
+}
+
+void CubismMatrix44::TransformPoints(const csmFloat32* matrix, const csmFloat32* src, csmFloat32* dst, csmInt32 pointCount)
+{
+    const csmFloat32 m0 = matrix[0], m1 = matrix[1];
+    const csmFloat32 m4 = matrix[4], m5 = matrix[5];
+    const csmFloat32 m12 = matrix[12], m13 = matrix[13];
+    csmInt32 i = 0;
+
+#if defined(CSM_MATRIX44_USE_SSE2)
+    // 4点ずつXとYに分けて変換し、並びを戻して書き込む
+    const __m128 xx = _mm_set1_ps(m0), yx = _mm_set1_ps(m4), tx = _mm_set1_ps(m12);
+    const __m128 xy = _mm_set1_ps(m1), yy = _mm_set1_ps(m5), ty = _mm_set1_ps(m13);
+
+    for (; i + 4 <= pointCount; i += 4)
+    {
+        const __m128 p0 = _mm_loadu_ps(src + i * 2);
+        const __m128 p1 = _mm_loadu_ps(src + i * 2 + 4);
+        const __m128 x = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 y = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, x), _mm_mul_ps(yx, y)), tx);
+        const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xy, x), _mm_mul_ps(yy, y)), ty);
+        _mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(rx, ry));
+        _mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(rx, ry));
+    }
+#elif defined(CSM_MATRIX44_USE_NEON)
+    // 4点ずつXとYに分けて読み込み、変換して書き戻す
+    for (; i + 4 <= pointCount; i += 4)
+    {
+        const float32x4x2_t p = vld2q_f32(src + i * 2);
+        float32x4x2_t r;
+        r.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], m0), vmulq_n_f32(p.val[1], m4)), vdupq_n_f32(m12));
+        r.val[1] = vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], m1), vmulq_n_f32(p.val[1], m5)), vdupq_n_f32(m13));
+        vst2q_f32(dst + i * 2, r);
+    }
+#endif
+
+    for (; i < pointCount; ++i)
+    {
+        const csmFloat32 x = src[i * 2];
+        const csmFloat32 y = src[i * 2 + 1];
+        dst[i * 2] = (m0 * x + m4 * y) + m12;
+        dst[i * 2 + 1] = (m1 * x + m5 * y) + m13;
+    }
 }
 
 void CubismMatrix44::TranslateRelative(csmFloat32 x, csmFloat32 y)
@@ -158,4 +304,14 @@ void CubismMatrix44::MultiplyByMatrix(CubismMatrix44* m)
 {
     Multiply(m->GetArray(), _tr, _tr);
 }
+
+csmBool CubismMatrix44::GetInvert(CubismMatrix44* dst) const
+{
+    return Invert(_tr, dst->_tr);
+}
+
+void CubismMatrix44::TransformPoints(const csmFloat32* src, csmFloat32* dst, csmInt32 pointCount) const
+{
+    TransformPoints(_tr, src, dst, pointCount);
+}
 }}}
@@ -32,9 +32,31 @@ public:
      *
      * @param a Matrix a
      * @param b Matrix b
-     * @param dst Destination matrix for storing the result
+     * @param dst Destination matrix for storing the result; may be the same array as a or b
      */
-    static void Multiply(csmFloat32* a, csmFloat32* b, csmFloat32* dst);
+    static void Multiply(const csmFloat32* a, const csmFloat32* b, csmFloat32* dst);
+
+    /**
+     * Calculates the inverse of the given matrix.
+     *
+     * @param src Matrix to invert
+     * @param dst Destination matrix for storing the result; may be the same array as src
+     *
+     * @return true if the matrix was inverted; false if it is singular, in which case dst is set to the identity matrix
+     */
+    static csmBool Invert(const csmFloat32* src, csmFloat32* dst);
+
+    /**
+     * Transforms points by the given matrix.
+     *
+     * @param matrix Matrix to transform by
+     * @param src Points to transform, stored as interleaved X and Y (same layout as csmVector2)
+     * @param dst Destination for the transformed points; may be the same array as src
+     * @param pointCount Number of points
+     *
+     * @note The points are treated as (x, y, 0, 1), so the transform applies scale, rotation and translation.
+     */
+    static void TransformPoints(const csmFloat32* matrix, const csmFloat32* src, csmFloat32* dst, csmInt32 pointCount);
 
     /**
      * Sets the identity matrix.
@@ -172,6 +194,24 @@ public:
      */
     void            MultiplyByMatrix(CubismMatrix44* m);
 
+    /**
+     * Stores the inverse of this matrix.
+     *
+     * @param dst Matrix to store the inverse in
+     *
+     * @return true if the matrix was inverted; false if it is singular, in which case dst is set to the identity matrix
+     */
+    csmBool         GetInvert(CubismMatrix44* dst) const;
+
+    /**
+     * Transforms points by this matrix.
+     *
+     * @param src Points to transform, stored as interleaved X and Y
+     * @param dst Destination for the transformed points; may be the same array as src
+     * @param pointCount Number of points
+     */
+    void            TransformPoints(const csmFloat32* src, csmFloat32* dst, csmInt32 pointCount) const;
+
 protected:
     csmFloat32  _tr[16];
 };
@@ -0,0 +1,520 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismHitTester.hpp"
+#include <float.h>
+#include "Model/CubismModel.hpp"
+#include "Math/CubismMatrix44.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+const csmInt32 MaxLeafTriangleCount = 4;   ///< 葉に入れる三角形の最大数
+const csmInt32 MaxTraversalDepth = 64;     ///< 探索スタックの大きさ。中央値で分割するので深さは三角形数の対数程度
+
+/**
+ * 点が三角形の内側（辺上を含む）にあるかを返す。頂点の回り順は問わない
+ */
+inline csmBool IsInsideTriangle(const csmFloat32* a, const csmFloat32* b, const csmFloat32* c, csmFloat32 x, csmFloat32 y)
+{
+    const csmFloat32 d0 = (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+    const csmFloat32 d1 = (c[0] - b[0]) * (y - b[1]) - (c[1] - b[1]) * (x - b[0]);
+    const csmFloat32 d2 = (a[0] - c[0]) * (y - c[1]) - (a[1] - c[1]) * (x - c[0]);
+
+    const csmBool hasNegative = (d0 < 0.0f) || (d1 < 0.0f) || (d2 < 0.0f);
+    const csmBool hasPositive = (d0 > 0.0f) || (d1 > 0.0f) || (d2 > 0.0f);
+
+    return !(hasNegative && hasPositive);
+}
+
+inline csmBool IsInsideBounds(const csmFloat32* bounds, csmFloat32 x, csmFloat32 y)
+{
+    return (bounds[0] <= x) && (x <= bounds[2]) && (bounds[1] <= y) && (y <= bounds[3]);
+}
+
+inline const csmFloat32* GetVertex(const csmFloat32* vertices, csmInt32 index)
+{
+    return vertices + Constant::VertexOffset + index * Constant::VertexStep;
+}
+}
+
+CubismHitTester* CubismHitTester::Create(const CubismModel* model)
+{
+    return CSM_NEW CubismHitTester(model);
+}
+
+void CubismHitTester::Delete(CubismHitTester* instance)
+{
+    CSM_DELETE_SELF(CubismHitTester, instance);
+}
+
+CubismHitTester::CubismHitTester(const CubismModel* model)
+    : _model(model)
+    , _hasModelMatrix(false)
+{
+    const csmInt32 drawableCount = _model->GetDrawableCount();
+
+    _bounds.UpdateSize(drawableCount * 4, 0.0f);
+    _boundsUpdateCounts.UpdateSize(drawableCount, 0);
+    _hasBounds.UpdateSize(drawableCount, false);
+    _meshes.UpdateSize(drawableCount, NULL);
+}
+
+CubismHitTester::~CubismHitTester()
+{
+    for (csmUint32 i = 0; i < _meshes.GetSize(); ++i)
+    {
+        CSM_DELETE(_meshes[i]);
+    }
+}
+
+csmBool CubismHitTester::SetModelMatrix(CubismMatrix44* matrix)
+{
+    _hasModelMatrix = false;
+
+    if (matrix == NULL)
+    {
+        return true;
+    }
+
+    // 点をモデル空間に戻すために逆行列を持つ
+    if (!CubismMatrix44::Invert(matrix->GetArray(), _inverseModelMatrix))
+    {
+        return false;
+    }
+
+    _hasModelMatrix = true;
+    return true;
+}
+
+csmBool CubismHitTester::GetDrawableBounds(csmInt32 drawableIndex, csmFloat32* outBounds)
+{
+    if (drawableIndex < 0 || drawableIndex >= static_cast<csmInt32>(_hasBounds.GetSize()))
+    {
+        return false;
+    }
+
+    RefreshBounds(drawableIndex);
+
+    const csmFloat32* bounds = &_bounds[drawableIndex * 4];
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        outBounds[i] = bounds[i];
+    }
+
+    return bounds[0] <= bounds[2];
+}
+
+csmBool CubismHitTester::IsHit(csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y)
+{
+    csmBool isHit = false;
+    const csmFloat32 point[2] = { x, y };
+    HitTestPoints(drawableIndex, point, 1, false, &isHit);
+    return isHit;
+}
+
+csmBool CubismHitTester::IsHitMesh(csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y)
+{
+    csmBool isHit = false;
+    const csmFloat32 point[2] = { x, y };
+    HitTestPoints(drawableIndex, point, 1, true, &isHit);
+    return isHit;
+}
+
+csmInt32 CubismHitTester::HitTestPoints(csmInt32 drawableIndex, const csmFloat32* points, csmInt32 pointCount, csmBool isPrecise, csmBool* outIsHit)
+{
+    if (drawableIndex < 0 || drawableIndex >= static_cast<csmInt32>(_hasBounds.GetSize()))
+    {
+        for (csmInt32 i = 0; i < pointCount; ++i)
+        {
+            outIsHit[i] = false;
+        }
+        return 0;
+    }
+
+    // 範囲と階層の更新は点の数によらず一度だけ行う
+    const MeshBvh* mesh = NULL;
+    if (isPrecise)
+    {
+        mesh = GetFittedMesh(drawableIndex);
+    }
+    else
+    {
+        RefreshBounds(drawableIndex);
+    }
+
+    const csmFloat32* modelSpacePoints = ToModelSpace(points, pointCount);
+    const csmFloat32* bounds = &_bounds[drawableIndex * 4];
+    csmInt32 hitCount = 0;
+
+    for (csmInt32 i = 0; i < pointCount; ++i)
+    {
+        const csmFloat32 x = modelSpacePoints[i * 2];
+        const csmFloat32 y = modelSpacePoints[i * 2 + 1];
+
+        csmBool isHit = IsInsideBounds(bounds, x, y);
+
+        if (isHit && isPrecise)
+        {
+            isHit = IsHitFittedMesh(drawableIndex, mesh, x, y);
+        }
+
+        outIsHit[i] = isHit;
+        hitCount += isHit ? 1 : 0;
+    }
+
+    return hitCount;
+}
+
+csmInt32 CubismHitTester::HitTestModels(CubismHitTester* const* testers, const csmInt32* drawableIndices, csmInt32 testCount,
+                                        const csmFloat32* points, csmInt32 pointCount, csmBool isPrecise, csmInt32* outTestIndices)
+{
+    // まだ当たっていない点だけを詰めて、次のテストに渡す
+    csmVector<csmFloat32> remainingPoints(pointCount * 2);
+    csmVector<csmInt32> remainingIndices(pointCount);
+    csmVector<csmBool> results(pointCount);
+
+    for (csmInt32 i = 0; i < pointCount; ++i)
+    {
+        outTestIndices[i] = -1;
+        remainingPoints.PushBack(points[i * 2]);
+        remainingPoints.PushBack(points[i * 2 + 1]);
+        remainingIndices.PushBack(i);
+    }
+    results.UpdateSize(pointCount, false);
+
+    csmInt32 remainingCount = pointCount;
+
+    for (csmInt32 test = 0; test < testCount && remainingCount > 0; ++test)
+    {
+        if (testers[test]->HitTestPoints(drawableIndices[test], remainingPoints.GetPtr(), remainingCount, isPrecise, results.GetPtr()) == 0)
+        {
+            continue;
+        }
+
+        csmInt32 count = 0;
+
+        for (csmInt32 i = 0; i < remainingCount; ++i)
+        {
+            if (results[i])
+            {
+                outTestIndices[remainingIndices[i]] = test;
+                continue;
+            }
+
+            remainingPoints[count * 2] = remainingPoints[i * 2];
+            remainingPoints[count * 2 + 1] = remainingPoints[i * 2 + 1];
+            remainingIndices[count] = remainingIndices[i];
+            ++count;
+        }
+
+        remainingCount = count;
+    }
+
+    return pointCount - remainingCount;
+}
+
+void CubismHitTester::RefreshBounds(csmInt32 drawableIndex)
+{
+    const csmUint32 updateCount = _model->GetUpdateCount();
+
+    // 頂点の変更フラグは CubismModel::Update() の中で既に落とされているので、更新があれば計算し直す
+    if (_hasBounds[drawableIndex] && _boundsUpdateCounts[drawableIndex] == updateCount)
+    {
+        return;
+    }
+
+    const csmInt32 vertexCount = _model->GetDrawableVertexCount(drawableIndex);
+    const csmFloat32* vertices = _model->GetDrawableVertices(drawableIndex);
+
+    // 頂点がなければ何も含まない範囲にする
+    csmFloat32 left = FLT_MAX;
+    csmFloat32 top = FLT_MAX;
+    csmFloat32 right = -FLT_MAX;
+    csmFloat32 bottom = -FLT_MAX;
+
+    for (csmInt32 i = 0; i < vertexCount; ++i)
+    {
+        const csmFloat32* vertex = GetVertex(vertices, i);
+
+        left = (vertex[0] < left) ? vertex[0] : left;
+        right = (vertex[0] > right) ? vertex[0] : right;
+        top = (vertex[1] < top) ? vertex[1] : top;
+        bottom = (vertex[1] > bottom) ? vertex[1] : bottom;
+    }
+
+    csmFloat32* bounds = &_bounds[drawableIndex * 4];
+    bounds[0] = left;
+    bounds[1] = top;
+    bounds[2] = right;
+    bounds[3] = bottom;
+
+    _hasBounds[drawableIndex] = true;
+    _boundsUpdateCounts[drawableIndex] = updateCount;
+
+    if (_meshes[drawableIndex] != NULL)
+    {
+        _meshes[drawableIndex]->IsFitted = false;
+    }
+}
+
+CubismHitTester::MeshBvh* CubismHitTester::GetFittedMesh(csmInt32 drawableIndex)
+{
+    RefreshBounds(drawableIndex);
+
+    MeshBvh* mesh = _meshes[drawableIndex];
+
+    if (mesh == NULL)
+    {
+        mesh = CSM_NEW MeshBvh();
+        mesh->IsFitted = false;
+        BuildMesh(drawableIndex, mesh);
+        _meshes[drawableIndex] = mesh;
+    }
+
+    // 三角形の構成は変わらないので、頂点が動いたら範囲だけを計算し直す
+    if (!mesh->IsFitted)
+    {
+        FitMesh(drawableIndex, mesh);
+    }
+
+    return mesh;
+}
+
+void CubismHitTester::BuildMesh(csmInt32 drawableIndex, MeshBvh* mesh)
+{
+    const csmInt32 triangleCount = _model->GetDrawableVertexIndexCount(drawableIndex) / 3;
+
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    const csmUint16* indices = _model->GetDrawableVertexIndices(drawableIndex);
+    const csmFloat32* vertices = _model->GetDrawableVertices(drawableIndex);
+
+    // 分割に使う重心は構築時の頂点位置で求める
+    csmFloat32* centroids = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * triangleCount * 2));
+
+    mesh->Triangles.PrepareCapacity(triangleCount);
+
+    for (csmInt32 i = 0; i < triangleCount; ++i)
+    {
+        const csmFloat32* a = GetVertex(vertices, indices[i * 3]);
+        const csmFloat32* b = GetVertex(vertices, indices[i * 3 + 1]);
+        const csmFloat32* c = GetVertex(vertices, indices[i * 3 + 2]);
+
+        centroids[i * 2] = (a[0] + b[0] + c[0]) / 3.0f;
+        centroids[i * 2 + 1] = (a[1] + b[1] + c[1]) / 3.0f;
+
+        mesh->Triangles.PushBack(i);
+    }
+
+    BvhNode root;
+    mesh->Nodes.PrepareCapacity(2 * (triangleCount / MaxLeafTriangleCount) + 1);
+    mesh->Nodes.PushBack(root);
+    BuildNode(mesh, centroids, 0, 0, triangleCount);
+
+    CSM_FREE(centroids);
+}
+
+void CubismHitTester::BuildNode(MeshBvh* mesh, const csmFloat32* centroids, csmInt32 nodeIndex, csmInt32 begin, csmInt32 end)
+{
+    const csmInt32 count = end - begin;
+    csmInt32* triangles = mesh->Triangles.GetPtr();
+
+    // 重心の範囲が広い方の軸で分ける
+    csmFloat32 minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+    for (csmInt32 i = begin; i < end; ++i)
+    {
+        const csmFloat32* centroid = centroids + triangles[i] * 2;
+
+        minX = (centroid[0] < minX) ? centroid[0] : minX;
+        maxX = (centroid[0] > maxX) ? centroid[0] : maxX;
+        minY = (centroid[1] < minY) ? centroid[1] : minY;
+        maxY = (centroid[1] > maxY) ? centroid[1] : maxY;
+    }
+
+    if (count <= MaxLeafTriangleCount || (maxX - minX == 0.0f && maxY - minY == 0.0f))
+    {
+        mesh->Nodes[nodeIndex].First = begin;
+        mesh->Nodes[nodeIndex].TriangleCount = count;
+        return;
+    }
+
+    const csmInt32 axis = (maxX - minX >= maxY - minY) ? 0 : 1;
+    const csmInt32 middle = begin + count / 2;
+
+    // 中央の要素が middle の位置に来るまで分割する（クイックセレクト）
+    csmInt32 low = begin;
+    csmInt32 high = end - 1;
+
+    while (low < high)
+    {
+        const csmFloat32 pivot = centroids[triangles[(low + high) / 2] * 2 + axis];
+        csmInt32 i = low;
+        csmInt32 j = high;
+
+        while (i <= j)
+        {
+            while (centroids[triangles[i] * 2 + axis] < pivot)
+            {
+                ++i;
+            }
+            while (centroids[triangles[j] * 2 + axis] > pivot)
+            {
+                --j;
+            }
+            if (i <= j)
+            {
+                const csmInt32 tmp = triangles[i];
+                triangles[i] = triangles[j];
+                triangles[j] = tmp;
+                ++i;
+                --j;
+            }
+        }
+
+        if (middle <= j)
+        {
+            high = j;
+        }
+        else if (middle >= i)
+        {
+            low = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // 子は親より後ろに並ぶので、後ろから順に範囲を計算できる
+    const csmInt32 firstChild = mesh->Nodes.GetSize();
+    BvhNode child;
+    mesh->Nodes.PushBack(child);
+    mesh->Nodes.PushBack(child);
+    mesh->Nodes[nodeIndex].First = firstChild;
+    mesh->Nodes[nodeIndex].TriangleCount = 0;
+
+    BuildNode(mesh, centroids, firstChild, begin, middle);
+    BuildNode(mesh, centroids, firstChild + 1, middle, end);
+}
+
+void CubismHitTester::FitMesh(csmInt32 drawableIndex, MeshBvh* mesh)
+{
+    const csmUint16* indices = _model->GetDrawableVertexIndices(drawableIndex);
+    const csmFloat32* vertices = _model->GetDrawableVertices(drawableIndex);
+    const csmInt32* triangles = mesh->Triangles.GetPtr();
+
+    for (csmInt32 n = static_cast<csmInt32>(mesh->Nodes.GetSize()) - 1; n >= 0; --n)
+    {
+        BvhNode& node = mesh->Nodes[n];
+        csmFloat32* bounds = node.Bounds;
+
+        if (node.TriangleCount == 0)
+        {
+            const csmFloat32* left = mesh->Nodes[node.First].Bounds;
+            const csmFloat32* right = mesh->Nodes[node.First + 1].Bounds;
+
+            bounds[0] = (left[0] < right[0]) ? left[0] : right[0];
+            bounds[1] = (left[1] < right[1]) ? left[1] : right[1];
+            bounds[2] = (left[2] > right[2]) ? left[2] : right[2];
+            bounds[3] = (left[3] > right[3]) ? left[3] : right[3];
+            continue;
+        }
+
+        bounds[0] = FLT_MAX;
+        bounds[1] = FLT_MAX;
+        bounds[2] = -FLT_MAX;
+        bounds[3] = -FLT_MAX;
+
+        for (csmInt32 t = node.First; t < node.First + node.TriangleCount; ++t)
+        {
+            const csmUint16* triangle = indices + triangles[t] * 3;
+
+            for (csmInt32 k = 0; k < 3; ++k)
+            {
+                const csmFloat32* vertex = GetVertex(vertices, triangle[k]);
+
+                bounds[0] = (vertex[0] < bounds[0]) ? vertex[0] : bounds[0];
+                bounds[1] = (vertex[1] < bounds[1]) ? vertex[1] : bounds[1];
+                bounds[2] = (vertex[0] > bounds[2]) ? vertex[0] : bounds[2];
+                bounds[3] = (vertex[1] > bounds[3]) ? vertex[1] : bounds[3];
+            }
+        }
+    }
+
+    mesh->IsFitted = true;
+}
+
+csmBool CubismHitTester::IsHitFittedMesh(csmInt32 drawableIndex, const MeshBvh* mesh, csmFloat32 x, csmFloat32 y) const
+{
+    if (mesh->Nodes.GetSize() == 0)
+    {
+        return false;
+    }
+
+    const csmUint16* indices = _model->GetDrawableVertexIndices(drawableIndex);
+    const csmFloat32* vertices = _model->GetDrawableVertices(drawableIndex);
+    const BvhNode* nodes = &mesh->Nodes[0];
+    const csmInt32* triangles = &mesh->Triangles[0];
+
+    csmInt32 stack[MaxTraversalDepth];
+    csmInt32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const BvhNode& node = nodes[stack[--stackSize]];
+
+        if (!IsInsideBounds(node.Bounds, x, y))
+        {
+            continue;
+        }
+
+        if (node.TriangleCount == 0)
+        {
+            CSM_ASSERT(stackSize + 2 <= MaxTraversalDepth);
+            stack[stackSize++] = node.First;
+            stack[stackSize++] = node.First + 1;
+            continue;
+        }
+
+        for (csmInt32 t = node.First; t < node.First + node.TriangleCount; ++t)
+        {
+            const csmUint16* triangle = indices + triangles[t] * 3;
+
+            if (IsInsideTriangle(GetVertex(vertices, triangle[0]), GetVertex(vertices, triangle[1]), GetVertex(vertices, triangle[2]), x, y))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+const csmFloat32* CubismHitTester::ToModelSpace(const csmFloat32* points, csmInt32 pointCount)
+{
+    if (!_hasModelMatrix)
+    {
+        return points;
+    }
+
+    if (static_cast<csmInt32>(_modelSpacePoints.GetSize()) < pointCount * 2)
+    {
+        _modelSpacePoints.UpdateSize(pointCount * 2, 0.0f);
+    }
+
+    CubismMatrix44::TransformPoints(_inverseModelMatrix, points, _modelSpacePoints.GetPtr(), pointCount);
+
+    return _modelSpacePoints.GetPtr();
+}
+
+}}}
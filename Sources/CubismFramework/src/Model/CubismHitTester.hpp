@@ -0,0 +1,172 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class CubismModel;
+class CubismMatrix44;
+
+/**
+ * Hit tests points against the drawables of a model
+ *
+ * Keeps the bounding box of each drawable and recalculates it at most once per update of the model, on first use.<br>
+ * Precise tests use a bounding volume hierarchy over the triangles of the drawable, built on first use and<br>
+ * refitted when the vertices move.
+ *
+ * Points are given in model space. After SetModelMatrix(), points are given in the space the model matrix maps to.
+ */
+class CubismHitTester
+{
+public:
+    /**
+     * Makes an instance of CubismHitTester.
+     *
+     * @param model Model to test; must outlive the instance
+     *
+     * @return Made instance of CubismHitTester
+     */
+    static CubismHitTester* Create(const CubismModel* model);
+
+    /**
+     * Destroys an instance of CubismHitTester.
+     *
+     * @param instance Instance of CubismHitTester to destroy
+     */
+    static void Delete(CubismHitTester* instance);
+
+    /**
+     * Sets the matrix that maps model space to the space of the points given to the tests.
+     *
+     * @param matrix Model matrix; NULL to give points in model space
+     *
+     * @return true if the matrix was set; false if it is singular, in which case points are given in model space
+     */
+    csmBool SetModelMatrix(CubismMatrix44* matrix);
+
+    /**
+     * Returns the bounding box of a drawable in model space.
+     *
+     * @param drawableIndex Index of the drawable
+     * @param outBounds Receives the left, top, right and bottom
+     *
+     * @return false if the drawable has no vertices; otherwise true
+     */
+    csmBool GetDrawableBounds(csmInt32 drawableIndex, csmFloat32* outBounds);
+
+    /**
+     * Returns whether a point is inside the bounding box of a drawable. Same result as CubismUserModel::IsHit().
+     *
+     * @param drawableIndex Index of the drawable
+     * @param x X position
+     * @param y Y position
+     *
+     * @return true if the point is inside the bounding box
+     */
+    csmBool IsHit(csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y);
+
+    /**
+     * Returns whether a point is inside one of the triangles of a drawable.
+     *
+     * @param drawableIndex Index of the drawable
+     * @param x X position
+     * @param y Y position
+     *
+     * @return true if the point is inside the mesh; points on an edge are inside
+     */
+    csmBool IsHitMesh(csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y);
+
+    /**
+     * Tests many points against a drawable.
+     *
+     * @param drawableIndex Index of the drawable
+     * @param points Points stored as interleaved X and Y
+     * @param pointCount Number of points
+     * @param isPrecise true to test the mesh as IsHitMesh(); false to test the bounding box as IsHit()
+     * @param outIsHit Receives the result of each point
+     *
+     * @return Number of points that hit
+     */
+    csmInt32 HitTestPoints(csmInt32 drawableIndex, const csmFloat32* points, csmInt32 pointCount, csmBool isPrecise, csmBool* outIsHit);
+
+    /**
+     * Tests many points against drawables of many models.
+     *
+     * @param testers Tester of each test, in priority order (front-most model first)
+     * @param drawableIndices Drawable of each test
+     * @param testCount Number of tests
+     * @param points Points stored as interleaved X and Y, in the space set by SetModelMatrix() of each tester
+     * @param pointCount Number of points
+     * @param isPrecise true to test meshes; false to test bounding boxes
+     * @param outTestIndices Receives for each point the first test that hits, or -1
+     *
+     * @return Number of points that hit a test
+     */
+    static csmInt32 HitTestModels(CubismHitTester* const* testers, const csmInt32* drawableIndices, csmInt32 testCount,
+                                  const csmFloat32* points, csmInt32 pointCount, csmBool isPrecise, csmInt32* outTestIndices);
+
+private:
+    /**
+     * Node of the bounding volume hierarchy of a drawable
+     */
+    struct BvhNode
+    {
+        BvhNode()
+            : First(0)
+            , TriangleCount(0)
+        {
+            Bounds[0] = Bounds[1] = Bounds[2] = Bounds[3] = 0.0f;
+        }
+
+        csmFloat32 Bounds[4];           ///< Left, top, right and bottom
+        csmInt32 First;                 ///< First triangle of a leaf; first of the two children of an inner node
+        csmInt32 TriangleCount;         ///< Number of triangles of a leaf; 0 for an inner node
+    };
+
+    /**
+     * Bounding volume hierarchy over the triangles of a drawable
+     */
+    struct MeshBvh
+    {
+        csmVector<BvhNode> Nodes;       ///< Nodes; children come after their parent
+        csmVector<csmInt32> Triangles;  ///< Triangle indices in leaf order
+        csmBool IsFitted;               ///< false if the vertices moved since the node bounds were calculated
+    };
+
+    CubismHitTester(const CubismModel* model);
+
+    virtual ~CubismHitTester();
+
+    void RefreshBounds(csmInt32 drawableIndex);
+
+    MeshBvh* GetFittedMesh(csmInt32 drawableIndex);
+
+    void BuildMesh(csmInt32 drawableIndex, MeshBvh* mesh);
+
+    void BuildNode(MeshBvh* mesh, const csmFloat32* centroids, csmInt32 nodeIndex, csmInt32 begin, csmInt32 end);
+
+    void FitMesh(csmInt32 drawableIndex, MeshBvh* mesh);
+
+    csmBool IsHitFittedMesh(csmInt32 drawableIndex, const MeshBvh* mesh, csmFloat32 x, csmFloat32 y) const;
+
+    const csmFloat32* ToModelSpace(const csmFloat32* points, csmInt32 pointCount);
+
+    const CubismModel* _model;
+    csmVector<csmFloat32> _bounds;              ///< Left, top, right and bottom of each drawable
+    csmVector<csmUint32> _boundsUpdateCounts;   ///< CubismModel::GetUpdateCount() when the bounds were calculated
+    csmVector<csmBool> _hasBounds;
+    csmVector<MeshBvh*> _meshes;                ///< Hierarchy of each drawable; NULL until the first precise test
+    csmFloat32 _inverseModelMatrix[16];
+    csmBool _hasModelMatrix;
+    csmVector<csmFloat32> _modelSpacePoints;    ///< Work buffer for points converted to model space
+};
+
+}}}
@@ -12,32 +12,64 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
 CubismMoc* CubismMoc::Create(const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency)
 {
-    CubismMoc* cubismMoc = NULL;
-
+    // 呼び出し元のバッファは読み込み後に解放されるので、その場で復元できるように複製する
     void* alignedBuffer = CSM_MALLOC_ALLIGNED(size, Core::csmAlignofMoc);
     memcpy(alignedBuffer, mocBytes, size);
 
+    CubismMoc* cubismMoc = Revive(alignedBuffer, size, shouldCheckMocConsistency);
+
+    if (cubismMoc == NULL)
+    {
+        CSM_FREE_ALLIGNED(alignedBuffer);
+    }
+
+    return cubismMoc;
+}
+
+CubismMoc* CubismMoc::CreateInPlace(void* mocMemory, csmSizeInt size, ReleaseMemoryFunction releaseMemory, void* userData,
+                                    csmBool shouldCheckMocConsistency)
+{
+    if (mocMemory == NULL || (reinterpret_cast<csmSizeType>(mocMemory) % Core::csmAlignofMoc) != 0)
+    {
+        CubismLogError("MOC memory must be aligned to csmAlignofMoc.");
+        return NULL;
+    }
+
+    CubismMoc* cubismMoc = Revive(mocMemory, size, shouldCheckMocConsistency);
+
+    if (cubismMoc != NULL)
+    {
+        cubismMoc->_releaseMemory = releaseMemory;
+        cubismMoc->_releaseUserData = userData;
+    }
+
+    return cubismMoc;
+}
+
+CubismMoc* CubismMoc::Revive(void* alignedMemory, csmSizeInt size, csmBool shouldCheckMocConsistency)
+{
+    CubismMoc* cubismMoc = NULL;
+
     if (shouldCheckMocConsistency)
     {
         // .moc3の整合性を確認
-        csmBool consistency = HasMocConsistency(alignedBuffer, size);
+        csmBool consistency = HasMocConsistency(alignedMemory, static_cast<csmUint32>(size));
         if (!consistency)
         {
-            CSM_FREE_ALLIGNED(alignedBuffer);
-
             // 整合性が確認できなければ処理しない
             CubismLogError("Inconsistent MOC3.");
             return cubismMoc;
         }
     }
 
-    Core::csmMoc* moc = Core::csmReviveMocInPlace(alignedBuffer, size);
-    const Core::csmMocVersion version = Core::csmGetMocVersion(alignedBuffer, size);
+    Core::csmMoc* moc = Core::csmReviveMocInPlace(alignedMemory, static_cast<csmUint32>(size));
+    const Core::csmMocVersion version = Core::csmGetMocVersion(alignedMemory, static_cast<csmUint32>(size));
 
     if (moc)
     {
         cubismMoc = CSM_NEW CubismMoc(moc);
         cubismMoc->_mocVersion = version;
+        cubismMoc->_mocSize = static_cast<csmUint32>(size);
     }
 
     return cubismMoc;
@@ -45,20 +77,58 @@ CubismMoc* CubismMoc::Create(const csmByte* mocBytes, csmSizeInt size, csmBool s
 
 void CubismMoc::Delete(CubismMoc* moc)
 {
-    CSM_DELETE_SELF(CubismMoc, moc);
+    if (moc != NULL)
+    {
+        moc->Release();
+    }
+}
+
+void CubismMoc::Retain()
+{
+    _referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CubismMoc::Release()
+{
+    if (_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // CSM_DELETE_SELF は this を NULL と比較するので、デストラクタと解放を直接呼ぶ
+        this->~CubismMoc();
+#ifdef CSM_ALLOCATION_CALL_SITES
+        operator delete(this, GlobalTag, __FILE__, __LINE__);
+#else
+        operator delete(this, GlobalTag);
+#endif
+    }
+}
+
+csmInt32 CubismMoc::GetReferenceCount() const
+{
+    return _referenceCount.load(std::memory_order_relaxed);
 }
 
 CubismMoc::CubismMoc(Core::csmMoc* moc)
                         : _moc(moc)
                         , _modelCount(0)
                         , _mocVersion(0)
+                        , _mocSize(0)
+                        , _referenceCount(1)
+                        , _releaseMemory(NULL)
+                        , _releaseUserData(NULL)
 { }
 
 CubismMoc::~CubismMoc()
 {
     CSM_ASSERT(_modelCount == 0);
 
-    CSM_FREE_ALLIGNED(_moc);
+    if (_releaseMemory != NULL)
+    {
+        _releaseMemory(_moc, _mocSize, _releaseUserData);
+    }
+    else
+    {
+        CSM_FREE_ALLIGNED(_moc);
+    }
 }
 
 CubismModel* CubismMoc::CreateModel()
@@ -96,6 +166,16 @@ Core::csmMocVersion CubismMoc::GetMocVersion()
     return _mocVersion;
 }
 
+csmUint32 CubismMoc::GetMocSize() const
+{
+    return _mocSize;
+}
+
+csmUint32 CubismMoc::GetModelSize() const
+{
+    return Core::csmGetSizeofModel(_moc);
+}
+
 csmBool CubismMoc::HasMocConsistency(void* address, const csmUint32 size)
 {
     csmInt32 isConsistent = Core::csmHasMocConsistency(address, size);
@@ -104,6 +184,12 @@ csmBool CubismMoc::HasMocConsistency(void* address, const csmUint32 size)
 
 csmBool CubismMoc::HasMocConsistencyFromUnrevivedMoc(const csmByte* mocBytes, csmSizeInt size)
 {
+    // 整合性の確認はバッファを書き換えないので、揃っていればそのまま確認する
+    if ((reinterpret_cast<csmSizeType>(mocBytes) % Core::csmAlignofMoc) == 0)
+    {
+        return CubismMoc::HasMocConsistency(const_cast<csmByte*>(mocBytes), static_cast<csmUint32>(size));
+    }
+
     void* alignedBuffer = CSM_MALLOC_ALLIGNED(size, Core::csmAlignofMoc);
     memcpy(alignedBuffer, mocBytes, size);
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "CubismFramework.hpp"
+#include <atomic>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -15,28 +16,75 @@ class CubismModel;
 
 /**
  * Handles management of MOC data
+ *
+ * @note The instance is reference counted so that several models can share one MOC.
  */
 class CubismMoc
 {
     friend class CubismModel;
 public:
     /**
-     * Makes an instance.
+     * Function that releases the memory handed to CreateInPlace().
+     *
+     * @param address Address passed to CreateInPlace()
+     * @param size Size passed to CreateInPlace()
+     * @param userData Pointer passed to CreateInPlace()
+     */
+    typedef void (*ReleaseMemoryFunction)(void* address, csmSizeInt size, void* userData);
+
+    /**
+     * Makes an instance from a copy of the MOC file.
      *
      * @param mocBytes Buffer containing the loaded MOC file
      * @param size Size of the buffer in bytes
      *
      * @return Created instance
+     *
+     * @note The buffer is copied, so the caller may release it right away.
      */
     static CubismMoc* Create(const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
 
     /**
-     * Destroys an instance.
+     * Makes an instance that revives the MOC file where it lies, without copying it.
+     *
+     * @param mocMemory Memory containing the MOC file, such as a private writable memory mapping of the file.<br>
+     *                  The address must be aligned to 'csmAlignofMoc'. The MOC is revived in place, so the memory is written to.
+     * @param size Size of the MOC file in bytes
+     * @param releaseMemory Function called with the memory when the instance is destroyed; NULL to keep the memory
+     * @param userData Pointer passed to releaseMemory
      *
-     * @param moc `CubismMoc` instance to be destroyed
+     * @return Created instance; NULL on failure
+     *
+     * @note On success the instance owns the memory, which must stay valid until releaseMemory is called.<br>
+     *       On failure the memory is left untouched by the release function and stays owned by the caller.
+     */
+    static CubismMoc* CreateInPlace(void* mocMemory, csmSizeInt size, ReleaseMemoryFunction releaseMemory, void* userData,
+                                    csmBool shouldCheckMocConsistency = false);
+
+    /**
+     * Releases a reference to an instance.
+     *
+     * @param moc `CubismMoc` instance to be destroyed when no reference remains
      */
     static void Delete(CubismMoc* moc);
 
+    /**
+     * Adds a reference.
+     */
+    void Retain();
+
+    /**
+     * Removes a reference and destroys the instance when none remain.
+     */
+    void Release();
+
+    /**
+     * Returns the number of references.
+     *
+     * @return Number of references
+     */
+    csmInt32 GetReferenceCount() const;
+
     /**
      * Makes a model instance.
      *
@@ -65,6 +113,20 @@ public:
      */
     Core::csmMocVersion GetMocVersion();
 
+    /**
+     * Returns the size of the MOC buffer.
+     *
+     * @return Size in bytes
+     */
+    csmUint32 GetMocSize() const;
+
+    /**
+     * Returns the size of the buffer of a model made from the MOC.
+     *
+     * @return Size in bytes
+     */
+    csmUint32 GetModelSize() const;
+
     /**
      * Checks the consistency of the MOC file.
      *
@@ -90,9 +152,24 @@ private:
 
     virtual ~CubismMoc();
 
+    /**
+     * Revives the MOC file in aligned memory.
+     *
+     * @param alignedMemory Memory containing the MOC file, aligned to 'csmAlignofMoc'
+     * @param size Size of the MOC file in bytes
+     * @param shouldCheckMocConsistency Flag to check the consistency before reviving
+     *
+     * @return Created instance; NULL on failure, leaving the memory to the caller
+     */
+    static CubismMoc* Revive(void* alignedMemory, csmSizeInt size, csmBool shouldCheckMocConsistency);
+
     Core::csmMoc*     _moc;
-    csmInt32          _modelCount;
+    std::atomic<csmInt32> _modelCount;          ///< このMOCから作成されたモデルの数
     csmUint32         _mocVersion;
+    csmUint32         _mocSize;
+    std::atomic<csmInt32> _referenceCount;      ///< 参照数
+    ReleaseMemoryFunction _releaseMemory;       ///< MOCのメモリを解放する関数。NULLならフレームワークで確保したメモリ
+    void*             _releaseUserData;         ///< _releaseMemoryに渡すデータ
 };
 
 }}}
@@ -0,0 +1,375 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMocCache.hpp"
+#include <string.h>
+#include "Utils/CubismPoolAllocator.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismMocCache::CubismMocCache()
+{ }
+
+CubismMocCache::~CubismMocCache()
+{
+    Clear();
+}
+
+CubismMoc* CubismMocCache::Acquire(const csmChar* filePath, const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency, csmBool* outIsRevived)
+{
+    if (outIsRevived != NULL)
+    {
+        *outIsRevived = false;
+    }
+
+    if (mocBytes == NULL)
+    {
+        return NULL;
+    }
+
+    // キャッシュするデータは他のモデルも使うので、呼び出し元のモデルのアリーナからは割り当てない
+    CubismPoolAllocator::ArenaScope arenaScope(NULL);
+
+    const CubismContentHash hash = CubismContentHash::Compute(mocBytes, size);
+    csmBool isConsistencyChecked = false;
+    CubismMoc* moc = NULL;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        moc = AcquireCachedMoc(filePath, hash, size, &isConsistencyChecked);
+    }
+
+    if (moc != NULL)
+    {
+        // 確認せずに復元されていたMOCは、復元前のバイト列で一度だけ確認する
+        if (shouldCheckMocConsistency && !isConsistencyChecked)
+        {
+            if (!CubismMoc::HasMocConsistencyFromUnrevivedMoc(mocBytes, size))
+            {
+                CubismLogError("Inconsistent MOC3.");
+                moc->Release();
+                return NULL;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            MarkConsistencyChecked(moc);
+        }
+
+        return moc;
+    }
+
+    // 復元はロックの外で行い、別スレッドからの要求を止めない
+    moc = CubismMoc::Create(mocBytes, size, shouldCheckMocConsistency);
+
+    if (moc == NULL)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    CubismMoc* addedMoc = AddEntry(filePath, hash, size, moc, shouldCheckMocConsistency);
+
+    // 復元中に他のスレッドが登録していれば、復元したのはそちら
+    if (outIsRevived != NULL)
+    {
+        *outIsRevived = (addedMoc == moc);
+    }
+
+    return addedMoc;
+}
+
+CubismMoc* CubismMocCache::AcquireInPlace(const csmChar* filePath, void* mocMemory, csmSizeInt size,
+                                          CubismMoc::ReleaseMemoryFunction releaseMemory, void* userData, csmBool shouldCheckMocConsistency)
+{
+    if (mocMemory == NULL)
+    {
+        return NULL;
+    }
+
+    // キャッシュするデータは他のモデルも使うので、呼び出し元のモデルのアリーナからは割り当てない
+    CubismPoolAllocator::ArenaScope arenaScope(NULL);
+
+    // 復元でメモリが書き換わるので、ハッシュは先に求める
+    const CubismContentHash hash = CubismContentHash::Compute(static_cast<const csmByte*>(mocMemory), size);
+    csmBool isConsistencyChecked = false;
+    CubismMoc* moc = NULL;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        moc = AcquireCachedMoc(filePath, hash, size, &isConsistencyChecked);
+    }
+
+    if (moc != NULL)
+    {
+        if (shouldCheckMocConsistency && !isConsistencyChecked)
+        {
+            if (!CubismMoc::HasMocConsistencyFromUnrevivedMoc(static_cast<const csmByte*>(mocMemory), size))
+            {
+                CubismLogError("Inconsistent MOC3.");
+                moc->Release();
+                return NULL;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            MarkConsistencyChecked(moc);
+        }
+
+        // 共有するMOCがあるので、渡されたメモリは不要
+        if (releaseMemory != NULL)
+        {
+            releaseMemory(mocMemory, size, userData);
+        }
+
+        return moc;
+    }
+
+    moc = CubismMoc::CreateInPlace(mocMemory, size, releaseMemory, userData, shouldCheckMocConsistency);
+
+    if (moc == NULL)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return AddEntry(filePath, hash, size, moc, shouldCheckMocConsistency);
+}
+
+CubismMoc* CubismMocCache::Find(const csmChar* filePath, csmBool shouldCheckMocConsistency)
+{
+    if (filePath == NULL)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const csmInt32 index = FindEntryIndex(filePath);
+
+    if (index < 0 || (shouldCheckMocConsistency && !_entries[index]->IsConsistencyChecked))
+    {
+        return NULL;
+    }
+
+    _entries[index]->Moc->Retain();
+
+    return _entries[index]->Moc;
+}
+
+void CubismMocCache::Release(CubismMoc* moc)
+{
+    if (moc == NULL)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    csmInt32 entryCount = 0;
+    for (csmUint32 i = 0; i < _entries.GetSize(); ++i)
+    {
+        if (_entries[i]->Moc == moc)
+        {
+            ++entryCount;
+        }
+    }
+
+    // キャッシュに無いMOCは参照を外すだけ
+    if (entryCount == 0)
+    {
+        moc->Release();
+        return;
+    }
+
+    moc->Release();
+
+    // 残りの参照がキャッシュだけになったら、エントリごと解放する
+    if (moc->GetReferenceCount() > entryCount)
+    {
+        return;
+    }
+
+    for (csmInt32 i = static_cast<csmInt32>(_entries.GetSize()) - 1; i >= 0; --i)
+    {
+        if (_entries[i]->Moc == moc)
+        {
+            RemoveEntry(i);
+        }
+    }
+}
+
+csmInt32 CubismMocCache::Purge()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    csmInt32 removedCount = 0;
+
+    // 同じMOCを共有するエントリがあるので、参照数はエントリの数と比べる
+    for (csmInt32 i = static_cast<csmInt32>(_entries.GetSize()) - 1; i >= 0; --i)
+    {
+        csmInt32 entryCount = 0;
+        for (csmUint32 j = 0; j < _entries.GetSize(); ++j)
+        {
+            if (_entries[j]->Moc == _entries[i]->Moc)
+            {
+                ++entryCount;
+            }
+        }
+
+        if (_entries[i]->Moc->GetReferenceCount() > entryCount)
+        {
+            continue;
+        }
+
+        RemoveEntry(i);
+        ++removedCount;
+    }
+
+    return removedCount;
+}
+
+void CubismMocCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (csmInt32 i = static_cast<csmInt32>(_entries.GetSize()) - 1; i >= 0; --i)
+    {
+        RemoveEntry(i);
+    }
+}
+
+csmInt32 CubismMocCache::GetSize()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return static_cast<csmInt32>(_entries.GetSize());
+}
+
+csmInt32 CubismMocCache::FindEntryIndex(const csmChar* filePath) const
+{
+    if (filePath == NULL)
+    {
+        return -1;
+    }
+
+    for (csmUint32 i = 0; i < _entries.GetSize(); ++i)
+    {
+        if (strcmp(_entries[i]->FilePath.GetRawString(), filePath) == 0)
+        {
+            return static_cast<csmInt32>(i);
+        }
+    }
+
+    return -1;
+}
+
+CubismMoc* CubismMocCache::AcquireCachedMoc(const csmChar* filePath, const CubismContentHash& hash, csmSizeInt size, csmBool* outIsConsistencyChecked)
+{
+    const csmInt32 index = FindEntryIndex(filePath);
+
+    if (index >= 0)
+    {
+        if (IsSameContent(_entries[index], hash, size))
+        {
+            *outIsConsistencyChecked = _entries[index]->IsConsistencyChecked;
+            _entries[index]->Moc->Retain();
+            return _entries[index]->Moc;
+        }
+
+        // 内容が変わっているので作り直す
+        RemoveEntry(index);
+    }
+
+    // 別パス、またはパスなしで同一内容のMOCがあれば共有する
+    for (csmUint32 i = 0; i < _entries.GetSize(); ++i)
+    {
+        if (!IsSameContent(_entries[i], hash, size))
+        {
+            continue;
+        }
+
+        CubismMoc* moc = _entries[i]->Moc;
+        *outIsConsistencyChecked = _entries[i]->IsConsistencyChecked;
+
+        if (filePath != NULL)
+        {
+            Entry* entry = CSM_NEW Entry();
+            entry->FilePath = filePath;
+            entry->Hash = hash;
+            entry->Size = size;
+            entry->Moc = moc;
+            entry->IsConsistencyChecked = _entries[i]->IsConsistencyChecked;
+            _entries.PushBack(entry, false);
+
+            moc->Retain();  // キャッシュの参照
+        }
+
+        moc->Retain();      // 呼び出し元の参照
+
+        return moc;
+    }
+
+    return NULL;
+}
+
+CubismMoc* CubismMocCache::AddEntry(const csmChar* filePath, const CubismContentHash& hash, csmSizeInt size, CubismMoc* moc, csmBool isConsistencyChecked)
+{
+    // 復元中に他のスレッドが登録していればそちらを使う
+    csmBool cachedIsConsistencyChecked = false;
+    CubismMoc* cachedMoc = AcquireCachedMoc(filePath, hash, size, &cachedIsConsistencyChecked);
+
+    if (cachedMoc != NULL)
+    {
+        if (isConsistencyChecked && !cachedIsConsistencyChecked)
+        {
+            MarkConsistencyChecked(cachedMoc);
+        }
+
+        moc->Release();
+        return cachedMoc;
+    }
+
+    Entry* entry = CSM_NEW Entry();
+    entry->FilePath = (filePath != NULL) ? filePath : "";
+    entry->Hash = hash;
+    entry->Size = size;
+    entry->Moc = moc;
+    entry->IsConsistencyChecked = isConsistencyChecked;
+    _entries.PushBack(entry, false);
+
+    // 呼び出し元の参照
+    moc->Retain();
+
+    return moc;
+}
+
+void CubismMocCache::MarkConsistencyChecked(CubismMoc* moc)
+{
+    for (csmUint32 i = 0; i < _entries.GetSize(); ++i)
+    {
+        if (_entries[i]->Moc == moc)
+        {
+            _entries[i]->IsConsistencyChecked = true;
+        }
+    }
+}
+
+void CubismMocCache::RemoveEntry(csmInt32 index)
+{
+    _entries[index]->Moc->Release();
+    CSM_DELETE(_entries[index]);
+    _entries.Remove(index);
+}
+
+csmBool CubismMocCache::IsSameContent(const Entry* entry, const CubismContentHash& hash, csmSizeInt size)
+{
+    // 内容は保持しないので、大きさと128ビットのハッシュで同一とみなす
+    return entry->Size == size && entry->Hash == hash;
+}
+
+}}}
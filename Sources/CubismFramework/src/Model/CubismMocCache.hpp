@@ -0,0 +1,144 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "CubismMoc.hpp"
+#include "Type/csmString.hpp"
+#include "Type/csmVector.hpp"
+#include "Utils/CubismContentHash.hpp"
+#include <mutex>
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Shares revived MOC data between models.
+ *
+ * @note Entries are keyed by file path, size and 128-bit content hash. Identical content under another path, or loaded<br>
+ *       without a path, is shared, so the consistency check and the revival run once per unique MOC.<br>
+ *       The cache keeps no copy of the file: only the revived MOC stays in memory.<br>
+ *       All methods are thread-safe. Reviving runs outside the lock.
+ */
+class CubismMocCache
+{
+public:
+    /**
+     * Constructor
+     */
+    CubismMocCache();
+
+    /**
+     * Destructor
+     *
+     * @note Releases the references held by the cache. MOCs still used by models stay alive.
+     */
+    virtual ~CubismMocCache();
+
+    /**
+     * Returns the MOC for the file, reviving a copy of the buffer on the first request.
+     *
+     * @param filePath path of the MOC file used as the cache key; NULL to key by content only
+     * @param mocBytes buffer containing the loaded MOC file
+     * @param size size of the buffer in bytes
+     * @param shouldCheckMocConsistency flag to check the consistency of the MOC file
+     * @param outIsRevived receives true if this call revived the MOC, false if it was already cached; may be NULL
+     *
+     * @return MOC with a reference added for the caller; NULL on failure
+     *
+     * @note The buffer is not kept, so the caller may release it right away.<br>
+     *       Release the returned MOC with Release() to drop the entry with its last user, or with CubismMoc::Release().
+     */
+    CubismMoc* Acquire(const csmChar* filePath, const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency = false, csmBool* outIsRevived = NULL);
+
+    /**
+     * Returns the MOC for the file, reviving it in the given memory on the first request.
+     *
+     * @param filePath path of the MOC file used as the cache key; NULL to key by content only
+     * @param mocMemory memory containing the MOC file, as for CubismMoc::CreateInPlace()
+     * @param size size of the MOC file in bytes
+     * @param releaseMemory function that releases the memory
+     * @param userData pointer passed to releaseMemory
+     * @param shouldCheckMocConsistency flag to check the consistency of the MOC file
+     *
+     * @return MOC with a reference added for the caller; NULL on failure
+     *
+     * @note On success the cache owns the memory. When the MOC is already cached the memory is released right away.<br>
+     *       On failure the memory stays owned by the caller.
+     */
+    CubismMoc* AcquireInPlace(const csmChar* filePath, void* mocMemory, csmSizeInt size,
+                              CubismMoc::ReleaseMemoryFunction releaseMemory, void* userData, csmBool shouldCheckMocConsistency = false);
+
+    /**
+     * Returns the cached MOC for the file without reading it.
+     *
+     * @param filePath path of the MOC file
+     * @param shouldCheckMocConsistency true to return only a MOC whose consistency was checked
+     *
+     * @return MOC with a reference added for the caller; NULL if not cached
+     */
+    CubismMoc* Find(const csmChar* filePath, csmBool shouldCheckMocConsistency = false);
+
+    /**
+     * Releases a reference to a MOC and removes its entries if only the cache still uses it.
+     *
+     * @param moc MOC returned by the cache, or any other MOC; NULL does nothing
+     */
+    void Release(CubismMoc* moc);
+
+    /**
+     * Removes the entries whose MOC is used only by the cache.
+     *
+     * @return number of removed entries
+     */
+    csmInt32 Purge();
+
+    /**
+     * Removes all entries.
+     */
+    void Clear();
+
+    /**
+     * Returns the number of cached entries.
+     *
+     * @return number of entries
+     */
+    csmInt32 GetSize();
+
+private:
+    /**
+     * Cache entry
+     */
+    struct Entry
+    {
+        csmString FilePath;                 ///< Path of the MOC file. Empty for content-only entries.
+        CubismContentHash Hash;             ///< Content hash of the MOC file before revival
+        csmSizeInt Size;                    ///< Size of the MOC file in bytes
+        CubismMoc* Moc;                     ///< Shared MOC. The cache owns one reference.
+        csmBool IsConsistencyChecked;       ///< True once the consistency of the MOC file has been checked
+    };
+
+    CubismMocCache(const CubismMocCache&);
+    CubismMocCache& operator=(const CubismMocCache&);
+
+    csmInt32 FindEntryIndex(const csmChar* filePath) const;
+
+    CubismMoc* AcquireCachedMoc(const csmChar* filePath, const CubismContentHash& hash, csmSizeInt size, csmBool* outIsConsistencyChecked);
+
+    CubismMoc* AddEntry(const csmChar* filePath, const CubismContentHash& hash, csmSizeInt size, CubismMoc* moc, csmBool isConsistencyChecked);
+
+    void MarkConsistencyChecked(CubismMoc* moc);
+
+    void RemoveEntry(csmInt32 index);
+
+    static csmBool IsSameContent(const Entry* entry, const CubismContentHash& hash, csmSizeInt size);
+
+    csmVector<Entry*> _entries;
+    std::mutex _mutex;
+};
+
+}}}
@@ -10,9 +10,15 @@
 #include "Id/CubismId.hpp"
 #include "Id/CubismIdManager.hpp"
 #include "Math/CubismMath.hpp"
+#include "Utils/CubismProfiler.hpp"
+#include <string.h>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+namespace {
+const csmFloat32 DefaultUpdateTolerance = 0.0001f;    ///< UpdateIfChanged() の許容値の初期値
+}
+
 static csmInt32 IsBitSet(const csmUint8 byte, const csmUint8 mask)
 {
     return ((byte & mask) == mask);
@@ -29,10 +35,17 @@ CubismModel::CubismModel(Core::csmModel* model)
     , _isOverriddenModelScreenColors(false)
     , _isOverriddenCullings(false)
     , _modelOpacity(1.0f)
+    , _updatedValues(NULL)
+    , _updateCount(0)
+    , _isSleeping(false)
+    , _updateTolerance(DefaultUpdateTolerance)
+    , _sleepStateChangedHandler(NULL)
+    , _sleepStateChangedUserData(NULL)
 { }
 
 CubismModel::~CubismModel()
 {
+    CSM_FREE(_updatedValues);
     CSM_FREE_ALLIGNED(_model);
 }
 
@@ -73,11 +86,130 @@ void CubismModel::MultiplyParameterValue(csmInt32 parameterIndex, csmFloat32 val
 
 void CubismModel::Update() const
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_ModelUpdate);
+
     // Update model.
     Core::csmUpdateModel(_model);
 
     // Reset dynamic drawable flags.
     Core::csmResetDrawableDynamicFlags(_model);
+
+    // UpdateIfChanged() が比較する値を記録する
+    const csmInt32 parameterCount = Core::csmGetParameterCount(_model);
+    const csmInt32 partCount = Core::csmGetPartCount(_model);
+    memcpy(_updatedValues, _parameterValues, sizeof(csmFloat32) * parameterCount);
+    memcpy(_updatedValues + parameterCount, _partOpacities, sizeof(csmFloat32) * partCount);
+
+    ++_updateCount;
+    SetSleeping(false);
+}
+
+csmBool CubismModel::UpdateIfChanged()
+{
+    // 一度も更新していなければ比較する値がない
+    if (_updateCount > 0 && !HasChangedSinceUpdate())
+    {
+        SetSleeping(true);
+        return false;
+    }
+
+    Update();
+    return true;
+}
+
+void CubismModel::EvaluatePose() const
+{
+    Core::csmUpdateModel(_model);
+    Core::csmResetDrawableDynamicFlags(_model);
+}
+
+void CubismModel::RestoreUpdatedPose() const
+{
+    // 一度も更新していなければ戻す姿勢がない
+    if (_updateCount == 0)
+    {
+        EvaluatePose();
+        return;
+    }
+
+    // 前回の更新時の値で評価し直してから、現在の値に戻す
+    const csmInt32 parameterCount = Core::csmGetParameterCount(_model);
+    const csmInt32 partCount = Core::csmGetPartCount(_model);
+    csmVector<csmFloat32> currentValues(parameterCount + partCount);
+    currentValues.Resize(parameterCount + partCount);
+    memcpy(currentValues.GetPtr(), _parameterValues, sizeof(csmFloat32) * parameterCount);
+    memcpy(currentValues.GetPtr() + parameterCount, _partOpacities, sizeof(csmFloat32) * partCount);
+
+    memcpy(_parameterValues, _updatedValues, sizeof(csmFloat32) * parameterCount);
+    memcpy(_partOpacities, _updatedValues + parameterCount, sizeof(csmFloat32) * partCount);
+    EvaluatePose();
+
+    memcpy(_parameterValues, currentValues.GetPtr(), sizeof(csmFloat32) * parameterCount);
+    memcpy(_partOpacities, currentValues.GetPtr() + parameterCount, sizeof(csmFloat32) * partCount);
+}
+
+void CubismModel::SetUpdateTolerance(csmFloat32 tolerance)
+{
+    _updateTolerance = (tolerance > 0.0f) ? tolerance : 0.0f;
+}
+
+csmBool CubismModel::IsSleeping() const
+{
+    return _isSleeping;
+}
+
+csmUint32 CubismModel::GetUpdateCount() const
+{
+    return _updateCount;
+}
+
+void CubismModel::SetSleepStateChangedHandler(SleepStateChangedFunction handler, void* userData)
+{
+    _sleepStateChangedHandler = handler;
+    _sleepStateChangedUserData = userData;
+}
+
+csmBool CubismModel::HasChangedSinceUpdate() const
+{
+    const csmInt32 parameterCount = Core::csmGetParameterCount(_model);
+    const csmInt32 partCount = Core::csmGetPartCount(_model);
+
+    // 許容値はパラメータごとの範囲に対する割合
+    for (csmInt32 i = 0; i < parameterCount; ++i)
+    {
+        const csmFloat32 tolerance = _updateTolerance * (_parameterMaximumValues[i] - _parameterMinimumValues[i]);
+
+        if (CubismMath::AbsF(_parameterValues[i] - _updatedValues[i]) > tolerance)
+        {
+            return true;
+        }
+    }
+
+    const csmFloat32* updatedOpacities = _updatedValues + parameterCount;
+    for (csmInt32 i = 0; i < partCount; ++i)
+    {
+        if (CubismMath::AbsF(_partOpacities[i] - updatedOpacities[i]) > _updateTolerance)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CubismModel::SetSleeping(csmBool isSleeping) const
+{
+    if (_isSleeping == isSleeping)
+    {
+        return;
+    }
+
+    _isSleeping = isSleeping;
+
+    if (_sleepStateChangedHandler != NULL)
+    {
+        _sleepStateChangedHandler(const_cast<CubismModel*>(this), isSleeping, _sleepStateChangedUserData);
+    }
 }
 
 void CubismModel::SetPartOpacity(CubismIdHandle partId, csmFloat32 opacity)
@@ -466,6 +598,11 @@ void CubismModel::Initialize()
     _parameterMaximumValues = Core::csmGetParameterMaximumValues(_model);
     _parameterMinimumValues = Core::csmGetParameterMinimumValues(_model);
 
+    {
+        const csmInt32 valueCount = Core::csmGetParameterCount(_model) + Core::csmGetPartCount(_model);
+        _updatedValues = static_cast<csmFloat32*>(CSM_MALLOC(sizeof(csmFloat32) * (valueCount > 0 ? valueCount : 1)));
+    }
+
     {
         const csmChar** parameterIds = Core::csmGetParameterIds(_model);
         const csmInt32  parameterCount = Core::csmGetParameterCount(_model);
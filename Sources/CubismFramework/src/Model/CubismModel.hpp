@@ -24,6 +24,15 @@ class CubismModel
 {
     friend class CubismMoc;
 public:
+    /**
+     * Function called when the model falls asleep or wakes up in UpdateIfChanged()
+     *
+     * @param model model whose state changed
+     * @param isSleeping true when the model fell asleep; false when it woke up
+     * @param userData pointer passed to SetSleepStateChangedHandler()
+     */
+    typedef void (*SleepStateChangedFunction)(CubismModel* model, csmBool isSleeping, void* userData);
+
     /**
      * Structure for color information of drawing object
      */
@@ -158,6 +167,62 @@ public:
      */
     void    Update() const;
 
+    /**
+     * Updates the model only if the parameters or part opacities moved since the last update.
+     *
+     * @return true if the model was updated; false if the update was skipped
+     *
+     * @note Values within the update tolerance of the last update count as unchanged, so settling physics<br>
+     *       and finished motions let the model sleep. A skipped update keeps the drawables of the last update.
+     */
+    csmBool UpdateIfChanged();
+
+    /**
+     * Evaluates the drawables for the set parameters without counting it as an update.
+     *
+     * @note Used to sample poses, such as by CubismParameterInfluenceMap. The model does not wake up and renderers<br>
+     *       do not upload the sampled vertices. Call RestoreUpdatedPose() afterwards.
+     */
+    void    EvaluatePose() const;
+
+    /**
+     * Evaluates the drawables again for the parameter values and part opacities of the last update.
+     *
+     * @note The set parameter values and part opacities are kept.
+     */
+    void    RestoreUpdatedPose() const;
+
+    /**
+     * Sets the tolerance used by UpdateIfChanged().
+     *
+     * @param tolerance largest change ignored, as a fraction of each parameter range and of the part opacity; 0 to update on any change
+     */
+    void    SetUpdateTolerance(csmFloat32 tolerance);
+
+    /**
+     * Returns whether the last call of UpdateIfChanged() skipped the update.
+     *
+     * @return true if the model is sleeping
+     */
+    csmBool IsSleeping() const;
+
+    /**
+     * Returns the number of times the model has been updated.
+     *
+     * @return update count
+     *
+     * @note Renderers compare the count with the one of their last upload to skip unchanged vertices.
+     */
+    csmUint32 GetUpdateCount() const;
+
+    /**
+     * Sets the function called when the model falls asleep or wakes up.
+     *
+     * @param handler function to call; NULL to remove
+     * @param userData pointer passed to the function
+     */
+    void    SetSleepStateChangedHandler(SleepStateChangedFunction handler, void* userData);
+
     /**
      * Returns the width of the canvas.
      *
@@ -1121,6 +1186,10 @@ private:
 
     void Initialize();
 
+    csmBool HasChangedSinceUpdate() const;
+
+    void SetSleeping(csmBool isSleeping) const;
+
     void SetPartColor(
         csmUint32 partIndex,
         csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a,
@@ -1165,6 +1234,14 @@ private:
     csmBool _isOverriddenModelMultiplyColors;
     csmBool _isOverriddenModelScreenColors;
     csmBool _isOverriddenCullings;
+
+    // UpdateIfChanged() 用の状態。Update() から更新するので mutable にする
+    csmFloat32* _updatedValues;                         ///< Parameter values followed by part opacities at the last update
+    mutable csmUint32 _updateCount;                     ///< Number of updates
+    mutable csmBool _isSleeping;                        ///< True while UpdateIfChanged() skips updates
+    csmFloat32 _updateTolerance;                        ///< Tolerance of UpdateIfChanged()
+    SleepStateChangedFunction _sleepStateChangedHandler;
+    void* _sleepStateChangedUserData;
 };
 
 }}}
@@ -56,6 +56,7 @@ void CubismModelUserData::ParseUserData(const csmByte* buffer, const csmSizeInt
     const ModelUserDataType typeOfArtMesh = CubismFramework::GetIdManager()->GetId(ArtMesh);
 
     const csmUint32 nodeCount = json->GetUserDataCount();
+    _userDataNodes.PrepareCapacity(nodeCount);
 
     for (csmUint32 i = 0; i < nodeCount; i++)
     {
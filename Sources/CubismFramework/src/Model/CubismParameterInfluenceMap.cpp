@@ -0,0 +1,296 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismParameterInfluenceMap.hpp"
+#include "CubismFramework.hpp"
+#include "Math/CubismMath.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+const csmFloat32 Epsilon = 0.0001f;
+const csmInt32 SampleCount = 3;
+
+}
+
+CubismParameterInfluenceMap* CubismParameterInfluenceMap::Create(CubismModel* model, csmBool isMeasured)
+{
+    CubismParameterInfluenceMap* ret = CSM_NEW CubismParameterInfluenceMap();
+
+    ret->MeasureDefaultPose(model);
+
+    if (isMeasured)
+    {
+        ret->MeasureStep(model, 0);
+    }
+
+    return ret;
+}
+
+void CubismParameterInfluenceMap::Delete(CubismParameterInfluenceMap* influenceMap)
+{
+    CSM_DELETE_SELF(CubismParameterInfluenceMap, influenceMap);
+}
+
+CubismParameterInfluenceMap::CubismParameterInfluenceMap()
+    : _measuredParameterCount(0)
+{ }
+
+CubismParameterInfluenceMap::~CubismParameterInfluenceMap()
+{ }
+
+void CubismParameterInfluenceMap::MeasureDefaultPose(CubismModel* model)
+{
+    const csmInt32 parameterCount = model->GetParameterCount();
+    const csmInt32 drawableCount = model->GetDrawableCount();
+
+    // 計測後に戻すため現在の値を退避し、全パラメータをデフォルト値にする
+    csmVector<csmFloat32> savedValues(parameterCount);
+    for (csmInt32 i = 0; i < parameterCount; ++i)
+    {
+        savedValues.PushBack(model->GetParameterValue(i));
+        model->SetParameterValue(i, model->GetParameterDefaultValue(i));
+    }
+    model->EvaluatePose();
+
+    // 基準となる頂点位置と不透明度を記録する
+    _vertexOffsets.Clear();
+    csmInt32 vertexCount = 0;
+    for (csmInt32 d = 0; d < drawableCount; ++d)
+    {
+        _vertexOffsets.PushBack(vertexCount);
+        vertexCount += model->GetDrawableVertexCount(d);
+    }
+    _vertexOffsets.PushBack(vertexCount);
+
+    _basePositions.Clear();
+    _basePositions.PrepareCapacity(vertexCount);
+    _baseOpacities.Clear();
+    _baseOpacities.PrepareCapacity(drawableCount);
+    _drawableSizes.Clear();
+
+    for (csmInt32 d = 0; d < drawableCount; ++d)
+    {
+        const Core::csmVector2* positions = model->GetDrawableVertexPositions(d);
+        const csmInt32 count = model->GetDrawableVertexCount(d);
+        csmFloat32 left = 0.0f, right = 0.0f, bottom = 0.0f, top = 0.0f;
+
+        for (csmInt32 v = 0; v < count; ++v)
+        {
+            _basePositions.PushBack(positions[v]);
+
+            if (v == 0 || positions[v].X < left) left = positions[v].X;
+            if (v == 0 || positions[v].X > right) right = positions[v].X;
+            if (v == 0 || positions[v].Y < bottom) bottom = positions[v].Y;
+            if (v == 0 || positions[v].Y > top) top = positions[v].Y;
+        }
+
+        _baseOpacities.PushBack(model->GetDrawableOpacity(d));
+        _drawableSizes.PushBack(CubismMath::Max(right - left, top - bottom));
+    }
+
+    _influenceOffsets.Clear();
+    _influencedDrawables.Clear();
+    _pinnedParameters.Clear();
+    _pinnedParameters.Resize(parameterCount, false);
+    _measuredParameterCount = 0;
+
+    // パラメータを計測前の状態に戻す。更新回数やスリープ状態は変えない
+    for (csmInt32 i = 0; i < parameterCount; ++i)
+    {
+        model->SetParameterValue(i, savedValues[i]);
+    }
+    model->RestoreUpdatedPose();
+}
+
+csmBool CubismParameterInfluenceMap::MeasureStep(CubismModel* model, csmInt32 parameterCount)
+{
+    if (IsMeasured())
+    {
+        return true;
+    }
+
+    const csmInt32 totalParameterCount = model->GetParameterCount();
+    const csmInt32 drawableCount = model->GetDrawableCount();
+    const csmInt32 endParameter = (parameterCount > 0 && _measuredParameterCount + parameterCount < totalParameterCount)
+                                      ? _measuredParameterCount + parameterCount
+                                      : totalParameterCount;
+
+    // 計測後に戻すため現在の値を退避し、全パラメータをデフォルト値にする
+    csmVector<csmFloat32> savedValues(totalParameterCount);
+    for (csmInt32 i = 0; i < totalParameterCount; ++i)
+    {
+        savedValues.PushBack(model->GetParameterValue(i));
+        model->SetParameterValue(i, model->GetParameterDefaultValue(i));
+    }
+
+    // パラメータごとに最小値・中間値・最大値を与え、基準から変化したDrawableを記録する
+    csmVector<csmBool> influenced;
+    influenced.Resize(drawableCount, false);
+
+    for (csmInt32 p = _measuredParameterCount; p < endParameter; ++p)
+    {
+        _influenceOffsets.PushBack(static_cast<csmInt32>(_influencedDrawables.GetSize()));
+
+        const csmFloat32 defaultValue = model->GetParameterDefaultValue(p);
+        const csmFloat32 minimumValue = model->GetParameterMinimumValue(p);
+        const csmFloat32 maximumValue = model->GetParameterMaximumValue(p);
+        const csmFloat32 samples[SampleCount] = { minimumValue, (minimumValue + maximumValue) * 0.5f, maximumValue };
+
+        for (csmInt32 d = 0; d < drawableCount; ++d)
+        {
+            influenced[d] = false;
+        }
+
+        for (csmInt32 s = 0; s < SampleCount; ++s)
+        {
+            if (CubismMath::AbsF(samples[s] - defaultValue) < Epsilon)
+            {
+                continue;
+            }
+
+            model->SetParameterValue(p, samples[s]);
+            model->EvaluatePose();
+
+            for (csmInt32 d = 0; d < drawableCount; ++d)
+            {
+                if (influenced[d])
+                {
+                    continue;
+                }
+
+                if (CubismMath::AbsF(model->GetDrawableOpacity(d) - _baseOpacities[d]) > Epsilon)
+                {
+                    influenced[d] = true;
+                    continue;
+                }
+
+                const Core::csmVector2* positions = model->GetDrawableVertexPositions(d);
+                for (csmInt32 v = 0, base = _vertexOffsets[d]; base + v < _vertexOffsets[d + 1]; ++v)
+                {
+                    if (CubismMath::AbsF(positions[v].X - _basePositions[base + v].X) > Epsilon ||
+                        CubismMath::AbsF(positions[v].Y - _basePositions[base + v].Y) > Epsilon)
+                    {
+                        influenced[d] = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        model->SetParameterValue(p, defaultValue);
+
+        for (csmInt32 d = 0; d < drawableCount; ++d)
+        {
+            if (influenced[d])
+            {
+                _influencedDrawables.PushBack(d);
+            }
+        }
+    }
+    _measuredParameterCount = endParameter;
+
+    if (IsMeasured())
+    {
+        // 基準の姿勢は計測にしか使わない
+        _influenceOffsets.PushBack(static_cast<csmInt32>(_influencedDrawables.GetSize()));
+        _vertexOffsets.Clear();
+        _basePositions.Clear();
+        _baseOpacities.Clear();
+    }
+
+    // パラメータを計測前の状態に戻す。更新回数やスリープ状態は変えない
+    for (csmInt32 i = 0; i < totalParameterCount; ++i)
+    {
+        model->SetParameterValue(i, savedValues[i]);
+    }
+    model->RestoreUpdatedPose();
+
+    return IsMeasured();
+}
+
+csmBool CubismParameterInfluenceMap::IsMeasured() const
+{
+    return _measuredParameterCount >= static_cast<csmInt32>(_pinnedParameters.GetSize());
+}
+
+void CubismParameterInfluenceMap::PinParameter(csmInt32 parameterIndex)
+{
+    if (parameterIndex < 0 || parameterIndex >= static_cast<csmInt32>(_pinnedParameters.GetSize()))
+    {
+        return;
+    }
+
+    _pinnedParameters[parameterIndex] = true;
+}
+
+csmInt32 CubismParameterInfluenceMap::GetInfluencedDrawableCount(csmInt32 parameterIndex) const
+{
+    if (parameterIndex < 0 || parameterIndex + 1 >= static_cast<csmInt32>(_influenceOffsets.GetSize()))
+    {
+        return 0;
+    }
+
+    return _influenceOffsets[parameterIndex + 1] - _influenceOffsets[parameterIndex];
+}
+
+const csmInt32* CubismParameterInfluenceMap::GetInfluencedDrawables(csmInt32 parameterIndex) const
+{
+    if (GetInfluencedDrawableCount(parameterIndex) == 0)
+    {
+        return NULL;
+    }
+
+    return &_influencedDrawables[_influenceOffsets[parameterIndex]];
+}
+
+csmFloat32 CubismParameterInfluenceMap::GetDrawableSize(csmInt32 drawableIndex) const
+{
+    if (drawableIndex < 0 || drawableIndex >= static_cast<csmInt32>(_drawableSizes.GetSize()))
+    {
+        return 0.0f;
+    }
+
+    return _drawableSizes[drawableIndex];
+}
+
+csmInt32 CubismParameterInfluenceMap::BuildSkippedParameters(csmFloat32 pixelsPerUnit, csmFloat32 minDrawablePixels, csmVector<csmBool>& skippedParameters) const
+{
+    const csmInt32 parameterCount = static_cast<csmInt32>(_pinnedParameters.GetSize());
+    const csmFloat32 minDrawableSize = (pixelsPerUnit > 0.0f && IsMeasured()) ? minDrawablePixels / pixelsPerUnit : 0.0f;
+    csmInt32 skippedCount = 0;
+
+    if (skippedParameters.GetSize() != static_cast<csmUint32>(parameterCount))
+    {
+        skippedParameters.Resize(parameterCount, false);
+    }
+
+    for (csmInt32 p = 0; p < parameterCount; ++p)
+    {
+        const csmInt32 count = GetInfluencedDrawableCount(p);
+        csmBool skipped = (!_pinnedParameters[p] && count > 0 && minDrawableSize > 0.0f);
+
+        for (csmInt32 i = 0; skipped && i < count; ++i)
+        {
+            if (_drawableSizes[_influencedDrawables[_influenceOffsets[p] + i]] >= minDrawableSize)
+            {
+                skipped = false;
+            }
+        }
+
+        skippedParameters[p] = skipped;
+        if (skipped)
+        {
+            ++skippedCount;
+        }
+    }
+
+    return skippedCount;
+}
+
+}}}
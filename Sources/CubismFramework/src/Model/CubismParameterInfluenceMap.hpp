@@ -0,0 +1,142 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "Model/CubismModel.hpp"
+#include "Type/csmVector.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Records which drawables each parameter of a model moves or fades.<br>
+ * The map is measured once by sweeping every parameter across its range,
+ * and is used to skip parameters whose visible effect is too small to notice.<br>
+ * Sweeping evaluates the model three times per parameter, so the measurement can be split
+ * into steps of a few parameters spread over several frames.<br>
+ * The evaluations go through CubismModel::EvaluatePose(), so they neither count as updates nor wake the model.
+ */
+class CubismParameterInfluenceMap
+{
+public:
+    /**
+     * Makes an instance of CubismParameterInfluenceMap by measuring the model.<br>
+     * The parameter values and the drawables of the last update are restored before returning.
+     *
+     * @param model Model to measure
+     * @param isMeasured true to measure every parameter now; false to only record the default pose and measure with MeasureStep()
+     *
+     * @return Maked instance of CubismParameterInfluenceMap
+     */
+    static CubismParameterInfluenceMap* Create(CubismModel* model, csmBool isMeasured = true);
+
+    /**
+     * Destroys an instance of CubismParameterInfluenceMap.
+     *
+     * @param influenceMap Instance of CubismParameterInfluenceMap to destroy
+     */
+    static void Delete(CubismParameterInfluenceMap* influenceMap);
+
+    /**
+     * Measures the next parameters.<br>
+     * The parameter values of the model are restored before returning.
+     *
+     * @param model Model given to Create()
+     * @param parameterCount Number of parameters to measure; 0 or less to measure all the remaining ones
+     *
+     * @return true if every parameter has been measured
+     */
+    csmBool MeasureStep(CubismModel* model, csmInt32 parameterCount);
+
+    /**
+     * Checks whether every parameter has been measured.
+     *
+     * @return true if the measurement is complete
+     */
+    csmBool IsMeasured() const;
+
+    /**
+     * Marks a parameter that must never be skipped, such as an input of the physics.
+     *
+     * @param parameterIndex Index of the parameter
+     */
+    void PinParameter(csmInt32 parameterIndex);
+
+    /**
+     * Returns the number of drawables influenced by the parameter.
+     *
+     * @param parameterIndex Index of the parameter
+     *
+     * @return Number of influenced drawables
+     */
+    csmInt32 GetInfluencedDrawableCount(csmInt32 parameterIndex) const;
+
+    /**
+     * Returns the indices of the drawables influenced by the parameter.
+     *
+     * @param parameterIndex Index of the parameter
+     *
+     * @return Indices of the influenced drawables
+     */
+    const csmInt32* GetInfluencedDrawables(csmInt32 parameterIndex) const;
+
+    /**
+     * Returns the larger side of the drawable bounds at the default pose.
+     *
+     * @param drawableIndex Index of the drawable
+     *
+     * @return Size of the drawable in model units
+     */
+    csmFloat32 GetDrawableSize(csmInt32 drawableIndex) const;
+
+    /**
+     * Flags the parameters whose influenced drawables are all smaller than the threshold on screen.<br>
+     * Parameters without any measured influence and pinned parameters are never flagged,
+     * as they may drive other parameters. Nothing is flagged until the measurement is complete.
+     *
+     * @param pixelsPerUnit Number of screen pixels per model unit
+     * @param minDrawablePixels Size in pixels below which a drawable is considered invisible
+     * @param skippedParameters Flags indexed by parameter index
+     *
+     * @return Number of flagged parameters
+     */
+    csmInt32 BuildSkippedParameters(csmFloat32 pixelsPerUnit, csmFloat32 minDrawablePixels, csmVector<csmBool>& skippedParameters) const;
+
+private:
+    /**
+     * Constructor
+     */
+    CubismParameterInfluenceMap();
+
+    /**
+     * Destructor
+     */
+    virtual ~CubismParameterInfluenceMap();
+
+    // Prevention of copy Constructor
+    CubismParameterInfluenceMap(const CubismParameterInfluenceMap&);
+    CubismParameterInfluenceMap& operator=(const CubismParameterInfluenceMap&);
+
+    /**
+     * Records the default pose the parameters are compared against.
+     *
+     * @param model Model to measure
+     */
+    void MeasureDefaultPose(CubismModel* model);
+
+    csmVector<csmInt32> _influenceOffsets;      ///< パラメータごとの_influencedDrawablesの開始位置（計測済みのパラメータ数+1）
+    csmVector<csmInt32> _influencedDrawables;   ///< パラメータが影響するDrawableのインデックス
+    csmVector<csmFloat32> _drawableSizes;       ///< デフォルト姿勢でのDrawableの大きさ
+    csmVector<csmBool> _pinnedParameters;       ///< 省略してはならないパラメータ
+    csmInt32 _measuredParameterCount;           ///< 計測済みのパラメータの数
+
+    csmVector<csmInt32> _vertexOffsets;         ///< Drawableごとの_basePositionsの開始位置。計測が終わると解放する
+    csmVector<Core::csmVector2> _basePositions; ///< デフォルト姿勢の頂点位置。計測が終わると解放する
+    csmVector<csmFloat32> _baseOpacities;       ///< デフォルト姿勢の不透明度。計測が終わると解放する
+};
+
+}}}
@@ -7,10 +7,22 @@
 
 #include "CubismUserModel.hpp"
 #include "Motion/CubismMotion.hpp"
+#include "Motion/CubismMotionInternal.hpp"
 #include "Physics/CubismPhysics.hpp"
+#include "Model/CubismParameterInfluenceMap.hpp"
+#include "Model/CubismMocCache.hpp"
+#include "Model/CubismHitTester.hpp"
+#include "Math/CubismMath.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+namespace {
+
+/// Parameters measured by each UpdateLod() until the parameter influence map is complete.
+const csmInt32 LodMeasureParametersPerUpdate = 8;
+
+}
+
 CubismUserModel::CubismUserModel()
     : _moc(NULL)
     , _model(NULL)
@@ -23,6 +35,7 @@ CubismUserModel::CubismUserModel()
     , _dragManager(NULL)
     , _physics(NULL)
     , _modelUserData(NULL)
+    , _hitTester(NULL)
     , _initialized(false)
     , _updating(false)
     , _opacity(1.0f)
@@ -36,8 +49,18 @@ CubismUserModel::CubismUserModel()
     , _mocConsistency(false)
     , _motionConsistency(false)
     , _debugMode(false)
+    , _lodTier(CubismMotionLodTier_Full)
+    , _parameterInfluenceMap(NULL)
+    , _lodSkippedPixelsPerUnit(0.0f)
+    , _memoryAccount(NULL)
+    , _memoryBudget(0)
+    , _isMocOwner(false)
+    , _profile(NULL)
     , _renderer(NULL)
 {
+    _memoryAccount = CubismMemoryAccount::Create();
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Other);
+
     // モーションマネージャーを作成
     // MotionQueueManagerクラスからの継承なので使い方は同じ
     _motionManager = CSM_NEW CubismMotionManager();
@@ -55,11 +78,21 @@ CubismUserModel::~CubismUserModel()
 {
     CSM_DELETE(_motionManager);
     CSM_DELETE(_expressionManager);
+    CubismHitTester::Delete(_hitTester);
     if (_moc)
     {
         _moc->DeleteModel(_model);
     }
-    CubismMoc::Delete(_moc);
+    // 最後の利用者であればキャッシュのエントリも解放する
+    CubismMocCache* mocCache = CubismFramework::GetMocCache();
+    if (mocCache != NULL)
+    {
+        mocCache->Release(_moc);
+    }
+    else
+    {
+        CubismMoc::Delete(_moc);
+    }
     CSM_DELETE(_modelMatrix);
     CubismPose::Delete(_pose);
     CubismEyeBlink::Delete(_eyeBlink);
@@ -67,8 +100,23 @@ CubismUserModel::~CubismUserModel()
     CSM_DELETE(_dragManager);
     CubismPhysics::Delete(_physics);
     CubismModelUserData::Delete(_modelUserData);
+    if (_parameterInfluenceMap)
+    {
+        CubismParameterInfluenceMap::Delete(_parameterInfluenceMap);
+    }
 
     DeleteRenderer();
+
+    if (_profile)
+    {
+        CubismProfile::Delete(_profile);
+    }
+
+    // アリーナのメモリは、他所に渡ったブロックが残っていなければここでまとめて返る
+    CubismPoolAllocator::CloseArena(_memoryAccount->GetArena());
+
+    // 生き残ったブロックが参照を持つので、アカウントはそれらが解放されるまで残る
+    _memoryAccount->Release();
 }
 
 void CubismUserModel::SetAcceleration(csmFloat32 x, csmFloat32 y, csmFloat32 z)
@@ -80,7 +128,14 @@ void CubismUserModel::SetAcceleration(csmFloat32 x, csmFloat32 y, csmFloat32 z)
 
 void CubismUserModel::LoadModel(const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency)
 {
-    _moc = CubismMoc::Create(buffer, size, shouldCheckMocConsistency);
+    {
+        // 同じ内容のMOCが既に復元されていれば共有する。メモリは最初に復元したモデルに計上される
+        CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Moc);
+        CubismMocCache* mocCache = CubismFramework::GetMocCache();
+        _isMocOwner = (mocCache == NULL);
+        _moc = (mocCache != NULL) ? mocCache->Acquire(NULL, buffer, size, shouldCheckMocConsistency, &_isMocOwner)
+                                  : CubismMoc::Create(buffer, size, shouldCheckMocConsistency);
+    }
 
     if (_moc == NULL)
     {
@@ -88,6 +143,26 @@ void CubismUserModel::LoadModel(const csmByte* buffer, csmSizeInt size, csmBool
         return;
     }
 
+    CreateModelFromMoc();
+}
+
+void CubismUserModel::LoadModel(CubismMoc* moc)
+{
+    if (moc == NULL)
+    {
+        CubismLogError("Failed to LoadModel(). The MOC is null.");
+        return;
+    }
+
+    moc->Retain();
+    _moc = moc;
+
+    CreateModelFromMoc();
+}
+
+void CubismUserModel::CreateModelFromMoc()
+{
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Model);
     _model = _moc->CreateModel();
 
     if (_model == NULL)
@@ -98,6 +173,7 @@ void CubismUserModel::LoadModel(const csmByte* buffer, csmSizeInt size, csmBool
 
     _model->SaveParameters();
     _modelMatrix = CSM_NEW CubismModelMatrix(_model->GetCanvasWidth(), _model->GetCanvasHeight());
+    _hitTester = CubismHitTester::Create(_model);
 
 }
 
@@ -109,11 +185,13 @@ ACubismMotion* CubismUserModel::LoadExpression(const csmByte* buffer, csmSizeInt
         return NULL;
     }
 
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Expression);
     return CubismExpressionMotion::Create(buffer, size);
 }
 
 void CubismUserModel::LoadPose(const csmByte* buffer, csmSizeInt size)
 {
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Pose);
     _pose = CubismPose::Create(buffer, size);
     if (!_pose)
     {
@@ -123,6 +201,7 @@ void CubismUserModel::LoadPose(const csmByte* buffer, csmSizeInt size)
 
 void CubismUserModel::LoadPhysics(const csmByte* buffer, csmSizeInt size)
 {
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Physics);
     _physics = CubismPhysics::Create(buffer, size);
     if (!_physics)
     {
@@ -138,6 +217,7 @@ void CubismUserModel::LoadUserData(const csmByte* buffer, csmSizeInt size)
         return;
     }
 
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_UserData);
     _modelUserData = CubismModelUserData::Create(buffer, size);
 }
 csmBool CubismUserModel::IsHit(CubismIdHandle drawableId, csmFloat32 pointX, csmFloat32 pointY)
@@ -149,44 +229,31 @@ csmBool CubismUserModel::IsHit(CubismIdHandle drawableId, csmFloat32 pointX, csm
         return false; // 存在しない場合はfalse
     }
 
-    const csmInt32    count = _model->GetDrawableVertexCount(drawIndex);
-    const csmFloat32* vertices = _model->GetDrawableVertices(drawIndex);
-
-    csmFloat32 left = vertices[0];
-    csmFloat32 right = vertices[0];
-    csmFloat32 top = vertices[1];
-    csmFloat32 bottom = vertices[1];
-
-    for (csmInt32 j = 1; j < count; ++j)
-    {
-        csmFloat32 x = vertices[Constant::VertexOffset + j * Constant::VertexStep];
-        csmFloat32 y = vertices[Constant::VertexOffset + j * Constant::VertexStep + 1];
-
-        if (x < left)
-        {
-            left = x; // Min x
-        }
+    const csmFloat32 tx = _modelMatrix->InvertTransformX(pointX);
+    const csmFloat32 ty = _modelMatrix->InvertTransformY(pointY);
 
-        if (x > right)
-        {
-            right = x; // Max x
-        }
+    // 矩形は頂点が動いた更新の後にだけ計算し直される
+    return _hitTester->IsHit(drawIndex, tx, ty);
+}
 
-        if (y < top)
-        {
-            top = y; // Min y
-        }
+csmBool CubismUserModel::IsHitMesh(CubismIdHandle drawableId, csmFloat32 pointX, csmFloat32 pointY)
+{
+    const csmInt32 drawIndex = _model->GetDrawableIndex(drawableId);
 
-        if (y > bottom)
-        {
-            bottom = y; // Max y
-        }
+    if (drawIndex < 0)
+    {
+        return false; // 存在しない場合はfalse
     }
 
     const csmFloat32 tx = _modelMatrix->InvertTransformX(pointX);
     const csmFloat32 ty = _modelMatrix->InvertTransformY(pointY);
 
-    return ((left <= tx) && (tx <= right) && (top <= ty) && (ty <= bottom));
+    return _hitTester->IsHitMesh(drawIndex, tx, ty);
+}
+
+CubismHitTester* CubismUserModel::GetHitTester() const
+{
+    return _hitTester;
 }
 
 ACubismMotion* CubismUserModel::LoadMotion(const csmByte* buffer, csmSizeInt size, const csmChar* name,
@@ -199,14 +266,36 @@ ACubismMotion* CubismUserModel::LoadMotion(const csmByte* buffer, csmSizeInt siz
         return NULL;
     }
 
-    ACubismMotion* motion = CubismMotion::Create(buffer, size, onFinishedMotionHandler, onBeganMotionHandler, shouldCheckMotionConsistency);
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Motion);
+    CubismMotionData* motionData = CubismMotion::CreateMotionData(buffer, size, shouldCheckMotionConsistency);
 
-    if (!motion)
+    if (!motionData)
     {
         CubismLogError("Failed to create motion from buffer in LoadMotion().");
         return NULL;
     }
 
+    ACubismMotion* motion = LoadMotion(motionData, name, onFinishedMotionHandler, onBeganMotionHandler, modelSetting, group, index);
+
+    // モーションが参照を保持する
+    motionData->Release();
+
+    return motion;
+}
+
+ACubismMotion* CubismUserModel::LoadMotion(CubismMotionData* motionData, const csmChar* name,
+                                            ACubismMotion::FinishedMotionCallback onFinishedMotionHandler, ACubismMotion::BeganMotionCallback onBeganMotionHandler,
+                                            ICubismModelSetting* modelSetting, const csmChar* group, const csmInt32 index)
+{
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Motion);
+    ACubismMotion* motion = CubismMotion::Create(motionData, onFinishedMotionHandler, onBeganMotionHandler);
+
+    if (!motion)
+    {
+        CubismLogError("Failed to create motion %s in LoadMotion().", name ? name : "");
+        return NULL;
+    }
+
     // 必要であればモーションフェード値を上書き
     if (modelSetting)
     {
@@ -277,6 +366,8 @@ void CubismUserModel::CreateRenderer(csmInt32 maskBufferCount)
     {
         DeleteRenderer();
     }
+
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Renderer);
     _renderer = Rendering::CubismRenderer::Create();
 
     _renderer->Initialize(_model, maskBufferCount);
@@ -306,4 +397,191 @@ void CubismUserModel::MotionEventFired(const csmString& eventValue)
     CubismLogInfo("%s",eventValue.GetRawString());
 }
 
+void CubismUserModel::SetLodPolicy(const CubismMotionLodPolicy& policy)
+{
+    _lodPolicy = policy;
+}
+
+const CubismMotionLodPolicy& CubismUserModel::GetLodPolicy() const
+{
+    return _lodPolicy;
+}
+
+CubismMotionLodTier CubismUserModel::UpdateLod(csmFloat32 viewPixelsPerUnit, csmBool isOnScreen)
+{
+    if (_model == NULL || _modelMatrix == NULL)
+    {
+        return _lodTier;
+    }
+
+    // モデル行列の拡大率から画面上の大きさを求める
+    const csmFloat32 modelScale = CubismMath::Max(CubismMath::AbsF(_modelMatrix->GetScaleX()), CubismMath::AbsF(_modelMatrix->GetScaleY()));
+    const csmFloat32 pixelsPerUnit = modelScale * viewPixelsPerUnit;
+    const CubismMotionLodTier tier = _lodPolicy.SelectTier(_model->GetCanvasHeight() * pixelsPerUnit, isOnScreen, _lodTier);
+    const CubismMotionLodPolicy::TierSetting& setting = _lodPolicy.GetTierSetting(tier);
+
+    _motionManager->SetEvaluationInterval(setting.EvaluationRate > 0.0f ? 1.0f / setting.EvaluationRate : 0.0f);
+
+    if (setting.MinDrawablePixels > 0.0f)
+    {
+        if (_parameterInfluenceMap == NULL)
+        {
+            CreateParameterInfluenceMap(false);
+        }
+
+        if (!_parameterInfluenceMap->IsMeasured())
+        {
+            // 計測は1回でモデルの更新がパラメータ数の3倍かかるので、数フレームに分けて行う
+            if (!_parameterInfluenceMap->MeasureStep(_model, LodMeasureParametersPerUpdate))
+            {
+                _motionManager->SetSkippedParameters(NULL);
+                _lodTier = tier;
+                return _lodTier;
+            }
+
+            _lodSkippedPixelsPerUnit = 0.0f;
+        }
+
+        // 段階が変わったか、大きさが前回から25%以上変わったときだけ作り直す
+        const csmFloat32 ratio = (_lodSkippedPixelsPerUnit > 0.0f) ? pixelsPerUnit / _lodSkippedPixelsPerUnit : 0.0f;
+        if (tier != _lodTier || ratio < 0.8f || ratio > 1.25f)
+        {
+            _parameterInfluenceMap->BuildSkippedParameters(pixelsPerUnit, setting.MinDrawablePixels, _lodSkippedParameters);
+            _lodSkippedPixelsPerUnit = pixelsPerUnit;
+        }
+
+        _motionManager->SetSkippedParameters(&_lodSkippedParameters);
+    }
+    else
+    {
+        _motionManager->SetSkippedParameters(NULL);
+        _lodSkippedPixelsPerUnit = 0.0f;
+    }
+
+    _lodTier = tier;
+
+    return _lodTier;
+}
+
+void CubismUserModel::PrepareLod()
+{
+    if (_model == NULL)
+    {
+        return;
+    }
+
+    if (_parameterInfluenceMap == NULL)
+    {
+        CreateParameterInfluenceMap(true);
+    }
+    else
+    {
+        _parameterInfluenceMap->MeasureStep(_model, 0);
+    }
+}
+
+void CubismUserModel::CreateParameterInfluenceMap(csmBool isMeasured)
+{
+    // 物理演算の入力は他のパラメータを動かすため省略しない
+    CubismMemoryScope memoryScope(_memoryAccount, CubismMemoryCategory_Model);
+    _parameterInfluenceMap = CubismParameterInfluenceMap::Create(_model, isMeasured);
+
+    if (_physics != NULL)
+    {
+        csmVector<CubismIdHandle> inputIds;
+        _physics->GetInputParameterIds(inputIds);
+        for (csmUint32 i = 0; i < inputIds.GetSize(); ++i)
+        {
+            _parameterInfluenceMap->PinParameter(_model->GetParameterIndex(inputIds[i]));
+        }
+    }
+}
+
+CubismMotionLodTier CubismUserModel::GetLodTier() const
+{
+    return _lodTier;
+}
+
+csmBool CubismUserModel::IsPhysicsFrozen() const
+{
+    return _lodPolicy.GetTierSetting(_lodTier).FreezePhysics;
+}
+
+CubismMemoryReport CubismUserModel::GetMemoryReport() const
+{
+    CubismMemoryReport report;
+    _memoryAccount->GetReport(report);
+
+    if (!report.IsTracked && _moc != NULL)
+    {
+        // タグがなくても、MOCとモデルのバッファの大きさは分かる。共有されたMOCは復元したモデルにだけ計上する
+        if (_isMocOwner)
+        {
+            report.Bytes[CubismMemoryCategory_Moc] += _moc->GetMocSize();
+            report.TotalBytes += _moc->GetMocSize();
+        }
+
+        if (_model != NULL)
+        {
+            report.Bytes[CubismMemoryCategory_Model] += _moc->GetModelSize();
+            report.TotalBytes += _moc->GetModelSize();
+        }
+    }
+
+    return report;
+}
+
+CubismMemoryAccount* CubismUserModel::GetMemoryAccount() const
+{
+    return _memoryAccount;
+}
+
+void CubismUserModel::UseArena(CubismPoolAllocator* allocator)
+{
+    if (allocator == NULL || _memoryAccount->GetArena() != NULL)
+    {
+        return;
+    }
+
+    _memoryAccount->SetArena(allocator->CreateArena());
+}
+
+void CubismUserModel::SetMemoryBudget(csmSizeType bytes)
+{
+    _memoryBudget = bytes;
+}
+
+csmSizeType CubismUserModel::GetMemoryBudget() const
+{
+    return _memoryBudget;
+}
+
+csmBool CubismUserModel::IsOverMemoryBudget(csmSizeType pendingBytes) const
+{
+    if (_memoryBudget == 0)
+    {
+        return false;
+    }
+
+    return GetMemoryReport().TotalBytes + pendingBytes > _memoryBudget;
+}
+
+void CubismUserModel::SetProfilingEnabled(csmBool enabled, csmInt32 frameCapacity)
+{
+    if (enabled && _profile == NULL)
+    {
+        _profile = CubismProfile::Create(frameCapacity);
+    }
+    else if (!enabled && _profile != NULL)
+    {
+        CubismProfile::Delete(_profile);
+        _profile = NULL;
+    }
+}
+
+CubismProfile* CubismUserModel::GetProfile() const
+{
+    return _profile;
+}
+
 }}}
@@ -15,14 +15,21 @@
 #include "Model/CubismMoc.hpp"
 #include "Model/CubismModel.hpp"
 #include "Motion/CubismMotionManager.hpp"
+#include "Motion/CubismMotionLodPolicy.hpp"
 #include "Motion/CubismExpressionMotion.hpp"
 #include "Physics/CubismPhysics.hpp"
 #include "Rendering/CubismRenderer.hpp"
 #include "Model/CubismModelUserData.hpp"
 #include "Motion/CubismExpressionMotionManager.hpp"
+#include "Utils/CubismMemoryTracker.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+struct CubismMotionData;
+class CubismParameterInfluenceMap;
+class CubismHitTester;
+
 /**
  * Base for models actually used by thegit a user.
  */
@@ -110,9 +117,21 @@ public:
      *
      * @param buffer Buffer where the MOC3 file is loaded
      * @param size Number of bytes in the buffer
+     *
+     * @note The MOC is shared through CubismFramework::GetMocCache(), so loading the same MOC3 file again<br>
+     *       hashes the buffer instead of reviving and checking it again.
      */
     virtual void            LoadModel(const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
 
+    /**
+     * Loads the model from a MOC shared with other models.
+     *
+     * @param moc MOC to make the model from; a reference is added and released with the model
+     *
+     * @note Only the model buffer is allocated, so models of the same MOC share its memory.
+     */
+    virtual void            LoadModel(CubismMoc* moc);
+
     /**
      * Loads motion from a motion file.
      * If a fade value is defined in model3.json, the fade value defined in motion3.json will be overwritten.
@@ -131,6 +150,24 @@ public:
                                        ACubismMotion::FinishedMotionCallback onFinishedMotionHandler = NULL, ACubismMotion::BeganMotionCallback onBeganMotionHandler = NULL,
                                        ICubismModelSetting* modelSetting = NULL, const csmChar* group = NULL, const csmInt32 index = -1, csmBool shouldCheckMotionConsistency = false);
 
+    /**
+     * Makes a motion that plays shared motion data.
+     * If a fade value is defined in model3.json, the fade value defined in motion3.json will be overwritten.
+     *
+     * @param motionData Motion data, typically acquired from CubismMotionDataCache
+     * @param name Name of the motion
+     * @param onFinishedMotionHandler Callback function when motion playback finishes
+     * @param onBeganMotionHandler Callback function when motion playback starts
+     * @param modelSetting Model setting information
+     * @param group – Name to the desired Motion Group
+     * @param index – Index to the desired Motion
+     *
+     * @return Instance of the motion class
+     */
+    virtual ACubismMotion*  LoadMotion(CubismMotionData* motionData, const csmChar* name,
+                                       ACubismMotion::FinishedMotionCallback onFinishedMotionHandler = NULL, ACubismMotion::BeganMotionCallback onBeganMotionHandler = NULL,
+                                       ICubismModelSetting* modelSetting = NULL, const csmChar* group = NULL, const csmInt32 index = -1);
+
     /**
      * Loads expression from an expression configuration file.
      *
@@ -177,6 +214,26 @@ public:
      */
     virtual csmBool         IsHit(CubismIdHandle drawableId, csmFloat32 pointX, csmFloat32 pointY);
 
+    /**
+     * Returns whether the specified position is inside one of the triangles of a drawable object.
+     *
+     * More precise than IsHit(), which tests the bounding box of the drawable object.
+     *
+     * @param drawableId ID of the drawable object to test
+     * @param pointX X position
+     * @param pointY Y position
+     *
+     * @return true if the position is inside the mesh of the drawable object; otherwise false.
+     */
+    csmBool                 IsHitMesh(CubismIdHandle drawableId, csmFloat32 pointX, csmFloat32 pointY);
+
+    /**
+     * Returns the hit tester of the model.
+     *
+     * @return Hit tester; NULL until the model is loaded
+     */
+    CubismHitTester*        GetHitTester() const;
+
     /**
      * Returns the model.
      *
@@ -221,6 +278,127 @@ public:
      * @note Calls the `MotionEventFired` of the CubismUserModel subclass.
      */
     static void   CubismDefaultMotionEventCallback(const CubismMotionQueueManager* caller, const csmString& eventValue, void* customData);
+
+    /**
+     * Sets the policy used to choose the level of detail.
+     *
+     * @param policy Level of detail policy
+     */
+    void SetLodPolicy(const CubismMotionLodPolicy& policy);
+
+    /**
+     * Returns the policy used to choose the level of detail.
+     *
+     * @return Level of detail policy
+     */
+    const CubismMotionLodPolicy& GetLodPolicy() const;
+
+    /**
+     * Chooses the level of detail from the scale of the model matrix and applies it to the motion manager.<br>
+     * Call this once per frame before updating the motions.
+     *
+     * @param viewPixelsPerUnit Number of screen pixels per unit of the view space the model matrix maps to
+     * @param isOnScreen false if the model is entirely outside the view
+     *
+     * @return Chosen tier
+     */
+    CubismMotionLodTier UpdateLod(csmFloat32 viewPixelsPerUnit, csmBool isOnScreen = true);
+
+    /**
+     * Measures which drawables each parameter influences, as used by tiers with a minimum drawable size.<br>
+     * Call this while loading to measure at once. Otherwise UpdateLod() measures a few parameters per call
+     * and skips no parameter until the measurement is complete.
+     *
+     * @note The measurement evaluates the model three times per parameter, without counting them as updates.
+     */
+    void PrepareLod();
+
+    /**
+     * Returns the current level of detail.
+     *
+     * @return Current tier
+     */
+    CubismMotionLodTier GetLodTier() const;
+
+    /**
+     * Checks whether the physics should be skipped at the current level of detail.
+     *
+     * @return true if the physics is frozen; otherwise false.
+     */
+    csmBool IsPhysicsFrozen() const;
+
+    /**
+     * Returns the memory the model uses, broken down by subsystem.
+     *
+     * @return Memory report
+     *
+     * @note Without CSM_MEMORY_TRACKING only the MOC and model buffers and the external bytes are counted.<br>
+     *       A MOC shared through CubismMocCache is charged to the model that revived it, and one passed to LoadModel(CubismMoc*) to none.<br>
+     *       Motion data shared through CubismMotionDataCache is charged to the model that parsed it first.
+     */
+    CubismMemoryReport GetMemoryReport() const;
+
+    /**
+     * Returns the account the allocations of the model are charged to.<br>
+     * Open a CubismMemoryScope on it to charge memory allocated outside the Load functions, and report<br>
+     * memory allocated outside the framework, such as textures, with CubismMemoryAccount::SetExternalBytes().
+     *
+     * @return Memory account
+     */
+    CubismMemoryAccount* GetMemoryAccount() const;
+
+    /**
+     * Serves the small allocations of the model from an arena of the allocator.<br>
+     * The arena is closed when the model is destroyed, and its memory is returned to the system in one shot.
+     *
+     * @param allocator Allocator passed to CubismFramework::StartUp()
+     *
+     * @note Call it before loading. Memory allocated before the call and data shared with other models,<br>
+     *       such as MOCs and motion data held by the caches, come from the shared pools.
+     */
+    void UseArena(CubismPoolAllocator* allocator);
+
+    /**
+     * Sets the memory budget of the model.<br>
+     * Loaders check IsOverMemoryBudget() to defer optional data, such as motion groups, until first use.
+     *
+     * @param bytes Budget in bytes; 0 for no limit
+     */
+    void SetMemoryBudget(csmSizeType bytes);
+
+    /**
+     * Returns the memory budget of the model.
+     *
+     * @return Budget in bytes; 0 for no limit
+     */
+    csmSizeType GetMemoryBudget() const;
+
+    /**
+     * Checks whether the model uses more memory than its budget.
+     *
+     * @param pendingBytes Bytes requested but not charged to the account yet, such as the files of queued load requests
+     *
+     * @return true if a budget is set and GetMemoryReport() plus pendingBytes exceeds it; otherwise false
+     */
+    csmBool IsOverMemoryBudget(csmSizeType pendingBytes = 0) const;
+
+    /**
+     * Starts or stops keeping the stage timings of the model.<br>
+     * Open a CubismProfileScope on GetProfile() around the update and the drawing, and delimit frames with<br>
+     * CubismProfile::BeginFrame() and CubismProfile::EndFrame().
+     *
+     * @param enabled true to make the profile; false to destroy it
+     * @param frameCapacity Number of frames the profile keeps; used only when the profile is made
+     */
+    void SetProfilingEnabled(csmBool enabled, csmInt32 frameCapacity = 120);
+
+    /**
+     * Returns the profile of the model.
+     *
+     * @return Profile; NULL if profiling is not enabled
+     */
+    CubismProfile* GetProfile() const;
+
 protected:
     CubismMoc*              _moc;
     CubismModel*            _model;
@@ -234,6 +412,7 @@ protected:
     CubismTargetPoint*      _dragManager;
     CubismPhysics*          _physics;
     CubismModelUserData*    _modelUserData;
+    CubismHitTester*        _hitTester;
 
     csmBool     _initialized;
     csmBool     _updating;
@@ -249,7 +428,30 @@ protected:
     csmBool     _motionConsistency;
     csmBool     _debugMode;
 
+    CubismMotionLodPolicy           _lodPolicy;
+    CubismMotionLodTier             _lodTier;
+    CubismParameterInfluenceMap*    _parameterInfluenceMap;
+    csmVector<csmBool>              _lodSkippedParameters;
+    csmFloat32                      _lodSkippedPixelsPerUnit;
+
+    CubismMemoryAccount*            _memoryAccount;
+    csmSizeType                     _memoryBudget;
+    csmBool                         _isMocOwner;        ///< MOCを復元したモデルか。共有されたMOCのメモリはこのモデルにだけ計上する
+    CubismProfile*                  _profile;
+
 private:
+    /**
+     * Makes the model from the loaded MOC.
+     */
+    void CreateModelFromMoc();
+
+    /**
+     * Makes the parameter influence map and pins the inputs of the physics.
+     *
+     * @param isMeasured true to measure every parameter now
+     */
+    void CreateParameterInfluenceMap(csmBool isMeasured);
+
     Rendering::CubismRenderer* _renderer;
 };
 
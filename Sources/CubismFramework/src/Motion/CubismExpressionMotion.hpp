@@ -75,7 +75,7 @@ public:
     /**
      * Returns the parameters referenced by the facial expression.
      */
-    csmVector<ExpressionParameter> GetExpressionParameters();
+    const csmVector<ExpressionParameter>& GetExpressionParameters() const;
 
     /**
      * Returns the current fade weight value of the facial expression.
@@ -10,6 +10,7 @@
 #include "CubismMotionQueueEntry.hpp"
 #include "CubismFramework.hpp"
 #include "Math/CubismMath.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -70,6 +71,8 @@ CubismMotionQueueEntryHandle CubismExpressionMotionManager::StartMotionPriority(
 
 csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat32 deltaTimeSeconds)
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_Expression);
+
     _userTimeSeconds += deltaTimeSeconds;
     csmBool updated = false;
     csmVector<CubismMotionQueueEntry*>* motions = GetCubismMotionQueueEntries();
@@ -103,7 +106,7 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
             continue;
         }
 
-        csmVector<CubismExpressionMotion::ExpressionParameter> expressionParameters = expressionMotion->GetExpressionParameters();
+        const csmVector<CubismExpressionMotion::ExpressionParameter>& expressionParameters = expressionMotion->GetExpressionParameters();
         if (motionQueueEntry->IsAvailable())
         {
             // 再生中のExpressionが参照しているパラメータをすべてリストアップ
@@ -15,6 +15,7 @@
 #include "Math/CubismMath.hpp"
 #include "Type/csmVector.hpp"
 #include "Id/CubismIdManager.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -214,6 +215,14 @@ csmFloat32 CorrectEndPoint(
     }
 }
 
+/**
+ * モーションのフレームレート。指定がなければ30fpsとみなす
+ */
+csmFloat32 GetMotionFps(const CubismMotionData* motionData)
+{
+    return (motionData->Fps > 0.0f) ? motionData->Fps : 30.0f;
+}
+
 csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time, const csmBool isCorrection, const csmFloat32 endTime)
 {
     // Find segment to evaluate.
@@ -266,50 +275,69 @@ csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 inde
 
 }
 
-CubismMotion::CubismMotion()
-    : _sourceFrameRate(30.0f)
-    , _loopDurationSeconds(-1.0f)
+CubismMotion::CubismMotion(CubismMotionData* motionData)
+    : _sourceFrameRate(motionData->Fps)
+    , _loopDurationSeconds(motionData->Duration)
     , _motionBehavior(MotionBehavior_V2)
     , _lastWeight(0.0f)
-    , _motionData(NULL)
-    , _modelCurveIdEyeBlink(NULL)
-    , _modelCurveIdLipSync(NULL)
-    , _modelCurveIdOpacity(NULL)
+    , _motionData(motionData)
+    , _modelCurveIdEyeBlink(CubismFramework::GetIdManager()->GetId(EffectNameEyeBlink))
+    , _modelCurveIdLipSync(CubismFramework::GetIdManager()->GetId(EffectNameLipSync))
+    , _modelCurveIdOpacity(CubismFramework::GetIdManager()->GetId(IdNameOpacity))
     , _modelOpacity(1.0f)
-{ }
+    , _bakedTable(NULL)
+{
+    _motionData->Retain();
+
+    _fadeInSeconds = _motionData->FadeInSeconds;
+    _fadeOutSeconds = _motionData->FadeOutSeconds;
+}
 
 CubismMotion::~CubismMotion()
 {
-    if(_motionData != NULL)
-    {
-        CSM_DELETE(_motionData);
-    }
+    _motionData->Release();
 }
 
 CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler, BeganMotionCallback onBeganMotionHandler, csmBool shouldCheckMotionConsistency)
 {
-    CubismMotion* ret = CSM_NEW CubismMotion();
+    CubismMotionData* motionData = CreateMotionData(buffer, size, shouldCheckMotionConsistency);
 
-    ret->Parse(buffer, size, shouldCheckMotionConsistency);
-    if(ret->_motionData)
+    if (motionData == NULL)
     {
-        ret->_sourceFrameRate = ret->_motionData->Fps;
-        ret->_loopDurationSeconds = ret->_motionData->Duration;
-        ret->_onFinishedMotion = onFinishedMotionHandler;
-        ret->_onBeganMotion = onBeganMotionHandler;
-    }
-    else
-    {
-        CSM_DELETE_SELF(CubismMotion, ret);
-        ret = NULL;
+        return NULL;
     }
 
+    CubismMotion* ret = Create(motionData, onFinishedMotionHandler, onBeganMotionHandler);
+
+    // インスタンスが参照を保持するので生成時の参照を手放す
+    motionData->Release();
+
     // NOTE: Editorではループありのモーション書き出しは非対応
     // ret->_loop = (ret->_motionData->Loop > 0);
 
     return ret;
 }
 
+CubismMotion* CubismMotion::Create(CubismMotionData* motionData, FinishedMotionCallback onFinishedMotionHandler, BeganMotionCallback onBeganMotionHandler)
+{
+    if (motionData == NULL)
+    {
+        return NULL;
+    }
+
+    CubismMotion* ret = CSM_NEW CubismMotion(motionData);
+
+    ret->_onFinishedMotion = onFinishedMotionHandler;
+    ret->_onBeganMotion = onBeganMotionHandler;
+
+    return ret;
+}
+
+const CubismMotionData* CubismMotion::GetMotionData() const
+{
+    return _motionData;
+}
+
 csmFloat32 CubismMotion::GetDuration()
 {
     return _isLoop ? -1.0f : _loopDurationSeconds;
@@ -317,21 +345,6 @@ csmFloat32 CubismMotion::GetDuration()
 
 void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSeconds, csmFloat32 fadeWeight, CubismMotionQueueEntry* motionQueueEntry)
 {
-    if (_modelCurveIdEyeBlink == NULL)
-    {
-        _modelCurveIdEyeBlink = CubismFramework::GetIdManager()->GetId(EffectNameEyeBlink);
-    }
-
-    if (_modelCurveIdLipSync == NULL)
-    {
-        _modelCurveIdLipSync = CubismFramework::GetIdManager()->GetId(EffectNameLipSync);
-    }
-
-    if (_modelCurveIdOpacity == NULL)
-    {
-        _modelCurveIdOpacity = CubismFramework::GetIdManager()->GetId(IdNameOpacity);
-    }
-
     if (_motionBehavior == MotionBehavior_V2)
     {
         if (_previousLoopState != _isLoop)
@@ -387,7 +400,7 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
     {
         if (_motionBehavior == MotionBehavior_V2)
         {
-            duration += 1.0f / _motionData->Fps;
+            duration += 1.0f / GetMotionFps(_motionData);
         }
         while (time > duration)
         {
@@ -395,13 +408,13 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         }
     }
 
-    csmVector<CubismMotionCurve>& curves = _motionData->Curves;
+    const csmVector<CubismMotionCurve>& curves = _motionData->Curves;
 
     // Evaluate model curves.
     for (c = 0; c < _motionData->CurveCount && curves[c].Type == CubismMotionCurveTarget_Model; ++c)
     {
         // Evaluate curve and call handler.
-        value = EvaluateCurve(_motionData, c, time, isCorrection, duration);
+        value = EvaluateCurveAt(c, time, isCorrection, duration);
 
         if (curves[c].Id == _modelCurveIdEyeBlink)
         {
@@ -435,10 +448,18 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
             continue;
         }
 
+        // Skip curves whose parameter is culled by the level of detail.
+        if (motionQueueEntry->_skippedParameters != NULL &&
+            parameterIndex < static_cast<csmInt32>(motionQueueEntry->_skippedParameters->GetSize()) &&
+            (*motionQueueEntry->_skippedParameters)[parameterIndex])
+        {
+            continue;
+        }
+
         const csmFloat32 sourceValue = model->GetParameterValue(parameterIndex);
 
         // Evaluate curve and apply value.
-        value = EvaluateCurve(_motionData, c, time, isCorrection, duration);
+        value = EvaluateCurveAt(c, time, isCorrection, duration);
 
         if (eyeBlinkValue != FLT_MAX)
         {
@@ -472,9 +493,12 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
             value = model->GetParameterRepeatValue(parameterIndex, value);
         }
 
+        const csmFloat32 curveFadeInTime = GetCurveFadeInTime(c);
+        const csmFloat32 curveFadeOutTime = GetCurveFadeOutTime(c);
+
         csmFloat32 v;
         // パラメータごとのフェード
-        if (curves[c].FadeInTime < 0.0f && curves[c].FadeOutTime < 0.0f)
+        if (curveFadeInTime < 0.0f && curveFadeOutTime < 0.0f)
         {
             //モーションのフェードを適用
             v = sourceValue + (value - sourceValue) * fadeWeight;
@@ -485,26 +509,26 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
             csmFloat32 fin;
             csmFloat32 fout;
 
-            if (curves[c].FadeInTime < 0.0f)
+            if (curveFadeInTime < 0.0f)
             {
                 fin = tmpFadeIn;
             }
             else
             {
-                fin = curves[c].FadeInTime == 0.0f
+                fin = curveFadeInTime == 0.0f
                             ? 1.0f
-                        : CubismMath::GetEasingSine((userTimeSeconds - motionQueueEntry->GetFadeInStartTime()) / curves[c].FadeInTime);
+                        : CubismMath::GetEasingSine((userTimeSeconds - motionQueueEntry->GetFadeInStartTime()) / curveFadeInTime);
             }
 
-            if (curves[c].FadeOutTime < 0.0f)
+            if (curveFadeOutTime < 0.0f)
             {
                 fout = tmpFadeOut;
             }
             else
             {
-                fout = (curves[c].FadeOutTime == 0.0f || motionQueueEntry->GetEndTime() < 0.0f)
+                fout = (curveFadeOutTime == 0.0f || motionQueueEntry->GetEndTime() < 0.0f)
                             ? 1.0f
-                        : CubismMath::GetEasingSine((motionQueueEntry->GetEndTime() - userTimeSeconds) / curves[c].FadeOutTime );
+                        : CubismMath::GetEasingSine((motionQueueEntry->GetEndTime() - userTimeSeconds) / curveFadeOutTime );
             }
 
             const csmFloat32 paramWeight = _weight * fin * fout;
@@ -564,11 +588,13 @@ void CubismMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSec
         }
 
         // Evaluate curve and apply value.
-        value = EvaluateCurve(_motionData, c, time, isCorrection, duration);
+        value = EvaluateCurveAt(c, time, isCorrection, duration);
 
         model->SetParameterValue(parameterIndex, value);
     }
 
+    CSM_PROFILE_COUNT(CubismProfileCounter_CurvesEvaluated, c);
+
     if (timeOffsetSeconds >= duration)
     {
         if (_isLoop)
@@ -620,14 +646,14 @@ void CubismMotion::UpdateForNextLoop(CubismMotionQueueEntry* motionQueueEntry, c
     }
 }
 
-void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBool shouldCheckMotionConsistency)
+CubismMotionData* CubismMotion::CreateMotionData(const csmByte* motionJson, csmSizeInt size, csmBool shouldCheckMotionConsistency)
 {
     CubismMotionJson* json = CSM_NEW CubismMotionJson(motionJson, size);
 
     if (!json->IsValid())
     {
         CSM_DELETE(json);
-        return;
+        return NULL;
     }
 
     if (shouldCheckMotionConsistency)
@@ -639,79 +665,79 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
 
             // 整合性が確認できなければ処理しない
             CubismLogError("Inconsistent motion3.json.");
-            return;
+            return NULL;
         }
     }
 
-    _motionData = CSM_NEW CubismMotionData;
+    CubismMotionData* motionData = CSM_NEW CubismMotionData;
 
-    _motionData->Duration = json->GetMotionDuration();
-    _motionData->Loop = json->IsMotionLoop();
-    _motionData->CurveCount = json->GetMotionCurveCount();
-    _motionData->Fps = json->GetMotionFps();
-    _motionData->EventCount = json->GetEventCount();
+    motionData->Duration = json->GetMotionDuration();
+    motionData->Loop = json->IsMotionLoop();
+    motionData->CurveCount = json->GetMotionCurveCount();
+    motionData->Fps = json->GetMotionFps();
+    motionData->EventCount = json->GetEventCount();
 
     csmBool areBeziersRestricted = json->GetEvaluationOptionFlag( EvaluationOptionFlag_AreBeziersRestricted );
 
     if (json->IsExistMotionFadeInTime())
     {
-        _fadeInSeconds = (json->GetMotionFadeInTime() < 0.0f)
+        motionData->FadeInSeconds = (json->GetMotionFadeInTime() < 0.0f)
                              ? 1.0f
                              : json->GetMotionFadeInTime();
     }
     else
     {
-        _fadeInSeconds = 1.0f;
+        motionData->FadeInSeconds = 1.0f;
     }
 
     if (json->IsExistMotionFadeOutTime())
     {
-        _fadeOutSeconds = (json->GetMotionFadeOutTime() < 0.0f)
+        motionData->FadeOutSeconds = (json->GetMotionFadeOutTime() < 0.0f)
                               ? 1.0f
                               : json->GetMotionFadeOutTime();
     }
     else
     {
-        _fadeOutSeconds = 1.0f;
+        motionData->FadeOutSeconds = 1.0f;
     }
 
-    _motionData->Curves.UpdateSize(_motionData->CurveCount, CubismMotionCurve(), true);
-    _motionData->Segments.UpdateSize(json->GetMotionTotalSegmentCount(), CubismMotionSegment(), true);
-    _motionData->Points.UpdateSize(json->GetMotionTotalPointCount(), CubismMotionPoint(), true);
-    _motionData->Events.UpdateSize(_motionData->EventCount, CubismMotionEvent(), true);
+    motionData->Curves.UpdateSize(motionData->CurveCount, CubismMotionCurve(), true);
+    motionData->Segments.UpdateSize(json->GetMotionTotalSegmentCount(), CubismMotionSegment(), true);
+    motionData->Points.UpdateSize(json->GetMotionTotalPointCount(), CubismMotionPoint(), true);
+    motionData->Events.UpdateSize(motionData->EventCount, CubismMotionEvent(), true);
 
     csmInt32 totalPointCount = 0;
     csmInt32 totalSegmentCount = 0;
 
     // Curves
-    for (csmInt32 curveCount = 0; curveCount < _motionData->CurveCount; ++curveCount)
+    for (csmInt32 curveCount = 0; curveCount < motionData->CurveCount; ++curveCount)
     {
         if (strcmp(json->GetMotionCurveTarget(curveCount), TargetNameModel) == 0)
         {
-            _motionData->Curves[curveCount].Type = CubismMotionCurveTarget_Model;
+            motionData->Curves[curveCount].Type = CubismMotionCurveTarget_Model;
         }
         else if (strcmp(json->GetMotionCurveTarget(curveCount), TargetNameParameter) == 0)
         {
-            _motionData->Curves[curveCount].Type = CubismMotionCurveTarget_Parameter;
+            motionData->Curves[curveCount].Type = CubismMotionCurveTarget_Parameter;
         }
         else if (strcmp(json->GetMotionCurveTarget(curveCount), TargetNamePartOpacity) == 0)
         {
-            _motionData->Curves[curveCount].Type = CubismMotionCurveTarget_PartOpacity;
+            motionData->Curves[curveCount].Type = CubismMotionCurveTarget_PartOpacity;
         }
         else
         {
             CubismLogWarning("Warning : Unable to get segment type from Curve! The number of \"CurveCount\" may be incorrect!");
         }
 
-        _motionData->Curves[curveCount].Id = json->GetMotionCurveId(curveCount);
+        motionData->Curves[curveCount].Id = json->GetMotionCurveId(curveCount);
 
-        _motionData->Curves[curveCount].BaseSegmentIndex = totalSegmentCount;
+        motionData->Curves[curveCount].BaseSegmentIndex = totalSegmentCount;
 
-        _motionData->Curves[curveCount].FadeInTime =
+        motionData->Curves[curveCount].FadeInTime =
                 (json->IsExistMotionCurveFadeInTime(curveCount))
                     ? json->GetMotionCurveFadeInTime(curveCount)
                     : -1.0f ;
-        _motionData->Curves[curveCount].FadeOutTime =
+        motionData->Curves[curveCount].FadeOutTime =
                 (json->IsExistMotionCurveFadeOutTime(curveCount))
                     ? json->GetMotionCurveFadeOutTime(curveCount)
                     : -1.0f;
@@ -721,17 +747,17 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
         {
             if (segmentPosition == 0)
             {
-                _motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount;
+                motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount;
 
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, segmentPosition);
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, segmentPosition + 1);
+                motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, segmentPosition);
+                motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, segmentPosition + 1);
 
                 totalPointCount += 1;
                 segmentPosition += 2;
             }
             else
             {
-                _motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount - 1;
+                motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount - 1;
             }
 
             const csmInt32 segment = static_cast<csmInt32>(json->GetMotionCurveSegment(curveCount, segmentPosition));
@@ -739,11 +765,11 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
             switch (segment)
             {
             case CubismMotionSegmentType_Linear: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Linear;
-                _motionData->Segments[totalSegmentCount].Evaluate = LinearEvaluate;
+                motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Linear;
+                motionData->Segments[totalSegmentCount].Evaluate = LinearEvaluate;
 
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
+                motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
+                motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
 
                 totalPointCount += 1;
                 segmentPosition += 3;
@@ -751,23 +777,23 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
                 break;
             }
             case CubismMotionSegmentType_Bezier: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Bezier;
+                motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Bezier;
                 if (areBeziersRestricted || UseOldBeziersCurveMotion) {
-                    _motionData->Segments[totalSegmentCount].Evaluate = BezierEvaluate;
+                    motionData->Segments[totalSegmentCount].Evaluate = BezierEvaluate;
                 }
                 else
                 {
-                    _motionData->Segments[totalSegmentCount].Evaluate = BezierEvaluateCardanoInterpretation;
+                    motionData->Segments[totalSegmentCount].Evaluate = BezierEvaluateCardanoInterpretation;
                 }
 
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
+                motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
+                motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
 
-                _motionData->Points[totalPointCount + 1].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 3));
-                _motionData->Points[totalPointCount + 1].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 4));
+                motionData->Points[totalPointCount + 1].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 3));
+                motionData->Points[totalPointCount + 1].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 4));
 
-                _motionData->Points[totalPointCount + 2].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 5));
-                _motionData->Points[totalPointCount + 2].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 6));
+                motionData->Points[totalPointCount + 2].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 5));
+                motionData->Points[totalPointCount + 2].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 6));
 
                 totalPointCount += 3;
                 segmentPosition += 7;
@@ -775,11 +801,11 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
                 break;
             }
             case CubismMotionSegmentType_Stepped: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Stepped;
-                _motionData->Segments[totalSegmentCount].Evaluate = SteppedEvaluate;
+                motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Stepped;
+                motionData->Segments[totalSegmentCount].Evaluate = SteppedEvaluate;
 
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
+                motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
+                motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
 
                 totalPointCount += 1;
                 segmentPosition += 3;
@@ -787,11 +813,11 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
                 break;
             }
             case CubismMotionSegmentType_InverseStepped: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_InverseStepped;
-                _motionData->Segments[totalSegmentCount].Evaluate = InverseSteppedEvaluate;
+                motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_InverseStepped;
+                motionData->Segments[totalSegmentCount].Evaluate = InverseSteppedEvaluate;
 
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
+                motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
+                motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
 
                 totalPointCount += 1;
                 segmentPosition += 3;
@@ -804,78 +830,126 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size, csmBo
             }
             }
 
-            ++_motionData->Curves[curveCount].SegmentCount;
+            ++motionData->Curves[curveCount].SegmentCount;
             ++totalSegmentCount;
         }
     }
 
     for (csmInt32 userdatacount = 0; userdatacount < json->GetEventCount(); ++userdatacount)
     {
-        _motionData->Events[userdatacount].FireTime = json->GetEventTime(userdatacount);
-        _motionData->Events[userdatacount].Value = json->GetEventValue(userdatacount);
+        motionData->Events[userdatacount].FireTime = json->GetEventTime(userdatacount);
+        motionData->Events[userdatacount].Value = json->GetEventValue(userdatacount);
     }
 
     CSM_DELETE(json);
+
+    return motionData;
 }
 
 void CubismMotion::SetParameterFadeInTime(CubismIdHandle parameterId, csmFloat32 value)
 {
-    csmVector<CubismMotionCurve>& curves = _motionData->Curves;
+    const csmInt32 curveIndex = FindCurveIndex(parameterId);
 
-    for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
+    if (curveIndex < 0)
     {
-        if (parameterId == curves[i].Id)
-        {
-            curves[i].FadeInTime = value;
-            return;
-        }
+        return;
     }
+
+    // 共有データは書き換えずインスタンス側で上書きする
+    PrepareCurveFadeTimes();
+    _curveFadeInTimes[curveIndex] = value;
 }
 
 void CubismMotion::SetParameterFadeOutTime(CubismIdHandle parameterId, csmFloat32 value)
 {
-    csmVector<CubismMotionCurve>& curves = _motionData->Curves;
+    const csmInt32 curveIndex = FindCurveIndex(parameterId);
 
-    for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
+    if (curveIndex < 0)
     {
-        if (parameterId == curves[i].Id)
-        {
-            curves[i].FadeOutTime = value;
-            return;
-        }
+        return;
     }
+
+    // 共有データは書き換えずインスタンス側で上書きする
+    PrepareCurveFadeTimes();
+    _curveFadeOutTimes[curveIndex] = value;
 }
 
 csmFloat32 CubismMotion::GetParameterFadeInTime(CubismIdHandle parameterId) const
 {
-    csmVector<CubismMotionCurve>& curves = _motionData->Curves;
+    const csmInt32 curveIndex = FindCurveIndex(parameterId);
 
-    for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
+    if (curveIndex < 0)
     {
-        if (parameterId == curves[i].Id)
-        {
-            return curves[i].FadeInTime;
-        }
+        return -1;
     }
 
-    return -1;
+    return GetCurveFadeInTime(curveIndex);
 }
 
 csmFloat32 CubismMotion::GetParameterFadeOutTime(CubismIdHandle parameterId) const
 {
-    csmVector<CubismMotionCurve>& curves = _motionData->Curves;
+    const csmInt32 curveIndex = FindCurveIndex(parameterId);
+
+    if (curveIndex < 0)
+    {
+        return -1;
+    }
+
+    return GetCurveFadeOutTime(curveIndex);
+}
+
+csmFloat32 CubismMotion::GetCurveFadeInTime(csmInt32 curveIndex) const
+{
+    if (_curveFadeInTimes.GetSize() > 0)
+    {
+        return _curveFadeInTimes[curveIndex];
+    }
+
+    return _motionData->Curves[curveIndex].FadeInTime;
+}
+
+csmFloat32 CubismMotion::GetCurveFadeOutTime(csmInt32 curveIndex) const
+{
+    if (_curveFadeOutTimes.GetSize() > 0)
+    {
+        return _curveFadeOutTimes[curveIndex];
+    }
+
+    return _motionData->Curves[curveIndex].FadeOutTime;
+}
+
+csmInt32 CubismMotion::FindCurveIndex(CubismIdHandle parameterId) const
+{
+    const csmVector<CubismMotionCurve>& curves = _motionData->Curves;
 
     for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
     {
         if (parameterId == curves[i].Id)
         {
-            return curves[i].FadeOutTime;
+            return i;
         }
     }
 
     return -1;
 }
 
+void CubismMotion::PrepareCurveFadeTimes()
+{
+    if (_curveFadeInTimes.GetSize() > 0)
+    {
+        return;
+    }
+
+    _curveFadeInTimes.PrepareCapacity(_motionData->CurveCount);
+    _curveFadeOutTimes.PrepareCapacity(_motionData->CurveCount);
+
+    for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
+    {
+        _curveFadeInTimes.PushBack(_motionData->Curves[i].FadeInTime, false);
+        _curveFadeOutTimes.PushBack(_motionData->Curves[i].FadeOutTime, false);
+    }
+}
+
 void CubismMotion::IsLoop(csmBool loop)
 {
     CubismLogWarning("IsLoop(csmBool loop) is a deprecated function. Please use SetLoop(csmBool loop).");
@@ -1007,4 +1081,265 @@ csmFloat32 CubismMotion::GetModelOpacityValue() const
     return _modelOpacity;
 }
 
+csmFloat32 CubismMotion::EvaluateCurveAt(csmInt32 curveIndex, csmFloat32 time, csmBool isCorrection, csmFloat32 endTime) const
+{
+    if (_bakedTable != NULL &&
+        _bakedTable->Curves[curveIndex].BaseSampleIndex >= 0 &&
+        isCorrection == _bakedTable->IsCorrection &&
+        endTime == _bakedTable->EndTime)
+    {
+        return EvaluateBakedCurve(curveIndex, time);
+    }
+
+    return EvaluateCurve(_motionData, curveIndex, time, isCorrection, endTime);
+}
+
+csmFloat32 CubismMotion::EvaluateBakedCurve(csmInt32 curveIndex, csmFloat32 time) const
+{
+    const CubismMotionBakedTable::Curve& curve = _bakedTable->Curves[curveIndex];
+    const csmUint16* samples = &_bakedTable->Samples[curve.BaseSampleIndex];
+    const csmInt32 lastSample = _bakedTable->SampleCount - 1;
+
+    const csmFloat32 position = time * _bakedTable->InverseStep;
+
+    if (position <= 0.0f)
+    {
+        return curve.Offset + curve.Scale * samples[0];
+    }
+
+    csmInt32 index = static_cast<csmInt32>(position);
+
+    if (index >= lastSample)
+    {
+        return curve.Offset + curve.Scale * samples[lastSample];
+    }
+
+    const csmFloat32 t = position - static_cast<csmFloat32>(index);
+    const csmFloat32 sample = samples[index] + (static_cast<csmFloat32>(samples[index + 1]) - samples[index]) * t;
+
+    return curve.Offset + curve.Scale * sample;
+}
+
+csmBool CubismMotion::Bake(csmInt32 samplesPerFrame)
+{
+    ReleaseBake();
+
+    if (samplesPerFrame < 1)
+    {
+        samplesPerFrame = 1;
+    }
+
+    // 再生時と同じ条件で終点補正を含めてサンプリングする
+    const csmBool isCorrection = _motionBehavior == MotionBehavior_V2 && _isLoop;
+    const csmFloat32 fps = GetMotionFps(_motionData);
+    csmFloat32 endTime = _motionData->Duration;
+
+    if (_isLoop && _motionBehavior == MotionBehavior_V2)
+    {
+        endTime += 1.0f / fps;
+    }
+
+    if (endTime <= 0.0f)
+    {
+        return false;
+    }
+
+    // 同じ条件のテーブルは共有するモーションデータに一つだけ作る
+    std::lock_guard<std::mutex> lock(_motionData->BakedTablesMutex);
+
+    for (csmUint32 i = 0; i < _motionData->BakedTables.GetSize(); ++i)
+    {
+        const CubismMotionBakedTable* table = _motionData->BakedTables[i];
+
+        if (table->SamplesPerFrame == samplesPerFrame && table->IsCorrection == isCorrection && table->EndTime == endTime)
+        {
+            _bakedTable = table;
+            return true;
+        }
+    }
+
+    const csmFloat32 intervals = endTime * fps * samplesPerFrame;
+    csmInt32 sampleCount = static_cast<csmInt32>(intervals);
+    if (static_cast<csmFloat32>(sampleCount) < intervals)
+    {
+        ++sampleCount;
+    }
+    sampleCount += 1;
+    const csmFloat32 step = endTime / static_cast<csmFloat32>(sampleCount - 1);
+    csmVector<csmFloat32> values(sampleCount);
+    csmInt32 bakedCount = 0;
+
+    CubismMotionBakedTable* table = CSM_NEW CubismMotionBakedTable();
+    table->SamplesPerFrame = samplesPerFrame;
+    table->IsCorrection = isCorrection;
+    table->EndTime = endTime;
+    table->InverseStep = 1.0f / step;
+    table->SampleCount = sampleCount;
+    table->Curves.Resize(_motionData->CurveCount);
+
+    for (csmInt32 c = 0; c < _motionData->CurveCount; ++c)
+    {
+        const CubismMotionCurve& curve = _motionData->Curves[c];
+        CubismMotionBakedTable::Curve& baked = table->Curves[c];
+        csmBool hasStep = false;
+
+        baked.BaseSampleIndex = -1;
+        baked.Offset = 0.0f;
+        baked.Scale = 0.0f;
+
+        for (csmInt32 i = curve.BaseSegmentIndex; i < curve.BaseSegmentIndex + curve.SegmentCount; ++i)
+        {
+            const csmInt32 segmentType = _motionData->Segments[i].SegmentType;
+
+            if (segmentType == CubismMotionSegmentType_Stepped || segmentType == CubismMotionSegmentType_InverseStepped)
+            {
+                hasStep = true;
+                break;
+            }
+        }
+
+        if (hasStep)
+        {
+            continue;
+        }
+
+        values.Clear();
+        csmFloat32 minValue = 0.0f;
+        csmFloat32 maxValue = 0.0f;
+
+        for (csmInt32 i = 0; i < sampleCount; ++i)
+        {
+            // 終点補正は始点の値へ向かうので、最後のサンプルは始点の値にして補間を連続させる
+            const csmFloat32 time = (i == sampleCount - 1) ? (isCorrection ? 0.0f : endTime) : step * i;
+            const csmFloat32 value = EvaluateCurve(_motionData, c, time, isCorrection, endTime);
+
+            if (i == 0 || value < minValue) minValue = value;
+            if (i == 0 || value > maxValue) maxValue = value;
+
+            values.PushBack(value);
+        }
+
+        // 曲線ごとの範囲で16bitに量子化する
+        baked.BaseSampleIndex = static_cast<csmInt32>(table->Samples.GetSize());
+        baked.Offset = minValue;
+        baked.Scale = (maxValue - minValue) / 65535.0f;
+
+        for (csmInt32 i = 0; i < sampleCount; ++i)
+        {
+            const csmFloat32 quantized = (baked.Scale > 0.0f) ? (values[i] - minValue) / baked.Scale + 0.5f : 0.0f;
+
+            table->Samples.PushBack(static_cast<csmUint16>(CubismMath::RangeF(quantized, 0.0f, 65535.0f)));
+        }
+
+        ++bakedCount;
+    }
+
+    if (bakedCount == 0)
+    {
+        CSM_DELETE(table);
+        return false;
+    }
+
+    _motionData->BakedTables.PushBack(table);
+    _bakedTable = table;
+
+    return true;
+}
+
+void CubismMotion::ReleaseBake()
+{
+    _bakedTable = NULL;
+}
+
+csmBool CubismMotion::IsBaked() const
+{
+    return _bakedTable != NULL;
+}
+
+CubismMotion::BakeReport CubismMotion::GetBakeReport(csmInt32 probesPerSample) const
+{
+    BakeReport report;
+    report.BakedCurveCount = 0;
+    report.AnalyticCurveCount = _motionData->CurveCount;
+    report.SampleCount = 0;
+    report.TableBytes = 0;
+    report.MaxError = 0.0f;
+    report.MeanError = 0.0f;
+    report.MaxErrorCurveIndex = -1;
+
+    if (!IsBaked())
+    {
+        return report;
+    }
+
+    report.SampleCount = _bakedTable->SampleCount;
+    report.TableBytes = _bakedTable->Samples.GetSize() * sizeof(csmUint16) + _bakedTable->Curves.GetSize() * sizeof(CubismMotionBakedTable::Curve);
+
+    if (probesPerSample < 1)
+    {
+        probesPerSample = 1;
+    }
+
+    const csmFloat32 step = 1.0f / _bakedTable->InverseStep;
+    const csmFloat32 probeStep = step / probesPerSample;
+    csmFloat32 totalError = 0.0f;
+    csmInt32 probeCount = 0;
+
+    // サンプル間を等分した位置で解析的な評価と比較する
+    for (csmInt32 c = 0; c < _motionData->CurveCount; ++c)
+    {
+        if (_bakedTable->Curves[c].BaseSampleIndex < 0)
+        {
+            continue;
+        }
+
+        ++report.BakedCurveCount;
+        --report.AnalyticCurveCount;
+
+        for (csmInt32 i = 0; i < (_bakedTable->SampleCount - 1) * probesPerSample; ++i)
+        {
+            const csmFloat32 time = probeStep * i;
+            const csmFloat32 expected = EvaluateCurve(_motionData, c, time, _bakedTable->IsCorrection, _bakedTable->EndTime);
+            const csmFloat32 error = CubismMath::AbsF(EvaluateBakedCurve(c, time) - expected);
+
+            if (error > report.MaxError || report.MaxErrorCurveIndex < 0)
+            {
+                report.MaxError = error;
+                report.MaxErrorCurveIndex = c;
+            }
+
+            totalError += error;
+            ++probeCount;
+        }
+    }
+
+    report.MeanError = (probeCount > 0) ? totalError / probeCount : 0.0f;
+
+    return report;
+}
+
+void CubismMotion::EvaluateCurves(csmFloat32 timeSeconds, csmFloat32* values) const
+{
+    csmFloat32 time = (timeSeconds < 0.0f) ? 0.0f : timeSeconds;
+    csmFloat32 duration = _motionData->Duration;
+    const csmBool isCorrection = _motionBehavior == MotionBehavior_V2 && _isLoop;
+
+    if (_isLoop)
+    {
+        if (_motionBehavior == MotionBehavior_V2)
+        {
+            duration += 1.0f / GetMotionFps(_motionData);
+        }
+        while (duration > 0.0f && time > duration)
+        {
+            time -= duration;
+        }
+    }
+
+    for (csmInt32 c = 0; c < _motionData->CurveCount; ++c)
+    {
+        values[c] = EvaluateCurveAt(c, time, isCorrection, duration);
+    }
+}
+
 }}}
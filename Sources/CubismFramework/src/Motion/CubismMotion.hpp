@@ -16,6 +16,7 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismMotionQueueEntry;
 struct CubismMotionData;
+struct CubismMotionBakedTable;
 
 /**
  * Handles motions.
@@ -33,6 +34,20 @@ public:
         MotionBehavior_V2,
     };
 
+    /**
+     * Accuracy and size of the baked curves.
+     */
+    struct BakeReport
+    {
+        csmInt32    BakedCurveCount;        ///< Number of curves evaluated from the tables
+        csmInt32    AnalyticCurveCount;     ///< Number of curves left analytic because they contain steps
+        csmInt32    SampleCount;            ///< Number of samples per baked curve
+        csmSizeInt  TableBytes;             ///< Memory used by the tables in bytes
+        csmFloat32  MaxError;               ///< Largest absolute error against the analytic curves
+        csmFloat32  MeanError;              ///< Mean absolute error against the analytic curves
+        csmInt32    MaxErrorCurveIndex;     ///< Index of the curve with the largest error; -1 if nothing is baked
+    };
+
     /**
      * Makes an instance.
      *
@@ -46,6 +61,37 @@ public:
      */
     static CubismMotion* Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler = NULL, BeganMotionCallback onBeganMotionHandler = NULL, csmBool shouldCheckMotionConsistency = false);
 
+    /**
+     * Makes an instance that plays shared motion data.
+     *
+     * @param motionData motion data created by CreateMotionData() or CubismMotionDataCache; a reference is added
+     * @param onFinishedMotionHandler callback function for when motion playback ends
+     * @param onBeganMotionHandler callback function for when motion playback starts
+     *
+     * @return created instance
+     */
+    static CubismMotion* Create(CubismMotionData* motionData, FinishedMotionCallback onFinishedMotionHandler = NULL, BeganMotionCallback onBeganMotionHandler = NULL);
+
+    /**
+     * Parses a motion file into motion data that can be shared between instances.
+     *
+     * @param buffer buffer containing the loaded motion file
+     * @param size size of the buffer in bytes
+     * @param shouldCheckMotionConsistency flag to validate the consistency of motion3.json
+     *
+     * @return motion data with a reference count of 1; NULL on failure
+     *
+     * @note Release the returned data with CubismMotionData::Release().
+     */
+    static CubismMotionData* CreateMotionData(const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMotionConsistency = false);
+
+    /**
+     * Returns the motion data played by this instance.
+     *
+     * @return motion data
+     */
+    const CubismMotionData* GetMotionData() const;
+
     /**
      * Updates the model parameters.
      *
@@ -204,11 +250,57 @@ public:
      */
     CubismIdHandle GetModelOpacityId(csmInt32 index);
 
+    /**
+     * Pre-samples the curves into quantized tables evaluated by linear interpolation.<br>
+     * Each curve is stored as 16-bit samples with its own scale and offset.
+     *
+     * @param samplesPerFrame number of samples per frame of the source frame rate
+     *
+     * @return true if at least one curve was baked; otherwise false.
+     *
+     * @note The tables are kept by the shared motion data, so the instances sharing it bake once<br>
+     *       for each loop setting, motion behavior and samplesPerFrame.<br>
+     *       Curves with stepped segments stay analytic, since interpolation would blur the steps.<br>
+     *       The tables are bypassed if the loop setting or the motion behavior changes after baking.
+     */
+    csmBool Bake(csmInt32 samplesPerFrame = 2);
+
+    /**
+     * Returns to analytic evaluation.
+     *
+     * @note The tables stay with the shared motion data until it is released.
+     */
+    void ReleaseBake();
+
+    /**
+     * Checks whether the curves are baked.
+     *
+     * @return true if baked; otherwise false.
+     */
+    csmBool IsBaked() const;
+
+    /**
+     * Measures the baked tables against the analytic curves.
+     *
+     * @param probesPerSample number of evaluation points between two samples
+     *
+     * @return report of the baked tables
+     */
+    BakeReport GetBakeReport(csmInt32 probesPerSample = 4) const;
+
+    /**
+     * Evaluates every curve at a time in the motion without applying the values to a model.
+     *
+     * @param timeSeconds time in the motion in seconds, wrapped like playback when looping
+     * @param values array receiving one value per curve, in curve order
+     */
+    void EvaluateCurves(csmFloat32 timeSeconds, csmFloat32* values) const;
+
 protected:
     csmFloat32 GetModelOpacityValue() const;
 
 private:
-    CubismMotion();
+    CubismMotion(CubismMotionData* motionData);
 
     virtual ~CubismMotion();
 
@@ -217,14 +309,33 @@ private:
 
     void UpdateForNextLoop(CubismMotionQueueEntry* motionQueueEntry, const csmFloat32 userTimeSeconds, const csmFloat32 time);
 
-    void Parse(const csmByte* motionJson, const csmSizeInt size, csmBool shouldCheckMotionConsistency);
+    csmFloat32 GetCurveFadeInTime(csmInt32 curveIndex) const;
+
+    csmFloat32 GetCurveFadeOutTime(csmInt32 curveIndex) const;
+
+    csmInt32 FindCurveIndex(CubismIdHandle parameterId) const;
+
+    void PrepareCurveFadeTimes();
+
+    /**
+     * Evaluates a curve from its baked table if available, otherwise analytically.
+     */
+    csmFloat32 EvaluateCurveAt(csmInt32 curveIndex, csmFloat32 time, csmBool isCorrection, csmFloat32 endTime) const;
+
+    /**
+     * Evaluates a curve from its baked table.
+     */
+    csmFloat32 EvaluateBakedCurve(csmInt32 curveIndex, csmFloat32 time) const;
 
     csmFloat32      _sourceFrameRate;
     csmFloat32      _loopDurationSeconds;
     MotionBehavior  _motionBehavior;
     csmFloat32      _lastWeight;
 
-    CubismMotionData*    _motionData;
+    CubismMotionData*    _motionData;                ///< Shared, immutable motion data
+
+    csmVector<csmFloat32>  _curveFadeInTimes;      ///< Per-instance overrides of the curve fade-in times. Empty if not overridden.
+    csmVector<csmFloat32>  _curveFadeOutTimes;     ///< Per-instance overrides of the curve fade-out times. Empty if not overridden.
 
     csmVector<CubismIdHandle>  _eyeBlinkParameterIds;
     csmVector<CubismIdHandle>  _lipSyncParameterIds;
@@ -234,6 +345,8 @@ private:
     CubismIdHandle _modelCurveIdOpacity;
 
     csmFloat32 _modelOpacity;
+
+    const CubismMotionBakedTable* _bakedTable;      ///< Baked tables kept by _motionData; NULL if not baked
 };
 
 }}}
@@ -0,0 +1,221 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMotionDataCache.hpp"
+#include <string.h>
+#include "CubismMotion.hpp"
+#include "CubismMotionInternal.hpp"
+#include "Utils/CubismPoolAllocator.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismMotionDataCache::CubismMotionDataCache()
+{ }
+
+CubismMotionDataCache::~CubismMotionDataCache()
+{
+    Clear();
+}
+
+CubismMotionData* CubismMotionDataCache::Acquire(const csmChar* filePath, const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMotionConsistency)
+{
+    if (filePath == NULL || buffer == NULL)
+    {
+        return NULL;
+    }
+
+    // キャッシュするデータは他のモデルも使うので、呼び出し元のモデルのアリーナからは割り当てない
+    CubismPoolAllocator::ArenaScope arenaScope(NULL);
+
+    const CubismContentHash hash = CubismContentHash::Compute(buffer, size);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        CubismMotionData* motionData = AcquireCachedData(filePath, hash, size);
+        if (motionData != NULL)
+        {
+            return motionData;
+        }
+    }
+
+    // 解析はロックの外で行い、別スレッドからの要求を止めない
+    CubismMotionData* motionData = CubismMotion::CreateMotionData(buffer, size, shouldCheckMotionConsistency);
+
+    if (motionData == NULL)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // 解析中に他のスレッドが登録していればそちらを使う
+    CubismMotionData* cachedData = AcquireCachedData(filePath, hash, size);
+    if (cachedData != NULL)
+    {
+        motionData->Release();
+        return cachedData;
+    }
+
+    Entry* entry = CSM_NEW Entry();
+    entry->FilePath = filePath;
+    entry->Hash = hash;
+    entry->Size = size;
+    entry->MotionData = motionData;
+    _entries.PushBack(entry, false);
+
+    // 呼び出し元の参照
+    motionData->Retain();
+
+    return motionData;
+}
+
+CubismMotionData* CubismMotionDataCache::Find(const csmChar* filePath)
+{
+    if (filePath == NULL)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const csmInt32 index = FindEntryIndex(filePath);
+
+    if (index < 0)
+    {
+        return NULL;
+    }
+
+    _entries[index]->MotionData->Retain();
+
+    return _entries[index]->MotionData;
+}
+
+void CubismMotionDataCache::Remove(const csmChar* filePath)
+{
+    if (filePath == NULL)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const csmInt32 index = FindEntryIndex(filePath);
+
+    if (index >= 0)
+    {
+        RemoveEntry(index);
+    }
+}
+
+csmInt32 CubismMotionDataCache::Purge()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    csmInt32 removedCount = 0;
+
+    for (csmInt32 i = static_cast<csmInt32>(_entries.GetSize()) - 1; i >= 0; --i)
+    {
+        if (_entries[i]->MotionData->GetReferenceCount() > 1)
+        {
+            continue;
+        }
+
+        RemoveEntry(i);
+        ++removedCount;
+    }
+
+    return removedCount;
+}
+
+void CubismMotionDataCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (csmInt32 i = static_cast<csmInt32>(_entries.GetSize()) - 1; i >= 0; --i)
+    {
+        RemoveEntry(i);
+    }
+}
+
+csmInt32 CubismMotionDataCache::GetSize()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return static_cast<csmInt32>(_entries.GetSize());
+}
+
+csmInt32 CubismMotionDataCache::FindEntryIndex(const csmChar* filePath) const
+{
+    for (csmUint32 i = 0; i < _entries.GetSize(); ++i)
+    {
+        if (strcmp(_entries[i]->FilePath.GetRawString(), filePath) == 0)
+        {
+            return static_cast<csmInt32>(i);
+        }
+    }
+
+    return -1;
+}
+
+CubismMotionData* CubismMotionDataCache::AcquireCachedData(const csmChar* filePath, const CubismContentHash& hash, csmSizeInt size)
+{
+    const csmInt32 index = FindEntryIndex(filePath);
+
+    if (index >= 0)
+    {
+        if (IsSameContent(_entries[index], hash, size))
+        {
+            _entries[index]->MotionData->Retain();
+            return _entries[index]->MotionData;
+        }
+
+        // 内容が変わっているので作り直す
+        RemoveEntry(index);
+    }
+
+    // 別パスで同一内容のデータがあれば共有する
+    for (csmUint32 i = 0; i < _entries.GetSize(); ++i)
+    {
+        if (!IsSameContent(_entries[i], hash, size))
+        {
+            continue;
+        }
+
+        CubismMotionData* motionData = _entries[i]->MotionData;
+
+        Entry* entry = CSM_NEW Entry();
+        entry->FilePath = filePath;
+        entry->Hash = hash;
+        entry->Size = size;
+        entry->MotionData = motionData;
+        _entries.PushBack(entry, false);
+
+        // キャッシュと呼び出し元の参照
+        motionData->Retain();
+        motionData->Retain();
+
+        return motionData;
+    }
+
+    return NULL;
+}
+
+void CubismMotionDataCache::RemoveEntry(csmInt32 index)
+{
+    _entries[index]->MotionData->Release();
+    CSM_DELETE(_entries[index]);
+    _entries.Remove(index);
+}
+
+csmBool CubismMotionDataCache::IsSameContent(const Entry* entry, const CubismContentHash& hash, csmSizeInt size)
+{
+    // 内容は保持しないので、大きさと128ビットのハッシュで同一とみなす
+    return entry->Size == size && entry->Hash == hash;
+}
+
+}}}
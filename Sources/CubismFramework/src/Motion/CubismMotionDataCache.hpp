@@ -0,0 +1,119 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmString.hpp"
+#include "Type/csmVector.hpp"
+#include "Utils/CubismContentHash.hpp"
+#include <mutex>
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+struct CubismMotionData;
+
+/**
+ * Shares parsed motion data between motion instances and models.
+ *
+ * @note Entries are keyed by file path, size and 128-bit content hash. The cache keeps no copy of the file.<br>
+ *       A path whose content changed is parsed again; identical content under another path is shared.<br>
+ *       All methods are thread-safe. Parsing runs outside the lock, so different files can be parsed concurrently.
+ */
+class CubismMotionDataCache
+{
+public:
+    /**
+     * Constructor
+     */
+    CubismMotionDataCache();
+
+    /**
+     * Destructor
+     *
+     * @note Releases the references held by the cache. Data still used by motions stays alive.
+     */
+    virtual ~CubismMotionDataCache();
+
+    /**
+     * Returns the motion data for the file, parsing it on the first request.
+     *
+     * @param filePath path of the motion file used as the cache key
+     * @param buffer buffer containing the loaded motion file
+     * @param size size of the buffer in bytes
+     * @param shouldCheckMotionConsistency flag to validate the consistency of motion3.json
+     *
+     * @return motion data with a reference added for the caller; NULL on failure
+     *
+     * @note Release the returned data with CubismMotionData::Release(),<br>
+     *       typically after handing it to CubismMotion::Create().
+     */
+    CubismMotionData* Acquire(const csmChar* filePath, const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMotionConsistency = false);
+
+    /**
+     * Returns the cached motion data for the file without parsing.
+     *
+     * @param filePath path of the motion file
+     *
+     * @return motion data with a reference added for the caller; NULL if not cached
+     */
+    CubismMotionData* Find(const csmChar* filePath);
+
+    /**
+     * Removes the entry of the file from the cache.
+     *
+     * @param filePath path of the motion file
+     */
+    void Remove(const csmChar* filePath);
+
+    /**
+     * Removes the entries that are referenced only by the cache.
+     *
+     * @return number of removed entries
+     */
+    csmInt32 Purge();
+
+    /**
+     * Removes all entries.
+     */
+    void Clear();
+
+    /**
+     * Returns the number of cached entries.
+     *
+     * @return number of entries
+     */
+    csmInt32 GetSize();
+
+private:
+    /**
+     * Cache entry
+     */
+    struct Entry
+    {
+        csmString FilePath;             ///< Path of the motion file
+        CubismContentHash Hash;         ///< Content hash of the motion file
+        csmSizeInt Size;                ///< Size of the motion file in bytes
+        CubismMotionData* MotionData;   ///< Shared motion data. The cache owns one reference.
+    };
+
+    CubismMotionDataCache(const CubismMotionDataCache&);
+    CubismMotionDataCache& operator=(const CubismMotionDataCache&);
+
+    csmInt32 FindEntryIndex(const csmChar* filePath) const;
+
+    CubismMotionData* AcquireCachedData(const csmChar* filePath, const CubismContentHash& hash, csmSizeInt size);
+
+    void RemoveEntry(csmInt32 index);
+
+    static csmBool IsSameContent(const Entry* entry, const CubismContentHash& hash, csmSizeInt size);
+
+    csmVector<Entry*> _entries;
+    std::mutex _mutex;
+};
+
+}}}
@@ -8,6 +8,11 @@
 #pragma once
 
 #include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+#include "Type/csmString.hpp"
+#include "Id/CubismId.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -116,13 +121,45 @@ struct CubismMotionEvent
     csmString   Value;          ///< Value
 };
 
+/**
+ * Curves of a motion pre-sampled into quantized tables by CubismMotion::Bake()
+ *
+ * @note Immutable once made. Kept by CubismMotionData, so the motions sharing the data share the tables.
+ */
+struct CubismMotionBakedTable
+{
+    /**
+     * Table of a curve
+     */
+    struct Curve
+    {
+        csmInt32    BaseSampleIndex;    ///< Index of the first sample; -1 if the curve is evaluated analytically
+        csmFloat32  Offset;             ///< Value of the sample 0
+        csmFloat32  Scale;              ///< Value of one quantization step
+    };
+
+    csmInt32 SamplesPerFrame;           ///< Samples per frame of the source frame rate the tables were made with
+    csmBool IsCorrection;               ///< Whether the tables include the loop end point correction
+    csmFloat32 EndTime;                 ///< End time the tables were sampled up to
+    csmFloat32 InverseStep;             ///< Samples per second
+    csmInt32 SampleCount;               ///< Number of samples per baked curve
+    csmVector<Curve> Curves;            ///< Table of each curve
+    csmVector<csmUint16> Samples;       ///< Quantized samples of all baked curves
+};
+
 /**
  * Data for motion
+ *
+ * @note Immutable once parsed and reference counted, so a single instance can be shared<br>
+ *       by any number of CubismMotion instances on any thread. Only BakedTables grows later, under BakedTablesMutex.<br>
+ *       Use Retain() / Release() instead of deleting it directly.
  */
 struct CubismMotionData
 {
     /**
      * Constructor
+     *
+     * @note The reference count starts at 1, owned by the creator.
      */
     CubismMotionData()
         : Duration(0.0f)
@@ -130,17 +167,70 @@ struct CubismMotionData
         , CurveCount(0)
         , EventCount(0)
         , Fps(0.0f)
+        , FadeInSeconds(1.0f)
+        , FadeOutSeconds(1.0f)
+        , _referenceCount(1)
     { }
 
+    /**
+     * Destructor
+     */
+    ~CubismMotionData()
+    {
+        for (csmUint32 i = 0; i < BakedTables.GetSize(); ++i)
+        {
+            CSM_DELETE(BakedTables[i]);
+        }
+    }
+
+    /**
+     * Adds a reference.
+     */
+    void Retain()
+    {
+        _referenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Removes a reference and destroys the data when the last one is released.
+     */
+    void Release()
+    {
+        if (_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            CSM_DELETE(this);
+        }
+    }
+
+    /**
+     * Returns the number of references.
+     *
+     * @return number of references
+     */
+    csmInt32 GetReferenceCount() const
+    {
+        return _referenceCount.load(std::memory_order_acquire);
+    }
+
     csmFloat32 Duration;                            ///< Motion length [seconds]
     csmInt16 Loop;                                  ///< Whether to loop
     csmInt16 CurveCount;                            ///< Number of curves
     csmInt32 EventCount;                            ///< Number of user data events
     csmFloat32 Fps;                                 ///< Motion frame rate
+    csmFloat32 FadeInSeconds;                       ///< Fade-in time of the motion declared in the file [seconds]
+    csmFloat32 FadeOutSeconds;                      ///< Fade-out time of the motion declared in the file [seconds]
     csmVector<CubismMotionCurve> Curves;            ///< Curve collection
     csmVector<CubismMotionSegment> Segments;        ///< Segment collection
     csmVector<CubismMotionPoint> Points;            ///< Control point collection
     csmVector<CubismMotionEvent> Events;            ///< User data event collection
+    csmVector<CubismMotionBakedTable*> BakedTables; ///< Tables made by CubismMotion::Bake(), one per set of bake conditions
+    std::mutex BakedTablesMutex;                    ///< Guards BakedTables
+
+private:
+    CubismMotionData(const CubismMotionData&);
+    CubismMotionData& operator=(const CubismMotionData&);
+
+    std::atomic<csmInt32> _referenceCount;          ///< Number of references
 };
 
 }}}
@@ -0,0 +1,403 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMotionLoader.hpp"
+#include "CubismExpressionMotion.hpp"
+#include "CubismMotion.hpp"
+#include "CubismMotionDataCache.hpp"
+#include "CubismMotionInternal.hpp"
+#include "Utils/CubismDebug.hpp"
+#include "Utils/CubismMemoryTracker.hpp"
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismMotionLoadHandle::CubismMotionLoadHandle(const csmChar* filePath, csmBool isExpression, CubismMotionLoadPriority priority,
+                                               CubismMemoryAccount* memoryAccount, csmBool shouldCheckMotionConsistency)
+    : _filePath(filePath)
+    , _isExpression(isExpression)
+    , _shouldCheckMotionConsistency(shouldCheckMotionConsistency)
+    , _memoryAccount(memoryAccount)
+    , _sequence(0)
+    , _priority(priority)
+    , _state(State_Pending)
+    , _referenceCount(1)
+    , _motionData(NULL)
+    , _expression(NULL)
+{
+    if (_memoryAccount != NULL)
+    {
+        _memoryAccount->Retain();
+    }
+}
+
+CubismMotionLoadHandle::~CubismMotionLoadHandle()
+{
+    if (_motionData != NULL)
+    {
+        _motionData->Release();
+    }
+
+    if (_expression != NULL)
+    {
+        ACubismMotion::Delete(_expression);
+    }
+
+    if (_memoryAccount != NULL)
+    {
+        _memoryAccount->Release();
+    }
+}
+
+void CubismMotionLoadHandle::Retain()
+{
+    _referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CubismMotionLoadHandle::Release()
+{
+    if (_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // CSM_DELETE_SELF は this を NULL と比較するので、デストラクタと解放を直接呼ぶ
+        this->~CubismMotionLoadHandle();
+#ifdef CSM_ALLOCATION_CALL_SITES
+        operator delete(this, GlobalTag, __FILE__, __LINE__);
+#else
+        operator delete(this, GlobalTag);
+#endif
+    }
+}
+
+CubismMotionLoadHandle::State CubismMotionLoadHandle::GetState() const
+{
+    return static_cast<State>(_state.load(std::memory_order_acquire));
+}
+
+csmBool CubismMotionLoadHandle::IsDone() const
+{
+    return GetState() != State_Pending;
+}
+
+void CubismMotionLoadHandle::Wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_state.load(std::memory_order_acquire) == State_Pending)
+    {
+        _doneCondition.wait(lock);
+    }
+}
+
+const csmString& CubismMotionLoadHandle::GetFilePath() const
+{
+    return _filePath;
+}
+
+csmBool CubismMotionLoadHandle::IsExpression() const
+{
+    return _isExpression;
+}
+
+CubismMotionLoadPriority CubismMotionLoadHandle::GetPriority() const
+{
+    return static_cast<CubismMotionLoadPriority>(_priority.load(std::memory_order_relaxed));
+}
+
+CubismMotionData* CubismMotionLoadHandle::AcquireMotionData() const
+{
+    if (GetState() != State_Ready || _motionData == NULL)
+    {
+        return NULL;
+    }
+
+    _motionData->Retain();
+
+    return _motionData;
+}
+
+ACubismMotion* CubismMotionLoadHandle::TakeExpression()
+{
+    if (GetState() != State_Ready)
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    ACubismMotion* expression = _expression;
+    _expression = NULL;
+
+    return expression;
+}
+
+void CubismMotionLoadHandle::Finish(State state)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _state.store(state, std::memory_order_release);
+    }
+    _doneCondition.notify_all();
+}
+
+CubismMotionLoader* CubismMotionLoader::Create(csmInt32 workerCount)
+{
+    return CSM_NEW CubismMotionLoader(workerCount);
+}
+
+void CubismMotionLoader::Delete(CubismMotionLoader* loader)
+{
+    CSM_DELETE_SELF(CubismMotionLoader, loader);
+}
+
+CubismMotionLoader::CubismMotionLoader(csmInt32 workerCount)
+    : _nextSequence(0)
+    , _isStopping(false)
+{
+    for (csmInt32 i = 0; i < workerCount; ++i)
+    {
+        _workers.PushBack(CSM_NEW std::thread(&CubismMotionLoader::WorkerMain, this));
+    }
+}
+
+CubismMotionLoader::~CubismMotionLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _wakeCondition.notify_all();
+
+    for (csmUint32 i = 0; i < _workers.GetSize(); ++i)
+    {
+        _workers[i]->join();
+        CSM_DELETE(_workers[i]);
+    }
+    _workers.Clear();
+
+    // ワーカーが取り出さなかった要求は中止する
+    for (csmUint32 i = 0; i < _queue.GetSize(); ++i)
+    {
+        _queue[i]->Finish(CubismMotionLoadHandle::State_Cancelled);
+        _queue[i]->Release();
+    }
+    _queue.Clear();
+}
+
+csmInt32 CubismMotionLoader::GetWorkerCount() const
+{
+    return static_cast<csmInt32>(_workers.GetSize());
+}
+
+CubismMotionLoadHandle* CubismMotionLoader::RequestMotion(const csmChar* filePath, CubismMotionLoadPriority priority,
+                                                          CubismMemoryAccount* memoryAccount, csmBool shouldCheckMotionConsistency)
+{
+    if (filePath == NULL)
+    {
+        return NULL;
+    }
+
+    CubismMotionLoadHandle* handle = CSM_NEW CubismMotionLoadHandle(filePath, false, priority, memoryAccount, shouldCheckMotionConsistency);
+
+    // 解析済みのデータがあればキューを通さずに返す
+    CubismMotionDataCache* cache = CubismFramework::GetMotionDataCache();
+    if (cache != NULL)
+    {
+        handle->_motionData = cache->Find(filePath);
+        if (handle->_motionData != NULL)
+        {
+            handle->Finish(CubismMotionLoadHandle::State_Ready);
+            return handle;
+        }
+    }
+
+    Enqueue(handle);
+
+    return handle;
+}
+
+CubismMotionLoadHandle* CubismMotionLoader::RequestExpression(const csmChar* filePath, CubismMotionLoadPriority priority,
+                                                              CubismMemoryAccount* memoryAccount)
+{
+    if (filePath == NULL)
+    {
+        return NULL;
+    }
+
+    CubismMotionLoadHandle* handle = CSM_NEW CubismMotionLoadHandle(filePath, true, priority, memoryAccount, false);
+
+    Enqueue(handle);
+
+    return handle;
+}
+
+void CubismMotionLoader::SetPriority(CubismMotionLoadHandle* handle, CubismMotionLoadPriority priority)
+{
+    if (handle == NULL)
+    {
+        return;
+    }
+
+    // 優先度は取り出すときに比べるので、キューの並べ替えは不要
+    std::lock_guard<std::mutex> lock(_mutex);
+    handle->_priority.store(priority, std::memory_order_relaxed);
+}
+
+csmBool CubismMotionLoader::Cancel(CubismMotionLoadHandle* handle)
+{
+    if (handle == NULL)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        csmInt32 index = -1;
+        for (csmUint32 i = 0; i < _queue.GetSize(); ++i)
+        {
+            if (_queue[i] == handle)
+            {
+                index = static_cast<csmInt32>(i);
+                break;
+            }
+        }
+
+        if (index < 0)
+        {
+            return false;
+        }
+
+        _queue.Remove(index);
+    }
+
+    handle->Finish(CubismMotionLoadHandle::State_Cancelled);
+    handle->Release();
+
+    return true;
+}
+
+csmInt32 CubismMotionLoader::GetQueuedCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<csmInt32>(_queue.GetSize());
+}
+
+void CubismMotionLoader::Enqueue(CubismMotionLoadHandle* handle)
+{
+    // ワーカーが無い場合は呼び出しスレッドで処理する
+    if (_workers.GetSize() == 0)
+    {
+        Decode(handle);
+        return;
+    }
+
+    handle->Retain();   // キューの参照
+
+    {
+        // キューは全モデルで共有するので、要求したモデルには計上しない
+        CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
+        std::lock_guard<std::mutex> lock(_mutex);
+        handle->_sequence = _nextSequence++;
+        _queue.PushBack(handle);
+    }
+    _wakeCondition.notify_one();
+}
+
+void CubismMotionLoader::WorkerMain()
+{
+    for (;;)
+    {
+        CubismMotionLoadHandle* handle = NULL;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_isStopping && _queue.GetSize() == 0)
+            {
+                _wakeCondition.wait(lock);
+            }
+
+            if (_isStopping)
+            {
+                return;
+            }
+
+            // 優先度の高いものから、同じ優先度なら要求順に取り出す
+            csmUint32 best = 0;
+            for (csmUint32 i = 1; i < _queue.GetSize(); ++i)
+            {
+                const csmInt32 priority = _queue[i]->_priority.load(std::memory_order_relaxed);
+                const csmInt32 bestPriority = _queue[best]->_priority.load(std::memory_order_relaxed);
+
+                if (priority > bestPriority || (priority == bestPriority && _queue[i]->_sequence < _queue[best]->_sequence))
+                {
+                    best = i;
+                }
+            }
+
+            handle = _queue[best];
+            _queue.Remove(static_cast<csmInt32>(best));
+        }
+
+        Decode(handle);
+        handle->Release();
+    }
+}
+
+void CubismMotionLoader::Decode(CubismMotionLoadHandle* handle)
+{
+    csmLoadFileFunction loadFile = CubismFramework::GetLoadFileFunction();
+    csmReleaseBytesFunction releaseBytes = CubismFramework::GetReleaseBytesFunction();
+
+    if (loadFile == NULL || releaseBytes == NULL)
+    {
+        CubismLogError("CubismMotionLoader requires LoadFileFunction and ReleaseBytesFunction.");
+        handle->Finish(CubismMotionLoadHandle::State_Failed);
+        return;
+    }
+
+    csmSizeInt size = 0;
+    csmByte* buffer = loadFile(handle->_filePath.GetRawString(), &size);
+
+    if (buffer == NULL)
+    {
+        CubismLogError("Failed to load %s.", handle->_filePath.GetRawString());
+        handle->Finish(CubismMotionLoadHandle::State_Failed);
+        return;
+    }
+
+    csmBool isDecoded = false;
+
+    {
+        // 解析したデータは要求元のモデルに計上する
+        CubismMemoryScope memoryScope(handle->_memoryAccount,
+                                      handle->_isExpression ? CubismMemoryCategory_Expression : CubismMemoryCategory_Motion);
+
+        if (handle->_isExpression)
+        {
+            ACubismMotion* expression = CubismExpressionMotion::Create(buffer, size);
+
+            std::lock_guard<std::mutex> lock(handle->_mutex);
+            handle->_expression = expression;
+            isDecoded = (expression != NULL);
+        }
+        else
+        {
+            CubismMotionDataCache* cache = CubismFramework::GetMotionDataCache();
+
+            handle->_motionData = (cache != NULL)
+                                      ? cache->Acquire(handle->_filePath.GetRawString(), buffer, size, handle->_shouldCheckMotionConsistency)
+                                      : CubismMotion::CreateMotionData(buffer, size, handle->_shouldCheckMotionConsistency);
+            isDecoded = (handle->_motionData != NULL);
+        }
+    }
+
+    releaseBytes(buffer);
+
+    handle->Finish(isDecoded ? CubismMotionLoadHandle::State_Ready : CubismMotionLoadHandle::State_Failed);
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
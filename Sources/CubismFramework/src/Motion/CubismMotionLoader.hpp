@@ -0,0 +1,301 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmString.hpp"
+#include "Type/csmVector.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class ACubismMotion;
+class CubismMemoryAccount;
+class CubismMotionLoader;
+struct CubismMotionData;
+
+/**
+ * Order in which queued load requests are decoded.
+ */
+enum CubismMotionLoadPriority
+{
+    CubismMotionLoadPriority_Low = 0,       ///< Motions that may never play
+    CubismMotionLoadPriority_Normal,        ///< Default
+    CubismMotionLoadPriority_High,          ///< Motions needed right away, such as the idle group
+};
+
+/**
+ * Result of a load request made with CubismMotionLoader.
+ *
+ * @note The handle is reference counted. The requester owns one reference and releases it with Release().<br>
+ *       State and results may be read from any thread.
+ */
+class CubismMotionLoadHandle
+{
+    friend class CubismMotionLoader;
+
+public:
+    /**
+     * State of the request
+     */
+    enum State
+    {
+        State_Pending = 0,      ///< Queued or being decoded
+        State_Ready,            ///< Decoded successfully
+        State_Failed,           ///< The file could not be read or parsed
+        State_Cancelled,        ///< Removed from the queue before it was decoded
+    };
+
+    /**
+     * Adds a reference.
+     */
+    void Retain();
+
+    /**
+     * Removes a reference and destroys the handle when none remain.
+     */
+    void Release();
+
+    /**
+     * Returns the state of the request.
+     *
+     * @return state
+     */
+    State GetState() const;
+
+    /**
+     * Returns whether the request has left the pending state.
+     *
+     * @return true if ready, failed or cancelled
+     */
+    csmBool IsDone() const;
+
+    /**
+     * Blocks until the request is done.
+     */
+    void Wait();
+
+    /**
+     * Returns the path of the requested file.
+     *
+     * @return file path
+     */
+    const csmString& GetFilePath() const;
+
+    /**
+     * Returns whether the request is for an expression.
+     *
+     * @return true for expressions, false for motions
+     */
+    csmBool IsExpression() const;
+
+    /**
+     * Returns the current priority of the request.
+     *
+     * @return priority
+     */
+    CubismMotionLoadPriority GetPriority() const;
+
+    /**
+     * Returns the decoded motion data.
+     *
+     * @return motion data with a reference added for the caller; NULL unless a motion request is ready
+     *
+     * @note Release the returned data with CubismMotionData::Release().
+     */
+    CubismMotionData* AcquireMotionData() const;
+
+    /**
+     * Takes the decoded expression out of the handle.
+     *
+     * @return expression owned by the caller; NULL unless an expression request is ready or if already taken
+     *
+     * @note Destroy the returned expression with ACubismMotion::Delete().
+     */
+    ACubismMotion* TakeExpression();
+
+private:
+    /**
+     * Constructor
+     *
+     * @param filePath path of the requested file
+     * @param isExpression true for an expression request
+     * @param priority priority of the request
+     * @param memoryAccount account charged for the decoded data; may be NULL
+     * @param shouldCheckMotionConsistency flag to validate the consistency of motion3.json
+     */
+    CubismMotionLoadHandle(const csmChar* filePath, csmBool isExpression, CubismMotionLoadPriority priority,
+                           CubismMemoryAccount* memoryAccount, csmBool shouldCheckMotionConsistency);
+
+    /**
+     * Destructor
+     */
+    virtual ~CubismMotionLoadHandle();
+
+    // Prevention of copy Constructor
+    CubismMotionLoadHandle(const CubismMotionLoadHandle&);
+    CubismMotionLoadHandle& operator=(const CubismMotionLoadHandle&);
+
+    /**
+     * Publishes the result and wakes the threads waiting for it.
+     *
+     * @param state final state
+     */
+    void Finish(State state);
+
+    csmString _filePath;                            ///< Path of the requested file
+    csmBool _isExpression;                          ///< True for an expression request
+    csmBool _shouldCheckMotionConsistency;          ///< Flag to validate the consistency of motion3.json
+    CubismMemoryAccount* _memoryAccount;            ///< Account charged for the decoded data
+    csmUint64 _sequence;                            ///< Order of the request among requests of the same priority
+    std::atomic<csmInt32> _priority;                ///< Current priority
+    std::atomic<csmInt32> _state;                   ///< Current state
+    std::atomic<csmInt32> _referenceCount;          ///< Number of references
+    CubismMotionData* _motionData;                  ///< Decoded motion data. Written once before the state becomes ready.
+    ACubismMotion* _expression;                     ///< Decoded expression until taken
+    std::mutex _mutex;                              ///< Guards the expression and the wait
+    std::condition_variable _doneCondition;         ///< Signals that the request is done
+};
+
+/**
+ * Decodes motion3.json and exp3.json files on background threads.
+ *
+ * @note Files are read with the LoadFileFunction of CubismFramework::Option, which must be callable from any thread.<br>
+ *       Motion data is decoded through CubismFramework::GetMotionDataCache(), so a file requested twice is parsed once.<br>
+ *       Queued requests are decoded in priority order, then in request order. A loader with no workers decodes<br>
+ *       each request on the requesting thread.
+ */
+class CubismMotionLoader
+{
+public:
+    /**
+     * Makes an instance and starts its workers.
+     *
+     * @param workerCount number of worker threads
+     *
+     * @return Made instance
+     */
+    static CubismMotionLoader* Create(csmInt32 workerCount);
+
+    /**
+     * Stops the workers and destroys the instance.
+     *
+     * @param loader instance to destroy
+     *
+     * @note Requests still queued are cancelled. Requests being decoded finish first.
+     */
+    static void Delete(CubismMotionLoader* loader);
+
+    /**
+     * Returns the number of worker threads.
+     *
+     * @return number of worker threads
+     */
+    csmInt32 GetWorkerCount() const;
+
+    /**
+     * Requests a motion file.
+     *
+     * @param filePath path of the motion3.json file
+     * @param priority priority of the request
+     * @param memoryAccount account charged for the decoded data; may be NULL
+     * @param shouldCheckMotionConsistency flag to validate the consistency of motion3.json
+     *
+     * @return handle with a reference owned by the caller; already ready if the cache holds the file
+     */
+    CubismMotionLoadHandle* RequestMotion(const csmChar* filePath, CubismMotionLoadPriority priority = CubismMotionLoadPriority_Normal,
+                                          CubismMemoryAccount* memoryAccount = NULL, csmBool shouldCheckMotionConsistency = false);
+
+    /**
+     * Requests an expression file.
+     *
+     * @param filePath path of the exp3.json file
+     * @param priority priority of the request
+     * @param memoryAccount account charged for the decoded data; may be NULL
+     *
+     * @return handle with a reference owned by the caller
+     */
+    CubismMotionLoadHandle* RequestExpression(const csmChar* filePath, CubismMotionLoadPriority priority = CubismMotionLoadPriority_Normal,
+                                              CubismMemoryAccount* memoryAccount = NULL);
+
+    /**
+     * Changes the priority of a queued request.
+     *
+     * @param handle handle returned by this loader
+     * @param priority new priority
+     *
+     * @note Has no effect once the request is being decoded.
+     */
+    void SetPriority(CubismMotionLoadHandle* handle, CubismMotionLoadPriority priority);
+
+    /**
+     * Removes a request from the queue.
+     *
+     * @param handle handle returned by this loader
+     *
+     * @return true if the request was cancelled; false if it is being decoded or already done
+     */
+    csmBool Cancel(CubismMotionLoadHandle* handle);
+
+    /**
+     * Returns the number of queued requests.
+     *
+     * @return number of requests not yet taken by a worker
+     */
+    csmInt32 GetQueuedCount();
+
+private:
+    /**
+     * Constructor
+     *
+     * @param workerCount number of worker threads
+     */
+    CubismMotionLoader(csmInt32 workerCount);
+
+    /**
+     * Destructor
+     */
+    virtual ~CubismMotionLoader();
+
+    // Prevention of copy Constructor
+    CubismMotionLoader(const CubismMotionLoader&);
+    CubismMotionLoader& operator=(const CubismMotionLoader&);
+
+    /**
+     * Queues a request, or decodes it right away when there are no workers.
+     *
+     * @param handle request to queue; the queue takes a reference
+     */
+    void Enqueue(CubismMotionLoadHandle* handle);
+
+    /**
+     * Loop of a worker thread.
+     */
+    void WorkerMain();
+
+    /**
+     * Reads and decodes the file of a request.
+     *
+     * @param handle request to decode
+     */
+    static void Decode(CubismMotionLoadHandle* handle);
+
+    csmVector<std::thread*> _workers;                   ///< Worker threads
+    csmVector<CubismMotionLoadHandle*> _queue;          ///< Requests not yet taken by a worker
+    std::mutex _mutex;                                  ///< Guards the queue
+    std::condition_variable _wakeCondition;             ///< Signals workers that a request was queued or the loader stops
+    csmUint64 _nextSequence;                            ///< Sequence given to the next request
+    csmBool _isStopping;                                ///< True while the loader shuts down
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,83 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMotionLodPolicy.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismMotionLodPolicy::CubismMotionLodPolicy()
+    : _hysteresis(0.1f)
+{
+    const TierSetting full      = { 400.0f,  0.0f, 0.0f, false };
+    const TierSetting reduced   = { 150.0f, 30.0f, 2.0f, false };
+    const TierSetting minimal   = {   0.0f, 10.0f, 4.0f, false };
+    const TierSetting offScreen = {   0.0f,  5.0f, 0.0f, true };
+
+    _tiers[CubismMotionLodTier_Full] = full;
+    _tiers[CubismMotionLodTier_Reduced] = reduced;
+    _tiers[CubismMotionLodTier_Minimal] = minimal;
+    _tiers[CubismMotionLodTier_OffScreen] = offScreen;
+}
+
+void CubismMotionLodPolicy::SetTierSetting(CubismMotionLodTier tier, const TierSetting& setting)
+{
+    if (tier < 0 || tier >= CubismMotionLodTier_Count)
+    {
+        return;
+    }
+
+    _tiers[tier] = setting;
+}
+
+const CubismMotionLodPolicy::TierSetting& CubismMotionLodPolicy::GetTierSetting(CubismMotionLodTier tier) const
+{
+    if (tier < 0 || tier >= CubismMotionLodTier_Count)
+    {
+        return _tiers[CubismMotionLodTier_Full];
+    }
+
+    return _tiers[tier];
+}
+
+void CubismMotionLodPolicy::SetHysteresis(csmFloat32 hysteresis)
+{
+    _hysteresis = (hysteresis > 0.0f) ? hysteresis : 0.0f;
+}
+
+CubismMotionLodTier CubismMotionLodPolicy::SelectTier(csmFloat32 modelHeightPixels, csmBool isOnScreen, CubismMotionLodTier currentTier) const
+{
+    if (!isOnScreen)
+    {
+        return CubismMotionLodTier_OffScreen;
+    }
+
+    // 詳細な段階から順に、閾値を満たす最初の段階を選ぶ
+    for (csmInt32 i = CubismMotionLodTier_Full; i < CubismMotionLodTier_Minimal; ++i)
+    {
+        csmFloat32 threshold = _tiers[i].MinModelHeightPixels;
+
+        // 現在の段階からは、閾値を少し下回るまで離れない
+        if (i == currentTier)
+        {
+            threshold *= (1.0f - _hysteresis);
+        }
+        // 現在より詳細な段階へは、閾値を少し上回るまで移らない
+        else if (i < currentTier && currentTier != CubismMotionLodTier_OffScreen)
+        {
+            threshold *= (1.0f + _hysteresis);
+        }
+
+        if (modelHeightPixels >= threshold)
+        {
+            return static_cast<CubismMotionLodTier>(i);
+        }
+    }
+
+    return CubismMotionLodTier_Minimal;
+}
+
+}}}
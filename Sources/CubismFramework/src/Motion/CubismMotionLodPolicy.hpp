@@ -0,0 +1,89 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Level of detail at which a model is animated.
+ */
+enum CubismMotionLodTier
+{
+    CubismMotionLodTier_Full = 0,       ///< Every curve on every update
+    CubismMotionLodTier_Reduced,        ///< Reduced rate, small drawables skipped
+    CubismMotionLodTier_Minimal,        ///< Lowest rate for thumbnails and distant models
+    CubismMotionLodTier_OffScreen,      ///< Not visible; physics is frozen
+    CubismMotionLodTier_Count
+};
+
+/**
+ * Chooses the level of detail of a model from its size on screen.
+ */
+class CubismMotionLodPolicy
+{
+public:
+    /**
+     * Settings of a level of detail tier.
+     */
+    struct TierSetting
+    {
+        csmFloat32 MinModelHeightPixels;    ///< Smallest on-screen model height at which the tier is used
+        csmFloat32 EvaluationRate;          ///< Motion evaluations per second; 0 evaluates on every update
+        csmFloat32 MinDrawablePixels;       ///< Curves that only move drawables smaller than this are skipped; 0 keeps all
+        csmBool FreezePhysics;              ///< true to stop evaluating the physics
+    };
+
+    /**
+     * Constructor<br>
+     * Sets up the default tiers.
+     */
+    CubismMotionLodPolicy();
+
+    /**
+     * Sets the settings of a tier.
+     *
+     * @param tier Tier to set
+     * @param setting Settings of the tier
+     */
+    void SetTierSetting(CubismMotionLodTier tier, const TierSetting& setting);
+
+    /**
+     * Returns the settings of a tier.
+     *
+     * @param tier Tier to get
+     *
+     * @return Settings of the tier
+     */
+    const TierSetting& GetTierSetting(CubismMotionLodTier tier) const;
+
+    /**
+     * Sets the ratio by which the model must shrink or grow past a threshold before the tier changes.
+     *
+     * @param hysteresis Ratio of the threshold, e.g. 0.1 for 10%
+     */
+    void SetHysteresis(csmFloat32 hysteresis);
+
+    /**
+     * Chooses the tier for a model.
+     *
+     * @param modelHeightPixels Height of the model canvas on screen in pixels
+     * @param isOnScreen false if the model is entirely outside the view
+     * @param currentTier Tier currently in use, to avoid flickering around a threshold
+     *
+     * @return Chosen tier
+     */
+    CubismMotionLodTier SelectTier(csmFloat32 modelHeightPixels, csmBool isOnScreen, CubismMotionLodTier currentTier) const;
+
+private:
+    TierSetting _tiers[CubismMotionLodTier_Count];
+    csmFloat32 _hysteresis;
+};
+
+}}}
@@ -6,16 +6,49 @@
  */
 
 #include "CubismMotionManager.hpp"
+#include "CubismMotion.hpp"
+#include "CubismMotionInternal.hpp"
+#include "CubismMotionLoader.hpp"
+#include "Math/CubismMath.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+namespace {
+
+void ReadParameters(CubismModel* model, csmVector<csmFloat32>& values)
+{
+    const csmInt32 parameterCount = model->GetParameterCount();
+
+    if (values.GetSize() != static_cast<csmUint32>(parameterCount))
+    {
+        values.Resize(parameterCount);
+    }
+
+    for (csmInt32 i = 0; i < parameterCount; ++i)
+    {
+        values[i] = model->GetParameterValue(i);
+    }
+}
+
+}
+
 CubismMotionManager::CubismMotionManager()
     : _currentPriority(0)
     , _reservePriority(0)
+    , _pendingHandle(NULL)
+    , _pendingPriority(0)
+    , _isPendingReserved(false)
+    , _pendingCreateMotion(NULL)
+    , _pendingUserData(NULL)
+    , _evaluationInterval(0.0f)
+    , _evaluationElapsedSeconds(0.0f)
+    , _lastEvaluationUpdated(false)
 { }
 
 CubismMotionManager::~CubismMotionManager()
-{ }
+{
+    CancelPendingMotion();
+}
 
 csmInt32 CubismMotionManager::GetCurrentPriority() const
 {
@@ -34,6 +67,9 @@ void CubismMotionManager::SetReservePriority(csmInt32 val)
 
 CubismMotionQueueEntryHandle CubismMotionManager::StartMotionPriority(ACubismMotion* motion, csmBool autoDelete, csmInt32 priority)
 {
+    // 後から開始したモーションを優先し、読み込み待ちのモーションは再生しない
+    CancelPendingMotion();
+
     if (priority == _reservePriority)
     {
         _reservePriority = 0;           // 予約を解除
@@ -44,11 +80,79 @@ CubismMotionQueueEntryHandle CubismMotionManager::StartMotionPriority(ACubismMot
     return CubismMotionQueueManager::StartMotion(motion, autoDelete);
 }
 
+csmBool CubismMotionManager::StartMotionPriority(CubismMotionLoadHandle* handle, csmInt32 priority, LoadedMotionFunction createMotion, void* userData)
+{
+    if (handle == NULL)
+    {
+        return false;
+    }
+
+    const CubismMotionLoadHandle::State state = handle->GetState();
+
+    if (state == CubismMotionLoadHandle::State_Failed || state == CubismMotionLoadHandle::State_Cancelled)
+    {
+        if (priority == _reservePriority)
+        {
+            _reservePriority = 0;       // 予約を解除
+        }
+        return false;
+    }
+
+    handle->Retain();
+    CancelPendingMotion();
+
+    _pendingHandle = handle;
+    _pendingPriority = priority;
+    _pendingCreateMotion = createMotion;
+    _pendingUserData = userData;
+
+    // 読み込みを待つ間は優先度を予約しておく。アプリが予約済みならそのまま使う
+    _isPendingReserved = (priority > _reservePriority);
+    if (_isPendingReserved)
+    {
+        _reservePriority = priority;
+    }
+
+    // 読み込み済みならすぐに再生する
+    StartPendingMotion();
+
+    return true;
+}
+
+csmBool CubismMotionManager::HasPendingMotion() const
+{
+    return _pendingHandle != NULL;
+}
+
+void CubismMotionManager::CancelPendingMotion()
+{
+    if (_pendingHandle == NULL)
+    {
+        return;
+    }
+
+    // 解除するのは読み込み待ちのために行った予約だけで、アプリの予約は残す
+    if (_isPendingReserved && _pendingPriority == _reservePriority)
+    {
+        _reservePriority = 0;
+    }
+
+    _pendingHandle->Release();
+    _pendingHandle = NULL;
+    _isPendingReserved = false;
+    _pendingCreateMotion = NULL;
+    _pendingUserData = NULL;
+}
+
 csmBool CubismMotionManager::UpdateMotion(CubismModel* model, csmFloat32 deltaTimeSeconds)
 {
+    StartPendingMotion();
+
     _userTimeSeconds += deltaTimeSeconds;
 
-    const csmBool updated = CubismMotionQueueManager::DoUpdateMotion(model, _userTimeSeconds);
+    const csmBool updated = (_evaluationInterval > 0.0f)
+                                ? UpdateMotionAtInterval(model, deltaTimeSeconds)
+                                : CubismMotionQueueManager::DoUpdateMotion(model, _userTimeSeconds);
 
     if (IsFinished())
     {
@@ -70,4 +174,143 @@ csmBool CubismMotionManager::ReserveMotion(csmInt32 priority)
     return true;
 }
 
+void CubismMotionManager::SetEvaluationInterval(csmFloat32 seconds)
+{
+    if (seconds < 0.0f)
+    {
+        seconds = 0.0f;
+    }
+
+    if (seconds == _evaluationInterval)
+    {
+        return;
+    }
+
+    _evaluationInterval = seconds;
+
+    // 補間元を破棄し、次の更新で評価し直す
+    _evaluationElapsedSeconds = 0.0f;
+    _currentPose.Clear();
+    _previousPose.Clear();
+    _interpolatedParameters.Clear();
+}
+
+csmFloat32 CubismMotionManager::GetEvaluationInterval() const
+{
+    return _evaluationInterval;
+}
+
+void CubismMotionManager::SetSkippedParameters(const csmVector<csmBool>* skippedParameters)
+{
+    _skippedParameters = skippedParameters;
+}
+
+void CubismMotionManager::StartPendingMotion()
+{
+    if (_pendingHandle == NULL || !_pendingHandle->IsDone())
+    {
+        return;
+    }
+
+    CubismMotionLoadHandle* handle = _pendingHandle;
+    const csmInt32 priority = _pendingPriority;
+    const LoadedMotionFunction createMotion = _pendingCreateMotion;
+    void* userData = _pendingUserData;
+
+    _pendingHandle = NULL;
+    _isPendingReserved = false;
+    _pendingCreateMotion = NULL;
+    _pendingUserData = NULL;
+
+    ACubismMotion* motion = NULL;
+
+    if (handle->GetState() == CubismMotionLoadHandle::State_Ready)
+    {
+        if (createMotion != NULL)
+        {
+            motion = createMotion(handle, userData);
+        }
+        else
+        {
+            CubismMotionData* motionData = handle->AcquireMotionData();
+            if (motionData != NULL)
+            {
+                motion = CubismMotion::Create(motionData);
+                motionData->Release();
+            }
+        }
+    }
+
+    handle->Release();
+
+    if (motion != NULL)
+    {
+        StartMotionPriority(motion, true, priority);
+    }
+    else if (priority == _reservePriority)
+    {
+        _reservePriority = 0;           // 予約を解除
+    }
+}
+
+csmBool CubismMotionManager::UpdateMotionAtInterval(CubismModel* model, csmFloat32 deltaTimeSeconds)
+{
+    const csmInt32 parameterCount = model->GetParameterCount();
+    const csmBool hasPose = (_currentPose.GetSize() == static_cast<csmUint32>(parameterCount));
+
+    _evaluationElapsedSeconds += deltaTimeSeconds;
+
+    if (!hasPose || _evaluationElapsedSeconds >= _evaluationInterval)
+    {
+        // 評価前の値を残し、モーションが書き換えたパラメータを特定する
+        ReadParameters(model, _basePose);
+
+        _lastEvaluationUpdated = CubismMotionQueueManager::DoUpdateMotion(model, _userTimeSeconds);
+
+        if (hasPose)
+        {
+            for (csmInt32 i = 0; i < parameterCount; ++i)
+            {
+                _previousPose[i] = _currentPose[i];
+            }
+        }
+
+        ReadParameters(model, _currentPose);
+
+        if (!hasPose)
+        {
+            _previousPose.Resize(parameterCount);
+            for (csmInt32 i = 0; i < parameterCount; ++i)
+            {
+                _previousPose[i] = _currentPose[i];
+            }
+        }
+
+        _interpolatedParameters.Clear();
+        for (csmInt32 i = 0; i < parameterCount; ++i)
+        {
+            if (_currentPose[i] != _basePose[i] || _currentPose[i] != _previousPose[i])
+            {
+                _interpolatedParameters.PushBack(i);
+            }
+        }
+
+        // 長い停止の後でも評価が連続しないように余りは一周期分までにする
+        _evaluationElapsedSeconds = hasPose ? CubismMath::ModF(_evaluationElapsedSeconds, _evaluationInterval) : 0.0f;
+    }
+
+    // 一つ前と最新の評価結果の間を補間する
+    const csmFloat32 t = CubismMath::RangeF(_evaluationElapsedSeconds / _evaluationInterval, 0.0f, 1.0f);
+
+    for (csmUint32 i = 0; i < _interpolatedParameters.GetSize(); ++i)
+    {
+        const csmInt32 parameterIndex = _interpolatedParameters[i];
+        const csmFloat32 value = _previousPose[parameterIndex] + (_currentPose[parameterIndex] - _previousPose[parameterIndex]) * t;
+
+        model->SetParameterValue(parameterIndex, value);
+    }
+
+    return _lastEvaluationUpdated;
+}
+
 }}}
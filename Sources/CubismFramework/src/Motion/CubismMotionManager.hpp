@@ -13,12 +13,24 @@
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+class CubismMotionLoadHandle;
+
 /**
  * Handles the management of motions.
  */
 class CubismMotionManager : public CubismMotionQueueManager
 {
 public:
+    /**
+     * Function that makes the motion to play once a load request is ready.
+     *
+     * @param handle ready load request
+     * @param userData pointer passed to StartMotionPriority()
+     *
+     * @return motion to play, deleted by the manager when playback ends; NULL to play nothing
+     */
+    typedef ACubismMotion* (*LoadedMotionFunction)(CubismMotionLoadHandle* handle, void* userData);
+
     /**
      * Constructor.
      */
@@ -60,10 +72,39 @@ public:
      * @return ID of the played motion.<br>
      *         -1 if the motion could not be started.
      *
-     * @note The return value can be used as an argument to IsFinished() to determine if the motion has finished playing.
+     * @note The return value can be used as an argument to IsFinished() to determine if the motion has finished playing.<br>
+     *       A motion waiting for its load request is dropped.
      */
     CubismMotionQueueEntryHandle StartMotionPriority(ACubismMotion* motion, csmBool autoDelete, csmInt32 priority);
 
+    /**
+     * Plays the motion of a load request with the specified priority as soon as it is ready.
+     *
+     * @param handle motion request made with CubismMotionLoader; a reference is added while waiting
+     * @param priority priority of the motion
+     * @param createMotion function that makes the motion; NULL plays the motion data as is
+     * @param userData pointer passed to createMotion
+     *
+     * @return true if the motion started or waits for its data; false if the request failed or was cancelled
+     *
+     * @note The priority stays reserved while waiting. Only one motion waits at a time;<br>
+     *       a new request replaces the waiting one. The waiting motion starts in UpdateMotion().
+     */
+    csmBool StartMotionPriority(CubismMotionLoadHandle* handle, csmInt32 priority, LoadedMotionFunction createMotion = NULL, void* userData = NULL);
+
+    /**
+     * Returns whether a motion waits for its load request.
+     *
+     * @return true if a motion waits
+     */
+    csmBool HasPendingMotion() const;
+
+    /**
+     * Drops the motion waiting for its load request.<br>
+     * The priority is unreserved only if StartMotionPriority() reserved it; a reservation made with ReserveMotion() stays.
+     */
+    void CancelPendingMotion();
+
     /**
      * Updates the motion.<br>
      * Evaluates the current motion and sets the parameter values on the model.
@@ -85,9 +126,62 @@ public:
      */
     csmBool ReserveMotion(csmInt32 priority);
 
+    /**
+     * Sets the interval at which motions are evaluated.<br>
+     * Between two evaluations the parameters written by the motions are interpolated
+     * from the last two evaluated poses, which delays the motion by one interval.
+     *
+     * @param seconds interval in seconds; 0 evaluates the motions on every update
+     */
+    void SetEvaluationInterval(csmFloat32 seconds);
+
+    /**
+     * Returns the interval at which motions are evaluated.
+     *
+     * @return interval in seconds; 0 if the motions are evaluated on every update
+     */
+    csmFloat32 GetEvaluationInterval() const;
+
+    /**
+     * Sets the parameters whose curves are not evaluated.
+     *
+     * @param skippedParameters flags indexed by parameter index, or NULL to evaluate every curve.<br>
+     *                          The vector is referenced, not copied, and must outlive its use.
+     */
+    void SetSkippedParameters(const csmVector<csmBool>* skippedParameters);
+
 private:
+    /**
+     * Evaluates the motions at the reduced rate and interpolates the parameters in between.
+     *
+     * @param model model to update
+     * @param deltaTimeSeconds elapsed time in seconds since the last update
+     *
+     * @return true if the motion was updated; otherwise false.
+     */
+    csmBool UpdateMotionAtInterval(CubismModel* model, csmFloat32 deltaTimeSeconds);
+
+    /**
+     * Starts the waiting motion if its load request is done.
+     */
+    void StartPendingMotion();
+
     csmInt32 _currentPriority;
     csmInt32 _reservePriority;
+
+    CubismMotionLoadHandle* _pendingHandle;         ///< 読み込みを待っているモーションの要求
+    csmInt32 _pendingPriority;                      ///< 読み込みを待っているモーションの優先度
+    csmBool _isPendingReserved;                     ///< 読み込みを待つ間の予約をこのクラスが行ったか
+    LoadedMotionFunction _pendingCreateMotion;      ///< 読み込み後にモーションを作る関数
+    void* _pendingUserData;                         ///< _pendingCreateMotionに渡すデータ
+
+    csmFloat32 _evaluationInterval;                 ///< モーションを評価する間隔（秒）。0なら毎回評価する
+    csmFloat32 _evaluationElapsedSeconds;           ///< 最後に評価してからの経過時間
+    csmBool _lastEvaluationUpdated;                 ///< 最後の評価でモーションが更新されたか
+    csmVector<csmFloat32> _basePose;                ///< 評価前のパラメータ値
+    csmVector<csmFloat32> _previousPose;            ///< 一つ前の評価結果
+    csmVector<csmFloat32> _currentPose;             ///< 最新の評価結果
+    csmVector<csmInt32> _interpolatedParameters;    ///< 評価間で補間するパラメータのインデックス
 };
 
 }}}
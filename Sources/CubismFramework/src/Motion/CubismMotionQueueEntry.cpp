@@ -25,6 +25,7 @@ CubismMotionQueueEntry::CubismMotionQueueEntry()
     , _motionQueueEntryHandle(NULL)
     , _fadeOutSeconds(0.0f)
     , _IsTriggeredFadeOut(false)
+    , _skippedParameters(NULL)
 {
     this->_motionQueueEntryHandle = this;
 }
@@ -201,6 +201,7 @@ private:
     csmFloat32      _lastEventCheckSeconds;
     csmFloat32      _fadeOutSeconds;
     csmBool         _IsTriggeredFadeOut;
+    const csmVector<csmBool>* _skippedParameters;   ///< LODで評価を省略するパラメータ（インデックス順）。NULLなら省略しない
 
     CubismMotionQueueEntryHandle  _motionQueueEntryHandle;
 };
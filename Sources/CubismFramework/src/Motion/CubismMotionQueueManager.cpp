@@ -9,6 +9,7 @@
 #include "CubismMotionQueueEntry.hpp"
 #include "CubismFramework.hpp"
 #include "CubismMotion.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -16,6 +17,7 @@ const CubismMotionQueueEntryHandle InvalidMotionQueueEntryHandleValue = reinterp
 
 CubismMotionQueueManager::CubismMotionQueueManager()
     : _userTimeSeconds(0.0f)
+    , _skippedParameters(NULL)
     , _eventCallback(NULL)
     , _eventCustomData(NULL)
 {}
@@ -95,6 +97,8 @@ CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion
 
 csmBool CubismMotionQueueManager::DoUpdateMotion(CubismModel* model, csmFloat32 userTimeSeconds)
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_Motion);
+
     csmBool updated = false;
 
     // ------- 処理を行う --------
@@ -121,6 +125,7 @@ csmBool CubismMotionQueueManager::DoUpdateMotion(CubismModel* model, csmFloat32
         }
 
         // ------ 値を反映する ------
+        motionQueueEntry->_skippedParameters = _skippedParameters;
         motion->UpdateParameters(model, motionQueueEntry, userTimeSeconds);
         updated = true;
 
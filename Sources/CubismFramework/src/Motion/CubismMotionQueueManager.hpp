@@ -127,6 +127,7 @@ protected:
 
 
     csmFloat32 _userTimeSeconds;
+    const csmVector<csmBool>* _skippedParameters;   ///< 評価を省略するパラメータ。NULLならすべて評価する
 
 private:
     csmVector<CubismMotionQueueEntry*>      _motions;
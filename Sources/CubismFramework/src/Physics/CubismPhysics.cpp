@@ -10,9 +10,16 @@
 #include "CubismPhysicsJson.hpp"
 #include "Model/CubismModel.hpp"
 #include "Utils/CubismString.hpp"
+#include "Utils/CubismProfiler.hpp"
+#include "Utils/CubismThreadPool.hpp"
 #include "Math/CubismMath.hpp"
 #include "Math/CubismVector2.hpp"
 
+// 決定論的モードの結果がCPUやコンパイラに依存しないよう、積和演算の融合を禁止する（GCCはCMakeLists.txtで-ffp-contract=offを指定する）
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
 namespace Live2D { namespace Cubism { namespace Framework {
 
 /// physics constants
@@ -35,6 +42,65 @@ const csmFloat32 MovementThreshold = 0.001f;
 /// Constant of maximum allowed delta time
 const csmFloat32 MaxDeltaTime = 5.0f;
 
+/// Minimum number of particles in a wave to evaluate it on the thread pool.
+const csmInt32 MinParallelParticleCount = 64;
+
+/// Identifier at the head of a saved state ("CPHS").
+const csmUint32 StateMagic = 0x53485043;
+
+/// Version of the saved state layout.
+const csmUint32 StateVersion = 1;
+
+/// Number of floats saved per particle.
+const csmInt32 StateFloatsPerParticle = 8;
+
+/// Number of floats saved per output.
+const csmInt32 StateFloatsPerOutput = 4;
+
+/// Size of the saved state header.
+const csmSizeInt StateHeaderSize = sizeof(csmUint32) * 2 + sizeof(csmInt32) * 3 + sizeof(csmFloat32);
+
+csmInt32 MaxIndex(csmInt32 l, csmInt32 r)
+{
+    return (l > r) ? l : r;
+}
+
+csmFloat32 PhysicsSinF(csmFloat32 x, csmBool isDeterministic)
+{
+    return isDeterministic ? CubismMath::TableSinF(x) : CubismMath::SinF(x);
+}
+
+csmFloat32 PhysicsCosF(csmFloat32 x, csmBool isDeterministic)
+{
+    return isDeterministic ? CubismMath::TableCosF(x) : CubismMath::CosF(x);
+}
+
+csmFloat32 PhysicsDirectionToRadian(CubismVector2 from, CubismVector2 to, csmBool isDeterministic)
+{
+    return isDeterministic ? CubismMath::TableDirectionToRadian(from, to) : CubismMath::DirectionToRadian(from, to);
+}
+
+CubismVector2 PhysicsRadianToDirection(csmFloat32 totalAngle, csmBool isDeterministic)
+{
+    return isDeterministic ? CubismMath::TableRadianToDirection(totalAngle) : CubismMath::RadianToDirection(totalAngle);
+}
+
+template <typename T>
+void WriteStateValue(csmByte*& cursor, T value)
+{
+    memcpy(cursor, &value, sizeof(T));
+    cursor += sizeof(T);
+}
+
+template <typename T>
+T ReadStateValue(const csmByte*& cursor)
+{
+    T value;
+    memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
 csmFloat32 GetRangeValue(csmFloat32 min, csmFloat32 max)
 {
     csmFloat32 maxValue = CubismMath::Max(min, max);
@@ -225,8 +291,8 @@ csmFloat32 GetOutputTranslationY(CubismVector2 translation, CubismPhysicsParticl
     return outputValue;
 }
 
-csmFloat32 GetOutputAngle(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex, csmInt32 isInverted,
-    CubismVector2 parentGravity)
+csmFloat32 GetOutputAngleValue(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex, csmInt32 isInverted,
+    CubismVector2 parentGravity, csmBool isDeterministic)
 {
     csmFloat32 outputValue;
 
@@ -239,7 +305,7 @@ csmFloat32 GetOutputAngle(CubismVector2 translation, CubismPhysicsParticle* part
         parentGravity *= -1.0f;
     }
 
-    outputValue = CubismMath::DirectionToRadian(parentGravity, translation);
+    outputValue = PhysicsDirectionToRadian(parentGravity, translation, isDeterministic);
 
     if (isInverted)
     {
@@ -249,6 +315,18 @@ csmFloat32 GetOutputAngle(CubismVector2 translation, CubismPhysicsParticle* part
     return outputValue;
 }
 
+csmFloat32 GetOutputAngle(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex, csmInt32 isInverted,
+    CubismVector2 parentGravity)
+{
+    return GetOutputAngleValue(translation, particles, particleIndex, isInverted, parentGravity, false);
+}
+
+csmFloat32 GetOutputAngleDeterministic(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex, csmInt32 isInverted,
+    CubismVector2 parentGravity)
+{
+    return GetOutputAngleValue(translation, particles, particleIndex, isInverted, parentGravity, true);
+}
+
 csmFloat32 GetOutputScaleTranslationX(CubismVector2 translationScale, csmFloat32 angleScale)
 {
     return translationScale.X;
@@ -274,8 +352,9 @@ csmFloat32 GetOutputScaleAngle(CubismVector2 translationScale, csmFloat32 angleS
 /// @param  thresholdValue    Threshold of movement.
 /// @param  deltaTimeSeconds  Delta time.
 /// @param  airResistance     Air resistance.
+/// @param  isDeterministic   Uses the table-based trigonometric functions.
 void UpdateParticles(CubismPhysicsParticle* strand, csmInt32 strandCount, CubismVector2 totalTranslation, csmFloat32 totalAngle,
-    CubismVector2 windDirection, csmFloat32 thresholdValue, csmFloat32 deltaTimeSeconds, csmFloat32 airResistance)
+    CubismVector2 windDirection, csmFloat32 thresholdValue, csmFloat32 deltaTimeSeconds, csmFloat32 airResistance, csmBool isDeterministic)
 {
     csmInt32 i;
     csmFloat32 totalRadian;
@@ -290,7 +369,7 @@ void UpdateParticles(CubismPhysicsParticle* strand, csmInt32 strandCount, Cubism
     strand[0].Position = totalTranslation;
 
     totalRadian = CubismMath::DegreesToRadian(totalAngle);
-    currentGravity = CubismMath::RadianToDirection(totalRadian);
+    currentGravity = PhysicsRadianToDirection(totalRadian, isDeterministic);
     currentGravity.Normalize();
 
     for (i = 1; i < strandCount; ++i)
@@ -304,10 +383,10 @@ void UpdateParticles(CubismPhysicsParticle* strand, csmInt32 strandCount, Cubism
         direction.X = strand[i].Position.X - strand[i - 1].Position.X;
         direction.Y = strand[i].Position.Y - strand[i - 1].Position.Y;
 
-        radian = CubismMath::DirectionToRadian(strand[i].LastGravity, currentGravity) / airResistance;
+        radian = PhysicsDirectionToRadian(strand[i].LastGravity, currentGravity, isDeterministic) / airResistance;
 
-        direction.X = ((CubismMath::CosF(radian) * direction.X) - (direction.Y * CubismMath::SinF(radian)));
-        direction.Y = ((CubismMath::SinF(radian) * direction.X) + (direction.Y * CubismMath::CosF(radian)));
+        direction.X = ((PhysicsCosF(radian, isDeterministic) * direction.X) - (direction.Y * PhysicsSinF(radian, isDeterministic)));
+        direction.Y = ((PhysicsSinF(radian, isDeterministic) * direction.X) + (direction.Y * PhysicsCosF(radian, isDeterministic)));
 
         strand[i].Position = strand[i - 1].Position + direction;
 
@@ -350,9 +429,10 @@ void UpdateParticles(CubismPhysicsParticle* strand, csmInt32 strandCount, Cubism
  * @param totalAngle            Total angle.
  * @param windDirection         Direction of Wind.
  * @param thresholdValue        Threshold of movement.
+ * @param isDeterministic       Uses the table-based trigonometric functions.
  */
 void UpdateParticlesForStabilization(CubismPhysicsParticle* strand, csmInt32 strandCount, CubismVector2 totalTranslation, csmFloat32 totalAngle,
-    CubismVector2 windDirection, csmFloat32 thresholdValue)
+    CubismVector2 windDirection, csmFloat32 thresholdValue, csmBool isDeterministic)
 {
     csmInt32 i;
     csmFloat32 totalRadian;
@@ -362,7 +442,7 @@ void UpdateParticlesForStabilization(CubismPhysicsParticle* strand, csmInt32 str
     strand[0].Position = totalTranslation;
 
     totalRadian = CubismMath::DegreesToRadian(totalAngle);
-    currentGravity = CubismMath::RadianToDirection(totalRadian);
+    currentGravity = PhysicsRadianToDirection(totalRadian, isDeterministic);
     currentGravity.Normalize();
 
     for (i = 1; i < strandCount; ++i)
@@ -442,6 +522,10 @@ void UpdateOutputParameterValue(csmFloat32* parameterValue, csmFloat32 parameter
 
 CubismPhysics::CubismPhysics()
     : _physicsRig(NULL)
+    , _threadPool(NULL)
+    , _usesSharedThreadPool(true)
+    , _areWavesBuilt(false)
+    , _isDeterministic(false)
 {
     // set default options.
     _options.Gravity.Y = -1.0f;
@@ -562,6 +646,8 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
 
     _currentRigOutputs.Clear();
     _previousRigOutputs.Clear();
+    _currentRigOutputs.PrepareCapacity(_physicsRig->SubRigCount);
+    _previousRigOutputs.PrepareCapacity(_physicsRig->SubRigCount);
 
     csmInt32 inputIndex = 0, outputIndex = 0, particleIndex = 0;
     for (csmUint32 i = 0; i < _physicsRig->Settings.GetSize(); ++i)
@@ -610,11 +696,11 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
 
         PhysicsOutput currentRigOutput;
         currentRigOutput.outputs.Resize(_physicsRig->Settings[i].OutputCount);
-        _currentRigOutputs.PushBack(currentRigOutput);
+        _currentRigOutputs.PushBack(std::move(currentRigOutput));
 
         PhysicsOutput previousRigOutput;
         previousRigOutput.outputs.Resize(_physicsRig->Settings[i].OutputCount);
-        _previousRigOutputs.PushBack(previousRigOutput);
+        _previousRigOutputs.PushBack(std::move(previousRigOutput));
 
         for (csmInt32 j = 0; j < _physicsRig->Settings[i].OutputCount; ++j)
         {
@@ -746,8 +832,8 @@ void CubismPhysics::Stabilization(CubismModel* model)
 
         radAngle = CubismMath::DegreesToRadian(-totalAngle);
 
-        totalTranslation.X = (totalTranslation.X * CubismMath::CosF(radAngle) - totalTranslation.Y * CubismMath::SinF(radAngle));
-        totalTranslation.Y = (totalTranslation.X * CubismMath::SinF(radAngle) + totalTranslation.Y * CubismMath::CosF(radAngle));
+        totalTranslation.X = (totalTranslation.X * PhysicsCosF(radAngle, _isDeterministic) - totalTranslation.Y * PhysicsSinF(radAngle, _isDeterministic));
+        totalTranslation.Y = (totalTranslation.X * PhysicsSinF(radAngle, _isDeterministic) + totalTranslation.Y * PhysicsCosF(radAngle, _isDeterministic));
 
         // Calculate particles position.
         UpdateParticlesForStabilization(
@@ -756,7 +842,8 @@ void CubismPhysics::Stabilization(CubismModel* model)
             totalTranslation,
             totalAngle,
             _options.Wind,
-            MovementThreshold * currentSetting->NormalizationPosition.Maximum
+            MovementThreshold * currentSetting->NormalizationPosition.Maximum,
+            _isDeterministic
         );
 
         // Update output parameters.
@@ -842,16 +929,10 @@ void CubismPhysics::Stabilization(CubismModel* model)
 /// @param deltaTimeSeconds  rendering delta time.
 void CubismPhysics::Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
 {
-    csmFloat32 totalAngle;
-    csmFloat32 weight;
-    csmFloat32 radAngle;
-    csmFloat32 outputValue;
-    CubismVector2 totalTranslation;
-    csmInt32 i, settingIndex, particleIndex;
+    CSM_PROFILE_STAGE(CubismProfileStage_Physics);
+
+    csmInt32 i, settingIndex, waveIndex;
     CubismPhysicsSubRig* currentSetting;
-    CubismPhysicsInput* currentInputs;
-    CubismPhysicsOutput* currentOutputs;
-    CubismPhysicsParticle* currentParticles;
 
     if (0.0f >= deltaTimeSeconds)
     {
@@ -887,6 +968,14 @@ void CubismPhysics::Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
         }
     }
 
+    if (!_areWavesBuilt)
+    {
+        BuildEvaluationWaves(model);
+    }
+
+    // 決定論的モードでは評価順を固定する
+    const csmBool isParallel = (!_isDeterministic && _threadPool != NULL && _threadPool->GetWorkerCount() > 0);
+
     if (_physicsRig->Fps > 0.0f)
     {
         physicsDeltaTime = 1.0f / _physicsRig->Fps;
@@ -902,7 +991,6 @@ void CubismPhysics::Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
         for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
         {
             currentSetting = &_physicsRig->Settings[settingIndex];
-            currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
             for (i = 0; i < currentSetting->OutputCount; ++i)
             {
                 _previousRigOutputs[settingIndex].outputs[i] = _currentRigOutputs[settingIndex].outputs[i];
@@ -920,100 +1008,263 @@ void CubismPhysics::Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
             _parameterInputCaches[j] = _parameterCaches[j];
         }
 
-        for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+        if (!isParallel)
         {
-            totalAngle = 0.0f;
-            totalTranslation.X = 0.0f;
-            totalTranslation.Y = 0.0f;
-            currentSetting = &_physicsRig->Settings[settingIndex];
-            currentInputs = &_physicsRig->Inputs[currentSetting->BaseInputIndex];
-            currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
-            currentParticles = &_physicsRig->Particles[currentSetting->BaseParticleIndex];
-
-            // Load input parameters.
-            for (i = 0; i < currentSetting->InputCount; ++i)
+            for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
             {
-                weight = currentInputs[i].Weight / MaximumWeight;
+                EvaluateSubRig(settingIndex, parameterMinimumValues, parameterMaximumValues, parameterDefaultValues, physicsDeltaTime);
+            }
+        }
+        else
+        {
+            // 同じウェーブのサブリグは互いに干渉しないため、逐次評価と同じ結果になる。
+            // Sub-rigs in the same wave do not interfere with each other, so the result matches the serial evaluation.
+            for (waveIndex = 0; waveIndex < static_cast<csmInt32>(_waveParticleCounts.GetSize()); ++waveIndex)
+            {
+                const csmInt32 waveBegin = _waveOffsets[waveIndex];
+                const csmInt32 waveSize = _waveOffsets[waveIndex + 1] - waveBegin;
 
-                if (currentInputs[i].SourceParameterIndex == -1)
+                if (waveSize > 1 && _waveParticleCounts[waveIndex] >= MinParallelParticleCount)
                 {
-                    currentInputs[i].SourceParameterIndex = model->GetParameterIndex(currentInputs[i].Source.Id);
+                    SubRigTaskContext context;
+                    context.Physics = this;
+                    context.SettingIndices = &_waveSettingIndices[waveBegin];
+                    context.ParameterMinimumValues = parameterMinimumValues;
+                    context.ParameterMaximumValues = parameterMaximumValues;
+                    context.ParameterDefaultValues = parameterDefaultValues;
+                    context.PhysicsDeltaTime = physicsDeltaTime;
+
+                    _threadPool->ParallelFor(waveSize, EvaluateSubRigTask, &context);
+                }
+                else
+                {
+                    for (i = 0; i < waveSize; ++i)
+                    {
+                        EvaluateSubRig(_waveSettingIndices[waveBegin + i], parameterMinimumValues, parameterMaximumValues, parameterDefaultValues, physicsDeltaTime);
+                    }
                 }
-
-                currentInputs[i].GetNormalizedParameterValue(
-                    &totalTranslation,
-                    &totalAngle,
-                    _parameterCaches[currentInputs[i].SourceParameterIndex],
-                    parameterMinimumValues[currentInputs[i].SourceParameterIndex],
-                    parameterMaximumValues[currentInputs[i].SourceParameterIndex],
-                    parameterDefaultValues[currentInputs[i].SourceParameterIndex],
-                    &currentSetting->NormalizationPosition,
-                    &currentSetting->NormalizationAngle,
-                    currentInputs[i].Reflect,
-                    weight
-                );
             }
+        }
 
-            radAngle = CubismMath::DegreesToRadian(-totalAngle);
+        _currentRemainTime -= physicsDeltaTime;
+    }
 
-            totalTranslation.X = (totalTranslation.X * CubismMath::CosF(radAngle) - totalTranslation.Y * CubismMath::SinF(radAngle));
-            totalTranslation.Y = (totalTranslation.X * CubismMath::SinF(radAngle) + totalTranslation.Y * CubismMath::CosF(radAngle));
+    const float alpha = _currentRemainTime / physicsDeltaTime;
+    Interpolate(model, alpha);
+}
 
-            // Calculate particles position.
-            UpdateParticles(
-                currentParticles,
-                currentSetting->ParticleCount,
-                totalTranslation,
-                totalAngle,
-                _options.Wind,
-                MovementThreshold * currentSetting->NormalizationPosition.Maximum,
-                physicsDeltaTime,
-                AirResistance
-            );
+void CubismPhysics::EvaluateSubRig(csmInt32 settingIndex, const csmFloat32* parameterMinimumValues, const csmFloat32* parameterMaximumValues,
+                                   const csmFloat32* parameterDefaultValues, csmFloat32 physicsDeltaTime)
+{
+    csmFloat32 totalAngle;
+    csmFloat32 weight;
+    csmFloat32 radAngle;
+    csmFloat32 outputValue;
+    CubismVector2 totalTranslation;
+    csmInt32 i, particleIndex;
+    CubismPhysicsSubRig* currentSetting;
+    CubismPhysicsInput* currentInputs;
+    CubismPhysicsOutput* currentOutputs;
+    CubismPhysicsParticle* currentParticles;
 
-            // Update output parameters.
-            for (i = 0; i < currentSetting->OutputCount; ++i)
-            {
-                particleIndex = currentOutputs[i].VertexIndex;
+    totalAngle = 0.0f;
+    totalTranslation.X = 0.0f;
+    totalTranslation.Y = 0.0f;
+    currentSetting = &_physicsRig->Settings[settingIndex];
+    currentInputs = &_physicsRig->Inputs[currentSetting->BaseInputIndex];
+    currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
+    currentParticles = &_physicsRig->Particles[currentSetting->BaseParticleIndex];
 
-                if (currentOutputs[i].DestinationParameterIndex == -1)
-                {
-                    currentOutputs[i].DestinationParameterIndex = model->GetParameterIndex(currentOutputs[i].Destination.Id);
-                }
+    // Load input parameters.
+    for (i = 0; i < currentSetting->InputCount; ++i)
+    {
+        weight = currentInputs[i].Weight / MaximumWeight;
+
+        currentInputs[i].GetNormalizedParameterValue(
+            &totalTranslation,
+            &totalAngle,
+            _parameterCaches[currentInputs[i].SourceParameterIndex],
+            parameterMinimumValues[currentInputs[i].SourceParameterIndex],
+            parameterMaximumValues[currentInputs[i].SourceParameterIndex],
+            parameterDefaultValues[currentInputs[i].SourceParameterIndex],
+            &currentSetting->NormalizationPosition,
+            &currentSetting->NormalizationAngle,
+            currentInputs[i].Reflect,
+            weight
+        );
+    }
 
-                if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
-                {
-                    continue;
-                }
+    radAngle = CubismMath::DegreesToRadian(-totalAngle);
+
+    totalTranslation.X = (totalTranslation.X * PhysicsCosF(radAngle, _isDeterministic) - totalTranslation.Y * PhysicsSinF(radAngle, _isDeterministic));
+    totalTranslation.Y = (totalTranslation.X * PhysicsSinF(radAngle, _isDeterministic) + totalTranslation.Y * PhysicsCosF(radAngle, _isDeterministic));
+
+    // Calculate particles position.
+    UpdateParticles(
+        currentParticles,
+        currentSetting->ParticleCount,
+        totalTranslation,
+        totalAngle,
+        _options.Wind,
+        MovementThreshold * currentSetting->NormalizationPosition.Maximum,
+        physicsDeltaTime,
+        AirResistance,
+        _isDeterministic
+    );
+
+    // Update output parameters.
+    for (i = 0; i < currentSetting->OutputCount; ++i)
+    {
+        particleIndex = currentOutputs[i].VertexIndex;
+
+        if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
+        {
+            continue;
+        }
+
+        CubismVector2 translation;
+        translation.X = currentParticles[particleIndex].Position.X - currentParticles[particleIndex - 1].Position.X;
+        translation.Y = currentParticles[particleIndex].Position.Y - currentParticles[particleIndex - 1].Position.Y;
+
+        outputValue = currentOutputs[i].GetValue(
+            translation,
+            currentParticles,
+            particleIndex,
+            currentOutputs[i].Reflect,
+            _options.Gravity
+        );
+
+        _currentRigOutputs[settingIndex].outputs[i] = outputValue;
+
+        UpdateOutputParameterValue(
+                &_parameterCaches[currentOutputs[i].DestinationParameterIndex],
+                parameterMinimumValues[currentOutputs[i].DestinationParameterIndex],
+                parameterMaximumValues[currentOutputs[i].DestinationParameterIndex],
+                outputValue,
+                &currentOutputs[i]);
+    }
+}
+
+void CubismPhysics::EvaluateSubRigTask(csmInt32 index, void* userData)
+{
+    SubRigTaskContext* context = static_cast<SubRigTaskContext*>(userData);
+
+    context->Physics->EvaluateSubRig(
+        context->SettingIndices[index],
+        context->ParameterMinimumValues,
+        context->ParameterMaximumValues,
+        context->ParameterDefaultValues,
+        context->PhysicsDeltaTime
+    );
+}
+
+void CubismPhysics::BuildEvaluationWaves(CubismModel* model)
+{
+    csmInt32 i, settingIndex, parameterIndex, level, waveCount;
+    CubismPhysicsSubRig* currentSetting;
+    CubismPhysicsInput* currentInputs;
+    CubismPhysicsOutput* currentOutputs;
+
+    // 評価中にモデルへ問い合わせないよう、先にパラメータのインデックスを解決する
+    csmInt32 parameterSlotCount = model->GetParameterCount();
+    for (i = 0; i < static_cast<csmInt32>(_physicsRig->Inputs.GetSize()); ++i)
+    {
+        if (_physicsRig->Inputs[i].SourceParameterIndex == -1)
+        {
+            _physicsRig->Inputs[i].SourceParameterIndex = model->GetParameterIndex(_physicsRig->Inputs[i].Source.Id);
+        }
+        parameterSlotCount = MaxIndex(parameterSlotCount, _physicsRig->Inputs[i].SourceParameterIndex + 1);
+    }
+    for (i = 0; i < static_cast<csmInt32>(_physicsRig->Outputs.GetSize()); ++i)
+    {
+        if (_physicsRig->Outputs[i].DestinationParameterIndex == -1)
+        {
+            _physicsRig->Outputs[i].DestinationParameterIndex = model->GetParameterIndex(_physicsRig->Outputs[i].Destination.Id);
+        }
+        parameterSlotCount = MaxIndex(parameterSlotCount, _physicsRig->Outputs[i].DestinationParameterIndex + 1);
+    }
+
+    // パラメータごとに最後に書き込んだウェーブと、それ以降に読み込んだ最大のウェーブを記録する。
+    // サブリグは読み込むパラメータの書き込みより後、書き込むパラメータの読み書きより後のウェーブに置く。
+    // 元の順序で衝突するサブリグ同士の前後関係が保たれるため、結果は逐次評価と一致する。
+    csmVector<csmInt32> lastWriteLevels(parameterSlotCount);
+    csmVector<csmInt32> lastReadLevels(parameterSlotCount);
+    lastWriteLevels.Resize(parameterSlotCount, -1);
+    lastReadLevels.Resize(parameterSlotCount, -1);
+
+    csmVector<csmInt32> settingLevels(_physicsRig->SubRigCount);
+    waveCount = 0;
+
+    for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        currentSetting = &_physicsRig->Settings[settingIndex];
+        currentInputs = &_physicsRig->Inputs[currentSetting->BaseInputIndex];
+        currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
+
+        level = 0;
+        for (i = 0; i < currentSetting->InputCount; ++i)
+        {
+            parameterIndex = currentInputs[i].SourceParameterIndex;
+            level = MaxIndex(level, lastWriteLevels[parameterIndex] + 1);
+        }
+        for (i = 0; i < currentSetting->OutputCount; ++i)
+        {
+            parameterIndex = currentOutputs[i].DestinationParameterIndex;
+            level = MaxIndex(level, lastWriteLevels[parameterIndex] + 1);
+            level = MaxIndex(level, lastReadLevels[parameterIndex] + 1);
+        }
+
+        for (i = 0; i < currentSetting->InputCount; ++i)
+        {
+            parameterIndex = currentInputs[i].SourceParameterIndex;
+            lastReadLevels[parameterIndex] = MaxIndex(lastReadLevels[parameterIndex], level);
+        }
+        for (i = 0; i < currentSetting->OutputCount; ++i)
+        {
+            lastWriteLevels[currentOutputs[i].DestinationParameterIndex] = level;
+        }
+
+        settingLevels.PushBack(level);
+        waveCount = MaxIndex(waveCount, level + 1);
+    }
+
+    _waveSettingIndices.Clear();
+    _waveOffsets.Clear();
+    _waveParticleCounts.Clear();
 
-                CubismVector2 translation;
-                translation.X = currentParticles[particleIndex].Position.X - currentParticles[particleIndex - 1].Position.X;
-                translation.Y = currentParticles[particleIndex].Position.Y - currentParticles[particleIndex - 1].Position.Y;
-
-                outputValue = currentOutputs[i].GetValue(
-                    translation,
-                    currentParticles,
-                    particleIndex,
-                    currentOutputs[i].Reflect,
-                    _options.Gravity
-                );
-
-                _currentRigOutputs[settingIndex].outputs[i] = outputValue;
-
-                UpdateOutputParameterValue(
-                        &_parameterCaches[currentOutputs[i].DestinationParameterIndex],
-                        parameterMinimumValues[currentOutputs[i].DestinationParameterIndex],
-                        parameterMaximumValues[currentOutputs[i].DestinationParameterIndex],
-                        outputValue,
-                        &currentOutputs[i]);
+    for (level = 0; level < waveCount; ++level)
+    {
+        csmInt32 particleCount = 0;
+
+        _waveOffsets.PushBack(static_cast<csmInt32>(_waveSettingIndices.GetSize()));
+        for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+        {
+            if (settingLevels[settingIndex] != level)
+            {
+                continue;
             }
+
+            _waveSettingIndices.PushBack(settingIndex);
+            particleCount += _physicsRig->Settings[settingIndex].ParticleCount;
         }
+        _waveParticleCounts.PushBack(particleCount);
+    }
+    _waveOffsets.PushBack(static_cast<csmInt32>(_waveSettingIndices.GetSize()));
 
-        _currentRemainTime -= physicsDeltaTime;
+    // 並列に評価できるウェーブがあるときだけ共有のスレッドプールを使い、不要なスレッドを作らせない
+    if (_usesSharedThreadPool && _threadPool == NULL)
+    {
+        for (level = 0; level < waveCount; ++level)
+        {
+            if (_waveOffsets[level + 1] - _waveOffsets[level] > 1 && _waveParticleCounts[level] >= MinParallelParticleCount)
+            {
+                _threadPool = CubismFramework::GetThreadPool();
+                break;
+            }
+        }
     }
 
-    const float alpha = _currentRemainTime / physicsDeltaTime;
-    Interpolate(model, alpha);
+    _areWavesBuilt = true;
 }
 
 void CubismPhysics::Interpolate(CubismModel* model, csmFloat32 weight)
@@ -1063,4 +1314,199 @@ const CubismPhysics::Options& CubismPhysics::GetOptions() const
     return _options;
 }
 
+void CubismPhysics::SetThreadPool(CubismThreadPool* threadPool)
+{
+    _threadPool = threadPool;
+    _usesSharedThreadPool = false;
+}
+
+CubismThreadPool* CubismPhysics::GetThreadPool() const
+{
+    return _threadPool;
+}
+
+void CubismPhysics::SetDeterministic(csmBool isDeterministic)
+{
+    _isDeterministic = isDeterministic;
+
+    if (_physicsRig == NULL)
+    {
+        return;
+    }
+
+    for (csmUint32 i = 0; i < _physicsRig->Outputs.GetSize(); ++i)
+    {
+        if (_physicsRig->Outputs[i].Type == CubismPhysicsSource_Angle)
+        {
+            _physicsRig->Outputs[i].GetValue = isDeterministic ? GetOutputAngleDeterministic : GetOutputAngle;
+        }
+    }
+}
+
+csmBool CubismPhysics::IsDeterministic() const
+{
+    return _isDeterministic;
+}
+
+csmSizeInt CubismPhysics::GetStateSize() const
+{
+    if (_physicsRig == NULL)
+    {
+        return 0;
+    }
+
+    return StateHeaderSize
+        + sizeof(csmFloat32) * StateFloatsPerParticle * _physicsRig->Particles.GetSize()
+        + sizeof(csmFloat32) * StateFloatsPerOutput * _physicsRig->Outputs.GetSize()
+        + sizeof(csmFloat32) * _parameterInputCaches.GetSize();
+}
+
+csmBool CubismPhysics::SaveState(csmByte* buffer, csmSizeInt size) const
+{
+    csmInt32 i, settingIndex;
+
+    if (_physicsRig == NULL || buffer == NULL || size < GetStateSize())
+    {
+        CubismLogError("Failed to save physics state: buffer is too small.");
+        return false;
+    }
+
+    csmByte* cursor = buffer;
+
+    WriteStateValue<csmUint32>(cursor, StateMagic);
+    WriteStateValue<csmUint32>(cursor, StateVersion);
+    WriteStateValue<csmInt32>(cursor, static_cast<csmInt32>(_physicsRig->Particles.GetSize()));
+    WriteStateValue<csmInt32>(cursor, static_cast<csmInt32>(_physicsRig->Outputs.GetSize()));
+    WriteStateValue<csmInt32>(cursor, static_cast<csmInt32>(_parameterInputCaches.GetSize()));
+    WriteStateValue<csmFloat32>(cursor, _currentRemainTime);
+
+    for (i = 0; i < static_cast<csmInt32>(_physicsRig->Particles.GetSize()); ++i)
+    {
+        const CubismPhysicsParticle& particle = _physicsRig->Particles[i];
+
+        WriteStateValue<csmFloat32>(cursor, particle.Position.X);
+        WriteStateValue<csmFloat32>(cursor, particle.Position.Y);
+        WriteStateValue<csmFloat32>(cursor, particle.LastPosition.X);
+        WriteStateValue<csmFloat32>(cursor, particle.LastPosition.Y);
+        WriteStateValue<csmFloat32>(cursor, particle.Velocity.X);
+        WriteStateValue<csmFloat32>(cursor, particle.Velocity.Y);
+        WriteStateValue<csmFloat32>(cursor, particle.LastGravity.X);
+        WriteStateValue<csmFloat32>(cursor, particle.LastGravity.Y);
+    }
+
+    for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        const CubismPhysicsSubRig& setting = _physicsRig->Settings[settingIndex];
+
+        for (i = 0; i < setting.OutputCount; ++i)
+        {
+            const CubismPhysicsOutput& output = _physicsRig->Outputs[setting.BaseOutputIndex + i];
+
+            WriteStateValue<csmFloat32>(cursor, _currentRigOutputs[settingIndex].outputs[i]);
+            WriteStateValue<csmFloat32>(cursor, _previousRigOutputs[settingIndex].outputs[i]);
+            WriteStateValue<csmFloat32>(cursor, output.ValueBelowMinimum);
+            WriteStateValue<csmFloat32>(cursor, output.ValueExceededMaximum);
+        }
+    }
+
+    for (i = 0; i < static_cast<csmInt32>(_parameterInputCaches.GetSize()); ++i)
+    {
+        WriteStateValue<csmFloat32>(cursor, _parameterInputCaches[i]);
+    }
+
+    return true;
+}
+
+csmBool CubismPhysics::RestoreState(const csmByte* buffer, csmSizeInt size)
+{
+    csmInt32 i, settingIndex;
+
+    if (_physicsRig == NULL || buffer == NULL || size < StateHeaderSize)
+    {
+        CubismLogError("Failed to restore physics state: invalid state.");
+        return false;
+    }
+
+    const csmByte* cursor = buffer;
+
+    const csmUint32 magic = ReadStateValue<csmUint32>(cursor);
+    const csmUint32 version = ReadStateValue<csmUint32>(cursor);
+    const csmInt32 particleCount = ReadStateValue<csmInt32>(cursor);
+    const csmInt32 outputCount = ReadStateValue<csmInt32>(cursor);
+    const csmInt32 inputCacheCount = ReadStateValue<csmInt32>(cursor);
+
+    if (magic != StateMagic || version != StateVersion
+        || particleCount != static_cast<csmInt32>(_physicsRig->Particles.GetSize())
+        || outputCount != static_cast<csmInt32>(_physicsRig->Outputs.GetSize())
+        || inputCacheCount < 0)
+    {
+        CubismLogError("Failed to restore physics state: the state was saved from another physics.");
+        return false;
+    }
+
+    const csmSizeInt expectedSize = StateHeaderSize
+        + sizeof(csmFloat32) * StateFloatsPerParticle * particleCount
+        + sizeof(csmFloat32) * StateFloatsPerOutput * outputCount
+        + sizeof(csmFloat32) * inputCacheCount;
+
+    if (size < expectedSize)
+    {
+        CubismLogError("Failed to restore physics state: the state is truncated.");
+        return false;
+    }
+
+    _currentRemainTime = ReadStateValue<csmFloat32>(cursor);
+
+    for (i = 0; i < particleCount; ++i)
+    {
+        CubismPhysicsParticle& particle = _physicsRig->Particles[i];
+
+        particle.Position.X = ReadStateValue<csmFloat32>(cursor);
+        particle.Position.Y = ReadStateValue<csmFloat32>(cursor);
+        particle.LastPosition.X = ReadStateValue<csmFloat32>(cursor);
+        particle.LastPosition.Y = ReadStateValue<csmFloat32>(cursor);
+        particle.Velocity.X = ReadStateValue<csmFloat32>(cursor);
+        particle.Velocity.Y = ReadStateValue<csmFloat32>(cursor);
+        particle.LastGravity.X = ReadStateValue<csmFloat32>(cursor);
+        particle.LastGravity.Y = ReadStateValue<csmFloat32>(cursor);
+        particle.Force = CubismVector2(0.0f, 0.0f);
+    }
+
+    for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        const CubismPhysicsSubRig& setting = _physicsRig->Settings[settingIndex];
+
+        for (i = 0; i < setting.OutputCount; ++i)
+        {
+            CubismPhysicsOutput& output = _physicsRig->Outputs[setting.BaseOutputIndex + i];
+
+            _currentRigOutputs[settingIndex].outputs[i] = ReadStateValue<csmFloat32>(cursor);
+            _previousRigOutputs[settingIndex].outputs[i] = ReadStateValue<csmFloat32>(cursor);
+            output.ValueBelowMinimum = ReadStateValue<csmFloat32>(cursor);
+            output.ValueExceededMaximum = ReadStateValue<csmFloat32>(cursor);
+        }
+    }
+
+    _parameterInputCaches.Resize(inputCacheCount);
+    for (i = 0; i < inputCacheCount; ++i)
+    {
+        _parameterInputCaches[i] = ReadStateValue<csmFloat32>(cursor);
+    }
+
+    return true;
+}
+
+void CubismPhysics::GetInputParameterIds(csmVector<CubismIdHandle>& parameterIds) const
+{
+    if (_physicsRig == NULL)
+    {
+        return;
+    }
+
+    for (csmUint32 i = 0; i < _physicsRig->Inputs.GetSize(); ++i)
+    {
+        parameterIds.PushBack(_physicsRig->Inputs[i].Source.Id);
+    }
+}
+
 }}}
@@ -13,6 +13,7 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismModel;
+class CubismThreadPool;
 struct CubismPhysicsRig;
 
 /**
@@ -105,7 +106,97 @@ public:
      */
     const Options& GetOptions() const;
 
+    /**
+     * @brief 入力パラメータIDの取得
+     *
+     * 物理演算の入力として参照するパラメータのIDを取得する。
+     *
+     * @param[out]  parameterIds    入力パラメータIDを追加するリスト
+     */
+    void GetInputParameterIds(csmVector<CubismIdHandle>& parameterIds) const;
+
+    /**
+     * @brief スレッドプールの設定
+     *
+     * 互いに依存しないサブリグを並列に評価するスレッドプールを設定する。
+     * 評価結果は逐次評価と同一になる。
+     *
+     * @param[in]   threadPool  スレッドプール。NULLの場合は逐次評価する
+     *
+     * @note 設定しなければ、並列に評価できるサブリグがあるときに CubismFramework::GetThreadPool() を使う。
+     */
+    void SetThreadPool(CubismThreadPool* threadPool);
+
+    /**
+     * @brief スレッドプールの取得
+     *
+     * @return スレッドプール。共有のスレッドプールは最初の評価まで取得しないため、それまではNULL
+     */
+    CubismThreadPool* GetThreadPool() const;
+
+    /**
+     * @brief 決定論的モードの設定
+     *
+     * 有効にすると三角関数をテーブル参照で計算し、サブリグを常に定義順に評価する。
+     * 同じ入力からCPUやコンパイラによらず同じ結果が得られるため、リプレイや複数クライアントの同期に用いる。
+     *
+     * @param[in]   isDeterministic     trueで決定論的モードを有効にする
+     *
+     * @note 決定論的モードの結果は通常モードの結果と一致しない。
+     */
+    void SetDeterministic(csmBool isDeterministic);
+
+    /**
+     * @brief 決定論的モードの取得
+     *
+     * @return 決定論的モードが有効ならtrue
+     */
+    csmBool IsDeterministic() const;
+
+    /**
+     * @brief 状態の保存に必要なサイズの取得
+     *
+     * @return SaveStateに必要なバッファのサイズ[byte]
+     */
+    csmSizeInt GetStateSize() const;
+
+    /**
+     * @brief 状態の保存
+     *
+     * 物理点の位置と速度、未処理の時間、入力キャッシュ、出力結果をバイナリとして書き出す。
+     * 書き出した状態を同じphysics3.jsonから作成したインスタンスに復元すると、Stabilizationなしで演算を続けられる。
+     *
+     * @param[out]  buffer  書き出し先のバッファ
+     * @param[in]   size    バッファのサイズ。GetStateSize()以上
+     * @return  保存に成功したらtrue
+     */
+    csmBool SaveState(csmByte* buffer, csmSizeInt size) const;
+
+    /**
+     * @brief 状態の復元
+     *
+     * SaveStateで書き出した状態を復元する。
+     *
+     * @param[in]   buffer  SaveStateで書き出したバッファ
+     * @param[in]   size    バッファのサイズ
+     * @return  復元に成功したらtrue。物理点や出力の数が一致しない場合はfalse
+     */
+    csmBool RestoreState(const csmByte* buffer, csmSizeInt size);
+
 private:
+    /**
+     * @brief サブリグ評価タスクの引数
+     */
+    struct SubRigTaskContext
+    {
+        CubismPhysics* Physics;                     ///< 評価する物理演算
+        const csmInt32* SettingIndices;             ///< 評価するサブリグのインデックス
+        const csmFloat32* ParameterMinimumValues;   ///< パラメータの最小値
+        const csmFloat32* ParameterMaximumValues;   ///< パラメータの最大値
+        const csmFloat32* ParameterDefaultValues;   ///< パラメータのデフォルト値
+        csmFloat32 PhysicsDeltaTime;                ///< 物理演算のデルタ時間
+    };
+
     /**
      * @brief コンストラクタ
      *
@@ -151,6 +242,38 @@ private:
      */
     void Interpolate(CubismModel* model, csmFloat32 weight);
 
+    /**
+     * @brief 評価ウェーブの構築
+     *
+     * 入出力パラメータのインデックスを解決し、サブリグを依存関係に従ってウェーブに分ける。
+     * 同じウェーブのサブリグは共通のパラメータを書き込まず、互いの出力も読まないため並列に評価できる。
+     *
+     * @param[in]   model   物理演算の結果を適用するモデル
+     */
+    void BuildEvaluationWaves(CubismModel* model);
+
+    /**
+     * @brief サブリグの評価
+     *
+     * サブリグの入力を読み込み、振り子を1ステップ進めて出力をパラメータのキャッシュに書き込む。
+     *
+     * @param[in]   settingIndex            サブリグのインデックス
+     * @param[in]   parameterMinimumValues  パラメータの最小値
+     * @param[in]   parameterMaximumValues  パラメータの最大値
+     * @param[in]   parameterDefaultValues  パラメータのデフォルト値
+     * @param[in]   physicsDeltaTime        物理演算のデルタ時間
+     */
+    void EvaluateSubRig(csmInt32 settingIndex, const csmFloat32* parameterMinimumValues, const csmFloat32* parameterMaximumValues,
+                        const csmFloat32* parameterDefaultValues, csmFloat32 physicsDeltaTime);
+
+    /**
+     * @brief スレッドプールから呼ばれるサブリグ評価
+     *
+     * @param[in]   index       ウェーブ内のサブリグの番号
+     * @param[in]   userData    SubRigTaskContext
+     */
+    static void EvaluateSubRigTask(csmInt32 index, void* userData);
+
     CubismPhysicsRig* _physicsRig; ///< 物理演算のデータ
     Options _options; ///< オプション
 
@@ -163,6 +286,15 @@ private:
     csmVector<csmFloat32> _parameterInputCaches; ///< UpdateParticlesが動くときの入力をキャッシュ
 
     csmBool _isJsonValid; ///< 正しくJsonデータが取得出来たか
+
+    CubismThreadPool* _threadPool;              ///< サブリグを並列評価するスレッドプール
+    csmBool _usesSharedThreadPool;              ///< SetThreadPool()が呼ばれておらず、必要になれば共有のスレッドプールを使うか
+    csmBool _areWavesBuilt;                     ///< 評価ウェーブが構築済みか
+    csmVector<csmInt32> _waveSettingIndices;    ///< ウェーブ順に並べたサブリグのインデックス
+    csmVector<csmInt32> _waveOffsets;           ///< 各ウェーブの_waveSettingIndices内の開始位置。末尾は総数
+    csmVector<csmInt32> _waveParticleCounts;    ///< 各ウェーブに含まれる物理点の数
+
+    csmBool _isDeterministic;                   ///< 決定論的モードが有効か
 };
 
 }}}
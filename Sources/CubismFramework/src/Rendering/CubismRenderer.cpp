@@ -8,6 +8,7 @@
 #include "CubismRenderer.hpp"
 #include "CubismFramework.hpp"
 #include "Model/CubismModel.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -43,6 +44,8 @@ void CubismRenderer::Initialize(Framework::CubismModel* model, csmInt32 maskBuff
 
 void CubismRenderer::DrawModel()
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_Draw);
+
     if (GetModel() == NULL) return;
 
     /**
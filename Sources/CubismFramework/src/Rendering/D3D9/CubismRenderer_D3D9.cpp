@@ -14,6 +14,7 @@
 #include "Model/CubismModel.hpp"
 #include "CubismShader_D3D9.hpp"
 #include "CubismRenderState_D3D9.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -49,6 +50,8 @@ D3DXMATRIX ConvertToD3DX(CubismMatrix44& mtx)
 ********************************************************************************************************************/
 void CubismClippingManager_DX9::SetupClippingContext(LPDIRECT3DDEVICE9 device, CubismModel& model, CubismRenderer_D3D9* renderer, csmInt32 offscreenCurrent)
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_ClippingSetup);
+
     // 全てのクリッピングを用意する
     // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
     csmInt32 usingClipCount = 0;
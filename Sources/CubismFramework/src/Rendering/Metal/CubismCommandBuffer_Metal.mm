@@ -7,6 +7,7 @@
 
 #include "CubismCommandBuffer_Metal.hpp"
 #include "CubismFramework.hpp"
+#include "Utils/CubismProfiler.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D {
@@ -110,6 +111,8 @@ void CubismCommandBuffer_Metal::DrawCommandBuffer::UpdateVertexBuffer(void* data
 
     memcpy(destVertices, sourceVertices, length);
     memcpy(destUvs, sourceUvs, length);
+
+    CSM_PROFILE_COUNT(CubismProfileCounter_BytesUploaded, length * 2);
 }
 
 void CubismCommandBuffer_Metal::DrawCommandBuffer::UpdateIndexBuffer(void* data, csmSizeInt count)
@@ -127,6 +130,8 @@ void CubismCommandBuffer_Metal::DrawCommandBuffer::UpdateIndexBuffer(void* data,
         dest++;
         sourceIndices++;
     }
+
+    CSM_PROFILE_COUNT(CubismProfileCounter_BytesUploaded, length);
 }
 
 CubismCommandBuffer_Metal::DrawCommandBuffer::DrawCommand* CubismCommandBuffer_Metal::DrawCommandBuffer::GetCommandDraw()
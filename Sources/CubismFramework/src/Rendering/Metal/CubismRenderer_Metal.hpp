@@ -305,6 +305,8 @@ private:
     csmVector<CubismOffscreenSurface_Metal> _offscreenSurfaces;         ///< マスク描画用のフレームバッファ
     CubismCommandBuffer_Metal _commandBuffer;
     csmVector<CubismCommandBuffer_Metal::DrawCommandBuffer*> _drawableDrawCommandBuffer;
+    csmUint32 _uploadedUpdateCount;                             ///< 頂点バッファに転送したときのモデルの更新回数
+    csmBool _isVertexBufferUploaded;                            ///< 頂点バッファに一度でも転送したか
 };
 
 }}}}
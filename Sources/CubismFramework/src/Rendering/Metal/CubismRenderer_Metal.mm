@@ -11,6 +11,7 @@
 #include "CubismShader_Metal.hpp"
 #include "CubismRenderingInstanceSingleton_Metal.h"
 #include "MetalShaderTypes.h"
+#include "Utils/CubismProfiler.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -20,6 +21,8 @@ namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering
 ********************************************************************************************************************/
 void CubismClippingManager_Metal::SetupClippingContext(CubismModel& model, CubismRenderer_Metal* renderer, CubismOffscreenSurface_Metal* lastColorBuffer, csmRectF lastViewport)
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_ClippingSetup);
+
     // 全てのクリッピングを用意する
     // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
     csmInt32 usingClipCount = 0;
@@ -42,6 +45,8 @@ void CubismClippingManager_Metal::SetupClippingContext(CubismModel& model, Cubis
         return;
     }
 
+    CSM_PROFILE_COUNT(CubismProfileCounter_MasksRendered, usingClipCount);
+
     // マスク作成処理
     id <MTLRenderCommandEncoder> renderEncoder = nil;
     MTLViewport clipVp = {0, 0, GetClippingMaskBufferSize().X, GetClippingMaskBufferSize().Y, 0.0, 1.0};
@@ -242,6 +247,8 @@ void CubismRenderer::StaticRelease()
 CubismRenderer_Metal::CubismRenderer_Metal() : _clippingManager(NULL)
                                                      , _clippingContextBufferForMask(NULL)
                                                      , _clippingContextBufferForDraw(NULL)
+                                                     , _uploadedUpdateCount(0)
+                                                     , _isVertexBufferUploaded(false)
 {
     // テクスチャ対応マップの容量を確保しておく.
     _textures.PrepareCapacity(32, true);
@@ -406,7 +413,12 @@ void CubismRenderer_Metal::DoDrawModel()
     }
 
     // Update Vertex / Index buffer.
-    for (csmInt32 i = 0; i < drawableCount; ++i)
+    // モデルが更新されていなければ前回転送した内容がバッファに残っているので転送しない
+    const csmBool isModelUpdated = !_isVertexBufferUploaded || _uploadedUpdateCount != GetModel()->GetUpdateCount();
+    _uploadedUpdateCount = GetModel()->GetUpdateCount();
+    _isVertexBufferUploaded = true;
+
+    for (csmInt32 i = 0; isModelUpdated && i < drawableCount; ++i)
     {
         csmFloat32* vertices = const_cast<csmFloat32*>(GetModel()->GetDrawableVertices(i));
         Core::csmVector2* uvs = const_cast<Core::csmVector2*>(GetModel()->GetDrawableVertexUvs(i));
@@ -445,6 +457,7 @@ void CubismRenderer_Metal::DoDrawModel()
             {
                 renderEncoder = PreDraw(s_commandBuffer, _offscreenSurfaces[ clipContext->_bufferIndex].GetRenderPassDescriptor());
                 [renderEncoder setViewport:clipVp];
+                CSM_PROFILE_COUNT(CubismProfileCounter_MasksRendered, 1);
             }
 
             {
@@ -517,6 +530,7 @@ void CubismRenderer_Metal::DoDrawModel()
         }
 
         DrawMeshMetal(_drawableDrawCommandBuffer[drawableIndex], renderEncoder, *GetModel(), drawableIndex);
+        CSM_PROFILE_COUNT(CubismProfileCounter_DrawablesDrawn, 1);
 
         if(IsUsingHighPrecisionMask())
         {
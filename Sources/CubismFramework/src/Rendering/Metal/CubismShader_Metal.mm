@@ -8,6 +8,7 @@
 #include "CubismShader_Metal.hpp"
 #include "CubismRenderer_Metal.hpp"
 #include "CubismRenderingInstanceSingleton_Metal.h"
+#include "Utils/CubismMemoryTracker.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -93,6 +94,8 @@ CubismShader_Metal* CubismShader_Metal::GetInstance()
 {
     if (s_instance == NULL)
     {
+        // シェーダは全モデルで共有するので、最初に描画したモデルには計上しない
+        CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
         s_instance = CSM_NEW CubismShader_Metal();
     }
     return s_instance;
@@ -110,6 +113,8 @@ void CubismShader_Metal::DeleteInstance()
 
 void CubismShader_Metal::GenerateShaders(CubismRenderer_Metal* renderer)
 {
+    CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
+
     for (csmInt32 i = 0; i < ShaderCount; i++)
     {
         _shaderSets.PushBack(CSM_NEW CubismShaderSet());
@@ -10,6 +10,7 @@
 #include "Type/csmVector.hpp"
 #include "Model/CubismModel.hpp"
 #include <float.h>
+#include "Utils/CubismProfiler.hpp"
 
 #ifdef CSM_TARGET_WIN_GL
 #include <Windows.h>
@@ -29,6 +30,8 @@ namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering
 ********************************************************************************************************************/
 void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, CubismRenderer_OpenGLES2* renderer, GLint lastFBO, GLint lastViewport[4])
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_ClippingSetup);
+
     // 全てのクリッピングを用意する
     // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
     csmInt32 usingClipCount = 0;
@@ -74,6 +74,11 @@ void CubismBufferVulkan::MemCpy(const void* src, VkDeviceSize size) const
     memcpy(mapped, src, (size_t)size);
 }
 
+void CubismBufferVulkan::MemCpy(const void* src, VkDeviceSize offset, VkDeviceSize size) const
+{
+    memcpy(static_cast<csmUint8*>(mapped) + offset, src, (size_t)size);
+}
+
 void CubismBufferVulkan::UnMap(VkDevice device) const
 {
     vkUnmapMemory(device, memory);
@@ -60,6 +60,15 @@ public:
      */
     void MemCpy(const void* src, VkDeviceSize size) const;
 
+    /**
+     * @brief   マップ領域の指定位置にメモリブロックをコピーする
+     *
+     * @param[in]  src    -> コピーするデータ
+     * @param[in]  offset -> コピー先のオフセット
+     * @param[in]  size   -> コピーするサイズ
+     */
+    void MemCpy(const void* src, VkDeviceSize offset, VkDeviceSize size) const;
+
     /**
      * @brief   メモリのマップを解除する
      *
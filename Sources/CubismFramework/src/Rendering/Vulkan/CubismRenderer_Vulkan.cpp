@@ -9,6 +9,8 @@
 #include "Math/CubismMatrix44.hpp"
 #include "Type/csmVector.hpp"
 #include "Model/CubismModel.hpp"
+#include "Utils/CubismProfiler.hpp"
+#include "Utils/CubismMemoryTracker.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -28,6 +30,59 @@ VkImage s_renderImage;
 VkImageView s_imageView;
 VkFormat s_imageFormat;
 VkFormat s_depthFormat;
+
+// 複数モデルを1回のサブミットにまとめる共有フレーム
+bool s_isRecordingSharedFrame = false;
+csmUint32 s_sharedFrameCurrent = 0;
+csmUint64 s_sharedFrameSerial = 0;
+bool s_isSharedFrameRenderingStarted = false; // 共有フレームのレンダーターゲットに描画したモデルがあるか
+csmVector<VkCommandBuffer> s_sharedUpdateCommandBuffers;
+csmVector<VkCommandBuffer> s_sharedDrawCommandBuffers;
+csmVector<VkSemaphore> s_sharedUpdateFinishedSemaphores;
+csmVector<VkFence> s_sharedFrameFences;
+
+/**
+ * @brief   共有フレーム用の同期オブジェクトとコマンドバッファを解放する
+ */
+void ReleaseSharedFrameResources()
+{
+    if (s_sharedFrameFences.GetSize() == 0)
+    {
+        return;
+    }
+
+    vkWaitForFences(s_device, s_sharedFrameFences.GetSize(), s_sharedFrameFences.GetPtr(), VK_TRUE, UINT64_MAX);
+    for (csmUint32 buffer = 0; buffer < s_sharedFrameFences.GetSize(); buffer++)
+    {
+        vkDestroyFence(s_device, s_sharedFrameFences[buffer], nullptr);
+        vkDestroySemaphore(s_device, s_sharedUpdateFinishedSemaphores[buffer], nullptr);
+    }
+    vkFreeCommandBuffers(s_device, s_commandPool, s_sharedUpdateCommandBuffers.GetSize(), s_sharedUpdateCommandBuffers.GetPtr());
+    vkFreeCommandBuffers(s_device, s_commandPool, s_sharedDrawCommandBuffers.GetSize(), s_sharedDrawCommandBuffers.GetPtr());
+
+    s_sharedFrameFences.Clear();
+    s_sharedUpdateFinishedSemaphores.Clear();
+    s_sharedUpdateCommandBuffers.Clear();
+    s_sharedDrawCommandBuffers.Clear();
+    s_sharedFrameCurrent = 0;
+}
+
+/**
+ * @brief   シグナル状態で作成したフェンスを返す
+ */
+VkFence CreateSignaledFence()
+{
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    VkFence fence = VK_NULL_HANDLE;
+    if (vkCreateFence(s_device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+        CubismLogError("failed to create fence!");
+    }
+    return fence;
+}
 }
 
 VkViewport GetViewport(csmFloat32 width, csmFloat32 height, csmFloat32 minDepth, csmFloat32 maxDepth)
@@ -58,6 +113,8 @@ void CubismClippingManager_Vulkan::SetupClippingContext(CubismModel& model, VkCo
                                                         VkCommandBuffer updateCommandBuffer,
                                                         CubismRenderer_Vulkan* renderer, csmInt32 offscreenCurrent)
 {
+    CSM_PROFILE_STAGE(CubismProfileStage_ClippingSetup);
+
     // 全てのクリッピングを用意する
     // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
     csmInt32 usingClipCount = 0;
@@ -217,10 +274,84 @@ CubismClippingContext_Vulkan::GetClippingManager()
 namespace {
 const csmInt32 ShaderCount = 19;
 ///<シェーダの数 = マスク生成用 + (通常 + 加算 + 乗算) * (マスク無 + マスク有 + マスク有反転 + マスク無の乗算済アルファ対応版 + マスク有の乗算済アルファ対応版 + マスク有反転の乗算済アルファ対応版)
+const csmInt32 ShaderProgramCount = 7; ///< 実際に作成するシェーダープログラムの数（ブレンド方法違いは共有する）
+const csmInt32 BlendCount = 4; ///< normal, add, multi, mask
 CubismPipeline_Vulkan* s_pipelineManager;
+
+#ifdef CSM_VULKAN_EMBEDDED_SHADERS
+// ビルド時にglslcで生成したSPIR-V
+constexpr csmUint32 VertShaderSrcSetupMaskCode[] =
+#include "VertShaderSrcSetupMask.spv.h"
+;
+constexpr csmUint32 FragShaderSrcSetupMaskCode[] =
+#include "FragShaderSrcSetupMask.spv.h"
+;
+constexpr csmUint32 VertShaderSrcCode[] =
+#include "VertShaderSrc.spv.h"
+;
+constexpr csmUint32 FragShaderSrcCode[] =
+#include "FragShaderSrc.spv.h"
+;
+constexpr csmUint32 VertShaderSrcMaskedCode[] =
+#include "VertShaderSrcMasked.spv.h"
+;
+constexpr csmUint32 FragShaderSrcMaskCode[] =
+#include "FragShaderSrcMask.spv.h"
+;
+constexpr csmUint32 FragShaderSrcMaskInvertedCode[] =
+#include "FragShaderSrcMaskInverted.spv.h"
+;
+constexpr csmUint32 FragShaderSrcPremultipliedAlphaCode[] =
+#include "FragShaderSrcPremultipliedAlpha.spv.h"
+;
+constexpr csmUint32 FragShaderSrcMaskPremultipliedAlphaCode[] =
+#include "FragShaderSrcMaskPremultipliedAlpha.spv.h"
+;
+constexpr csmUint32 FragShaderSrcMaskInvertedPremultipliedAlphaCode[] =
+#include "FragShaderSrcMaskInvertedPremultipliedAlpha.spv.h"
+;
+#define CSM_SPIRV(name) name##Code, sizeof(name##Code)
+#else
+#define CSM_SPIRV(name) NULL, 0
+#endif
+
+/**
+ * @brief   シェーダープログラムを構成するSPIR-V
+ */
+struct ShaderProgramSource
+{
+    const char* vertFileName; ///< 埋め込みが無い場合に読み込むVertexシェーダーのファイル
+    const csmUint32* vertCode; ///< 埋め込まれたVertexシェーダー
+    csmSizeInt vertCodeSize; ///< 埋め込まれたVertexシェーダーのバイト数
+    const char* fragFileName; ///< 埋め込みが無い場合に読み込むFragmentシェーダーのファイル
+    const csmUint32* fragCode; ///< 埋め込まれたFragmentシェーダー
+    csmSizeInt fragCodeSize; ///< 埋め込まれたFragmentシェーダーのバイト数
+};
+
+const ShaderProgramSource ShaderProgramSources[ShaderProgramCount] = {
+    {"FrameworkShaders/VertShaderSrcSetupMask.spv", CSM_SPIRV(VertShaderSrcSetupMask),
+     "FrameworkShaders/FragShaderSrcSetupMask.spv", CSM_SPIRV(FragShaderSrcSetupMask)},
+    {"FrameworkShaders/VertShaderSrc.spv", CSM_SPIRV(VertShaderSrc),
+     "FrameworkShaders/FragShaderSrc.spv", CSM_SPIRV(FragShaderSrc)},
+    {"FrameworkShaders/VertShaderSrcMasked.spv", CSM_SPIRV(VertShaderSrcMasked),
+     "FrameworkShaders/FragShaderSrcMask.spv", CSM_SPIRV(FragShaderSrcMask)},
+    {"FrameworkShaders/VertShaderSrcMasked.spv", CSM_SPIRV(VertShaderSrcMasked),
+     "FrameworkShaders/FragShaderSrcMaskInverted.spv", CSM_SPIRV(FragShaderSrcMaskInverted)},
+    {"FrameworkShaders/VertShaderSrc.spv", CSM_SPIRV(VertShaderSrc),
+     "FrameworkShaders/FragShaderSrcPremultipliedAlpha.spv", CSM_SPIRV(FragShaderSrcPremultipliedAlpha)},
+    {"FrameworkShaders/VertShaderSrcMasked.spv", CSM_SPIRV(VertShaderSrcMasked),
+     "FrameworkShaders/FragShaderSrcMaskPremultipliedAlpha.spv", CSM_SPIRV(FragShaderSrcMaskPremultipliedAlpha)},
+    {"FrameworkShaders/VertShaderSrcMasked.spv", CSM_SPIRV(VertShaderSrcMasked),
+     "FrameworkShaders/FragShaderSrcMaskInvertedPremultipliedAlpha.spv", CSM_SPIRV(FragShaderSrcMaskInvertedPremultipliedAlpha)},
+};
+#undef CSM_SPIRV
 }
 
 CubismPipeline_Vulkan::CubismPipeline_Vulkan()
+    : _pipelineLayout(VK_NULL_HANDLE)
+    , _pipelineCache(VK_NULL_HANDLE)
+    , _colorFormat(VK_FORMAT_UNDEFINED)
+    , _depthFormat(VK_FORMAT_UNDEFINED)
 {}
 
 CubismPipeline_Vulkan::~CubismPipeline_Vulkan()
@@ -228,6 +359,13 @@ CubismPipeline_Vulkan::~CubismPipeline_Vulkan()
     ReleaseShaderProgram();
 }
 
+CubismPipeline_Vulkan::PipelineResource::PipelineResource()
+    : _vertShaderModule(VK_NULL_HANDLE)
+    , _fragShaderModule(VK_NULL_HANDLE)
+{
+    _pipeline.Resize(BlendCount, VK_NULL_HANDLE);
+}
+
 VkShaderModule CubismPipeline_Vulkan::PipelineResource::CreateShaderModule(VkDevice device, std::string filename)
 {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
@@ -245,10 +383,16 @@ VkShaderModule CubismPipeline_Vulkan::PipelineResource::CreateShaderModule(VkDev
     file.read(buffer.GetPtr(), fileSize);
     file.close();
 
+    return CreateShaderModule(device, reinterpret_cast<const csmUint32*>(buffer.GetPtr()), fileSize);
+}
+
+VkShaderModule CubismPipeline_Vulkan::PipelineResource::CreateShaderModule(VkDevice device, const csmUint32* code,
+                                                                           csmSizeInt codeSize)
+{
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = fileSize;
-    createInfo.pCode = reinterpret_cast<const csmUint32*>(buffer.GetPtr());
+    createInfo.codeSize = codeSize;
+    createInfo.pCode = code;
 
     VkShaderModule shaderModule;
     if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
@@ -260,34 +404,41 @@ VkShaderModule CubismPipeline_Vulkan::PipelineResource::CreateShaderModule(VkDev
     return shaderModule;
 }
 
-bool CubismPipeline_Vulkan::PipelineResource::CreateGraphicsPipeline(std::string vertFileName, std::string fragFileName,
-                                                                   VkDescriptorSetLayout descriptorSetLayout)
+bool CubismPipeline_Vulkan::PipelineResource::CreateShaderModules(csmInt32 programIndex)
 {
-    VkShaderModule vertShaderModule = CreateShaderModule(s_device, vertFileName);
-    if(vertShaderModule == NULL)
+    const ShaderProgramSource& source = ShaderProgramSources[programIndex];
+
+    _vertShaderModule = (source.vertCode != NULL)
+                            ? CreateShaderModule(s_device, source.vertCode, source.vertCodeSize)
+                            : CreateShaderModule(s_device, source.vertFileName);
+    if(_vertShaderModule == NULL)
     {
         return false;
     }
 
-    VkShaderModule fragShaderModule = CreateShaderModule(s_device, fragFileName);
-    if(fragShaderModule == NULL)
+    _fragShaderModule = (source.fragCode != NULL)
+                            ? CreateShaderModule(s_device, source.fragCode, source.fragCodeSize)
+                            : CreateShaderModule(s_device, source.fragFileName);
+    if(_fragShaderModule == NULL)
     {
         return false;
     }
 
-    _pipeline.Resize(4);
-    _pipelineLayout.Resize(4);
+    return true;
+}
 
+VkPipeline CubismPipeline_Vulkan::PipelineResource::CreateGraphicsPipeline(csmInt32 blendIndex)
+{
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
+    vertShaderStageInfo.module = _vertShaderModule;
     vertShaderStageInfo.pName = "main";
 
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
     fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
+    fragShaderStageInfo.module = _fragShaderModule;
     fragShaderStageInfo.pName = "main";
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
@@ -326,18 +477,48 @@ bool CubismPipeline_Vulkan::PipelineResource::CreateGraphicsPipeline(std::string
     multisampling.sampleShadingEnable = VK_FALSE;
     multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
-    // 通常
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
             | VK_COLOR_COMPONENT_A_BIT;
     colorBlendAttachment.blendEnable = VK_TRUE;
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
 
+    switch (blendIndex)
+    {
+    default:
+        // 通常
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        break;
+
+    case Blend_Add:
+        // 加算
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        break;
+
+    case Blend_Mult:
+        // 乗算
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_DST_COLOR;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        break;
+
+    case Blend_Mask:
+        // マスク
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        break;
+    }
+
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlending.logicOpEnable = VK_FALSE;
@@ -345,11 +526,6 @@ bool CubismPipeline_Vulkan::PipelineResource::CreateGraphicsPipeline(std::string
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-
     VkDynamicState dynamicState[3] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_CULL_MODE};
 
     VkPipelineDynamicStateCreateInfo dynamicStateCI{};
@@ -364,16 +540,11 @@ bool CubismPipeline_Vulkan::PipelineResource::CreateGraphicsPipeline(std::string
     pipelineDepthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
     pipelineDepthStencilStateCreateInfo.back.compareOp = VK_COMPARE_OP_ALWAYS;
 
-    if (vkCreatePipelineLayout(s_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout[Blend_Normal]) != VK_SUCCESS)
-    {
-        CubismLogError("failed to create _pipeline layout!");
-    }
-
     VkPipelineRenderingCreateInfo renderingInfo{};
     renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
     renderingInfo.colorAttachmentCount = 1;
-    renderingInfo.pColorAttachmentFormats = &s_imageFormat;
-    renderingInfo.depthAttachmentFormat = s_depthFormat;
+    renderingInfo.pColorAttachmentFormats = &s_pipelineManager->_colorFormat;
+    renderingInfo.depthAttachmentFormat = s_pipelineManager->_depthFormat;
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -385,89 +556,45 @@ bool CubismPipeline_Vulkan::PipelineResource::CreateGraphicsPipeline(std::string
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
     pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.layout = _pipelineLayout[Blend_Normal];
+    pipelineInfo.layout = s_pipelineManager->_pipelineLayout;
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.pDynamicState = &dynamicStateCI;
     pipelineInfo.pDepthStencilState = &pipelineDepthStencilStateCreateInfo;
     pipelineInfo.pNext = &renderingInfo;
 
-    if (vkCreateGraphicsPipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline[Blend_Normal]) !=
-        VK_SUCCESS)
-    {
-        CubismLogError("failed to create graphics _pipeline!");
-    }
-
-    // 加算
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    if (vkCreatePipelineLayout(s_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout[Blend_Add]) != VK_SUCCESS)
-    {
-        CubismLogError("failed to create _pipeline layout!");
-    }
-    pipelineInfo.layout = _pipelineLayout[Blend_Add];
-    if (vkCreateGraphicsPipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline[Blend_Add]) !=
-        VK_SUCCESS)
-    {
-        CubismLogError("failed to create graphics _pipeline!");
-    }
-
-    // 乗算
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_DST_COLOR;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    if (vkCreatePipelineLayout(s_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout[Blend_Mult]) != VK_SUCCESS)
-    {
-        CubismLogError("failed to create _pipeline layout!");
-    }
-    pipelineInfo.layout = _pipelineLayout[Blend_Mult];
-    if (vkCreateGraphicsPipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline[Blend_Mult]) !=
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(s_device, s_pipelineManager->_pipelineCache, 1, &pipelineInfo, nullptr, &pipeline) !=
         VK_SUCCESS)
     {
         CubismLogError("failed to create graphics _pipeline!");
+        return VK_NULL_HANDLE;
     }
 
-    // マスク
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    if (vkCreatePipelineLayout(s_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout[Blend_Mask]) != VK_SUCCESS)
-    {
-        CubismLogError("failed to create _pipeline layout!");
-    }
-    renderingInfo.pColorAttachmentFormats = &s_imageFormat;
-    pipelineInfo.layout = _pipelineLayout[Blend_Mask];
-    if (vkCreateGraphicsPipelines(s_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline[Blend_Mask]) !=
-        VK_SUCCESS)
-    {
-        CubismLogError("failed to create graphics _pipeline!");
-    }
-
-    vkDestroyShaderModule(s_device, vertShaderModule, nullptr);
-    vkDestroyShaderModule(s_device, fragShaderModule, nullptr);
-
-    return true;
+    return pipeline;
 }
 
 void CubismPipeline_Vulkan::PipelineResource::Release()
 {
-    for (csmInt32 i = 0; i < 4; i++)
+    for (csmUint32 i = 0; i < _pipeline.GetSize(); i++)
     {
-        if(_pipeline.GetPtr() != NULL)
+        if(_pipeline[i] != VK_NULL_HANDLE)
         {
             vkDestroyPipeline(s_device, _pipeline[i], nullptr);
         }
-        if(_pipelineLayout.GetPtr() != NULL)
-        {
-            vkDestroyPipelineLayout(s_device, _pipelineLayout[i], nullptr);
-        }
     }
     _pipeline.Clear();
-    _pipelineLayout.Clear();
+
+    if (_vertShaderModule != VK_NULL_HANDLE)
+    {
+        vkDestroyShaderModule(s_device, _vertShaderModule, nullptr);
+        _vertShaderModule = VK_NULL_HANDLE;
+    }
+    if (_fragShaderModule != VK_NULL_HANDLE)
+    {
+        vkDestroyShaderModule(s_device, _fragShaderModule, nullptr);
+        _fragShaderModule = VK_NULL_HANDLE;
+    }
 }
 
 void CubismPipeline_Vulkan::CreatePipelines(VkDescriptorSetLayout descriptorSetLayout)
@@ -478,26 +605,43 @@ void CubismPipeline_Vulkan::CreatePipelines(VkDescriptorSetLayout descriptorSetL
         return;
     }
 
-    _pipelineResource.Resize(ShaderCount);
-    for (csmInt32 i = 0; i < 7; i++)
+    CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
+
+    // 初回作成時の描画対象のフォーマットで全パイプラインを作成する
+    _colorFormat = s_imageFormat;
+    _depthFormat = s_depthFormat;
+
+    // 描画ごとの色情報はプッシュ定数で渡す
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(ModelPushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(s_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS)
     {
-        _pipelineResource[i] = CSM_NEW PipelineResource();
+        CubismLogError("failed to create _pipeline layout!");
     }
 
-    std::string shaderFiles[7][2] = {
-        {"FrameworkShaders/VertShaderSrcSetupMask.spv", "FrameworkShaders/FragShaderSrcSetupMask.spv"},
-        {"FrameworkShaders/VertShaderSrc.spv", "FrameworkShaders/FragShaderSrc.spv"},
-        {"FrameworkShaders/VertShaderSrcMasked.spv", "FrameworkShaders/FragShaderSrcMask.spv"},
-        {"FrameworkShaders/VertShaderSrcMasked.spv", "FrameworkShaders/FragShaderSrcMaskInverted.spv"},
-        {"FrameworkShaders/VertShaderSrc.spv", "FrameworkShaders/FragShaderSrcPremultipliedAlpha.spv"},
-        {"FrameworkShaders/VertShaderSrcMasked.spv", "FrameworkShaders/FragShaderSrcMaskPremultipliedAlpha.spv"},
-        {"FrameworkShaders/VertShaderSrcMasked.spv", "FrameworkShaders/FragShaderSrcMaskInvertedPremultipliedAlpha.spv"},
-    };
+    if (_pipelineCache == VK_NULL_HANDLE)
+    {
+        _pipelineCache = CreatePipelineCache(NULL, 0);
+    }
 
-    for(int i = 0; i < 7; i++)
+    _pipelineResource.Resize(ShaderCount, NULL);
+    for (csmInt32 i = 0; i < ShaderProgramCount; i++)
     {
-        if(!_pipelineResource[i]->CreateGraphicsPipeline(shaderFiles[i][0],shaderFiles[i][1], descriptorSetLayout))
+        _pipelineResource[i] = CSM_NEW PipelineResource();
+        if(!_pipelineResource[i]->CreateShaderModules(i))
         {
+            _pipelineResource[i]->Release();
+            CSM_DELETE(_pipelineResource[i]);
             _pipelineResource[i] = NULL;
         }
     }
@@ -517,10 +661,105 @@ void CubismPipeline_Vulkan::CreatePipelines(VkDescriptorSetLayout descriptorSetL
     _pipelineResource[18] = _pipelineResource[6];
 }
 
+VkPipelineCache CubismPipeline_Vulkan::CreatePipelineCache(const csmByte* data, csmSizeInt size) const
+{
+    // 別のデバイスやドライバで作成したキャッシュは使わない
+    if (data != NULL)
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(s_physicalDevice, &properties);
+
+        VkPipelineCacheHeaderVersionOne header;
+        if (size < sizeof(header))
+        {
+            CubismLogWarning("The pipeline cache data is too small. It is ignored.");
+            data = NULL;
+        }
+        else
+        {
+            memcpy(&header, data, sizeof(header));
+            if (header.headerSize < sizeof(header) || header.headerSize > size ||
+                header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+                header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+                memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+            {
+                CubismLogWarning("The pipeline cache data was created on a different device or driver. It is ignored.");
+                data = NULL;
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = (data != NULL) ? size : 0;
+    cacheInfo.pInitialData = data;
+
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    if (vkCreatePipelineCache(s_device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+    {
+        CubismLogError("failed to create pipeline cache!");
+        return VK_NULL_HANDLE;
+    }
+    return pipelineCache;
+}
+
+void CubismPipeline_Vulkan::LoadPipelineCache(const csmByte* data, csmSizeInt size)
+{
+    if (s_device == VK_NULL_HANDLE)
+    {
+        CubismLogError("Device has not been set.");
+        return;
+    }
+
+    VkPipelineCache loadedCache = CreatePipelineCache(data, size);
+    if (loadedCache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (_pipelineCache == VK_NULL_HANDLE)
+    {
+        _pipelineCache = loadedCache;
+        return;
+    }
+
+    // 作成済みのキャッシュがある場合は統合する
+    vkMergePipelineCaches(s_device, _pipelineCache, 1, &loadedCache);
+    vkDestroyPipelineCache(s_device, loadedCache, nullptr);
+}
+
+csmSizeInt CubismPipeline_Vulkan::GetPipelineCacheSize() const
+{
+    if (_pipelineCache == VK_NULL_HANDLE)
+    {
+        return 0;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(s_device, _pipelineCache, &size, NULL) != VK_SUCCESS)
+    {
+        return 0;
+    }
+    return static_cast<csmSizeInt>(size);
+}
+
+csmBool CubismPipeline_Vulkan::SavePipelineCache(csmByte* buffer, csmSizeInt size) const
+{
+    if (_pipelineCache == VK_NULL_HANDLE || buffer == NULL)
+    {
+        return false;
+    }
+
+    size_t dataSize = size;
+    return vkGetPipelineCacheData(s_device, _pipelineCache, &dataSize, buffer) == VK_SUCCESS;
+}
+
 CubismPipeline_Vulkan* CubismPipeline_Vulkan::GetInstance()
 {
     if (s_pipelineManager == NULL)
     {
+        // パイプラインは全モデルで共有するので、最初に描画したモデルには計上しない
+        CubismMemoryScope memoryScope(NULL, CubismMemoryCategory_Other);
         s_pipelineManager = CSM_NEW CubismPipeline_Vulkan();
     }
     return s_pipelineManager;
@@ -528,7 +767,7 @@ CubismPipeline_Vulkan* CubismPipeline_Vulkan::GetInstance()
 
 void CubismPipeline_Vulkan::ReleaseShaderProgram()
 {
-    for (csmInt32 i = 0; i < 7; i++)
+    for (csmInt32 i = 0; i < ShaderProgramCount && i < static_cast<csmInt32>(_pipelineResource.GetSize()); i++)
     {
         if(_pipelineResource[i] != NULL)
         {
@@ -537,6 +776,18 @@ void CubismPipeline_Vulkan::ReleaseShaderProgram()
             _pipelineResource[i] = NULL;
         }
     }
+    _pipelineResource.Clear();
+
+    if (_pipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(s_device, _pipelineLayout, nullptr);
+        _pipelineLayout = VK_NULL_HANDLE;
+    }
+    if (_pipelineCache != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineCache(s_device, _pipelineCache, nullptr);
+        _pipelineCache = VK_NULL_HANDLE;
+    }
 }
 
 /*********************************************************************************************************************
@@ -560,12 +811,28 @@ CubismRenderer_Vulkan::CubismRenderer_Vulkan() :
                                                , _clippingContextBufferForDraw(NULL)
                                                , _descriptorPool(VK_NULL_HANDLE)
                                                , _descriptorSetLayout(VK_NULL_HANDLE)
+                                               , _descriptorTextureCount(0)
+                                               , _descriptorMaskBufferCount(0)
                                                , _clearColor()
                                                , _commandBufferCurrent(0)
+                                               , _uniformRingStride(0)
+                                               , _uniformRingCapacity(0)
+                                               , _uniformRingUsedCount(0)
+                                               , _singleTimeCommandBuffer(VK_NULL_HANDLE)
+                                               , _singleTimeFence(VK_NULL_HANDLE)
+                                               , _isSharedFrameUsed(false)
+                                               , _sharedFrameSerial(0)
 {}
 
 CubismRenderer_Vulkan::~CubismRenderer_Vulkan()
 {
+    // GPUが参照中のリソースを破棄しないよう、このレンダラを含むフレームの完了を待つ
+    WaitInFlightFrames();
+    if (_isSharedFrameUsed)
+    {
+        WaitSharedFrames();
+    }
+
     CSM_DELETE_SELF(CubismClippingManager_Vulkan, _clippingManager);
 
     // オフスクリーンを作成していたのなら開放
@@ -580,22 +847,29 @@ CubismRenderer_Vulkan::~CubismRenderer_Vulkan()
     _offscreenFrameBuffers.Clear();
     _depthImage.Destroy(s_device);
 
-    // セマフォ解放
+    // 同期オブジェクト解放
     for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
     {
         vkDestroySemaphore(s_device, _updateFinishedSemaphores[buffer], nullptr);
+        vkDestroyFence(s_device, _inFlightFences[buffer], nullptr);
     }
+    if (_singleTimeFence != VK_NULL_HANDLE)
+    {
+        vkDestroyFence(s_device, _singleTimeFence, nullptr);
+        vkFreeCommandBuffers(s_device, s_commandPool, 1, &_singleTimeCommandBuffer);
+    }
+
+    // コマンドバッファ解放
+    vkFreeCommandBuffers(s_device, s_commandPool, _updateCommandBuffers.GetSize(), _updateCommandBuffers.GetPtr());
+    vkFreeCommandBuffers(s_device, s_commandPool, _drawCommandBuffers.GetSize(), _drawCommandBuffers.GetPtr());
 
     // ディスクリプタ関連解放
     vkDestroyDescriptorPool(s_device, _descriptorPool, nullptr);
     vkDestroyDescriptorSetLayout(s_device, _descriptorSetLayout, nullptr);
 
-    for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
+    for (csmUint32 buffer = 0; buffer < _uniformRingBuffers.GetSize(); buffer++)
     {
-        for (csmInt32 i = 0; i < _descriptorSets[buffer].GetSize(); i++)
-        {
-            _descriptorSets[buffer][i].uniformBuffer.Destroy(s_device);
-        }
+        _uniformRingBuffers[buffer].Destroy(s_device);
     }
 
     // その他バッファ開放
@@ -612,6 +886,8 @@ CubismRenderer_Vulkan::~CubismRenderer_Vulkan()
 
 void CubismRenderer_Vulkan::DoStaticRelease()
 {
+    ReleaseSharedFrameResources();
+
     if (s_pipelineManager)
     {
         CSM_DELETE_SELF(CubismPipeline_Vulkan, s_pipelineManager);
@@ -621,53 +897,168 @@ void CubismRenderer_Vulkan::DoStaticRelease()
 
 VkCommandBuffer CubismRenderer_Vulkan::BeginSingleTimeCommands()
 {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = s_commandPool;
-    allocInfo.commandBufferCount = 1;
+    if (_singleTimeCommandBuffer == VK_NULL_HANDLE)
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = s_commandPool;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(s_device, &allocInfo, &_singleTimeCommandBuffer) != VK_SUCCESS)
+        {
+            CubismLogError("failed to allocate command buffers!");
+        }
+        _singleTimeFence = CreateSignaledFence();
+    }
 
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(s_device, &allocInfo, &commandBuffer);
+    // 前回の記録がGPUで実行中の場合は完了を待ってから再利用する
+    vkWaitForFences(s_device, 1, &_singleTimeFence, VK_TRUE, UINT64_MAX);
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    vkBeginCommandBuffer(_singleTimeCommandBuffer, &beginInfo);
 
-    return commandBuffer;
+    return _singleTimeCommandBuffer;
 }
 
-void CubismRenderer_Vulkan::SubmitCommand(VkCommandBuffer commandBuffer, VkSemaphore signalUpdateFinishedSemaphore, VkSemaphore waitUpdateFinishedSemaphore)
+void CubismRenderer_Vulkan::SubmitCommand(VkCommandBuffer commandBuffer, VkSemaphore signalUpdateFinishedSemaphore,
+                                          VkSemaphore waitUpdateFinishedSemaphore, VkFence fence)
 {
     vkEndCommandBuffer(commandBuffer);
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
-    if(waitUpdateFinishedSemaphore != VK_NULL_HANDLE)
+
+    // 更新用コマンドでコピーした頂点を読む段階で待つ
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    if (waitUpdateFinishedSemaphore != VK_NULL_HANDLE)
     {
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
         submitInfo.waitSemaphoreCount = 1;
         submitInfo.pWaitSemaphores = &waitUpdateFinishedSemaphore;
-        submitInfo.pWaitDstStageMask = waitStages;
-        vkQueueSubmit(s_queue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(s_queue);
+        submitInfo.pWaitDstStageMask = &waitStage;
     }
-    else if (signalUpdateFinishedSemaphore != VK_NULL_HANDLE)
+    if (signalUpdateFinishedSemaphore != VK_NULL_HANDLE)
     {
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = &signalUpdateFinishedSemaphore;
-        vkQueueSubmit(s_queue, 1, &submitInfo, VK_NULL_HANDLE);
     }
-    else
+
+    if (waitUpdateFinishedSemaphore == VK_NULL_HANDLE && signalUpdateFinishedSemaphore == VK_NULL_HANDLE &&
+        fence == VK_NULL_HANDLE && commandBuffer == _singleTimeCommandBuffer)
+    {
+        // 読み込み時の転送コマンド。呼び出し側がステージングバッファを破棄できるよう完了まで待つ
+        vkResetFences(s_device, 1, &_singleTimeFence);
+        vkQueueSubmit(s_queue, 1, &submitInfo, _singleTimeFence);
+        vkWaitForFences(s_device, 1, &_singleTimeFence, VK_TRUE, UINT64_MAX);
+        return;
+    }
+
+    vkQueueSubmit(s_queue, 1, &submitInfo, fence);
+}
+
+void CubismRenderer_Vulkan::BeginFrame()
+{
+    if (s_isRecordingSharedFrame)
+    {
+        CubismLogWarning("BeginFrame has already been called.");
+        return;
+    }
+
+    // スワップチェーンのイメージ数が変わった場合は作り直す
+    if (s_sharedFrameFences.GetSize() != s_bufferSetNum)
+    {
+        ReleaseSharedFrameResources();
+
+        s_sharedUpdateCommandBuffers.Resize(s_bufferSetNum);
+        s_sharedDrawCommandBuffers.Resize(s_bufferSetNum);
+        s_sharedUpdateFinishedSemaphores.Resize(s_bufferSetNum);
+        s_sharedFrameFences.Resize(s_bufferSetNum);
+        for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = s_commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(s_device, &allocInfo, &s_sharedUpdateCommandBuffers[buffer]) != VK_SUCCESS ||
+                vkAllocateCommandBuffers(s_device, &allocInfo, &s_sharedDrawCommandBuffers[buffer]) != VK_SUCCESS)
+            {
+                CubismLogError("failed to allocate command buffers!");
+            }
+
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &s_sharedUpdateFinishedSemaphores[buffer]);
+
+            s_sharedFrameFences[buffer] = CreateSignaledFence();
+        }
+        s_sharedFrameCurrent = 0;
+    }
+
+    // このスロットを前回使用したフレームのGPU処理完了を待つ
+    vkWaitForFences(s_device, 1, &s_sharedFrameFences[s_sharedFrameCurrent], VK_TRUE, UINT64_MAX);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(s_sharedUpdateCommandBuffers[s_sharedFrameCurrent], &beginInfo);
+    vkBeginCommandBuffer(s_sharedDrawCommandBuffers[s_sharedFrameCurrent], &beginInfo);
+
+    s_sharedFrameSerial++;
+    s_isSharedFrameRenderingStarted = false;
+    s_isRecordingSharedFrame = true;
+}
+
+void CubismRenderer_Vulkan::EndFrame()
+{
+    if (!s_isRecordingSharedFrame)
     {
-        vkQueueSubmit(s_queue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(s_queue);
-        vkFreeCommandBuffers(s_device, s_commandPool, 1, &commandBuffer);
+        CubismLogWarning("EndFrame was called without BeginFrame.");
+        return;
+    }
+    s_isRecordingSharedFrame = false;
+
+    VkCommandBuffer commandBuffers[2] = {
+        s_sharedUpdateCommandBuffers[s_sharedFrameCurrent],
+        s_sharedDrawCommandBuffers[s_sharedFrameCurrent]
+    };
+    vkEndCommandBuffer(commandBuffers[0]);
+    vkEndCommandBuffer(commandBuffers[1]);
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    VkSubmitInfo submitInfo[2]{};
+    submitInfo[0].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo[0].commandBufferCount = 1;
+    submitInfo[0].pCommandBuffers = &commandBuffers[0];
+    submitInfo[0].signalSemaphoreCount = 1;
+    submitInfo[0].pSignalSemaphores = &s_sharedUpdateFinishedSemaphores[s_sharedFrameCurrent];
+    submitInfo[1].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo[1].commandBufferCount = 1;
+    submitInfo[1].pCommandBuffers = &commandBuffers[1];
+    submitInfo[1].waitSemaphoreCount = 1;
+    submitInfo[1].pWaitSemaphores = &s_sharedUpdateFinishedSemaphores[s_sharedFrameCurrent];
+    submitInfo[1].pWaitDstStageMask = &waitStage;
+
+    vkResetFences(s_device, 1, &s_sharedFrameFences[s_sharedFrameCurrent]);
+    vkQueueSubmit(s_queue, 2, submitInfo, s_sharedFrameFences[s_sharedFrameCurrent]);
+
+    s_sharedFrameCurrent++;
+    if (s_bufferSetNum <= s_sharedFrameCurrent)
+    {
+        s_sharedFrameCurrent = 0;
     }
+}
 
+void CubismRenderer_Vulkan::WaitSharedFrames()
+{
+    if (s_sharedFrameFences.GetSize() == 0)
+    {
+        return;
+    }
+    vkWaitForFences(s_device, s_sharedFrameFences.GetSize(), s_sharedFrameFences.GetPtr(), VK_TRUE, UINT64_MAX);
 }
 
 void CubismRenderer_Vulkan::InitializeConstantSettings(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool, VkQueue queue,
@@ -760,6 +1151,10 @@ void CubismRenderer_Vulkan::CreateIndexBuffer()
     const csmInt32 drawableCount = GetModel()->GetDrawableCount();
     _indexBuffers.Resize(s_bufferSetNum);
 
+    // 全ての転送を1つのコマンドバッファに積み、完了待ちを1回にする
+    csmVector<CubismBufferVulkan> stagingBuffers;
+    VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
+
     for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
     {
         _indexBuffers[buffer].Resize(drawableCount);
@@ -783,32 +1178,46 @@ void CubismRenderer_Vulkan::CreateIndexBuffer()
                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-                VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-
                 VkBufferCopy copyRegion{};
                 copyRegion.size = bufferSize;
                 vkCmdCopyBuffer(commandBuffer, stagingBuffer.GetBuffer(), indexBuffer.GetBuffer(), 1, &copyRegion);
-                SubmitCommand(commandBuffer);
                 _indexBuffers[buffer][drawAssign] = indexBuffer;
-                stagingBuffer.Destroy(s_device);
+                stagingBuffers.PushBack(stagingBuffer);
             }
         }
     }
+
+    SubmitCommand(commandBuffer);
+    for (csmUint32 i = 0; i < stagingBuffers.GetSize(); i++)
+    {
+        stagingBuffers[i].Destroy(s_device);
+    }
 }
 
 void CubismRenderer_Vulkan::CreateDescriptorSets()
 {
     // ディスクリプタプールの作成
+    // ディスクリプタセットはテクスチャとマスクバッファ（マスク無しを含む）の組み合わせごとに用意する
     const csmInt32 drawableCount = GetModel()->GetDrawableCount();
+    _descriptorTextureCount = 0;
+    for (csmInt32 drawAssign = 0; drawAssign < drawableCount; drawAssign++)
+    {
+        const csmInt32 textureIndex = GetModel()->GetDrawableTextureIndex(drawAssign);
+        if (_descriptorTextureCount <= textureIndex)
+        {
+            _descriptorTextureCount = textureIndex + 1;
+        }
+    }
+    _descriptorMaskBufferCount = (_offscreenFrameBuffers.GetSize() > 0) ? _offscreenFrameBuffers[0].GetSize() : 0;
+
     csmInt32 textureCount = 2;
-    csmInt32 drawModeCount = 2; // マスクされる描画と通常の描画
-    csmInt32 descriptorSetCountPerBuffer = drawableCount * drawModeCount;
-    csmInt32 descriptorSetCount = s_bufferSetNum * descriptorSetCountPerBuffer;
+    csmInt32 descriptorSetCountPerBuffer = _descriptorTextureCount * (1 + _descriptorMaskBufferCount);
+    csmInt32 descriptorSetCount = s_bufferSetNum * (descriptorSetCountPerBuffer > 0 ? descriptorSetCountPerBuffer : 1);
     VkDescriptorPoolSize poolSizes[2]{};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     poolSizes[0].descriptorCount = descriptorSetCount;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = descriptorSetCount * textureCount; // drawableCount * 描画方法の数 * テクスチャの数
+    poolSizes[1].descriptorCount = descriptorSetCount * textureCount; // 組み合わせの数 * テクスチャの数
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -826,7 +1235,7 @@ void CubismRenderer_Vulkan::CreateDescriptorSets()
     VkDescriptorSetLayoutBinding bindings[3];
     bindings[0].binding = 0;
     bindings[0].descriptorCount = 1;
-    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     bindings[0].pImmutableSamplers = nullptr;
     bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
 
@@ -854,43 +1263,40 @@ void CubismRenderer_Vulkan::CreateDescriptorSets()
         CubismLogError("failed to create descriptor set layout!");
     }
 
-    // ディスクリプタセットの作成
-    _descriptorSets.Resize(s_bufferSetNum);
-    for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
+    // UBO用リングバッファの作成
+    // 1フレームの描画回数は 描画オブジェクト数 + 各描画オブジェクトが参照するマスクの数 を超えない
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(s_physicalDevice, &properties);
+    const VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+    _uniformRingStride = sizeof(ModelUBO);
+    if (alignment > 0)
     {
-        _descriptorSets[buffer].Resize(drawableCount);
-        for (csmInt32 drawAssign = 0; drawAssign < drawableCount; drawAssign++)
-        {
-            _descriptorSets[buffer][drawAssign].uniformBuffer.CreateBuffer(s_device, s_physicalDevice, sizeof(ModelUBO),
-                                                                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-            _descriptorSets[buffer][drawAssign].uniformBuffer.Map(s_device, VK_WHOLE_SIZE);
-        }
+        _uniformRingStride = (_uniformRingStride + alignment - 1) / alignment * alignment;
+    }
 
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = _descriptorPool;
-        allocInfo.descriptorSetCount = descriptorSetCountPerBuffer;
-        csmVector<VkDescriptorSetLayout> layouts;
-        for (csmInt32 i = 0; i < descriptorSetCountPerBuffer; i++)
-        {
-            layouts.PushBack(_descriptorSetLayout);
-        }
-        allocInfo.pSetLayouts = layouts.GetPtr();
+    _uniformRingCapacity = drawableCount;
+    const csmInt32* maskCounts = GetModel()->GetDrawableMaskCounts();
+    for (csmInt32 drawAssign = 0; drawAssign < drawableCount; drawAssign++)
+    {
+        _uniformRingCapacity += maskCounts[drawAssign];
+    }
+    const VkDeviceSize ringSize = _uniformRingStride * (_uniformRingCapacity > 0 ? _uniformRingCapacity : 1);
 
-        csmVector<VkDescriptorSet> descriptorSets;
-        descriptorSets.Resize(descriptorSetCountPerBuffer);
-        if (vkAllocateDescriptorSets(s_device, &allocInfo, descriptorSets.GetPtr()) != VK_SUCCESS)
-        {
-            CubismLogError("failed to allocate descriptor sets!");
-        }
+    _uniformRingBuffers.Resize(s_bufferSetNum);
+    for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
+    {
+        _uniformRingBuffers[buffer].CreateBuffer(s_device, s_physicalDevice, ringSize,
+                                                 VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        _uniformRingBuffers[buffer].Map(s_device, VK_WHOLE_SIZE);
+    }
 
-        for (csmInt32 drawAssign = 0; drawAssign < drawableCount; drawAssign++)
-        {
-            _descriptorSets[buffer][drawAssign].descriptorSet = descriptorSets[drawAssign * 2];
-            _descriptorSets[buffer][drawAssign].descriptorSetMasked = descriptorSets[drawAssign * 2 + 1];
-        }
+    // ディスクリプタセットは実際に使われる組み合わせのみ、初めて使う時に確保する
+    _descriptorSets.Resize(s_bufferSetNum);
+    for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
+    {
+        _descriptorSets[buffer].Resize(descriptorSetCountPerBuffer);
     }
 }
 
@@ -908,12 +1314,17 @@ void CubismRenderer_Vulkan::InitializeRenderer()
     vkCmdSetCullModeEXT = reinterpret_cast<PFN_vkCmdSetCullMode>(vkGetDeviceProcAddr(s_device, "vkCmdSetCullModeEXT"));
 
     _updateFinishedSemaphores.Resize(s_bufferSetNum);
+    _inFlightFences.Resize(s_bufferSetNum);
     for (csmUint32 buffer = 0; buffer < s_bufferSetNum; buffer++)
     {
         VkSemaphoreCreateInfo semaphoreInfo{};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
         vkCreateSemaphore(s_device, &semaphoreInfo, nullptr, &_updateFinishedSemaphores[buffer]);
+
+        // 最初のフレームで待たないようシグナル状態で作成する
+        _inFlightFences[buffer] = CreateSignaledFence();
     }
+    _isVertexBufferCopied.Resize(GetModel()->GetDrawableCount(), false);
 
     CreateCommandBuffer();
     CreateVertexBuffer();
@@ -986,7 +1397,15 @@ void CubismRenderer_Vulkan::Initialize(CubismModel* model, csmInt32 maskBufferCo
 void CubismRenderer_Vulkan::CopyToBuffer(csmInt32 drawAssign, const csmInt32 vcount, const csmFloat32* varray,
                                          const csmFloat32* uvarray, VkCommandBuffer commandBuffer)
 {
+    // 同じフレームでマスクと本体の両方に使われる場合、コピーは1回でよい
+    if (_isVertexBufferCopied[drawAssign])
+    {
+        return;
+    }
+    _isVertexBufferCopied[drawAssign] = true;
+
     csmVector<ModelVertex> vertices;
+    vertices.PrepareCapacity(vcount);
 
     for (csmInt32 ct = 0; ct < vcount * 2; ct += 2)
     {
@@ -1023,37 +1442,51 @@ void CubismRenderer_Vulkan::UpdateColor(csmFloat32 vkVec4[4], csmFloat32 r, csmF
     vkVec4[3] = a;
 }
 
-void CubismRenderer_Vulkan::UpdateDescriptorSet(Descriptor& descriptor, csmUint32 textureIndex, bool isMasked)
+VkDescriptorSet CubismRenderer_Vulkan::GetDescriptorSet(csmInt32 textureIndex, csmInt32 maskBufferIndex)
 {
-    VkBuffer uniformBuffer = descriptor.uniformBuffer.GetBuffer();
-    // descriptorが更新されていない最初の1回のみ行う
-    VkDescriptorSet descriptorSet;
-    if (isMasked && !descriptor.isDescriptorSetMaskedUpdated)
+    if (textureIndex >= _descriptorTextureCount || maskBufferIndex >= _descriptorMaskBufferCount)
     {
-        descriptorSet = descriptor.descriptorSetMasked;
-        descriptor.isDescriptorSetMaskedUpdated = true;
+        CubismLogError("The descriptor set for texture %d and mask buffer %d is not prepared.", textureIndex, maskBufferIndex);
+        return VK_NULL_HANDLE;
     }
-    else if (!descriptor.isDescriptorSetUpdated)
+
+    Descriptor& descriptor = _descriptorSets[_commandBufferCurrent][
+        textureIndex * (1 + _descriptorMaskBufferCount) + (maskBufferIndex + 1)];
+
+    // ディスクリプタセットが更新されていない最初の1回のみ行う
+    if (descriptor.isDescriptorSetUpdated)
     {
-        descriptorSet = descriptor.descriptorSet;
-        descriptor.isDescriptorSetUpdated = true;
+        return descriptor.descriptorSet;
     }
-    else
+
+    if (descriptor.descriptorSet == VK_NULL_HANDLE)
     {
-        return;
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = _descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &_descriptorSetLayout;
+        if (vkAllocateDescriptorSets(s_device, &allocInfo, &descriptor.descriptorSet) != VK_SUCCESS)
+        {
+            CubismLogError("failed to allocate descriptor sets!");
+            return VK_NULL_HANDLE;
+        }
     }
 
+    VkDescriptorSet descriptorSet = descriptor.descriptorSet;
+    descriptor.isDescriptorSetUpdated = true;
+
     csmVector<VkWriteDescriptorSet> descriptorWrites{};
 
     VkDescriptorBufferInfo uniformBufferInfo{};
-    uniformBufferInfo.buffer = uniformBuffer;
+    uniformBufferInfo.buffer = _uniformRingBuffers[_commandBufferCurrent].GetBuffer();
     uniformBufferInfo.offset = 0;
-    uniformBufferInfo.range = VK_WHOLE_SIZE;
+    uniformBufferInfo.range = sizeof(ModelUBO);
     VkWriteDescriptorSet ubo{};
     ubo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     ubo.dstSet = descriptorSet;
     ubo.dstBinding = 0;
-    ubo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    ubo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     ubo.descriptorCount = 1;
     ubo.pBufferInfo = &uniformBufferInfo;
     descriptorWrites.PushBack(ubo);
@@ -1072,14 +1505,12 @@ void CubismRenderer_Vulkan::UpdateDescriptorSet(Descriptor& descriptor, csmUint3
     image1.pImageInfo = &imageInfo1;
     descriptorWrites.PushBack(image1);
 
-    if (isMasked)
+    VkDescriptorImageInfo imageInfo2{};
+    if (maskBufferIndex >= 0)
     {
-        VkDescriptorImageInfo imageInfo2{};
         imageInfo2.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo2.imageView = _offscreenFrameBuffers[_commandBufferCurrent][GetClippingContextBufferForDraw()->
-            _bufferIndex].GetTextureView();
-        imageInfo2.sampler = _offscreenFrameBuffers[_commandBufferCurrent][GetClippingContextBufferForDraw()->
-            _bufferIndex].GetTextureSampler();
+        imageInfo2.imageView = _offscreenFrameBuffers[_commandBufferCurrent][maskBufferIndex].GetTextureView();
+        imageInfo2.sampler = _offscreenFrameBuffers[_commandBufferCurrent][maskBufferIndex].GetTextureSampler();
         VkWriteDescriptorSet image2{};
         image2.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         image2.dstSet = descriptorSet;
@@ -1091,6 +1522,8 @@ void CubismRenderer_Vulkan::UpdateDescriptorSet(Descriptor& descriptor, csmUint3
     }
 
     vkUpdateDescriptorSets(s_device, descriptorWrites.GetSize(), descriptorWrites.GetPtr(), 0, NULL);
+
+    return descriptorSet;
 }
 
 void CubismRenderer_Vulkan::ExecuteDrawForDraw(const CubismModel& model, const csmInt32 index, VkCommandBuffer& cmdBuffer)
@@ -1132,16 +1565,15 @@ void CubismRenderer_Vulkan::ExecuteDrawForDraw(const CubismModel& model, const c
         return;
     }
 
-
-    Descriptor &descriptor = _descriptorSets[_commandBufferCurrent][index];
     ModelUBO ubo;
+    ModelPushConstants pushConstants{};
     if (masked)
     {
         // クリッピング用行列の設定
         UpdateMatrix(ubo.clipMatrix, GetClippingContextBufferForDraw()->_matrixForDraw); // テクスチャ座標の変換に使用するのでy軸の向きは反転しない
 
         // カラーチャンネルの設定
-        SetColorChannel(ubo, GetClippingContextBufferForDraw());
+        SetColorChannel(pushConstants, GetClippingContextBufferForDraw());
     }
 
     // MVP行列の設定
@@ -1151,10 +1583,14 @@ void CubismRenderer_Vulkan::ExecuteDrawForDraw(const CubismModel& model, const c
     CubismTextureColor baseColor = GetModelColorWithOpacity(model.GetDrawableOpacity(index));
     CubismTextureColor multiplyColor = model.GetMultiplyColor(index);
     CubismTextureColor screenColor = model.GetScreenColor(index);
-    SetColorUniformBuffer(ubo, baseColor, multiplyColor, screenColor);
+    SetColorPushConstants(pushConstants, baseColor, multiplyColor, screenColor);
 
-    // ディスクリプタにユニフォームバッファをコピー
-    descriptor.uniformBuffer.MemCpy(&ubo, sizeof(ModelUBO));
+    // リングバッファにユニフォームバッファをコピー
+    csmUint32 dynamicOffset = 0;
+    if (!WriteUniformBuffer(ubo, dynamicOffset))
+    {
+        return;
+    }
 
     // 頂点バッファの設定
     BindVertexAndIndexBuffers(index, cmdBuffer);
@@ -1163,12 +1599,19 @@ void CubismRenderer_Vulkan::ExecuteDrawForDraw(const CubismModel& model, const c
     csmInt32 textureIndex = model.GetDrawableTextureIndex(index);
 
     // ディスクリプタセットのバインド
-    UpdateDescriptorSet(descriptor, textureIndex, masked);
-    VkDescriptorSet* descriptorSet = (masked ? &_descriptorSets[_commandBufferCurrent][index].descriptorSetMasked
-                                             : &_descriptorSets[_commandBufferCurrent][index].descriptorSet);
+    VkDescriptorSet descriptorSet = GetDescriptorSet(textureIndex,
+                                                     masked ? GetClippingContextBufferForDraw()->_bufferIndex : -1);
+    if (descriptorSet == VK_NULL_HANDLE)
+    {
+        return;
+    }
     vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                 pipelineLayout, 0, 1,
-                                descriptorSet, 0, nullptr);
+                                &descriptorSet, 1, &dynamicOffset);
+
+    // 色はプッシュ定数で渡す
+    vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(ModelPushConstants), &pushConstants);
 
     // パイプラインのバインド
     vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -1195,24 +1638,28 @@ void CubismRenderer_Vulkan::ExecuteDrawForMask(const CubismModel& model, const c
         return;
     }
 
-    Descriptor &descriptor = _descriptorSets[_commandBufferCurrent][index];
     ModelUBO ubo;
+    ModelPushConstants pushConstants{};
 
     // クリッピング用行列の設定
     UpdateMatrix(ubo.clipMatrix, GetClippingContextBufferForMask()->_matrixForMask);
 
     // カラーチャンネルの設定
-    SetColorChannel(ubo, GetClippingContextBufferForMask());
+    SetColorChannel(pushConstants, GetClippingContextBufferForMask());
 
     // 色定数バッファの設定
     csmRectF *rect = GetClippingContextBufferForMask()->_layoutBounds;
     CubismTextureColor baseColor = {rect->X * 2.0f - 1.0f, rect->Y * 2.0f - 1.0f, rect->GetRight() * 2.0f - 1.0f, rect->GetBottom() * 2.0f - 1.0f};
     CubismTextureColor multiplyColor = model.GetMultiplyColor(index);
     CubismTextureColor screenColor = model.GetScreenColor(index);
-    SetColorUniformBuffer(ubo, baseColor, multiplyColor, screenColor);
+    SetColorPushConstants(pushConstants, baseColor, multiplyColor, screenColor);
 
-    // ディスクリプタにユニフォームバッファをコピー
-    descriptor.uniformBuffer.MemCpy(&ubo, sizeof(ModelUBO));
+    // リングバッファにユニフォームバッファをコピー
+    csmUint32 dynamicOffset = 0;
+    if (!WriteUniformBuffer(ubo, dynamicOffset))
+    {
+        return;
+    }
 
     // 頂点バッファの設定
     BindVertexAndIndexBuffers(index, cmdBuffer);
@@ -1221,10 +1668,18 @@ void CubismRenderer_Vulkan::ExecuteDrawForMask(const CubismModel& model, const c
     csmInt32 textureIndex = model.GetDrawableTextureIndex(index);
 
     // ディスクリプタセットのバインド
-    UpdateDescriptorSet(descriptor, textureIndex, false);
+    VkDescriptorSet descriptorSet = GetDescriptorSet(textureIndex, -1);
+    if (descriptorSet == VK_NULL_HANDLE)
+    {
+        return;
+    }
     vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipelineLayout, 0, 1,
-                            &_descriptorSets[_commandBufferCurrent][index].descriptorSet, 0, nullptr);
+                            &descriptorSet, 1, &dynamicOffset);
+
+    // 色はプッシュ定数で渡す
+    vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(ModelPushConstants), &pushConstants);
 
     // パイプラインのバインド
     vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -1273,7 +1728,7 @@ void CubismRenderer_Vulkan::DrawMeshVulkan(const CubismModel& model, const csmIn
     CopyToBuffer(index, model.GetDrawableVertexCount(index),
                  const_cast<csmFloat32*>(model.GetDrawableVertices(index)),
                  reinterpret_cast<csmFloat32*>(const_cast<Core::csmVector2*>(model.GetDrawableVertexUvs(index))),
-                 _updateCommandBuffers[_commandBufferCurrent]);
+                 updateCommandBuffer);
 
     if (GetClippingContextBufferForMask() != NULL) // マスク生成時
     {
@@ -1296,14 +1751,25 @@ void CubismRenderer_Vulkan::BeginRendering(VkCommandBuffer drawCommandBuffer, bo
 
     VkImageMemoryBarrier memoryBarrier{};
     memoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    memoryBarrier.srcAccessMask = VK_ACCESS_NONE;
+    memoryBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
     memoryBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    memoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // 再開時はサブミットを挟まず同じコマンドバッファで続けるため、EndRenderingで遷移させたレイアウトから戻す
+    memoryBarrier.oldLayout = (isResume ? (s_useRenderTarget ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL)
+                                        : VK_IMAGE_LAYOUT_UNDEFINED);
     memoryBarrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     memoryBarrier.image = s_renderImage;
     memoryBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
-    vkCmdPipelineBarrier(drawCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
+
+    // 深度バッファは全スロットで共有しているため、実行中の前フレームの書き込みとの順序を保証する
+    VkMemoryBarrier depthBarrier{};
+    depthBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    vkCmdPipelineBarrier(drawCommandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+        0, 1, &depthBarrier, 0, nullptr, 1, &memoryBarrier);
 
     VkRenderingAttachmentInfoKHR colorAttachment{};
     colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
@@ -1353,15 +1819,58 @@ void CubismRenderer_Vulkan::EndRendering(VkCommandBuffer drawCommandBuffer)
 
 void CubismRenderer_Vulkan::DoDrawModel()
 {
-    VkCommandBuffer updateCommandBuffer = _updateCommandBuffers[_commandBufferCurrent];
-    VkCommandBuffer drawCommandBuffer = _drawCommandBuffers[_commandBufferCurrent];
+    VkCommandBuffer updateCommandBuffer;
+    VkCommandBuffer drawCommandBuffer;
 
-    //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    vkBeginCommandBuffer(updateCommandBuffer, &beginInfo);
-    vkBeginCommandBuffer(drawCommandBuffer, &beginInfo);
+    if (s_isRecordingSharedFrame)
+    {
+        // 共有フレームに記録する。スロットの再利用待ちはBeginFrameで済んでいる
+        // 同じフレームで2回記録するとリングバッファを上書きしてしまうため受け付けない
+        if (_isSharedFrameUsed && _sharedFrameSerial == s_sharedFrameSerial)
+        {
+            CubismLogWarning("The model has already been recorded in this frame.");
+            return;
+        }
+        _sharedFrameSerial = s_sharedFrameSerial;
+        if (!_isSharedFrameUsed)
+        {
+            WaitInFlightFrames();
+            _isSharedFrameUsed = true;
+        }
+        _commandBufferCurrent = s_sharedFrameCurrent;
+        updateCommandBuffer = s_sharedUpdateCommandBuffers[_commandBufferCurrent];
+        drawCommandBuffer = s_sharedDrawCommandBuffers[_commandBufferCurrent];
+    }
+    else
+    {
+        if (_isSharedFrameUsed)
+        {
+            WaitSharedFrames();
+            _isSharedFrameUsed = false;
+        }
+
+        // このスロットを前回使用したフレームのGPU処理完了を待つ
+        // 待つのはスワップチェーンのイメージ数だけ前のフレームなので、通常は待たずに通過する
+        vkWaitForFences(s_device, 1, &_inFlightFences[_commandBufferCurrent], VK_TRUE, UINT64_MAX);
+
+        updateCommandBuffer = _updateCommandBuffers[_commandBufferCurrent];
+        drawCommandBuffer = _drawCommandBuffers[_commandBufferCurrent];
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(updateCommandBuffer, &beginInfo);
+        vkBeginCommandBuffer(drawCommandBuffer, &beginInfo);
+    }
 
+    // スロットのリングバッファと頂点コピーの記録状態を初期化
+    _uniformRingUsedCount = 0;
+    for (csmUint32 i = 0; i < _isVertexBufferCopied.GetSize(); i++)
+    {
+        _isVertexBufferCopied[i] = false;
+    }
+
+    //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
     if (_clippingManager != NULL)
     {
         // サイズが違う場合はここで作成しなおし
@@ -1381,6 +1890,13 @@ void CubismRenderer_Vulkan::DoDrawModel()
                     static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y),
                     s_imageFormat, s_depthFormat
                 );
+
+                // 作り直したマスクバッファを参照するディスクリプタセットは次に使う時に設定し直す
+                for (csmInt32 textureIndex = 0; textureIndex < _descriptorTextureCount; textureIndex++)
+                {
+                    _descriptorSets[_commandBufferCurrent][textureIndex * (1 + _descriptorMaskBufferCount) + (i + 1)]
+                        .isDescriptorSetUpdated = false;
+                }
             }
         }
         if (IsUsingHighPrecisionMask())
@@ -1392,12 +1908,13 @@ void CubismRenderer_Vulkan::DoDrawModel()
             _clippingManager->SetupClippingContext(*GetModel(), drawCommandBuffer, updateCommandBuffer, this, _commandBufferCurrent);
         }
     }
-    SubmitCommand(updateCommandBuffer, _updateFinishedSemaphores[_commandBufferCurrent]);
-    SubmitCommand(drawCommandBuffer, VK_NULL_HANDLE, _updateFinishedSemaphores[_commandBufferCurrent]);
 
     // スワップチェーンを再作成した際に深度バッファのサイズを更新する
     if (_depthImage.GetWidth() != s_renderExtent.width || _depthImage.GetHeight() != s_renderExtent.height)
     {
+        // 深度バッファは全スロットで共有しているため、実行中のフレームが終わるのを待ってから作り直す
+        WaitInFlightFrames();
+        WaitSharedFrames();
         _depthImage.Destroy(s_device);
         CreateDepthBuffer();
     }
@@ -1412,9 +1929,14 @@ void CubismRenderer_Vulkan::DoDrawModel()
     }
 
     //描画
-    vkBeginCommandBuffer(updateCommandBuffer, &beginInfo);
-    vkBeginCommandBuffer(drawCommandBuffer, &beginInfo);
-    BeginRendering(drawCommandBuffer, false);
+    // 共有フレームでクリアするのは最初のモデルだけで、以降のモデルは先に記録したモデルの描画結果に続けて描く
+    bool isResume = false;
+    if (s_isRecordingSharedFrame)
+    {
+        isResume = s_isSharedFrameRenderingStarted;
+        s_isSharedFrameRenderingStarted = true;
+    }
+    BeginRendering(drawCommandBuffer, isResume);
 
     for (csmInt32 i = 0; i < drawableCount; ++i)
     {
@@ -1436,14 +1958,9 @@ void CubismRenderer_Vulkan::DoDrawModel()
             if (clipContext->_isUsing) // 書くことになっていた
             {
                 // 一旦オフスクリーン描画に移る
+                // UBOは描画ごとに別領域へ書き込むため、ここでサブミットを挟む必要はない
                 EndRendering(drawCommandBuffer);
 
-                // 描画順を考慮して今までに積んだコマンドを実行する
-                SubmitCommand(updateCommandBuffer, _updateFinishedSemaphores[_commandBufferCurrent]);
-                SubmitCommand(drawCommandBuffer, VK_NULL_HANDLE, _updateFinishedSemaphores[_commandBufferCurrent]);
-                vkBeginCommandBuffer(updateCommandBuffer, &beginInfo);
-                vkBeginCommandBuffer(drawCommandBuffer, &beginInfo);
-
                 CubismOffscreenSurface_Vulkan* currentHighPrecisionMaskColorBuffer = &_offscreenFrameBuffers[_commandBufferCurrent][clipContext->_bufferIndex];
                 currentHighPrecisionMaskColorBuffer->BeginDraw(drawCommandBuffer, 1.0f, 1.0f, 1.0f, 1.0f);
 
@@ -1481,10 +1998,6 @@ void CubismRenderer_Vulkan::DoDrawModel()
                 // --- 後処理 ---
                 currentHighPrecisionMaskColorBuffer->EndDraw(drawCommandBuffer); // オフスクリーン描画終了
                 SetClippingContextBufferForMask(NULL);
-                SubmitCommand(updateCommandBuffer, _updateFinishedSemaphores[_commandBufferCurrent]);
-                SubmitCommand(drawCommandBuffer, VK_NULL_HANDLE, _updateFinishedSemaphores[_commandBufferCurrent]);
-                vkBeginCommandBuffer(updateCommandBuffer, &beginInfo);
-                vkBeginCommandBuffer(drawCommandBuffer, &beginInfo);
 
                 // 描画再開
                 BeginRendering(drawCommandBuffer, true);
@@ -1513,8 +2026,18 @@ void CubismRenderer_Vulkan::DoDrawModel()
     }
 
     EndRendering(drawCommandBuffer);
+
+    // 共有フレームの場合はEndFrameでまとめてサブミットする
+    if (s_isRecordingSharedFrame)
+    {
+        return;
+    }
+
+    // 更新用コマンドの完了をセマフォで描画用コマンドに伝え、フレームの完了はフェンスで管理する
+    vkResetFences(s_device, 1, &_inFlightFences[_commandBufferCurrent]);
     SubmitCommand(updateCommandBuffer, _updateFinishedSemaphores[_commandBufferCurrent]);
-    SubmitCommand(drawCommandBuffer, VK_NULL_HANDLE, _updateFinishedSemaphores[_commandBufferCurrent]);
+    SubmitCommand(drawCommandBuffer, VK_NULL_HANDLE, _updateFinishedSemaphores[_commandBufferCurrent],
+                  _inFlightFences[_commandBufferCurrent]);
 
     PostDraw();
 }
@@ -1528,6 +2051,15 @@ void CubismRenderer_Vulkan::PostDraw()
     }
 }
 
+void CubismRenderer_Vulkan::WaitInFlightFrames()
+{
+    if (_inFlightFences.GetSize() == 0)
+    {
+        return;
+    }
+    vkWaitForFences(s_device, _inFlightFences.GetSize(), _inFlightFences.GetPtr(), VK_TRUE, UINT64_MAX);
+}
+
 void CubismRenderer_Vulkan::SetClippingContextBufferForMask(CubismClippingContext_Vulkan* clip)
 {
     _clippingContextBufferForMask = clip;
@@ -1581,12 +2113,12 @@ CubismOffscreenSurface_Vulkan* CubismRenderer_Vulkan::GetMaskBuffer(csmUint32 ba
     return &_offscreenFrameBuffers[backbufferNum][offscreenIndex];
 }
 
-void CubismRenderer_Vulkan::SetColorUniformBuffer(ModelUBO& ubo, const CubismTextureColor& baseColor,
+void CubismRenderer_Vulkan::SetColorPushConstants(ModelPushConstants& pushConstants, const CubismTextureColor& baseColor,
                                                   const CubismTextureColor& multiplyColor, const CubismTextureColor& screenColor)
 {
-    UpdateColor(ubo.baseColor, baseColor.R, baseColor.G, baseColor.B, baseColor.A);
-    UpdateColor(ubo.multiplyColor, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
-    UpdateColor(ubo.screenColor, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
+    UpdateColor(pushConstants.baseColor, baseColor.R, baseColor.G, baseColor.B, baseColor.A);
+    UpdateColor(pushConstants.multiplyColor, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
+    UpdateColor(pushConstants.screenColor, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
 }
 
 void CubismRenderer_Vulkan::BindVertexAndIndexBuffers(const csmInt32 index, VkCommandBuffer& cmdBuffer)
@@ -1597,11 +2129,27 @@ void CubismRenderer_Vulkan::BindVertexAndIndexBuffers(const csmInt32 index, VkCo
     vkCmdBindIndexBuffer(cmdBuffer, _indexBuffers[_commandBufferCurrent][index].GetBuffer(), 0, VK_INDEX_TYPE_UINT16);
 }
 
-void CubismRenderer_Vulkan::SetColorChannel(ModelUBO& ubo, CubismClippingContext_Vulkan* contextBuffer)
+void CubismRenderer_Vulkan::SetColorChannel(ModelPushConstants& pushConstants, CubismClippingContext_Vulkan* contextBuffer)
 {
     const csmInt32 channelIndex = contextBuffer->_layoutChannelIndex;
     CubismTextureColor *colorChannel = contextBuffer->GetClippingManager()->GetChannelFlagAsColor(channelIndex);
-    UpdateColor(ubo.channelFlag, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
+    UpdateColor(pushConstants.channelFlag, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
+}
+
+csmBool CubismRenderer_Vulkan::WriteUniformBuffer(const ModelUBO& ubo, csmUint32& dynamicOffset)
+{
+    if (_uniformRingUsedCount >= _uniformRingCapacity)
+    {
+        CubismLogError("Uniform ring buffer overflow. The drawable is skipped.");
+        return false;
+    }
+
+    const VkDeviceSize offset = _uniformRingStride * _uniformRingUsedCount;
+    _uniformRingBuffers[_commandBufferCurrent].MemCpy(&ubo, offset, sizeof(ModelUBO));
+    _uniformRingUsedCount++;
+
+    dynamicOffset = static_cast<csmUint32>(offset);
+    return true;
 }
 
 }}}}
@@ -170,9 +170,23 @@ struct ModelVertex
     }
 };
 
+/**
+ * @brief   描画ごとに変わる色情報をプッシュ定数でシェーダーに渡すための構造体
+ *
+ */
+struct ModelPushConstants
+{
+    csmFloat32 baseColor[4]; ///< シェーダープログラムに渡すデータ(BaseColor)
+    csmFloat32 multiplyColor[4]; ///< シェーダープログラムに渡すデータ(MultiplyColor)
+    csmFloat32 screenColor[4]; ///< シェーダープログラムに渡すデータ(ScreenColor)
+    csmFloat32 channelFlag[4]; ///< シェーダープログラムに渡すデータ(ChannelFlag)
+};
+
 /**
  * @brief  シェーダー関連のプログラムを生成・破棄するクラス<br>
- *         シングルトンなクラスであり、CubismShader_Vulkan::GetInstance()からアクセスする。
+ *         シングルトンなクラスであり、CubismShader_Vulkan::GetInstance()からアクセスする。<br>
+ *         パイプラインは各シェーダーとブレンド方法の組み合わせが初めて使われた時に作成し、
+ *         VkPipelineCacheを通して作成結果を保存・復元できる。
  */
 class CubismPipeline_Vulkan
 {
@@ -189,6 +203,11 @@ public:
 
     struct PipelineResource
     {
+        /**
+         * @brief   コンストラクタ
+         */
+        PipelineResource();
+
         /**
          * @brief   シェーダーモジュールを作成する
          *
@@ -197,29 +216,58 @@ public:
          */
         VkShaderModule CreateShaderModule(VkDevice device, std::string filename);
 
+        /**
+         * @brief   メモリ上のSPIR-Vからシェーダーモジュールを作成する
+         *
+         * @param[in]   device        ->  論理デバイス
+         * @param[in]   code          ->  SPIR-Vのコード
+         * @param[in]   codeSize      ->  コードのバイト数
+         */
+        VkShaderModule CreateShaderModule(VkDevice device, const csmUint32* code, csmSizeInt codeSize);
+
+        /**
+         * @brief   シェーダーモジュールを用意する<br>
+         *          SPIR-Vが埋め込まれている場合はそれを使い、そうでない場合はファイルから読み込む。
+         *
+         * @param[in]   programIndex  ->  シェーダープログラムのインデックス
+         *
+         * @return  作成に成功した場合はtrue
+         */
+        bool CreateShaderModules(csmInt32 programIndex);
+
         /**
          * @brief   パイプラインを作成する
          *
-         * @param[in]   vertFileName        ->  Vertexシェーダーのファイル
-         * @param[in]   fragFileName        ->  Fragmentシェーダーのファイル
-         * @param[in]   descriptorSetLayout ->  ディスクリプタセットレイアウト
+         * @param[in]   blendIndex    ->  ブレンドモードのインデックス
+         *
+         * @return  作成したパイプライン
          */
-        bool CreateGraphicsPipeline(std::string vertFileName, std::string fragFileName,
-                                    VkDescriptorSetLayout descriptorSetLayout);
+        VkPipeline CreateGraphicsPipeline(csmInt32 blendIndex);
         void Release();
+
+        /**
+         * @brief   パイプラインを取得する。未作成の場合はここで作成する。
+         *
+         * @param[in]   index         ->  ブレンドモードのインデックス
+         */
         VkPipeline GetPipeline(csmInt32 index)
         {
-             return _pipeline[index];
+            if (_pipeline[index] == VK_NULL_HANDLE)
+            {
+                _pipeline[index] = CreateGraphicsPipeline(index);
+            }
+            return _pipeline[index];
         }
-        VkPipelineLayout GetPipelineLayout(csmInt32 index) { return _pipelineLayout[index]; }
 
     private:
+        VkShaderModule _vertShaderModule; ///< Vertexシェーダーモジュール
+        VkShaderModule _fragShaderModule; ///< Fragmentシェーダーモジュール
         csmVector<VkPipeline> _pipeline; ///< normal, add, multi, maskそれぞれのパイプライン
-        csmVector<VkPipelineLayout> _pipelineLayout; ///< normal, add, multi, maskそれぞれのパイプラインレイアウト
     };
 
     /**
-     * @brief   シェーダーごとにPipelineResourceのインスタンスを作成する
+     * @brief   シェーダーごとにPipelineResourceのインスタンスを作成する<br>
+     *          パイプライン自体は初めて使われた時に作成する。
      *
      * @param[in]   descriptorSetLayout ->  ディスクリプタセットレイアウト
      */
@@ -243,7 +291,8 @@ public:
     }
 
     /**
-     * @brief   指定したブレンド方法のパイプラインレイアウトを取得する
+     * @brief   指定したブレンド方法のパイプラインレイアウトを取得する<br>
+     *          パイプラインレイアウトは全てのパイプラインで共通。
      *
      * @param[in]   shaderIndex         ->  シェーダインデックス
      * @param[in]   blendIndex          ->  ブレンドモードのインデックス
@@ -256,9 +305,36 @@ public:
         {
             return NULL;
         }
-        return _pipelineResource[shaderIndex]->GetPipelineLayout(blendIndex);
+        return _pipelineLayout;
     }
 
+    /**
+     * @brief   保存しておいたパイプラインキャッシュを読み込む<br>
+     *          InitializeConstantSettingsの後、モデルを読み込む前に呼ぶと初回のパイプライン作成が速くなる。<br>
+     *          別のデバイスやドライバで保存したデータは無視される。
+     *
+     * @param[in]   data    ->  SavePipelineCacheで保存したデータ
+     * @param[in]   size    ->  データのバイト数
+     */
+    void LoadPipelineCache(const csmByte* data, csmSizeInt size);
+
+    /**
+     * @brief   パイプラインキャッシュの保存に必要なバイト数を取得する
+     *
+     * @return  バイト数
+     */
+    csmSizeInt GetPipelineCacheSize() const;
+
+    /**
+     * @brief   パイプラインキャッシュを保存する
+     *
+     * @param[out]  buffer  ->  保存先
+     * @param[in]   size    ->  保存先のバイト数。GetPipelineCacheSize()以上であること
+     *
+     * @return  保存に成功した場合はtrue
+     */
+    csmBool SavePipelineCache(csmByte* buffer, csmSizeInt size) const;
+
     /**
      * @brief   インスタンスを取得する（シングルトン）
      *
@@ -272,7 +348,21 @@ public:
     void ReleaseShaderProgram();
 
 private:
+    /**
+     * @brief   パイプラインキャッシュを作成する
+     *
+     * @param[in]   data    ->  初期データ。無い場合はNULL
+     * @param[in]   size    ->  初期データのバイト数
+     *
+     * @return  作成したパイプラインキャッシュ
+     */
+    VkPipelineCache CreatePipelineCache(const csmByte* data, csmSizeInt size) const;
+
     csmVector<PipelineResource*> _pipelineResource;
+    VkPipelineLayout _pipelineLayout; ///< 全パイプライン共通のパイプラインレイアウト
+    VkPipelineCache _pipelineCache; ///< パイプラインキャッシュ
+    VkFormat _colorFormat; ///< パイプライン作成時の描画対象のフォーマット
+    VkFormat _depthFormat; ///< パイプライン作成時の深度フォーマット
 };
 
 /**
@@ -291,26 +381,19 @@ class CubismRenderer_Vulkan : public CubismRenderer
     {
         csmFloat32 projectionMatrix[16]; ///< シェーダープログラムに渡すデータ(ProjectionMatrix)
         csmFloat32 clipMatrix[16]; ///< シェーダープログラムに渡すデータ(ClipMatrix)
-        csmFloat32 baseColor[4]; ///< シェーダープログラムに渡すデータ(BaseColor)
-        csmFloat32 multiplyColor[4]; ///< シェーダープログラムに渡すデータ(MultiplyColor)
-        csmFloat32 screenColor[4]; ///< シェーダープログラムに渡すデータ(ScreenColor)
-        csmFloat32 channelFlag[4]; ///< シェーダープログラムに渡すデータ(ChannelFlag)
     };
 
     /**
-     * @brief   ディスクリプタセットとUBOを保持する構造体
-     *          コマンドバッファでまとめて描画する場合、ディスクリプタセットをバインド後に
-     *          更新してはならない。<br>
-     *          マスクされる描画対象のみ、フレームバッファをディスクリプタセットに設定する必要があるが、
-     *          その際バインド済みのディスクリプタセットを更新しないよう、別でマスクされる用のディスクリプタセットを用意する。
+     * @brief   ディスクリプタセットを保持する構造体<br>
+     *          ディスクリプタセットは描画オブジェクトごとではなく、テクスチャとマスクバッファの組み合わせごとに用意して使い回す。<br>
+     *          コマンドバッファでまとめて描画する場合、ディスクリプタセットをバインド後に更新してはならないため、
+     *          内容は最初に使う時に1度だけ設定する。<br>
+     *          UBOはフレームごとのリングバッファに置き、バインド時の動的オフセットで描画ごとの領域を指定する。
      */
     struct Descriptor
     {
-        CubismBufferVulkan uniformBuffer; ///< ユニフォームバッファ
         VkDescriptorSet descriptorSet = VK_NULL_HANDLE; ///< ディスクリプタセット
         bool isDescriptorSetUpdated = false; ///< ディスクリプタセットが更新されたか
-        VkDescriptorSet descriptorSetMasked = VK_NULL_HANDLE; ///< マスクされる描画対象用のディスクリプタセット
-        bool isDescriptorSetMaskedUpdated = false; ///< マスクされる描画対象用のディスクリプタセットが更新されたか
     };
 
 protected:
@@ -332,20 +415,41 @@ protected:
 public:
 
     /**
-     * @brief   コマンドの記録を開始する。
+     * @brief   コマンドの記録を開始する。<br>
+     *          コマンドバッファは毎回確保せず、レンダラが保持する1つを使い回す。
      *
      * @return  記録を開始したコマンドバッファ
      */
     VkCommandBuffer BeginSingleTimeCommands();
 
     /**
-     * @brief   コマンドを実行する。
+     * @brief   コマンドを実行する。<br>
+     *          セマフォを指定しない場合はBeginSingleTimeCommandsで記録したコマンドとみなし、完了までフェンスで待つ。<br>
+     *          セマフォを指定した場合は待機せずに戻る。
      *
      * @param[in]   commandBuffer                   -> コマンドバッファ
      * @param[in]   signalUpdateFinishedSemaphore   -> コマンド終了時にシグナルを出すセマフォ
      * @param[in]   waitUpdateFinishedSemaphore     -> コマンド実行前に待つセマフォ
+     * @param[in]   fence                           -> コマンド終了時にシグナルを出すフェンス
+     */
+    void SubmitCommand(VkCommandBuffer commandBuffer, VkSemaphore signalUpdateFinishedSemaphore = VK_NULL_HANDLE,
+                       VkSemaphore waitUpdateFinishedSemaphore = VK_NULL_HANDLE, VkFence fence = VK_NULL_HANDLE);
+
+    /**
+     * @brief    複数モデルの描画を1回のサブミットにまとめるフレームを開始する
+     *
+     *           BeginFrameとEndFrameの間に呼ばれたDrawModelはサブミットを行わず、共有のコマンドバッファに記録される。<br>
+     *           レンダーターゲットをクリアするのはフレームで最初に描画するモデルだけで、以降のモデルはその上に描く。<br>
+     *           同じスロットを前回使用したフレームのGPU処理が終わるまでここで待つ。
      */
-    void SubmitCommand(VkCommandBuffer commandBuffer, VkSemaphore signalUpdateFinishedSemaphore = VK_NULL_HANDLE, VkSemaphore waitUpdateFinishedSemaphore = VK_NULL_HANDLE);
+    static void BeginFrame();
+
+    /**
+     * @brief    BeginFrame以降に記録した全モデルの描画をサブミットする
+     *
+     *           更新用コマンドと描画用コマンドをセマフォでつなぎ、フレームの完了はフェンスで管理する。キューの待機は行わない。
+     */
+    static void EndFrame();
 
     /**
      * @brief    レンダラを作成するための各種設定
@@ -406,7 +510,7 @@ public:
 
     /**
      * @brief   ユニフォームバッファとディスクリプタセットを作成する。
-     *          ディスクリプタセットレイアウトはユニフォームバッファ1つとモデル用テクスチャ1つとマスク用テクスチャ1つを指定する。
+     *          ディスクリプタセットレイアウトは動的オフセットのユニフォームバッファ1つとモデル用テクスチャ1つとマスク用テクスチャ1つを指定する。
      */
     void CreateDescriptorSets();
 
@@ -465,12 +569,14 @@ public:
     void UpdateColor(csmFloat32 vkVec4[4], csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a);
 
     /**
-     * @brief  ディスクリプタセットを更新する
-     * @param[in]   descriptor    -> 1つのシェーダーが使用するディスクリプタセットとUBO
-     * @param[in]   textureIndex  -> テクスチャインデックス
-     * @param[in]   isMasked      -> 描画対象がマスクされるか
+     * @brief  テクスチャとマスクバッファの組み合わせに対応するディスクリプタセットを取得する<br>
+     *         初めて使う組み合わせの場合はここで内容を設定する。
+     * @param[in]   textureIndex     -> テクスチャインデックス
+     * @param[in]   maskBufferIndex  -> マスクバッファのインデックス。マスクされない場合は-1
+     *
+     * @return  ディスクリプタセット
      */
-    void UpdateDescriptorSet(Descriptor& descriptor, csmUint32 textureIndex, bool isMasked);
+    VkDescriptorSet GetDescriptorSet(csmInt32 textureIndex, csmInt32 maskBufferIndex);
 
     /**
      * @brief   メッシュ描画を実行する
@@ -505,7 +611,8 @@ public:
      * @brief   レンダリング開始
      *
      * @param[in]   drawCommandBuffer       ->  コマンドバッファ
-     * @param[in]   isResume                ->  レンダリング再開かのフラグ
+     * @param[in]   isResume                ->  同じコマンドバッファで描画済みの内容に続けて描くかのフラグ<br>
+     *                                          trueの場合はクリアせず、EndRenderingで遷移させたレイアウトから戻す
      */
     void BeginRendering(VkCommandBuffer drawCommandBuffer, bool isResume);
 
@@ -528,6 +635,11 @@ public:
      */
     void PostDraw();
 
+    /**
+     * @brief   このレンダラが単独でサブミットした全フレームのGPU処理完了を待つ
+     */
+    void WaitInFlightFrames();
+
     /**
      * @brief   モデル描画直前のステートを保持する
      */
@@ -604,14 +716,14 @@ public:
 private:
 
     /**
-     * @brief  色定数バッファを設定する
+     * @brief  色のプッシュ定数を設定する
      *
-     * @param[in]   ubo                   ->  ユニフォームバッファ
+     * @param[in]   pushConstants         ->  プッシュ定数
      * @param[in]   baseColor             ->  ベースカラー
      * @param[in]   multiplyColor         ->  乗算カラー
      * @param[in]   screenColor           ->  スクリーンカラー
      */
-    void SetColorUniformBuffer(ModelUBO& ubo, const CubismTextureColor& baseColor,
+    void SetColorPushConstants(ModelPushConstants& pushConstants, const CubismTextureColor& baseColor,
                                const CubismTextureColor& multiplyColor, const CubismTextureColor& screenColor);
 
     /**
@@ -625,10 +737,25 @@ private:
     /**
      * @brief  描画に使用するカラーチャンネルを設定
      *
-     * @param[in]   ubo              ->  ユニフォームバッファ
+     * @param[in]   pushConstants    ->  プッシュ定数
      * @param[in]   contextBuffer    ->  描画コンテキスト
      */
-    void SetColorChannel(ModelUBO& ubo, CubismClippingContext_Vulkan* contextBuffer);
+    void SetColorChannel(ModelPushConstants& pushConstants, CubismClippingContext_Vulkan* contextBuffer);
+
+    /**
+     * @brief  現在のフレームのリングバッファにUBOを書き込む
+     *
+     * @param[in]   ubo              ->  書き込むUBO
+     * @param[out]  dynamicOffset    ->  ディスクリプタセットのバインド時に指定する動的オフセット
+     *
+     * @return  領域を確保できた場合はtrue
+     */
+    csmBool WriteUniformBuffer(const ModelUBO& ubo, csmUint32& dynamicOffset);
+
+    /**
+     * @brief  共有フレームでサブミットした全フレームのGPU処理完了を待つ
+     */
+    static void WaitSharedFrames();
 
     PFN_vkCmdSetCullModeEXT vkCmdSetCullModeEXT;
 
@@ -649,15 +776,28 @@ private:
 
     VkDescriptorPool _descriptorPool; ///< ディスクリプタプール
     VkDescriptorSetLayout _descriptorSetLayout; ///< ディスクリプタセットのレイアウト
-    csmVector<csmVector<Descriptor>> _descriptorSets; ///< ディスクリプタ管理オブジェクト
+    csmVector<csmVector<Descriptor>> _descriptorSets; ///< ディスクリプタ管理オブジェクト。[スロット][テクスチャ * (1 + マスクバッファ数) + マスクバッファ]
+    csmInt32 _descriptorTextureCount; ///< ディスクリプタセットを用意するテクスチャの数
+    csmInt32 _descriptorMaskBufferCount; ///< ディスクリプタセットを用意するマスクバッファの数
 
     csmVector<CubismImageVulkan> _textures; ///< モデルが使うテクスチャ
     CubismImageVulkan _depthImage; ///< オフスクリーンの色情報を保持する深度画像
     VkClearValue _clearColor; ///< クリアカラー
 
+    csmVector<CubismBufferVulkan> _uniformRingBuffers; ///< フレームごとのUBO用リングバッファ
+    VkDeviceSize _uniformRingStride; ///< 描画1回分のUBO領域のサイズ（アライメント調整済み）
+    csmUint32 _uniformRingCapacity; ///< 1フレームで確保できるUBO領域の数
+    csmUint32 _uniformRingUsedCount; ///< 現在のフレームで確保済みのUBO領域の数
+    csmVector<csmBool> _isVertexBufferCopied; ///< 現在のフレームで頂点バッファへのコピーを記録済みか
+
     csmVector<VkSemaphore> _updateFinishedSemaphores; ///< セマフォ
+    csmVector<VkFence> _inFlightFences; ///< スロットごとの描画完了を示すフェンス
     csmVector<VkCommandBuffer> _updateCommandBuffers; ///< 更新用コマンドバッファ
     csmVector<VkCommandBuffer> _drawCommandBuffers; ///< 描画用コマンドバッファ
+    VkCommandBuffer _singleTimeCommandBuffer; ///< BeginSingleTimeCommandsで使い回すコマンドバッファ
+    VkFence _singleTimeFence; ///< _singleTimeCommandBufferの完了を示すフェンス
+    csmBool _isSharedFrameUsed; ///< 直前の描画を共有フレームに記録したか
+    csmUint64 _sharedFrameSerial; ///< 最後に記録した共有フレームの通し番号
 };
 }}}}
 
@@ -9,8 +9,8 @@ layout(location = 0) out vec4 outColor;
 void main()
 {
     vec4 texColor = texture(s_texture0, v_texCoord);
-    texColor.rgb = texColor.rgb * ubo.u_multiplyColor.rgb;
-    texColor.rgb = texColor.rgb + ubo.u_screenColor.rgb - (texColor.rgb * ubo.u_screenColor.rgb);
-    vec4 color = texColor *  ubo.u_baseColor;
+    texColor.rgb = texColor.rgb * pc.u_multiplyColor.rgb;
+    texColor.rgb = texColor.rgb + pc.u_screenColor.rgb - (texColor.rgb * pc.u_screenColor.rgb);
+    vec4 color = texColor *  pc.u_baseColor;
     outColor = vec4(color.rgb * color.a, color.a);
 }
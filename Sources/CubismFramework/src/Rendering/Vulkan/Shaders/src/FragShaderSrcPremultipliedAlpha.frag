@@ -8,7 +8,7 @@ layout(location = 0) out vec4 outColor;
 void main()
 {
     vec4 texColor = texture(s_texture0 , v_texCoord);
-    texColor.rgb = texColor.rgb * ubo.u_multiplyColor.rgb;
-    texColor.rgb = (texColor.rgb + ubo.u_screenColor.rgb * texColor.a) - (texColor.rgb * ubo.u_screenColor.rgb);
-    outColor = texColor * ubo.u_baseColor;
+    texColor.rgb = texColor.rgb * pc.u_multiplyColor.rgb;
+    texColor.rgb = (texColor.rgb + pc.u_screenColor.rgb * texColor.a) - (texColor.rgb * pc.u_screenColor.rgb);
+    outColor = texColor * pc.u_baseColor;
 }
@@ -8,10 +8,10 @@ layout(location = 0) out vec4 outColor;
 
 void main()
 {
-    float isInside = step(ubo.u_baseColor.x, v_myPos.x/v_myPos.w)*
-    step(ubo.u_baseColor.y, v_myPos.y/v_myPos.w)*
-    step(v_myPos.x/v_myPos.w, ubo.u_baseColor.z)*
-    step(v_myPos.y/v_myPos.w, ubo.u_baseColor.w);
+    float isInside = step(pc.u_baseColor.x, v_myPos.x/v_myPos.w)*
+    step(pc.u_baseColor.y, v_myPos.y/v_myPos.w)*
+    step(v_myPos.x/v_myPos.w, pc.u_baseColor.z)*
+    step(v_myPos.y/v_myPos.w, pc.u_baseColor.w);
 
-    outColor = ubo.u_channelFlag * texture(s_texture0 , v_texCoord).a * isInside;
+    outColor = pc.u_channelFlag * texture(s_texture0 , v_texCoord).a * isInside;
 }
@@ -2,11 +2,15 @@ layout(binding = 0) uniform UBO
 {
     mat4 u_matrix;
     mat4 u_clipMatrix;
+}ubo;
+
+layout(push_constant) uniform PushConstants
+{
     vec4 u_baseColor;
     vec4 u_multiplyColor;
     vec4 u_screenColor;
     vec4 u_channelFlag;
-}ubo;
+}pc;
 
 layout(binding = 1) uniform sampler2D s_texture0;
 layout(binding = 2) uniform sampler2D s_texture1;
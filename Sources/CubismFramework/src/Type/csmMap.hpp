@@ -10,6 +10,7 @@
 #include "CubismFramework.hpp"
 #include "csmString.hpp"
 #include "Utils/CubismDebug.hpp"
+#include "Utils/CubismAllocationStats.hpp"
 
 #ifndef NULL
 #   define  NULL 0
@@ -537,6 +538,8 @@ public:
      */
     void Copy(const csmMap& c)
     {
+        CSM_COUNT_COPY(c._size * sizeof(csmPair<_KeyT, _ValT>));
+
         _dummyValuePtr = NULL;
         _size = c._size;
         _capacity = c._capacity;
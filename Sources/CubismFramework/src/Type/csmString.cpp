@@ -9,89 +9,86 @@
 #include <stdarg.h>
 #include "CubismFramework.hpp"
 #include "Utils/CubismDebug.hpp"
+#include "Utils/CubismAllocationStats.hpp"
 
 //--------- LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework {
-csmInt32 csmString::s_totalInstanceNo = 0;
 
-namespace {
-const csmChar* s_emptyString = "";
-
-csmChar* GetEmptyString()
-{
-    return const_cast<csmChar*>(s_emptyString);
-}
-}
+csmStringView::csmStringView(const csmString& s)
+    : _ptr(s.GetRawString())
+    , _length(s.GetLength())
+    , _hashcode(-1)
+{ }
 
+// ハッシュコードは比較に使われるまで計算しない
 csmString::csmString()
-    : _ptr(NULL)
-    , _length(0)
-    , _hashcode(-1)
 {
-    this->_small[0] = '\0';
-    _hashcode = CalcHashcode(WritePointer(), this->_length);
-    _instanceNo = s_totalInstanceNo++;
+    SetEmpty();
 }
 
 csmString::csmString(const csmChar* c)
 {
     const csmInt32 count = static_cast<csmInt32>(strlen(c));
 
-    if (count)
-    {
-        Copy(c, count);
-        this->_hashcode = CalcHashcode(WritePointer(), _length);
-    }
-    else
-    {
-        SetEmpty();
-    }
-
-    _instanceNo = s_totalInstanceNo++;
+    SetEmpty();
+    Copy(c, count);
 }
 
 csmString::csmString(const csmString& s)
 {
-    if (!s.IsEmpty())
-    {
-        Copy(s.GetRawString(), s._length);
-        this->_hashcode = s._hashcode;
-    }
-    else
-    {
-        SetEmpty();
-    }
+    CSM_COUNT_COPY(s._length);
 
-    _instanceNo = s_totalInstanceNo++;
+    SetEmpty();
+    Copy(s.GetRawString(), s._length);
+    this->_hashcode = s._hashcode;
 }
 
-csmString::csmString(const csmChar* s, csmInt32 length)
+csmString::csmString(csmString&& s)
 {
-    if (length)
+    SetEmpty();
+
+    if (s.IsAllocated())
     {
-        Copy(s, length);
-        this->_hashcode = CalcHashcode(WritePointer(), _length);
+        this->_ptr = s._ptr;
     }
     else
     {
-        SetEmpty();
+        memcpy(this->_small, s._small, s._length + 1);
     }
+    this->_length = s._length;
+    this->_hashcode = s._hashcode;
 
-    _instanceNo = s_totalInstanceNo++;
+    // 領域は引き取ったので解放せずに空にする
+    s.SetEmpty();
+}
+
+csmString::csmString(const csmStringView& s)
+{
+    SetEmpty();
+    Copy(s.GetData(), s.GetLength());
+}
+
+csmString::csmString(const csmChar* s, csmInt32 length)
+{
+    SetEmpty();
+    Copy(s, length);
 }
 
 csmString::csmString(const csmChar* c, csmInt32 length, csmBool useptr)
 {
     Initialize(c, length, useptr);
-    _instanceNo = s_totalInstanceNo++;
 }
 
 void csmString::Initialize(const csmChar* c, csmInt32 length, csmBool usePtr)
 {
+    SetEmpty();
+
     if (!length)
     {
-        SetEmpty();
-
+        if (usePtr && c != NULL)
+        {
+            CSM_FREE(const_cast<csmChar*>(c));
+        }
         return;
     }
 
@@ -99,24 +96,23 @@ void csmString::Initialize(const csmChar* c, csmInt32 length, csmBool usePtr)
     {
         Copy(c, length);
     }
+    else if (length < SmallLength - 1)
+    {
+        // 内部バッファに収まる長さなら、受け取った領域は複製後に解放する
+        Copy(c, length);
+        CSM_FREE(const_cast<csmChar*>(c));
+    }
     else
     {
         this->_ptr = const_cast<csmChar*>(c);
         this->_length = length;
         this->_ptr[length] = 0x0;
     }
-
-    this->_hashcode = CalcHashcode(this->GetRawString(), this->_length);
 }
 
 csmString::~csmString()
 {
-    if (IsEmpty())
-    {
-        return;
-    }
-
-    if (this->_ptr)
+    if (IsAllocated())
     {
         CSM_FREE(this->_ptr);
     }
@@ -129,7 +125,10 @@ void csmString::Clear()
         return;
     }
 
-    CSM_FREE(this->_ptr);
+    if (IsAllocated())
+    {
+        CSM_FREE(this->_ptr);
+    }
 
     SetEmpty();
 }
@@ -139,19 +138,49 @@ csmString& csmString::operator=(const csmChar* c)
     Clear(); //現在のポインタを開放してから処理する
 
     Copy(c, static_cast<csmInt32>(strlen(c)));
-    this->_hashcode = CalcHashcode(this->GetRawString(), this->_length);
     return *this;
 }
 
 csmString& csmString::operator=(const csmString& s)
 {
+    if (this == &s)
+    {
+        return *this;
+    }
+
     Clear(); //現在のポインタを開放してから処理する
 
+    CSM_COUNT_COPY(s._length);
     Copy(s.GetRawString(), s._length);
     this->_hashcode = s._hashcode;
     return *this;
 }
 
+csmString& csmString::operator=(csmString&& s)
+{
+    if (this == &s)
+    {
+        return *this;
+    }
+
+    Clear(); //現在のポインタを開放してから処理する
+
+    if (s.IsAllocated())
+    {
+        this->_ptr = s._ptr;
+    }
+    else
+    {
+        memcpy(this->_small, s._small, s._length + 1);
+    }
+    this->_length = s._length;
+    this->_hashcode = s._hashcode;
+
+    // 領域は引き取ったので解放せずに空にする
+    s.SetEmpty();
+    return *this;
+}
+
 csmString csmString::operator+(const csmString& s) const
 {
     csmSizeType len1 = static_cast<csmSizeType>(this->_length);
@@ -296,8 +325,8 @@ csmBool csmString::operator==(const csmString& s) const
     //サイズ違い
     if (s._length != this->_length) return false;
 
-    //hashcode比較
-    if (this->_hashcode != s._hashcode) return false;
+    //hashcode比較（両方とも計算済みの場合のみ）
+    if (this->_hashcode != -1 && s._hashcode != -1 && this->_hashcode != s._hashcode) return false;
 
     const csmChar* c1 = this->GetRawString();
     const csmChar* c2 = s.GetRawString();
@@ -325,6 +354,25 @@ csmBool csmString::operator==(const csmChar* rc) const
     return true;
 }
 
+csmBool csmString::operator==(const csmStringView& s) const
+{
+    //サイズ違い
+    if (s.GetLength() != this->_length) return false;
+
+    //hashcode比較
+    if (GetHashcode() != s.GetHashcode()) return false;
+
+    const csmChar* lc = this->GetRawString();
+    const csmChar* rc = s.GetData();
+
+    //文字違い（逆順なのはPARAMの比較の特性）
+    for (csmInt32 i = this->_length - 1; i >= 0; --i)
+    {
+        if (lc[i] != rc[i]) return false;
+    }
+    return true;
+}
+
 csmBool csmString::operator<(const csmString& s) const
 {
     return strcmp(this->GetRawString(), s.GetRawString()) < 0;
@@ -414,11 +462,10 @@ void csmString::Copy(const csmChar* c, csmInt32 length)
     }
 
     this->_length = length;
+    this->_hashcode = -1;
 
     if (this->_length < SmallLength -1)
     {
-        this->_ptr = NULL;
-
         memcpy(this->_small, c, length);
         this->_small[length] = 0x0;
     }
@@ -433,16 +480,7 @@ void csmString::Copy(const csmChar* c, csmInt32 length)
 
 csmInt32 csmString::CalcHashcode(const csmChar* c, csmInt32 length)
 {
-    csmInt32 hash = 0;
-    for (csmInt32 i = length; i >= 0; --i)
-    {
-        hash = hash * 31 + c[i];
-    }
-    if ((hash == -1) || (c == GetEmptyString()))
-    {
-        hash = -2; //-1だけ特別な意味をもたせる
-    }
-    return hash;
+    return csmStringView::CalcHashcode(c, length);
 }
 
 const csmChar* csmString::GetRawString() const
@@ -457,42 +495,22 @@ const csmChar* csmString::GetRawString() const
     }
 }
 
-csmInt32 csmString::GetHashcode()
+csmInt32 csmString::GetHashcode() const
 {
-    if (_hashcode == -1) _hashcode = CalcHashcode(WritePointer(), this->_length);
+    if (_hashcode == -1) _hashcode = csmStringView::CalcHashcode(GetRawString(), this->_length);
     return _hashcode;
 }
 
 csmBool csmString::IsEmpty() const
 {
-#ifdef CSM_DEBUG
-
-    csmBool isEmpty = (_ptr == NULL && _small[0]=='\0');
-
-    if (isEmpty)
-    {
-        CSM_ASSERT(_length == 0);
-    }
-
-    return isEmpty;
-
-#else
-
-    //return (_ptr == GetEmptyString());
-
-    return (_ptr == NULL && _small[0] == '\0');
-
-#endif
+    return (_length == 0);
 }
 
 void csmString::SetEmpty()
 {
-    //_ptr = GetEmptyString();
-    _ptr = NULL;
     _small[0] = '\0';
     _length = 0;
     _hashcode = -1;
-    _hashcode = CalcHashcode(WritePointer(), this->_length);
 }
 
 csmChar* csmString::WritePointer()
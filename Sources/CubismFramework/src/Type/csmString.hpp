@@ -8,6 +8,7 @@
 #pragma once
 
 #include "CubismFramework.hpp"
+#include "csmStringView.hpp"
 #include <string.h>
 
 //--------- LIVE2D NAMESPACE ------------
@@ -16,7 +17,8 @@ namespace Live2D { namespace Cubism { namespace Framework {
 /**
  * @brief   文字列クラス<br>
  *           コンシューマゲーム機等でSTLの組み込みを避けるための実装。<br>
- *           std::string の簡易版マルチバイト文字列未対応
+ *           std::string の簡易版マルチバイト文字列未対応<br>
+ *           短い文字列はポインタと共有する内部バッファに格納し、メモリを確保しない。
  */
 class csmString
 {
@@ -49,6 +51,21 @@ public:
      */
     csmString(const csmString& s);
 
+    /**
+     * @brief   ムーブコンストラクタ<br>
+     *           確保済みの領域を引き取る。sは空になる。
+     *
+     * @param[in]   s   ->  文字列
+     */
+    csmString(csmString&& s);
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   s   ->  コピーする文字列のビュー
+     */
+    explicit csmString(const csmStringView& s);
+
     /**
      * @brief   引数付きコンストラクタ
      *
@@ -69,6 +86,11 @@ public:
      */
     csmString& operator=(const csmString& s);
 
+    /**
+     * @brief =演算子のオーバーロード(ムーブ)
+     */
+    csmString& operator=(csmString&& s);
+
     /**
      * @brief =演算子のオーバーロード(csmChar型)
      */
@@ -84,6 +106,12 @@ public:
      */
     csmBool operator==(const csmChar* c) const;
 
+    /**
+     * @brief ==演算子のオーバーロード(csmStringView型)<br>
+     *         ハッシュコードが異なれば文字を比較せずに不一致とする。
+     */
+    csmBool operator==(const csmStringView& s) const;
+
     /**
      * @brief <演算子のオーバーロード(csmString型)
      */
@@ -162,11 +190,12 @@ public:
     void Clear();
 
     /**
-     * @brief   ハッシュコードを取得する
+     * @brief   ハッシュコードを取得する<br>
+     *           初回のみ計算し、以降は保持した値を返す。
      *
      * @return  ハッシュコード
      */
-    csmInt32 GetHashcode();
+    csmInt32 GetHashcode() const;
 
 
 protected:
@@ -198,15 +227,23 @@ protected:
     csmInt32 CalcHashcode(const csmChar* c, csmInt32 length);
 
 private:
-    static const csmInt32 SmallLength = 64; ///< この長さ-1未満の文字列は内部バッファを使用
+    static const csmInt32 SmallLength = 32; ///< この長さ-1未満の文字列は内部バッファを使用
     static const csmInt32 DefaultSize = 10; ///< デフォルトの文字数
-    static csmInt32 s_totalInstanceNo;      ///< 通算のインスタンス番号
-    csmChar* _ptr;                          ///< 文字型配列のポインタ
+    union
+    {
+        csmChar* _ptr;                      ///< 文字型配列のポインタ。文字列の長さがSmallLength-1以上の場合に使用
+        csmChar _small[SmallLength];        ///< 文字列の長さがSmallLength-1未満の場合はこちらを使用
+    };
     csmInt32 _length;                       ///< 半角文字数（メモリ確保は最後に0が入るため_length+1）
-    csmInt32 _hashcode;                     ///< インスタンスに当てられたハッシュ値
-    csmInt32 _instanceNo;                   ///< インスタンスに割り当てられた番号
+    mutable csmInt32 _hashcode;             ///< インスタンスに当てられたハッシュ値。未計算なら-1
 
-    csmChar _small[SmallLength];            ///< 文字列の長さがSmallLength-1未満の場合はこちらを使用
+    /**
+     * @brief   文字列を確保した領域に持っているか
+     *
+     * @retval  true    _ptrが確保した領域を指している
+     * @retval  false   _smallを使用している
+     */
+    csmBool IsAllocated() const { return _length >= SmallLength - 1; }
 
     /**
      * @brief 文字列が空かどうか？
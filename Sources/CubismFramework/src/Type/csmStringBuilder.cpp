@@ -0,0 +1,116 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "csmStringBuilder.hpp"
+#include <string.h>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+csmStringBuilder::csmStringBuilder(csmInt32 capacity)
+    : _buffer(NULL)
+    , _length(0)
+    , _capacity(0)
+{
+    if (capacity > 0)
+    {
+        Reserve(capacity);
+    }
+}
+
+csmStringBuilder::~csmStringBuilder()
+{
+    if (_buffer)
+    {
+        CSM_FREE(_buffer);
+    }
+}
+
+csmStringBuilder& csmStringBuilder::Append(const csmStringView& s)
+{
+    return Append(s.GetData(), s.GetLength());
+}
+
+csmStringBuilder& csmStringBuilder::Append(const csmChar* c, csmInt32 length)
+{
+    if (length <= 0)
+    {
+        return *this;
+    }
+
+    Reserve(_length + length);
+    memcpy(_buffer + _length, c, length);
+    _length += length;
+    return *this;
+}
+
+csmStringBuilder& csmStringBuilder::Append(csmChar c)
+{
+    Reserve(_length + 1);
+    _buffer[_length++] = c;
+    return *this;
+}
+
+csmString csmStringBuilder::ToString()
+{
+    if (_length == 0)
+    {
+        return csmString();
+    }
+
+    // 領域の所有権を文字列に渡す。終端の'\0'は csmString 側で書き込まれる
+    csmChar* buffer = _buffer;
+    const csmInt32 length = _length;
+
+    _buffer = NULL;
+    _length = 0;
+    _capacity = 0;
+
+    return csmString(buffer, length, true);
+}
+
+csmStringView csmStringBuilder::GetView() const
+{
+    if (_length == 0)
+    {
+        return csmStringView();
+    }
+
+    return csmStringView(_buffer, _length);
+}
+
+void csmStringBuilder::Reserve(csmInt32 length)
+{
+    if (length + 1 <= _capacity)
+    {
+        return;
+    }
+
+    // 追記のたびに確保し直さないよう倍々で広げる
+    csmInt32 capacity = (_capacity > 0) ? _capacity : 32;
+    while (capacity < length + 1)
+    {
+        capacity *= 2;
+    }
+
+    csmChar* buffer = static_cast<csmChar*>(CSM_MALLOC(capacity));
+    if (_length > 0)
+    {
+        memcpy(buffer, _buffer, _length);
+    }
+    if (_buffer)
+    {
+        CSM_FREE(_buffer);
+    }
+
+    _buffer = buffer;
+    _capacity = capacity;
+}
+
+}}}
+
+//------------------------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,112 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "csmString.hpp"
+#include "csmStringView.hpp"
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * @brief   文字列を組み立てるクラス<br>
+ *           連結のたびに csmString を作り直さずに、一つの領域へ追記していく。<br>
+ *           ToString() は領域をそのまま csmString に渡すため、最後の複製も発生しない。
+ */
+class csmStringBuilder
+{
+public:
+    /**
+     * @brief   コンストラクタ
+     *
+     * @param[in]   capacity    ->  最初に確保する文字数
+     */
+    csmStringBuilder(csmInt32 capacity = 0);
+
+    /**
+     * @brief   デストラクタ
+     */
+    ~csmStringBuilder();
+
+    /**
+     * @brief   文字列を追加する
+     *
+     * @param[in]   s   ->  追加する文字列
+     *
+     * @return  自身の参照
+     */
+    csmStringBuilder& Append(const csmStringView& s);
+
+    /**
+     * @brief   文字列を追加する
+     *
+     * @param[in]   c       ->  追加する文字列
+     * @param[in]   length  ->  追加する長さ
+     *
+     * @return  自身の参照
+     */
+    csmStringBuilder& Append(const csmChar* c, csmInt32 length);
+
+    /**
+     * @brief   文字を追加する
+     *
+     * @param[in]   c   ->  追加する文字
+     *
+     * @return  自身の参照
+     */
+    csmStringBuilder& Append(csmChar c);
+
+    /**
+     * @brief   組み立てた文字列を返す<br>
+     *           領域は返す文字列に引き渡され、ビルダーは空になる。
+     *
+     * @return  組み立てた文字列
+     */
+    csmString ToString();
+
+    /**
+     * @brief   組み立て中の文字列を参照する
+     *
+     * @return  組み立て中の文字列のビュー
+     */
+    csmStringView GetView() const;
+
+    /**
+     * @brief   組み立て中の文字列の長さを返す
+     *
+     * @return  文字列の長さ
+     */
+    csmInt32 GetLength() const { return _length; }
+
+    /**
+     * @brief   組み立て中の文字列を空にする<br>
+     *           確保済みの領域は再利用する。
+     */
+    void Clear() { _length = 0; }
+
+private:
+    // コピー禁止
+    csmStringBuilder(const csmStringBuilder&);
+    csmStringBuilder& operator=(const csmStringBuilder&);
+
+    /**
+     * @brief   終端の'\0'を含めて指定の長さが入るように領域を確保する
+     *
+     * @param[in]   length  ->  必要な文字列の長さ
+     */
+    void Reserve(csmInt32 length);
+
+    csmChar* _buffer;       ///< 組み立て中の文字列
+    csmInt32 _length;       ///< 文字列の長さ
+    csmInt32 _capacity;     ///< 確保済みの領域のバイト数
+};
+
+}}}
+
+//------------------------- LIVE2D NAMESPACE ------------
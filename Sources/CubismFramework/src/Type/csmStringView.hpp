@@ -0,0 +1,203 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include <string.h>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class csmString;
+
+/**
+ * @brief   所有しない文字列の参照<br>
+ *           文字列を複製せずに比較や検索に渡すためのクラス。参照先の文字列はビューより長く生存している必要がある。<br>
+ *           終端に'\0'があるとは限らない。
+ */
+class csmStringView
+{
+public:
+    /**
+     * @brief   コンストラクタ（空の文字列）
+     */
+    csmStringView()
+        : _ptr("")
+        , _length(0)
+        , _hashcode(-1)
+    { }
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   c   ->  '\0'で終わる文字列
+     */
+    csmStringView(const csmChar* c)
+        : _ptr(c)
+        , _length(static_cast<csmInt32>(strlen(c)))
+        , _hashcode(-1)
+    { }
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   c       ->  文字列の先頭
+     * @param[in]   length  ->  文字列の長さ
+     */
+    csmStringView(const csmChar* c, csmInt32 length)
+        : _ptr(c)
+        , _length(length)
+        , _hashcode(-1)
+    { }
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   s   ->  参照する文字列
+     */
+    csmStringView(const csmString& s);
+
+    /**
+     * @brief   文字列の先頭を返す
+     *
+     * @return  文字列の先頭。終端に'\0'があるとは限らない。
+     */
+    const csmChar* GetData() const { return _ptr; }
+
+    /**
+     * @brief   文字列の長さを返す
+     *
+     * @return  文字列の長さ
+     */
+    csmInt32 GetLength() const { return _length; }
+
+    /**
+     * @brief   文字列が空かどうか
+     *
+     * @retval  true    空の文字列
+     * @retval  false   文字がある
+     */
+    csmBool IsEmpty() const { return _length == 0; }
+
+    /**
+     * @brief   ハッシュコードを取得する<br>
+     *           csmString::GetHashcode() と同じ値を返す。初回のみ計算する。
+     *
+     * @return  ハッシュコード
+     */
+    csmInt32 GetHashcode() const
+    {
+        if (_hashcode == -1)
+        {
+            _hashcode = CalcHashcode(_ptr, _length);
+        }
+        return _hashcode;
+    }
+
+    /**
+     * @brief   部分文字列を返す
+     *
+     * @param[in]   begin   ->  開始位置
+     * @param[in]   length  ->  長さ。残りの長さを超える場合は末尾まで
+     *
+     * @return  部分文字列のビュー
+     */
+    csmStringView Substring(csmInt32 begin, csmInt32 length) const
+    {
+        if (begin > _length)
+        {
+            begin = _length;
+        }
+        if (length > _length - begin)
+        {
+            length = _length - begin;
+        }
+        return csmStringView(_ptr + begin, length);
+    }
+
+    /**
+     * @brief   文字を後ろから探す
+     *
+     * @param[in]   c   ->  探す文字
+     *
+     * @return  見つかった位置。見つからない場合は-1
+     */
+    csmInt32 FindLast(csmChar c) const
+    {
+        for (csmInt32 i = _length - 1; i >= 0; --i)
+        {
+            if (_ptr[i] == c)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief ==演算子のオーバーロード
+     */
+    csmBool operator==(const csmStringView& s) const
+    {
+        if (_length != s._length)
+        {
+            return false;
+        }
+
+        // 両方のハッシュコードが計算済みなら、それだけで異なる文字列を除外できる
+        if (_hashcode != -1 && s._hashcode != -1 && _hashcode != s._hashcode)
+        {
+            return false;
+        }
+
+        return memcmp(_ptr, s._ptr, _length) == 0;
+    }
+
+    /**
+     * @brief !=演算子のオーバーロード
+     */
+    csmBool operator!=(const csmStringView& s) const
+    {
+        return !(*this == s);
+    }
+
+    /**
+     * @brief   文字列からハッシュ値を生成して返す<br>
+     *           終端の'\0'は読まないので、終端のない部分文字列にも使える。-1は未計算を表すので返さない。
+     *
+     * @param[in]   c       ->  文字列
+     * @param[in]   length  ->  文字列の長さ
+     *
+     * @return  文字列から生成したハッシュ値
+     */
+    static csmInt32 CalcHashcode(const csmChar* c, csmInt32 length)
+    {
+        // 最後の文字から始めて、先頭に向かって畳み込む
+        csmUint32 hash = 0;
+        for (csmInt32 i = length - 1; i >= 0; --i)
+        {
+            hash = hash * 31 + static_cast<csmUint32>(static_cast<csmInt32>(c[i]));
+        }
+
+        csmInt32 result = static_cast<csmInt32>(hash);
+        if (result == -1)
+        {
+            result = -2; //-1だけ特別な意味をもたせる
+        }
+        return result;
+    }
+
+private:
+    const csmChar* _ptr;            ///< 文字列の先頭
+    csmInt32 _length;               ///< 文字列の長さ
+    mutable csmInt32 _hashcode;     ///< 計算済みのハッシュ値。未計算なら-1
+};
+
+}}}
+
+//------------------------- LIVE2D NAMESPACE ------------
@@ -10,6 +10,9 @@
 #include "csmString.hpp"
 #include "CubismFramework.hpp"
 #include "Utils/CubismDebug.hpp"
+#include "Utils/CubismAllocationStats.hpp"
+#include <type_traits>
+#include <utility>
 
 #ifndef NULL
 #   define  NULL    0
@@ -94,6 +97,23 @@ public:
      */
     void PushBack(const T& value, csmBool callPlacementNew = true);
 
+    /**
+     * @brief   PushBack処理.コンテナに新たな要素をムーブして追加する。
+     *
+     * @param[in]   value   -> PushBack処理で追加する値。呼び出し後は中身を失ってよい。
+     */
+    void PushBack(T&& value);
+
+    /**
+     * @brief   コンテナの末尾に、引数から直接要素を生成して追加する。
+     *
+     * @param[in]   args    -> 要素のコンストラクタに渡す引数
+     *
+     * @return  追加した要素
+     */
+    template<class... Args>
+    T& EmplaceBack(Args&&... args);
+
     /**
      * @brief   コンテナの全要素を解放する
      *
@@ -514,9 +534,75 @@ public:
         return *this;
     }
 
+    /**
+     * @brief   ムーブコンストラクタ<br>
+     *           領域を引き取るので要素のコピーは発生しない。cは空になる。
+     *
+     * @param[in]   c   ->  csmVector<T>のインスタンス
+     */
+    csmVector(csmVector&& c)
+        : _ptr(c._ptr)
+        , _size(c._size)
+        , _capacity(c._capacity)
+    {
+        c._ptr = NULL;
+        c._size = 0;
+        c._capacity = 0;
+    }
+
+    /**
+     * @brief   ムーブ代入<br>
+     *           領域を引き取るので要素のコピーは発生しない。cは空になる。
+     *
+     * @param[in]   c   ->  csmVector<T>のインスタンス
+     */
+    csmVector& operator=(csmVector&& c)
+    {
+        if (this != &c)
+        {
+            Clear();
+
+            _ptr = c._ptr;
+            _size = c._size;
+            _capacity = c._capacity;
+
+            c._ptr = NULL;
+            c._size = 0;
+            c._capacity = 0;
+        }
+
+        return *this;
+    }
+
 private:
     static const csmInt32 s_defaultSize = 10;   ///< コンテナ初期化のデフォルトサイズ
 
+    /**
+     * @brief   要素を別の領域へ移す。移動元の要素は破棄済みの扱いになる。
+     *
+     * @param[in]   dst     ->  移動先の先頭アドレス
+     * @param[in]   src     ->  移動元の先頭アドレス
+     * @param[in]   count   ->  要素数
+     */
+    static void Relocate(T* dst, T* src, csmInt32 count)
+    {
+        // トリビアルにコピーできる型はまとめてメモリをコピーする
+        if (std::is_trivially_copyable<T>::value)
+        {
+            if (count > 0)
+            {
+                memcpy(static_cast<void*>(dst), src, sizeof(T) * count);
+            }
+            return;
+        }
+
+        for (csmInt32 i = 0; i < count; ++i)
+        {
+            CSM_PLACEMENT_NEW(&dst[i]) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+
     /**
      * @brief   csmVector<T>のコピー関数
      *
@@ -524,6 +610,8 @@ private:
      */
     void Copy(const csmVector& c)
     {
+        CSM_COUNT_COPY(c._size * sizeof(T));
+
         _size = c._size;
         _capacity = c._capacity;
 
@@ -535,6 +623,15 @@ private:
 
         _ptr = (T*)CSM_MALLOC(_capacity * sizeof(T));
 
+        if (std::is_trivially_copyable<T>::value)
+        {
+            if (_size > 0)
+            {
+                memcpy(static_cast<void*>(_ptr), c._ptr, sizeof(T) * _size);
+            }
+            return;
+        }
+
         for (csmInt32 i = 0; i < _size; ++i)
         {
             CSM_PLACEMENT_NEW(&_ptr[i]) T(c._ptr[i]);
@@ -605,6 +702,33 @@ void csmVector<T>::PushBack(const T& value, csmBool callPlacementNew)
     }
 }
 
+template<class T>
+void csmVector<T>::PushBack(T&& value)
+{
+    if (_size >= _capacity)
+    {
+        PrepareCapacity(_capacity == 0 ? s_defaultSize : _capacity * 2);
+    }
+
+    CSM_PLACEMENT_NEW(&_ptr[_size++]) T(std::move(value));
+}
+
+template<class T>
+template<class... Args>
+T& csmVector<T>::EmplaceBack(Args&&... args)
+{
+    if (_size >= _capacity)
+    {
+        PrepareCapacity(_capacity == 0 ? s_defaultSize : _capacity * 2);
+    }
+
+    // placement new 指定のアドレスに、引数から実体を生成する
+    T* element = CSM_PLACEMENT_NEW(&_ptr[_size]) T(std::forward<Args>(args)...);
+    ++_size;
+
+    return *element;
+}
+
 template<class T>
 void csmVector<T>::PrepareCapacity(csmInt32 newSize)
 {
@@ -622,19 +746,15 @@ void csmVector<T>::PrepareCapacity(csmInt32 newSize)
         {
             csmInt32 tmp_capacity = newSize;
             T* tmp = static_cast<T *>(CSM_MALLOC(sizeof(T) * tmp_capacity));
-            csmInt32 tmp_size = _size;
 
             CSM_ASSERT(tmp != NULL);
 
-            for (csmInt32 i = 0; i < _size; i++)
-            {
-                CSM_PLACEMENT_NEW(&tmp[i]) T(_ptr[i]);
-            }
-            Clear();
+            // 要素はコピーせずに新しい領域へ移し、古い領域は解放だけ行う
+            Relocate(tmp, _ptr, _size);
+            CSM_FREE(_ptr);
 
             _ptr = tmp;
             _capacity = newSize;
-            _size = tmp_size;
         }
     }
 }
@@ -750,7 +870,7 @@ void csmVector<T>::Insert(iterator position, iterator begin, iterator end, csmBo
     {
         for (csmInt32 i = src_si; i < src_ei; i++, dst_si++)
         {
-            CSM_PLACEMENT_NEW(&_ptr[i]) T(begin._vector->_ptr[i]);
+            CSM_PLACEMENT_NEW(&_ptr[dst_si]) T(begin._vector->_ptr[i]);
         }
     }
     else
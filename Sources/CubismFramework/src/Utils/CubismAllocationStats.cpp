@@ -0,0 +1,351 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismAllocationStats.hpp"
+#include "CubismDebug.hpp"
+#include <atomic>
+#include <cstring>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+/**
+ * Header in front of a block.
+ */
+struct BlockHeader
+{
+    csmSizeType Size;       ///< Size requested by the caller
+    csmInt32 CallSite;      ///< Index of the call site; -1 if the table was full
+    csmUint16 Offset;       ///< Bytes from the start of the allocator's memory to the block
+};
+
+/**
+ * Counters of a call site.
+ */
+struct CallSiteEntry
+{
+    std::atomic<csmUint32> Hash;                ///< Hash of the file name and line; 0 while the entry is free
+    std::atomic<const csmChar*> FileName;       ///< Set after Hash; NULL until the entry is published
+    std::atomic<csmInt32> LineNumber;
+    std::atomic<csmUint64> AllocationCount;
+    std::atomic<csmUint64> AllocatedBytes;
+    std::atomic<csmUint64> LiveBlockCount;
+    std::atomic<csmUint64> LiveBytes;
+    std::atomic<csmUint64> PeakLiveBytes;
+};
+
+// 静的記憶域はゼロ初期化されるので、他の静的初期化中の確保も数えられる
+CallSiteEntry s_callSites[CubismAllocationStats::MaxCallSiteCount];
+std::atomic<csmInt32> s_callSiteCount;
+
+std::atomic<csmUint64> s_allocationCount;
+std::atomic<csmUint64> s_deallocationCount;
+std::atomic<csmUint64> s_allocatedBytes;
+std::atomic<csmUint64> s_liveBlockCount;
+std::atomic<csmUint64> s_liveBytes;
+std::atomic<csmUint64> s_peakLiveBytes;
+std::atomic<csmUint64> s_copyCount;
+std::atomic<csmUint64> s_copiedBytes;
+
+thread_local csmUint64 s_threadAllocationCount = 0;
+thread_local csmUint64 s_threadCopyCount = 0;
+thread_local const csmChar* s_threadLastFileName = NULL;
+thread_local csmInt32 s_threadLastLineNumber = 0;
+
+void UpdatePeak(std::atomic<csmUint64>& peak, csmUint64 value)
+{
+    csmUint64 current = peak.load(std::memory_order_relaxed);
+
+    while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+csmUint32 HashCallSite(const csmChar* fileName, csmInt32 lineNumber)
+{
+    // FNV-1a。同じファイルでも翻訳単位ごとに __FILE__ のアドレスが異なるので、文字列で比べる
+    csmUint32 hash = 2166136261u;
+
+    for (const csmChar* c = fileName; *c != '\0'; ++c)
+    {
+        hash = (hash ^ static_cast<csmUint8>(*c)) * 16777619u;
+    }
+
+    hash = (hash ^ static_cast<csmUint32>(lineNumber)) * 16777619u;
+
+    return (hash != 0) ? hash : 1;
+}
+
+csmInt32 FindCallSite(const csmChar* fileName, csmInt32 lineNumber)
+{
+    if (fileName == NULL)
+    {
+        fileName = "";
+    }
+
+    const csmUint32 hash = HashCallSite(fileName, lineNumber);
+    const csmInt32 mask = CubismAllocationStats::MaxCallSiteCount - 1;
+
+    for (csmInt32 probe = 0; probe < CubismAllocationStats::MaxCallSiteCount; ++probe)
+    {
+        const csmInt32 index = (static_cast<csmInt32>(hash) + probe) & mask;
+        CallSiteEntry& entry = s_callSites[index];
+        csmUint32 entryHash = entry.Hash.load(std::memory_order_acquire);
+
+        if (entryHash == 0)
+        {
+            if (entry.Hash.compare_exchange_strong(entryHash, hash, std::memory_order_acq_rel))
+            {
+                entry.LineNumber.store(lineNumber, std::memory_order_relaxed);
+                entry.FileName.store(fileName, std::memory_order_release);
+                s_callSiteCount.fetch_add(1, std::memory_order_relaxed);
+                return index;
+            }
+        }
+
+        if (entryHash != hash)
+        {
+            continue;
+        }
+
+        // 他のスレッドが登録中なら、ファイル名が書き込まれるまで待つ
+        const csmChar* entryFileName = entry.FileName.load(std::memory_order_acquire);
+        while (entryFileName == NULL)
+        {
+            entryFileName = entry.FileName.load(std::memory_order_acquire);
+        }
+
+        if (entry.LineNumber.load(std::memory_order_relaxed) == lineNumber &&
+            (entryFileName == fileName || strcmp(entryFileName, fileName) == 0))
+        {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+}
+
+csmBool CubismAllocationStats::IsEnabled()
+{
+#ifdef CSM_ALLOCATION_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CubismAllocationStats::GetSnapshot(CubismAllocationSnapshot& outSnapshot)
+{
+    outSnapshot.AllocationCount = s_allocationCount.load(std::memory_order_relaxed);
+    outSnapshot.DeallocationCount = s_deallocationCount.load(std::memory_order_relaxed);
+    outSnapshot.AllocatedBytes = s_allocatedBytes.load(std::memory_order_relaxed);
+    outSnapshot.LiveBlockCount = s_liveBlockCount.load(std::memory_order_relaxed);
+    outSnapshot.LiveBytes = s_liveBytes.load(std::memory_order_relaxed);
+    outSnapshot.PeakLiveBytes = s_peakLiveBytes.load(std::memory_order_relaxed);
+    outSnapshot.CopyCount = s_copyCount.load(std::memory_order_relaxed);
+    outSnapshot.CopiedBytes = s_copiedBytes.load(std::memory_order_relaxed);
+}
+
+void CubismAllocationStats::GetDifference(const CubismAllocationSnapshot& begin, const CubismAllocationSnapshot& end, CubismAllocationSnapshot& outDifference)
+{
+    outDifference.AllocationCount = end.AllocationCount - begin.AllocationCount;
+    outDifference.DeallocationCount = end.DeallocationCount - begin.DeallocationCount;
+    outDifference.AllocatedBytes = end.AllocatedBytes - begin.AllocatedBytes;
+    outDifference.LiveBlockCount = end.LiveBlockCount;
+    outDifference.LiveBytes = end.LiveBytes;
+    outDifference.PeakLiveBytes = end.PeakLiveBytes;
+    outDifference.CopyCount = end.CopyCount - begin.CopyCount;
+    outDifference.CopiedBytes = end.CopiedBytes - begin.CopiedBytes;
+}
+
+void CubismAllocationStats::ResetPeak()
+{
+    s_peakLiveBytes.store(s_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+csmInt32 CubismAllocationStats::GetCallSiteCount()
+{
+    return s_callSiteCount.load(std::memory_order_relaxed);
+}
+
+csmInt32 CubismAllocationStats::GetCallSites(CubismAllocationCallSite* outCallSites, csmInt32 capacity)
+{
+    csmInt32 count = 0;
+
+    for (csmInt32 i = 0; i < MaxCallSiteCount && count < capacity; ++i)
+    {
+        const CallSiteEntry& entry = s_callSites[i];
+        const csmChar* fileName = entry.FileName.load(std::memory_order_acquire);
+
+        if (fileName == NULL)
+        {
+            continue;
+        }
+
+        CubismAllocationCallSite& callSite = outCallSites[count++];
+        callSite.FileName = fileName;
+        callSite.LineNumber = entry.LineNumber.load(std::memory_order_relaxed);
+        callSite.AllocationCount = entry.AllocationCount.load(std::memory_order_relaxed);
+        callSite.AllocatedBytes = entry.AllocatedBytes.load(std::memory_order_relaxed);
+        callSite.LiveBlockCount = entry.LiveBlockCount.load(std::memory_order_relaxed);
+        callSite.LiveBytes = entry.LiveBytes.load(std::memory_order_relaxed);
+        callSite.PeakLiveBytes = entry.PeakLiveBytes.load(std::memory_order_relaxed);
+    }
+
+    return count;
+}
+
+void CubismAllocationStats::LogLiveCallSites()
+{
+    CubismLogInfo("Allocations: %llu, live blocks: %llu, live bytes: %llu, peak live bytes: %llu, copies: %llu",
+                  static_cast<unsigned long long>(s_allocationCount.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(s_liveBlockCount.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(s_liveBytes.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(s_peakLiveBytes.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(s_copyCount.load(std::memory_order_relaxed)));
+
+    for (csmInt32 i = 0; i < MaxCallSiteCount; ++i)
+    {
+        const CallSiteEntry& entry = s_callSites[i];
+        const csmChar* fileName = entry.FileName.load(std::memory_order_acquire);
+        const csmUint64 liveBlockCount = entry.LiveBlockCount.load(std::memory_order_relaxed);
+
+        if (fileName == NULL || liveBlockCount == 0)
+        {
+            continue;
+        }
+
+        CubismLogInfo("Live: %llu blocks, %llu bytes allocated at %s(%d)",
+                      static_cast<unsigned long long>(liveBlockCount),
+                      static_cast<unsigned long long>(entry.LiveBytes.load(std::memory_order_relaxed)),
+                      fileName, entry.LineNumber.load(std::memory_order_relaxed));
+    }
+}
+
+csmUint64 CubismAllocationStats::GetThreadAllocationCount()
+{
+    return s_threadAllocationCount;
+}
+
+csmUint64 CubismAllocationStats::GetThreadCopyCount()
+{
+    return s_threadCopyCount;
+}
+
+void CubismAllocationStats::CountCopy(csmSizeType bytes)
+{
+    s_copyCount.fetch_add(1, std::memory_order_relaxed);
+    s_copiedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    ++s_threadCopyCount;
+}
+
+csmSizeType CubismAllocationStats::GetOffset(csmUint32 alignment)
+{
+    // アラインメントを保つため、ヘッダの領域はアラインメントの倍数にする
+    return (alignment > HeaderSize) ? alignment : HeaderSize;
+}
+
+void* CubismAllocationStats::Attach(void* memory, csmSizeType size, csmSizeType offset, const csmChar* fileName, csmInt32 lineNumber)
+{
+    if (memory == NULL)
+    {
+        return NULL;
+    }
+
+    CSM_ASSERT(offset <= 0xFFFF);
+
+    csmByte* address = static_cast<csmByte*>(memory) + offset;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(address - HeaderSize);
+    const csmInt32 callSite = FindCallSite(fileName, lineNumber);
+
+    header->Size = size;
+    header->CallSite = callSite;
+    header->Offset = static_cast<csmUint16>(offset);
+
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    s_liveBlockCount.fetch_add(1, std::memory_order_relaxed);
+    UpdatePeak(s_peakLiveBytes, s_liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+
+    if (callSite >= 0)
+    {
+        CallSiteEntry& entry = s_callSites[callSite];
+        entry.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+        entry.AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        entry.LiveBlockCount.fetch_add(1, std::memory_order_relaxed);
+        UpdatePeak(entry.PeakLiveBytes, entry.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    }
+
+    ++s_threadAllocationCount;
+    s_threadLastFileName = fileName;
+    s_threadLastLineNumber = lineNumber;
+
+    return address;
+}
+
+void* CubismAllocationStats::Detach(void* address)
+{
+    csmByte* bytes = static_cast<csmByte*>(address);
+    const BlockHeader* header = reinterpret_cast<const BlockHeader*>(bytes - HeaderSize);
+
+    s_deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_liveBlockCount.fetch_sub(1, std::memory_order_relaxed);
+    s_liveBytes.fetch_sub(header->Size, std::memory_order_relaxed);
+
+    if (header->CallSite >= 0)
+    {
+        CallSiteEntry& entry = s_callSites[header->CallSite];
+        entry.LiveBlockCount.fetch_sub(1, std::memory_order_relaxed);
+        entry.LiveBytes.fetch_sub(header->Size, std::memory_order_relaxed);
+    }
+
+    return bytes - header->Offset;
+}
+
+CubismNoAllocationScope::CubismNoAllocationScope(const csmChar* name, csmBool assertsOnAllocation)
+    : _name(name)
+    , _assertsOnAllocation(assertsOnAllocation)
+    , _beginAllocationCount(s_threadAllocationCount)
+    , _beginCopyCount(s_threadCopyCount)
+{
+}
+
+CubismNoAllocationScope::~CubismNoAllocationScope()
+{
+    const csmUint64 allocationCount = GetAllocationCount();
+
+    if (allocationCount == 0)
+    {
+        return;
+    }
+
+    CubismLogError("%s: %llu allocations in a scope that must not allocate; the last one at %s(%d)",
+                   (_name != NULL) ? _name : "CubismNoAllocationScope", static_cast<unsigned long long>(allocationCount),
+                   (s_threadLastFileName != NULL) ? s_threadLastFileName : "", s_threadLastLineNumber);
+
+    if (_assertsOnAllocation)
+    {
+        CSM_ASSERT(allocationCount == 0);
+    }
+}
+
+csmUint64 CubismNoAllocationScope::GetAllocationCount() const
+{
+    return s_threadAllocationCount - _beginAllocationCount;
+}
+
+csmUint64 CubismNoAllocationScope::GetCopyCount() const
+{
+    return s_threadCopyCount - _beginCopyCount;
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,226 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+#ifdef CSM_ALLOCATION_STATS
+#define CSM_COUNT_COPY(bytes)   Live2D::Cubism::Framework::CubismAllocationStats::CountCopy(bytes)
+#else
+#define CSM_COUNT_COPY(bytes)
+#endif
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Allocation and copy counters of the whole process at one point in time.
+ */
+struct CubismAllocationSnapshot
+{
+    csmUint64 AllocationCount;      ///< Allocations made
+    csmUint64 DeallocationCount;    ///< Deallocations made
+    csmUint64 AllocatedBytes;       ///< Bytes requested by the allocations
+    csmUint64 LiveBlockCount;       ///< Blocks not deallocated yet
+    csmUint64 LiveBytes;            ///< Bytes of the live blocks
+    csmUint64 PeakLiveBytes;        ///< Highest LiveBytes since the last CubismAllocationStats::ResetPeak()
+    csmUint64 CopyCount;            ///< Copies of csmVector and csmString
+    csmUint64 CopiedBytes;          ///< Bytes copied by them
+};
+
+/**
+ * Allocation counters of one call site of CSM_MALLOC / CSM_NEW.
+ */
+struct CubismAllocationCallSite
+{
+    const csmChar* FileName;        ///< Source file of the call
+    csmInt32 LineNumber;            ///< Line of the call
+    csmUint64 AllocationCount;      ///< Allocations made
+    csmUint64 AllocatedBytes;       ///< Bytes requested by the allocations
+    csmUint64 LiveBlockCount;       ///< Blocks not deallocated yet
+    csmUint64 LiveBytes;            ///< Bytes of the live blocks
+    csmUint64 PeakLiveBytes;        ///< Highest LiveBytes
+};
+
+/**
+ * Counts the allocations of the framework, per call site and in total, and the copies of csmVector and csmString.
+ *
+ * A frame is measured by taking a snapshot before and after it and subtracting them with GetDifference().<br>
+ * Counters are atomic, so allocations of any thread are counted, including the workers of CubismThreadPool.
+ *
+ * @note Counting needs CSM_ALLOCATION_STATS to be defined in CubismFrameworkConfig.hpp.<br>
+ *       Without it, every counter stays 0 and CSM_COUNT_COPY() expands to nothing.
+ */
+class CubismAllocationStats
+{
+public:
+    static const csmSizeType HeaderSize = 16;           ///< Bytes of the header in front of a block
+    static const csmInt32 MaxCallSiteCount = 2048;      ///< Call sites counted separately; allocations of further sites are only counted in total
+
+    /**
+     * Returns whether allocations are counted in this build.
+     *
+     * @return true if CSM_ALLOCATION_STATS is defined
+     */
+    static csmBool IsEnabled();
+
+    /**
+     * Reads the counters of the process.
+     *
+     * @param outSnapshot receives the counters
+     */
+    static void GetSnapshot(CubismAllocationSnapshot& outSnapshot);
+
+    /**
+     * Subtracts two snapshots, such as the ones taken before and after a frame.
+     *
+     * @param begin earlier snapshot
+     * @param end later snapshot
+     * @param outDifference receives the counts made in between; LiveBlockCount, LiveBytes and PeakLiveBytes are those of end
+     */
+    static void GetDifference(const CubismAllocationSnapshot& begin, const CubismAllocationSnapshot& end, CubismAllocationSnapshot& outDifference);
+
+    /**
+     * Starts a new high-water mark of the live bytes at the current value, such as at the beginning of a frame.
+     */
+    static void ResetPeak();
+
+    /**
+     * Returns the number of call sites that have allocated.
+     *
+     * @return number of call sites, up to MaxCallSiteCount
+     */
+    static csmInt32 GetCallSiteCount();
+
+    /**
+     * Reads the counters of the call sites.
+     *
+     * @param outCallSites receives the call sites, in no particular order
+     * @param capacity number of elements of outCallSites
+     *
+     * @return number of call sites written
+     */
+    static csmInt32 GetCallSites(CubismAllocationCallSite* outCallSites, csmInt32 capacity);
+
+    /**
+     * Logs the call sites that still have live blocks, such as at the termination of the framework.
+     */
+    static void LogLiveCallSites();
+
+    /**
+     * Returns the allocations made by the calling thread.
+     *
+     * @return number of allocations since the thread started
+     */
+    static csmUint64 GetThreadAllocationCount();
+
+    /**
+     * Returns the copies made by the calling thread.
+     *
+     * @return number of copies of csmVector and csmString since the thread started
+     */
+    static csmUint64 GetThreadCopyCount();
+
+    /**
+     * Counts a copy of a container. Used through CSM_COUNT_COPY().
+     *
+     * @param bytes bytes copied
+     */
+    static void CountCopy(csmSizeType bytes);
+
+    /**
+     * Gets the bytes to reserve in front of a block.
+     *
+     * @param alignment alignment of the block; 0 for the default alignment
+     *
+     * @return bytes in front of the block; a multiple of the alignment
+     *
+     * @note Used by CubismFramework::Allocate() and its relatives; applications do not call it.
+     */
+    static csmSizeType GetOffset(csmUint32 alignment);
+
+    /**
+     * Writes the header of a block and counts the allocation.
+     *
+     * @param memory memory returned by the allocator; NULL is passed through
+     * @param size size requested by the caller
+     * @param offset value returned by GetOffset()
+     * @param fileName source file of the call
+     * @param lineNumber line of the call
+     *
+     * @return address handed to the caller
+     *
+     * @note Used by CubismFramework::Allocate() and its relatives; applications do not call it.
+     */
+    static void* Attach(void* memory, csmSizeType size, csmSizeType offset, const csmChar* fileName, csmInt32 lineNumber);
+
+    /**
+     * Counts the deallocation of a block.
+     *
+     * @param address address returned by Attach()
+     *
+     * @return memory to return to the allocator
+     *
+     * @note Used by CubismFramework::Deallocate() and its relatives; applications do not call it.
+     */
+    static void* Detach(void* address);
+};
+
+/**
+ * Checks that the calling thread does not allocate while the scope is alive.
+ *
+ * Use it around code that must be allocation-free, such as the update of a model in a steady-state frame:<br>
+ * tests read GetAllocationCount(), and the destructor logs the last offending call site and asserts.
+ *
+ * @note Only allocations of the calling thread are counted. Without CSM_ALLOCATION_STATS, nothing is counted.
+ */
+class CubismNoAllocationScope
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param name name of the scope used in the log
+     * @param assertsOnAllocation true to CSM_ASSERT() on destruction if the scope allocated
+     */
+    CubismNoAllocationScope(const csmChar* name, csmBool assertsOnAllocation = true);
+
+    /**
+     * Destructor
+     *
+     * Logs an error if the scope allocated.
+     */
+    ~CubismNoAllocationScope();
+
+    /**
+     * Returns the allocations made by the calling thread since the scope began.
+     *
+     * @return number of allocations
+     */
+    csmUint64 GetAllocationCount() const;
+
+    /**
+     * Returns the copies made by the calling thread since the scope began.
+     *
+     * @return number of copies of csmVector and csmString
+     */
+    csmUint64 GetCopyCount() const;
+
+private:
+    // Prevention of copy Constructor
+    CubismNoAllocationScope(const CubismNoAllocationScope&);
+    CubismNoAllocationScope& operator=(const CubismNoAllocationScope&);
+
+    const csmChar* _name;               ///< Name used in the log
+    csmBool _assertsOnAllocation;       ///< true to assert on destruction if the scope allocated
+    csmUint64 _beginAllocationCount;    ///< Allocations of the thread when the scope began
+    csmUint64 _beginCopyCount;          ///< Copies of the thread when the scope began
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,134 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismContentHash.hpp"
+#include <cstring>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+const csmUint64 C1 = 0x87c37b91114253d5ULL;
+const csmUint64 C2 = 0x4cf5ad432745937fULL;
+
+inline csmUint64 RotateLeft(csmUint64 value, csmInt32 shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+inline csmUint64 MixKey1(csmUint64 k1)
+{
+    k1 *= C1;
+    k1 = RotateLeft(k1, 31);
+    k1 *= C2;
+    return k1;
+}
+
+inline csmUint64 MixKey2(csmUint64 k2)
+{
+    k2 *= C2;
+    k2 = RotateLeft(k2, 33);
+    k2 *= C1;
+    return k2;
+}
+
+inline csmUint64 Finalize(csmUint64 h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+CubismContentHash CubismContentHash::Compute(const csmByte* buffer, csmSizeType size)
+{
+    csmUint64 h1 = 0;
+    csmUint64 h2 = 0;
+
+    // 16バイトずつ畳み込む。MOCは数十MBになるので、1バイトずつは処理しない
+    const csmSizeType blockCount = size / 16;
+
+    for (csmSizeType i = 0; i < blockCount; ++i)
+    {
+        csmUint64 k1;
+        csmUint64 k2;
+        memcpy(&k1, buffer + i * 16, sizeof(csmUint64));
+        memcpy(&k2, buffer + i * 16 + 8, sizeof(csmUint64));
+
+        h1 ^= MixKey1(k1);
+        h1 = RotateLeft(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        h2 ^= MixKey2(k2);
+        h2 = RotateLeft(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // 残りのバイト
+    const csmByte* tail = buffer + blockCount * 16;
+    const csmSizeType tailSize = size & 15;
+    csmUint64 k1 = 0;
+    csmUint64 k2 = 0;
+
+    for (csmSizeType i = tailSize; i > 8; --i)
+    {
+        k2 ^= static_cast<csmUint64>(tail[i - 1]) << ((i - 9) * 8);
+    }
+
+    for (csmSizeType i = (tailSize < 8) ? tailSize : 8; i > 0; --i)
+    {
+        k1 ^= static_cast<csmUint64>(tail[i - 1]) << ((i - 1) * 8);
+    }
+
+    if (tailSize > 8)
+    {
+        h2 ^= MixKey2(k2);
+    }
+
+    if (tailSize > 0)
+    {
+        h1 ^= MixKey1(k1);
+    }
+
+    h1 ^= static_cast<csmUint64>(size);
+    h2 ^= static_cast<csmUint64>(size);
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = Finalize(h1);
+    h2 = Finalize(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    CubismContentHash hash;
+    hash.High = h2;
+    hash.Low = h1;
+
+    return hash;
+}
+
+csmBool CubismContentHash::operator==(const CubismContentHash& rhs) const
+{
+    return High == rhs.High && Low == rhs.Low;
+}
+
+csmBool CubismContentHash::operator!=(const CubismContentHash& rhs) const
+{
+    return !(*this == rhs);
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,58 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * 128-bit hash of the content of a file, used by the caches to recognize a file loaded again under any path.
+ *
+ * The hash is MurmurHash3 x64_128. It is not cryptographic, but the caches also compare the size,<br>
+ * and two files of the same size colliding on 128 bits is unlikely enough to share data without keeping the bytes to compare.
+ *
+ * @note The hash depends on the byte order of the platform, so it is not meant to be stored.
+ */
+struct CubismContentHash
+{
+    csmUint64 High;     ///< Upper 64 bits
+    csmUint64 Low;      ///< Lower 64 bits
+
+    /**
+     * Computes the hash of a buffer.
+     *
+     * @param buffer buffer to hash
+     * @param size size of the buffer in bytes
+     *
+     * @return hash of the buffer
+     */
+    static CubismContentHash Compute(const csmByte* buffer, csmSizeType size);
+
+    /**
+     * Compares two hashes.
+     *
+     * @param rhs hash to compare with
+     *
+     * @return true if the hashes are equal
+     */
+    csmBool operator==(const CubismContentHash& rhs) const;
+
+    /**
+     * Compares two hashes.
+     *
+     * @param rhs hash to compare with
+     *
+     * @return true if the hashes differ
+     */
+    csmBool operator!=(const CubismContentHash& rhs) const;
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
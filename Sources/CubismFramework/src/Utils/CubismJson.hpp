@@ -210,7 +210,11 @@ public:
      *@brief Valueにエラー値をセットする
      */
     virtual Value* SetErrorNotForClientCall(const csmChar* errorStr) {
-        this->_stringBuffer = errorStr;
+        // 静的な値は複数のスレッドから同時に返されるので書き換えない
+        if (!IsStatic())
+        {
+            this->_stringBuffer = errorStr;
+        }
         return NullValue;
     }
 
@@ -247,7 +251,8 @@ class CubismJson
 public:
     /**
      * @brief  バイトデータから直接ロードしてパースする<br>
-     *          引数 buffer は外部で管理（破棄）する必要がある
+     *          引数 buffer は外部で管理（破棄）する必要がある<br>
+     *          buffer は複製せず、終端の'\0'も不要なので、メモリマップしたファイルをそのまま渡せる。パース後は参照しない。
      *
      * @param   buffer  ->  バイトデータのバッファ
      * @param   size    ->  バッファサイズ
@@ -617,7 +622,11 @@ public:
     */
     virtual Value* SetErrorNotForClientCall(const csmChar* s)
     {
-        this->_stringBuffer = s;
+        // 静的な値は複数のスレッドから同時に返されるので書き換えない
+        if (!_isStatic)
+        {
+            this->_stringBuffer = s;
+        }
         return this;
     }
 
@@ -805,12 +814,7 @@ public:
      */
     virtual Value& operator[](const csmString& s)
     {
-        Value* ret = _map[s];
-        if (ret == NULL)
-        {
-            return *Value::NullValue;
-        }
-        return *ret;
+        return Find(csmStringView(s));
     }
 
     /**
@@ -819,19 +823,7 @@ public:
      */
     virtual Value& operator[](const csmChar* s)
     {
-        for (csmMap<csmString, Value*>::const_iterator iter = _map.Begin(); iter != _map.End(); ++iter)
-        {
-            if( strcmp(iter->First.GetRawString(), s) == 0 )
-            {
-                if(iter->Second==NULL)
-                {
-                    return *Value::NullValue;
-                }
-                return *iter->Second;
-            }
-        }
-
-        return *Value::NullValue;
+        return Find(csmStringView(s));
     }
 
     /**
@@ -899,6 +891,31 @@ public:
     virtual csmInt32 GetSize() { return static_cast<csmInt32>(_keys->GetSize()); }
 
 private:
+    /**
+     * @brief   キーに対応する要素を探す<br>
+     *           見つからなくても要素は追加しない。キーのハッシュ値で異なるキーを先に除外する。
+     *
+     * @param[in]   key ->  探すキー
+     *
+     * @return  キーに対応する要素。見つからない場合はNullValue
+     */
+    Value& Find(const csmStringView& key)
+    {
+        for (csmMap<csmString, Value*>::const_iterator iter = _map.Begin(); iter != _map.End(); ++iter)
+        {
+            if (iter->First == key)
+            {
+                if (iter->Second == NULL)
+                {
+                    return *Value::NullValue;
+                }
+                return *iter->Second;
+            }
+        }
+
+        return *Value::NullValue;
+    }
+
     csmMap<csmString, Value*> _map;     ///< JSON要素の値
     csmVector<csmString>* _keys;        ///< JSON要素の値
 };
@@ -0,0 +1,221 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMemoryTracker.hpp"
+#include "CubismDebug.hpp"
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+/**
+ * Tag in front of a block.
+ */
+struct BlockHeader
+{
+    CubismMemoryAccount* Account;   ///< Account charged; NULL if uncharged
+    csmUint32 Size;                 ///< Size requested by the caller
+    csmUint16 Offset;               ///< Bytes from the start of the allocator's memory to the block
+    csmUint16 Category;             ///< Category charged
+};
+
+/**
+ * Scope active on a thread.
+ */
+struct ThreadScope
+{
+    CubismMemoryAccount* Account;
+    CubismMemoryCategory Category;
+};
+
+thread_local ThreadScope s_currentScope = { NULL, CubismMemoryCategory_Other };
+
+const csmChar* CategoryNames[CubismMemoryCategory_Count] =
+{
+    "Other",
+    "Moc",
+    "Model",
+    "Motion",
+    "Expression",
+    "Physics",
+    "Pose",
+    "UserData",
+    "Renderer",
+    "Texture",
+};
+
+}
+
+CubismMemoryAccount* CubismMemoryAccount::Create()
+{
+    // アカウント自身はどこにも計上しない
+    CubismMemoryScope scope(NULL, CubismMemoryCategory_Other);
+    return CSM_NEW CubismMemoryAccount();
+}
+
+csmBool CubismMemoryAccount::IsTrackingEnabled()
+{
+#ifdef CSM_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+const csmChar* CubismMemoryAccount::GetCategoryName(CubismMemoryCategory category)
+{
+    if (category < 0 || category >= CubismMemoryCategory_Count)
+    {
+        return "";
+    }
+    return CategoryNames[category];
+}
+
+CubismMemoryAccount::CubismMemoryAccount()
+    : _referenceCount(1)
+    , _arena(NULL)
+{
+    for (csmInt32 i = 0; i < CubismMemoryCategory_Count; ++i)
+    {
+        _trackedBytes[i].store(0, std::memory_order_relaxed);
+        _trackedBlocks[i].store(0, std::memory_order_relaxed);
+        _externalBytes[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void CubismMemoryAccount::Retain()
+{
+    _referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CubismMemoryAccount::Release()
+{
+    if (_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        SetArena(NULL);
+        CSM_DELETE(this);
+    }
+}
+
+csmSizeType CubismMemoryAccount::GetTrackedBytes(CubismMemoryCategory category) const
+{
+    return _trackedBytes[category].load(std::memory_order_relaxed);
+}
+
+csmSizeType CubismMemoryAccount::GetTrackedBlockCount(CubismMemoryCategory category) const
+{
+    return _trackedBlocks[category].load(std::memory_order_relaxed);
+}
+
+void CubismMemoryAccount::SetExternalBytes(CubismMemoryCategory category, csmSizeType bytes)
+{
+    _externalBytes[category].store(bytes, std::memory_order_relaxed);
+}
+
+csmSizeType CubismMemoryAccount::GetExternalBytes(CubismMemoryCategory category) const
+{
+    return _externalBytes[category].load(std::memory_order_relaxed);
+}
+
+void CubismMemoryAccount::SetArena(CubismPoolAllocator::Arena* arena)
+{
+    if (_arena != arena)
+    {
+        CubismPoolAllocator::DeleteArena(_arena);
+        _arena = arena;
+    }
+}
+
+CubismPoolAllocator::Arena* CubismMemoryAccount::GetArena() const
+{
+    return _arena;
+}
+
+void CubismMemoryAccount::GetReport(CubismMemoryReport& outReport) const
+{
+    outReport.TotalBytes = 0;
+    outReport.IsTracked = IsTrackingEnabled();
+
+    for (csmInt32 i = 0; i < CubismMemoryCategory_Count; ++i)
+    {
+        outReport.Bytes[i] = _trackedBytes[i].load(std::memory_order_relaxed) + _externalBytes[i].load(std::memory_order_relaxed);
+        outReport.BlockCounts[i] = _trackedBlocks[i].load(std::memory_order_relaxed);
+        outReport.TotalBytes += outReport.Bytes[i];
+    }
+}
+
+CubismMemoryScope::CubismMemoryScope(CubismMemoryAccount* account, CubismMemoryCategory category)
+    : _previousAccount(s_currentScope.Account)
+    , _previousCategory(s_currentScope.Category)
+    , _arenaScope((account != NULL) ? account->GetArena() : NULL)
+{
+    s_currentScope.Account = account;
+    s_currentScope.Category = category;
+}
+
+CubismMemoryScope::~CubismMemoryScope()
+{
+    s_currentScope.Account = _previousAccount;
+    s_currentScope.Category = _previousCategory;
+}
+
+csmSizeType CubismMemoryTracker::GetOffset(csmUint32 alignment)
+{
+    // アラインメントを保つため、タグの領域はアラインメントの倍数にする
+    return (alignment > HeaderSize) ? alignment : HeaderSize;
+}
+
+void* CubismMemoryTracker::Attach(void* memory, csmSizeType size, csmSizeType offset)
+{
+    if (memory == NULL)
+    {
+        return NULL;
+    }
+
+    CSM_ASSERT(offset <= 0xFFFF);
+
+    csmByte* address = static_cast<csmByte*>(memory) + offset;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(address - HeaderSize);
+    CubismMemoryAccount* account = s_currentScope.Account;
+
+    header->Account = account;
+    header->Size = static_cast<csmUint32>(size);
+    header->Offset = static_cast<csmUint16>(offset);
+    header->Category = static_cast<csmUint16>(s_currentScope.Category);
+
+    if (account != NULL)
+    {
+        account->Retain();
+        account->_trackedBytes[header->Category].fetch_add(size, std::memory_order_relaxed);
+        account->_trackedBlocks[header->Category].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return address;
+}
+
+void* CubismMemoryTracker::Detach(void* address)
+{
+    csmByte* bytes = static_cast<csmByte*>(address);
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(bytes - HeaderSize);
+    CubismMemoryAccount* account = header->Account;
+    void* memory = bytes - header->Offset;
+
+    if (account != NULL)
+    {
+        account->_trackedBytes[header->Category].fetch_sub(header->Size, std::memory_order_relaxed);
+        account->_trackedBlocks[header->Category].fetch_sub(1, std::memory_order_relaxed);
+
+        // アカウントの破棄でこの関数が再び呼ばれても、このブロックのタグはもう読まない
+        account->Release();
+    }
+
+    return memory;
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,250 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "CubismPoolAllocator.hpp"
+#include <atomic>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Subsystems that memory is charged to.
+ */
+enum CubismMemoryCategory
+{
+    CubismMemoryCategory_Other = 0,     ///< Anything not covered by the other categories
+    CubismMemoryCategory_Moc,           ///< MOC buffer
+    CubismMemoryCategory_Model,         ///< Model buffer and its parameter/part/drawable caches
+    CubismMemoryCategory_Motion,        ///< Motions and their parsed data
+    CubismMemoryCategory_Expression,    ///< Expressions
+    CubismMemoryCategory_Physics,       ///< Physics rig
+    CubismMemoryCategory_Pose,          ///< Pose
+    CubismMemoryCategory_UserData,      ///< User data
+    CubismMemoryCategory_Renderer,      ///< Renderer
+    CubismMemoryCategory_Texture,       ///< Textures; reported by the application through SetExternalBytes()
+    CubismMemoryCategory_Count          ///< Number of categories
+};
+
+/**
+ * Memory used by a model, broken down by category.
+ */
+struct CubismMemoryReport
+{
+    csmSizeType Bytes[CubismMemoryCategory_Count];          ///< Bytes of each category; tagged blocks plus external bytes
+    csmSizeType BlockCounts[CubismMemoryCategory_Count];    ///< Number of tagged blocks of each category
+    csmSizeType TotalBytes;                                 ///< Sum of Bytes
+    csmBool IsTracked;                                      ///< false if allocations are not tagged in this build and only the known buffers are counted
+};
+
+/**
+ * Per-category memory usage of an owner such as a model.
+ *
+ * Blocks allocated through CSM_MALLOC / CSM_NEW while a CubismMemoryScope of the account is active on the<br>
+ * allocating thread are charged to it until they are released, whichever thread releases them.<br>
+ * Memory that the framework does not allocate itself, such as GPU textures, is reported with SetExternalBytes().
+ *
+ * @note Tagging needs CSM_MEMORY_TRACKING to be defined in CubismFrameworkConfig.hpp.<br>
+ *       Without it, GetTrackedBytes() returns 0 and only the external bytes are known.
+ */
+class CubismMemoryAccount
+{
+public:
+    /**
+     * Makes an account.
+     *
+     * @return Made account; the caller holds one reference
+     */
+    static CubismMemoryAccount* Create();
+
+    /**
+     * Returns whether allocations are tagged in this build.
+     *
+     * @return true if CSM_MEMORY_TRACKING is defined
+     */
+    static csmBool IsTrackingEnabled();
+
+    /**
+     * Returns the name of a category.
+     *
+     * @param category category
+     *
+     * @return name of the category
+     */
+    static const csmChar* GetCategoryName(CubismMemoryCategory category);
+
+    /**
+     * Adds a reference.
+     */
+    void Retain();
+
+    /**
+     * Removes a reference and destroys the account at the last one.
+     *
+     * @note Every block charged to the account holds a reference, so an account outlives the blocks charged to it.
+     */
+    void Release();
+
+    /**
+     * Gets the bytes of the live blocks charged to a category.
+     *
+     * @param category category
+     *
+     * @return bytes requested by the live blocks, excluding the allocator's own overhead
+     */
+    csmSizeType GetTrackedBytes(CubismMemoryCategory category) const;
+
+    /**
+     * Gets the number of live blocks charged to a category.
+     *
+     * @param category category
+     *
+     * @return number of live blocks
+     */
+    csmSizeType GetTrackedBlockCount(CubismMemoryCategory category) const;
+
+    /**
+     * Sets the bytes a category uses outside the framework allocator.
+     *
+     * @param category category
+     * @param bytes bytes in use; replaces the previous value
+     */
+    void SetExternalBytes(CubismMemoryCategory category, csmSizeType bytes);
+
+    /**
+     * Gets the bytes a category uses outside the framework allocator.
+     *
+     * @param category category
+     *
+     * @return bytes set by SetExternalBytes()
+     */
+    csmSizeType GetExternalBytes(CubismMemoryCategory category) const;
+
+    /**
+     * Fills a report with the usage of the account.
+     *
+     * @param outReport receives the usage
+     */
+    void GetReport(CubismMemoryReport& outReport) const;
+
+    /**
+     * Sets the arena that the small allocations charged to the account are served from.
+     *
+     * @param arena arena made by CubismPoolAllocator::CreateArena(); the account destroys it with<br>
+     *              CubismPoolAllocator::DeleteArena() when it is replaced or the account is destroyed. NULL for none.
+     *
+     * @note Set it while no CubismMemoryScope of the account is alive.
+     */
+    void SetArena(CubismPoolAllocator::Arena* arena);
+
+    /**
+     * Gets the arena set by SetArena().
+     *
+     * @return arena; NULL if none is set
+     */
+    CubismPoolAllocator::Arena* GetArena() const;
+
+private:
+    friend class CubismMemoryTracker;
+
+    /**
+     * Constructor
+     *
+     * @note The reference count starts at 1, owned by the creator.
+     */
+    CubismMemoryAccount();
+
+    // Prevention of copy Constructor
+    CubismMemoryAccount(const CubismMemoryAccount&);
+    CubismMemoryAccount& operator=(const CubismMemoryAccount&);
+
+    std::atomic<csmSizeType> _trackedBytes[CubismMemoryCategory_Count];     ///< Bytes of the live blocks of each category
+    std::atomic<csmSizeType> _trackedBlocks[CubismMemoryCategory_Count];    ///< Number of live blocks of each category
+    std::atomic<csmSizeType> _externalBytes[CubismMemoryCategory_Count];    ///< Bytes reported by the application
+    std::atomic<csmInt32> _referenceCount;                                  ///< Number of references
+    CubismPoolAllocator::Arena* _arena;                                     ///< Arena the small allocations are served from
+};
+
+/**
+ * Charges the allocations of the calling thread to an account while the scope is alive.
+ *
+ * Small allocations are also served from the arena of the account, if it has one.
+ *
+ * @note Scopes nest; the innermost one wins and the enclosing one is restored on destruction.
+ */
+class CubismMemoryScope
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param account account to charge; NULL leaves the allocations uncharged, such as data shared by every model
+     * @param category category to charge
+     */
+    CubismMemoryScope(CubismMemoryAccount* account, CubismMemoryCategory category);
+
+    /**
+     * Destructor
+     *
+     * Restores the scope that was active before.
+     */
+    ~CubismMemoryScope();
+
+private:
+    // Prevention of copy Constructor
+    CubismMemoryScope(const CubismMemoryScope&);
+    CubismMemoryScope& operator=(const CubismMemoryScope&);
+
+    CubismMemoryAccount* _previousAccount;      ///< Account of the enclosing scope
+    CubismMemoryCategory _previousCategory;     ///< Category of the enclosing scope
+    CubismPoolAllocator::ArenaScope _arenaScope;  ///< Serves the allocations from the arena of the account
+};
+
+/**
+ * Writes and reads the tag placed in front of every block when CSM_MEMORY_TRACKING is defined.
+ *
+ * @note Used by CubismFramework::Allocate() and its relatives; applications do not call it.
+ */
+class CubismMemoryTracker
+{
+public:
+    static const csmSizeType HeaderSize = 16;   ///< Bytes of the tag in front of a block
+
+    /**
+     * Gets the bytes to reserve in front of a block.
+     *
+     * @param alignment alignment of the block; 0 for the default alignment
+     *
+     * @return bytes in front of the block; a multiple of the alignment
+     */
+    static csmSizeType GetOffset(csmUint32 alignment);
+
+    /**
+     * Tags a block and charges it to the account of the calling thread.
+     *
+     * @param memory memory returned by the allocator; NULL is passed through
+     * @param size size requested by the caller
+     * @param offset value returned by GetOffset()
+     *
+     * @return address handed to the caller
+     */
+    static void* Attach(void* memory, csmSizeType size, csmSizeType offset);
+
+    /**
+     * Uncharges a block.
+     *
+     * @param address address returned by Attach()
+     *
+     * @return memory to return to the allocator
+     */
+    static void* Detach(void* address);
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,770 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismPoolAllocator.hpp"
+#include <cstdlib>
+#include <new>
+#include "Utils/CubismDebug.hpp"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+const csmSizeType SpanHeaderSize = 64;      ///< Bytes at the start of a span kept for its header
+const csmSizeType MinAlignment = 16;        ///< Alignment of every block
+const csmSizeType ThreadCacheBytes = 16384; ///< Bytes moved between a thread cache and a shared list at once
+const csmSizeType ArenaPageCount = CubismPoolAllocator::SpanSize / CubismPoolAllocator::PageSize;   ///< Pages of an arena span
+const csmSizeType ArenaRunBlockCount = 8;   ///< Blocks an arena run should hold at least
+
+enum SpanKind
+{
+    SpanKind_Small = 0,     ///< Blocks of a size class
+    SpanKind_Large,         ///< A single block
+    SpanKind_Arena,         ///< Runs of pages owned by an arena
+};
+
+std::mutex s_liveAllocatorsMutex;           ///< Guards the list of live allocators
+CubismPoolAllocator* s_liveAllocators = NULL;
+csmUint64 s_nextAllocatorId = 1;
+thread_local CubismPoolAllocator::Arena* s_currentArena = NULL;   ///< Arena of the innermost ArenaScope of the thread
+
+csmSizeType AlignUp(csmSizeType value, csmSizeType alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void* AllocateSystemMemory(csmSizeType size)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(size, CubismPoolAllocator::SpanSize);
+#else
+    void* memory = NULL;
+    if (posix_memalign(&memory, CubismPoolAllocator::SpanSize, size) != 0)
+    {
+        return NULL;
+    }
+    return memory;
+#endif
+}
+
+void DeallocateSystemMemory(void* memory)
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+/**
+ * Number of blocks moved between a thread cache and a shared list at once.
+ */
+csmUint32 GetBatchCount(csmInt32 sizeClass)
+{
+    csmSizeType count = ThreadCacheBytes / CubismPoolAllocator::GetSizeClassSize(sizeClass);
+    if (count < 4)
+    {
+        count = 4;
+    }
+    else if (count > 64)
+    {
+        count = 64;
+    }
+    return static_cast<csmUint32>(count);
+}
+
+}
+
+struct CubismPoolAllocator::SpanHeader
+{
+    csmInt32 Kind;                          ///< SpanKind
+    csmInt32 SizeClass;                     ///< Size class of a small span
+    csmSizeType Size;                       ///< Bytes taken from the system
+    csmSizeType BlockSize;                  ///< Requested size of a large span
+    SpanHeader* Next;                       ///< Next span of the same size class or arena
+    Arena* Owner;                           ///< Arena of an arena span
+    csmUint8 PageClasses[ArenaPageCount];   ///< Size class of each page of an arena span
+};
+
+struct CubismPoolAllocator::Arena
+{
+    Arena(CubismPoolAllocator* allocator)
+        : Allocator(allocator)
+        , Spans(NULL)
+        , NextPage(ArenaPageCount)
+        , BlockCount(0)
+        , IsClosed(false)
+        , IsDeleted(false)
+    {
+        for (csmInt32 i = 0; i < SizeClassCount; ++i)
+        {
+            Heads[i] = NULL;
+        }
+    }
+
+    /**
+     * Returns every span of the arena to the system.
+     *
+     * @note The mutex is held by the caller and no block of the arena is alive.
+     */
+    void ReleaseSpans()
+    {
+        while (Spans != NULL)
+        {
+            SpanHeader* next = Spans->Next;
+            Allocator->DeallocateSpan(Spans);
+            Spans = next;
+        }
+
+        for (csmInt32 i = 0; i < SizeClassCount; ++i)
+        {
+            Heads[i] = NULL;
+        }
+        NextPage = ArenaPageCount;
+    }
+
+    /**
+     * Destroys the arena.
+     */
+    static void Destroy(Arena* arena)
+    {
+        arena->~Arena();
+        std::free(arena);
+    }
+
+    CubismPoolAllocator* Allocator;     ///< Allocator the spans are taken from
+    std::mutex Mutex;                   ///< Guards the members below
+    void* Heads[SizeClassCount];        ///< First free block of each size class
+    SpanHeader* Spans;                  ///< Spans of the arena; runs are carved from the first one
+    csmSizeType NextPage;               ///< First page of the first span not carved yet
+    csmSizeType BlockCount;             ///< Number of blocks handed out and not released yet
+    csmBool IsClosed;                   ///< True after CloseArena()
+    csmBool IsDeleted;                  ///< True after DeleteArena()
+};
+
+struct CubismPoolAllocator::ThreadCache
+{
+    ThreadCache()
+        : Allocator(NULL)
+        , AllocatorId(0)
+    {
+        for (csmInt32 i = 0; i < SizeClassCount; ++i)
+        {
+            Heads[i] = NULL;
+            Counts[i] = 0;
+        }
+    }
+
+    ~ThreadCache()
+    {
+        Detach();
+    }
+
+    /**
+     * Gives the cached blocks back to the allocator if it is still alive and unbinds the cache.
+     */
+    void Detach()
+    {
+        if (AllocatorId != 0)
+        {
+            std::lock_guard<std::mutex> lock(s_liveAllocatorsMutex);
+
+            for (CubismPoolAllocator* allocator = s_liveAllocators; allocator != NULL; allocator = allocator->_nextLive)
+            {
+                if (allocator != Allocator || allocator->_id != AllocatorId)
+                {
+                    continue;
+                }
+
+                for (csmInt32 i = 0; i < SizeClassCount; ++i)
+                {
+                    if (Counts[i] > 0)
+                    {
+                        allocator->ReleaseThreadCache(*this, i, Counts[i]);
+                    }
+                }
+                break;
+            }
+        }
+
+        // 破棄済みのアロケータのブロックは解放済みのメモリなので、リストをたどらずに捨てる
+        for (csmInt32 i = 0; i < SizeClassCount; ++i)
+        {
+            Heads[i] = NULL;
+            Counts[i] = 0;
+        }
+        Allocator = NULL;
+        AllocatorId = 0;
+    }
+
+    CubismPoolAllocator* Allocator;     ///< Allocator the blocks belong to
+    csmUint64 AllocatorId;              ///< Id of the allocator; 0 when unbound
+    void* Heads[SizeClassCount];        ///< First free block of each size class
+    csmUint32 Counts[SizeClassCount];   ///< Number of free blocks of each size class
+};
+
+CubismPoolAllocator::CubismPoolAllocator(csmBool isStatsEnabled)
+    : _isStatsEnabled(isStatsEnabled)
+    , _liveBytes(0)
+    , _peakBytes(0)
+    , _reservedBytes(0)
+    , _deallocationCount(0)
+    , _largeCount(0)
+    , _arenaCount(0)
+{
+    for (csmInt32 i = 0; i < SizeClassCount; ++i)
+    {
+        _sharedLists[i].Head = NULL;
+        _sharedLists[i].Spans = NULL;
+        _sizeClassCounts[i].store(0);
+    }
+
+    std::lock_guard<std::mutex> lock(s_liveAllocatorsMutex);
+    _id = s_nextAllocatorId++;
+    _nextLive = s_liveAllocators;
+    s_liveAllocators = this;
+}
+
+CubismPoolAllocator::~CubismPoolAllocator()
+{
+    {
+        // リストから外した後は、どのスレッドのキャッシュもこのアロケータにブロックを返さない
+        std::lock_guard<std::mutex> lock(s_liveAllocatorsMutex);
+        for (CubismPoolAllocator** link = &s_liveAllocators; *link != NULL; link = &(*link)->_nextLive)
+        {
+            if (*link == this)
+            {
+                *link = _nextLive;
+                break;
+            }
+        }
+    }
+
+    for (csmInt32 i = 0; i < SizeClassCount; ++i)
+    {
+        SpanHeader* span = _sharedLists[i].Spans;
+        while (span != NULL)
+        {
+            SpanHeader* next = span->Next;
+            DeallocateSpan(span);
+            span = next;
+        }
+        _sharedLists[i].Head = NULL;
+        _sharedLists[i].Spans = NULL;
+    }
+}
+
+CubismPoolAllocator::ArenaScope::ArenaScope(Arena* arena)
+    : _previousArena(s_currentArena)
+{
+    s_currentArena = arena;
+}
+
+CubismPoolAllocator::ArenaScope::~ArenaScope()
+{
+    s_currentArena = _previousArena;
+}
+
+void* CubismPoolAllocator::Allocate(const csmSizeType size)
+{
+    if (size <= MaxSmallSize)
+    {
+        // 閉じたアリーナのスコープや別のアロケータのアリーナでは共有のプールから割り当てる
+        Arena* arena = s_currentArena;
+        if (arena != NULL && arena->Allocator == this)
+        {
+            void* block = AllocateFromArena(*arena, size);
+            if (block != NULL)
+            {
+                return block;
+            }
+        }
+
+        return AllocateSmall(size);
+    }
+
+    return AllocateLarge(size, MinAlignment);
+}
+
+void CubismPoolAllocator::Deallocate(void* memory)
+{
+    if (memory == NULL)
+    {
+        return;
+    }
+
+    DeallocateBlock(memory);
+}
+
+void* CubismPoolAllocator::AllocateAligned(const csmSizeType size, const csmUint32 alignment)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > MaxAlignment)
+    {
+        CubismLogError("CubismPoolAllocator: alignment %u is not supported.", alignment);
+        return NULL;
+    }
+
+    if (alignment <= MinAlignment)
+    {
+        return Allocate(size);
+    }
+
+    return AllocateLarge(size, alignment);
+}
+
+void CubismPoolAllocator::DeallocateAligned(void* alignedMemory)
+{
+    if (alignedMemory == NULL)
+    {
+        return;
+    }
+
+    DeallocateBlock(alignedMemory);
+}
+
+void CubismPoolAllocator::FlushThreadCache()
+{
+    ThreadCache& cache = GetThreadCache();
+
+    for (csmInt32 i = 0; i < SizeClassCount; ++i)
+    {
+        if (cache.Counts[i] > 0)
+        {
+            ReleaseThreadCache(cache, i, cache.Counts[i]);
+        }
+    }
+}
+
+void CubismPoolAllocator::GetStats(Stats& outStats) const
+{
+    outStats.LiveBytes = _liveBytes.load(std::memory_order_relaxed);
+    outStats.PeakBytes = _peakBytes.load(std::memory_order_relaxed);
+    outStats.ReservedBytes = _reservedBytes.load(std::memory_order_relaxed);
+    outStats.DeallocationCount = _deallocationCount.load(std::memory_order_relaxed);
+    outStats.LargeAllocationCount = _largeCount.load(std::memory_order_relaxed);
+    outStats.ArenaAllocationCount = _arenaCount.load(std::memory_order_relaxed);
+
+    outStats.AllocationCount = outStats.LargeAllocationCount + outStats.ArenaAllocationCount;
+    for (csmInt32 i = 0; i < SizeClassCount; ++i)
+    {
+        outStats.SizeClassAllocationCounts[i] = _sizeClassCounts[i].load(std::memory_order_relaxed);
+        outStats.AllocationCount += outStats.SizeClassAllocationCounts[i];
+    }
+}
+
+CubismPoolAllocator::Arena* CubismPoolAllocator::CreateArena()
+{
+    void* memory = std::malloc(sizeof(Arena));
+    if (memory == NULL)
+    {
+        CubismLogError("CubismPoolAllocator: failed to allocate an arena.");
+        return NULL;
+    }
+
+    return new(memory) Arena(this);
+}
+
+void CubismPoolAllocator::CloseArena(Arena* arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(arena->Mutex);
+    arena->IsClosed = true;
+
+    // 生きているブロックがあれば、最後のブロックの解放時にまとめて返す
+    if (arena->BlockCount == 0)
+    {
+        arena->ReleaseSpans();
+    }
+}
+
+void CubismPoolAllocator::DeleteArena(Arena* arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(arena->Mutex);
+        arena->IsClosed = true;
+        arena->IsDeleted = true;
+
+        if (arena->BlockCount > 0)
+        {
+            return;
+        }
+
+        arena->ReleaseSpans();
+    }
+
+    Arena::Destroy(arena);
+}
+
+csmSizeType CubismPoolAllocator::GetSizeClassSize(csmInt32 sizeClass)
+{
+    // 128バイトまでは16バイト刻み、それ以降は2倍になるまでを4段階に分ける
+    if (sizeClass < 8)
+    {
+        return static_cast<csmSizeType>(sizeClass + 1) * 16;
+    }
+
+    const csmSizeType base = static_cast<csmSizeType>(128) << ((sizeClass - 8) / 4);
+    return base + static_cast<csmSizeType>((sizeClass - 8) % 4 + 1) * (base / 4);
+}
+
+csmInt32 CubismPoolAllocator::GetSizeClass(csmSizeType size)
+{
+    if (size <= 128)
+    {
+        return (size == 0) ? 0 : static_cast<csmInt32>((size - 1) >> 4);
+    }
+
+    // size - 1 の最上位ビットで2倍ごとの区間を、その下の2ビットで区間内の段階を求める
+    const csmSizeType value = size - 1;
+    csmInt32 topBit = 7;
+    while ((value >> (topBit + 1)) != 0)
+    {
+        ++topBit;
+    }
+
+    const csmInt32 step = static_cast<csmInt32>((value >> (topBit - 2)) & 3);
+    return 8 + (topBit - 7) * 4 + step;
+}
+
+CubismPoolAllocator::ThreadCache& CubismPoolAllocator::GetThreadCache()
+{
+    static thread_local ThreadCache s_threadCache;
+
+    if (s_threadCache.AllocatorId != _id)
+    {
+        s_threadCache.Detach();
+        s_threadCache.Allocator = this;
+        s_threadCache.AllocatorId = _id;
+    }
+
+    return s_threadCache;
+}
+
+csmBool CubismPoolAllocator::RefillThreadCache(ThreadCache& cache, csmInt32 sizeClass)
+{
+    SharedFreeList& shared = _sharedLists[sizeClass];
+    std::lock_guard<std::mutex> lock(shared.Mutex);
+
+    if (shared.Head == NULL)
+    {
+        SpanHeader* span = AllocateSpan(SpanSize);
+        if (span == NULL)
+        {
+            return false;
+        }
+
+        span->Kind = SpanKind_Small;
+        span->SizeClass = sizeClass;
+        span->Next = shared.Spans;
+        shared.Spans = span;
+
+        // スパンの末尾から切り出してリストの先頭が低いアドレスになるようにする
+        const csmSizeType blockSize = GetSizeClassSize(sizeClass);
+        const csmSizeType blockCount = (SpanSize - SpanHeaderSize) / blockSize;
+        csmByte* first = reinterpret_cast<csmByte*>(span) + SpanHeaderSize;
+        for (csmSizeType i = blockCount; i > 0; --i)
+        {
+            void* block = first + (i - 1) * blockSize;
+            *static_cast<void**>(block) = shared.Head;
+            shared.Head = block;
+        }
+    }
+
+    const csmUint32 batchCount = GetBatchCount(sizeClass);
+    for (csmUint32 i = 0; i < batchCount && shared.Head != NULL; ++i)
+    {
+        void* block = shared.Head;
+        shared.Head = *static_cast<void**>(block);
+
+        *static_cast<void**>(block) = cache.Heads[sizeClass];
+        cache.Heads[sizeClass] = block;
+        ++cache.Counts[sizeClass];
+    }
+
+    return true;
+}
+
+void CubismPoolAllocator::ReleaseThreadCache(ThreadCache& cache, csmInt32 sizeClass, csmUint32 count)
+{
+    if (count > cache.Counts[sizeClass])
+    {
+        count = cache.Counts[sizeClass];
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    // ロックの外で返すブロックの鎖を切り出しておく
+    void* first = cache.Heads[sizeClass];
+    void* last = first;
+    for (csmUint32 i = 1; i < count; ++i)
+    {
+        last = *static_cast<void**>(last);
+    }
+    cache.Heads[sizeClass] = *static_cast<void**>(last);
+    cache.Counts[sizeClass] -= count;
+
+    SharedFreeList& shared = _sharedLists[sizeClass];
+    std::lock_guard<std::mutex> lock(shared.Mutex);
+    *static_cast<void**>(last) = shared.Head;
+    shared.Head = first;
+}
+
+void* CubismPoolAllocator::AllocateSmall(csmSizeType size)
+{
+    const csmInt32 sizeClass = GetSizeClass(size);
+    ThreadCache& cache = GetThreadCache();
+
+    if (cache.Heads[sizeClass] == NULL && !RefillThreadCache(cache, sizeClass))
+    {
+        return NULL;
+    }
+
+    void* block = cache.Heads[sizeClass];
+    cache.Heads[sizeClass] = *static_cast<void**>(block);
+    --cache.Counts[sizeClass];
+
+    RecordAllocation(GetSizeClassSize(sizeClass), _sizeClassCounts[sizeClass]);
+
+    return block;
+}
+
+void* CubismPoolAllocator::AllocateLarge(csmSizeType size, csmUint32 alignment)
+{
+    // ブロックの先頭をスパンの最初の SpanSize バイト内に置き、アドレスからヘッダを求められるようにする
+    // スパンはページ単位に切り上げるだけにして、中くらいの要求で SpanSize まで膨らませない
+    const csmSizeType offset = AlignUp(SpanHeaderSize, alignment);
+    SpanHeader* span = AllocateSpan(AlignUp(offset + size, PageSize));
+    if (span == NULL)
+    {
+        return NULL;
+    }
+
+    span->Kind = SpanKind_Large;
+    span->BlockSize = size;
+
+    RecordAllocation(size, _largeCount);
+
+    return reinterpret_cast<csmByte*>(span) + offset;
+}
+
+void* CubismPoolAllocator::AllocateFromArena(Arena& arena, csmSizeType size)
+{
+    const csmInt32 sizeClass = GetSizeClass(size);
+    void* block = NULL;
+    {
+        std::lock_guard<std::mutex> lock(arena.Mutex);
+
+        if (arena.IsClosed || (arena.Heads[sizeClass] == NULL && !CarveArenaRun(arena, sizeClass)))
+        {
+            return NULL;
+        }
+
+        block = arena.Heads[sizeClass];
+        arena.Heads[sizeClass] = *static_cast<void**>(block);
+        ++arena.BlockCount;
+    }
+
+    RecordAllocation(GetSizeClassSize(sizeClass), _arenaCount);
+
+    return block;
+}
+
+csmBool CubismPoolAllocator::CarveArenaRun(Arena& arena, csmInt32 sizeClass)
+{
+    // 小さなクラスごとにスパンを占有しないよう、スパンをページの連なりに分けて各クラスに渡す
+    const csmSizeType blockSize = GetSizeClassSize(sizeClass);
+    csmSizeType pageCount = AlignUp(blockSize * ArenaRunBlockCount, PageSize) / PageSize;
+    if (pageCount > ArenaPageCount)
+    {
+        pageCount = ArenaPageCount;
+    }
+
+    if (arena.NextPage + pageCount > ArenaPageCount)
+    {
+        SpanHeader* span = AllocateSpan(SpanSize);
+        if (span == NULL)
+        {
+            return false;
+        }
+
+        span->Kind = SpanKind_Arena;
+        span->Owner = &arena;
+        span->Next = arena.Spans;
+        arena.Spans = span;
+        arena.NextPage = 0;
+    }
+
+    SpanHeader* span = arena.Spans;
+    const csmSizeType firstPage = arena.NextPage;
+    arena.NextPage += pageCount;
+
+    for (csmSizeType i = firstPage; i < firstPage + pageCount; ++i)
+    {
+        span->PageClasses[i] = static_cast<csmUint8>(sizeClass);
+    }
+
+    // 先頭のページはヘッダの後ろから使う
+    csmByte* base = reinterpret_cast<csmByte*>(span);
+    csmByte* first = base + ((firstPage == 0) ? SpanHeaderSize : firstPage * PageSize);
+    const csmSizeType blockCount = static_cast<csmSizeType>(base + (firstPage + pageCount) * PageSize - first) / blockSize;
+    for (csmSizeType i = blockCount; i > 0; --i)
+    {
+        void* block = first + (i - 1) * blockSize;
+        *static_cast<void**>(block) = arena.Heads[sizeClass];
+        arena.Heads[sizeClass] = block;
+    }
+
+    return true;
+}
+
+void CubismPoolAllocator::DeallocateBlock(void* memory)
+{
+    SpanHeader* span = reinterpret_cast<SpanHeader*>(reinterpret_cast<csmSizeType>(memory) & ~(SpanSize - 1));
+
+    switch (span->Kind)
+    {
+    case SpanKind_Small:
+    {
+        const csmInt32 sizeClass = span->SizeClass;
+        ThreadCache& cache = GetThreadCache();
+
+        *static_cast<void**>(memory) = cache.Heads[sizeClass];
+        cache.Heads[sizeClass] = memory;
+        ++cache.Counts[sizeClass];
+
+        RecordDeallocation(GetSizeClassSize(sizeClass));
+
+        // 溜め込みすぎないよう、1回分を共有リストに返す
+        const csmUint32 batchCount = GetBatchCount(sizeClass);
+        if (cache.Counts[sizeClass] > batchCount * 2)
+        {
+            ReleaseThreadCache(cache, sizeClass, batchCount);
+        }
+        break;
+    }
+    case SpanKind_Large:
+        RecordDeallocation(span->BlockSize);
+        DeallocateSpan(span);
+        break;
+    case SpanKind_Arena:
+        DeallocateToArena(span, memory);
+        break;
+    default:
+        CubismLogError("CubismPoolAllocator: %p was not allocated by this allocator.", memory);
+        break;
+    }
+}
+
+void CubismPoolAllocator::DeallocateToArena(SpanHeader* span, void* memory)
+{
+    Arena* arena = span->Owner;
+    const csmSizeType page = static_cast<csmSizeType>(static_cast<csmByte*>(memory) - reinterpret_cast<csmByte*>(span)) / PageSize;
+    const csmInt32 sizeClass = span->PageClasses[page];
+
+    RecordDeallocation(GetSizeClassSize(sizeClass));
+
+    {
+        std::lock_guard<std::mutex> lock(arena->Mutex);
+
+        *static_cast<void**>(memory) = arena->Heads[sizeClass];
+        arena->Heads[sizeClass] = memory;
+        --arena->BlockCount;
+
+        if (arena->BlockCount > 0 || !arena->IsClosed)
+        {
+            return;
+        }
+
+        // 閉じたアリーナの最後のブロックなので、スパンをまとめて返す
+        arena->ReleaseSpans();
+
+        if (!arena->IsDeleted)
+        {
+            return;
+        }
+    }
+
+    Arena::Destroy(arena);
+}
+
+CubismPoolAllocator::SpanHeader* CubismPoolAllocator::AllocateSpan(csmSizeType size)
+{
+    static_assert(sizeof(SpanHeader) <= SpanHeaderSize, "The header of a span must fit in SpanHeaderSize.");
+
+    void* memory = AllocateSystemMemory(size);
+    if (memory == NULL)
+    {
+        CubismLogError("CubismPoolAllocator: failed to allocate %lu bytes.", static_cast<unsigned long>(size));
+        return NULL;
+    }
+
+    SpanHeader* span = new(memory) SpanHeader();
+    span->Kind = SpanKind_Small;
+    span->SizeClass = 0;
+    span->Size = size;
+    span->BlockSize = 0;
+    span->Next = NULL;
+    span->Owner = NULL;
+
+    _reservedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    return span;
+}
+
+void CubismPoolAllocator::DeallocateSpan(SpanHeader* span)
+{
+    _reservedBytes.fetch_sub(span->Size, std::memory_order_relaxed);
+
+    span->~SpanHeader();
+    DeallocateSystemMemory(span);
+}
+
+void CubismPoolAllocator::RecordAllocation(csmSizeType size, std::atomic<csmUint64>& counter)
+{
+    if (!_isStatsEnabled)
+    {
+        return;
+    }
+
+    counter.fetch_add(1, std::memory_order_relaxed);
+
+    const csmSizeType liveBytes = _liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    csmSizeType peakBytes = _peakBytes.load(std::memory_order_relaxed);
+    while (liveBytes > peakBytes && !_peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+void CubismPoolAllocator::RecordDeallocation(csmSizeType size)
+{
+    if (!_isStatsEnabled)
+    {
+        return;
+    }
+
+    _deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    _liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
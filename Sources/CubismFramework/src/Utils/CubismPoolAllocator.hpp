@@ -0,0 +1,319 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include <atomic>
+#include <mutex>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Allocator that serves small blocks from size-class pools.
+ *
+ * Memory is taken from the system in spans of SpanSize bytes aligned to SpanSize, and the header at the start<br>
+ * of each span tells how the blocks in it are released, so blocks carry no header of their own.<br>
+ * Requests up to MaxSmallSize bytes are rounded up to a size class and served from a free list cached per thread.<br>
+ * Larger or more strictly aligned requests get a dedicated span rounded up to whole pages.
+ *
+ * Small requests made inside an ArenaScope are served from the arena of the scope instead, such as the data of<br>
+ * a model, so that all of it is returned to the system in one shot when the arena is closed.
+ *
+ * @note Blocks of the size classes are kept for reuse and returned to the system only when the allocator is destroyed.<br>
+ *       The allocator must outlive every block and arena it handed out and every thread that used it must stop<br>
+ *       allocating before it is destroyed.
+ */
+class CubismPoolAllocator : public ICubismAllocator
+{
+public:
+    static const csmSizeType SpanSize = 64 * 1024;  ///< Size and alignment of the memory taken from the system
+    static const csmSizeType MaxSmallSize = 8192;   ///< Largest request served from the size classes
+    static const csmUint32 MaxAlignment = 4096;     ///< Largest alignment supported by AllocateAligned()
+    static const csmInt32 SizeClassCount = 32;      ///< Number of size classes
+    static const csmSizeType PageSize = 4096;       ///< Granularity of the dedicated spans and of the arena runs
+
+    struct Arena;
+
+    /**
+     * Serves the small allocations of the calling thread from an arena while the scope is alive.
+     *
+     * @note Scopes nest; the innermost one wins and the enclosing one is restored on destruction.
+     */
+    class ArenaScope
+    {
+    public:
+        /**
+         * Constructor
+         *
+         * @param arena arena to allocate from; NULL serves the allocations from the shared pools, such as data shared by every model
+         */
+        ArenaScope(Arena* arena);
+
+        /**
+         * Destructor
+         *
+         * Restores the arena that was active before.
+         */
+        ~ArenaScope();
+
+    private:
+        // Prevention of copy Constructor
+        ArenaScope(const ArenaScope&);
+        ArenaScope& operator=(const ArenaScope&);
+
+        Arena* _previousArena;      ///< Arena of the enclosing scope
+    };
+
+    /**
+     * Statistics of an allocator.
+     */
+    struct Stats
+    {
+        csmSizeType LiveBytes;                                  ///< Bytes handed out and not released yet. Small requests count the size of their class.
+        csmSizeType PeakBytes;                                  ///< Largest value LiveBytes has reached
+        csmSizeType ReservedBytes;                              ///< Bytes currently taken from the system
+        csmUint64 AllocationCount;                              ///< Number of allocations
+        csmUint64 DeallocationCount;                            ///< Number of deallocations
+        csmUint64 SizeClassAllocationCounts[SizeClassCount];    ///< Number of allocations served by each size class
+        csmUint64 LargeAllocationCount;                         ///< Number of allocations that got a dedicated span
+        csmUint64 ArenaAllocationCount;                         ///< Number of allocations served by arenas
+    };
+
+    /**
+     * Constructor
+     *
+     * @param isStatsEnabled true to collect the statistics returned by GetStats()
+     */
+    CubismPoolAllocator(csmBool isStatsEnabled = true);
+
+    /**
+     * Destructor
+     *
+     * Returns every span to the system.
+     */
+    virtual ~CubismPoolAllocator();
+
+    /**
+     * Allocates the memory.
+     *
+     * @param size Desired amount of memory in bytes
+     *
+     * @return Pointer to the allocated memory if succeeded; otherwise `0`
+     */
+    virtual void* Allocate(const csmSizeType size);
+
+    /**
+     * Deallocates the memory.
+     *
+     * @param memory Pointer to allocated memory to be deallocated
+     */
+    virtual void Deallocate(void* memory);
+
+    /**
+     * Allocates the memory with specified alignment.
+     *
+     * @param size Desired amount of memory in bytes
+     * @param alignment Desired alignment of memory in bytes. Must be a power of two not greater than MaxAlignment.
+     *
+     * @return Pointer to the allocated memory if succeeded; otherwise `0`
+     */
+    virtual void* AllocateAligned(const csmSizeType size, const csmUint32 alignment);
+
+    /**
+     * Deallocates the aligned memory.
+     *
+     * @param alignedMemory Pointer to allocated memory to be deallocated
+     */
+    virtual void DeallocateAligned(void* alignedMemory);
+
+    /**
+     * Returns the blocks cached by the calling thread to the shared free lists.
+     *
+     * @note Threads do this by themselves when they exit.
+     */
+    void FlushThreadCache();
+
+    /**
+     * Makes an arena.
+     *
+     * Small blocks allocated inside an ArenaScope of the arena are carved from spans that the arena owns,<br>
+     * and blocks released into it are reused only by allocations of the same arena.
+     *
+     * @return Made arena; NULL on failure. Destroy it with DeleteArena().
+     */
+    Arena* CreateArena();
+
+    /**
+     * Closes an arena.
+     *
+     * The spans of the arena are returned to the system in one shot as soon as every block carved from them<br>
+     * is released, and later allocations inside scopes of the arena are served by the shared pools.
+     *
+     * @param arena arena to close; NULL is ignored
+     */
+    static void CloseArena(Arena* arena);
+
+    /**
+     * Closes an arena and destroys it once every block carved from it is released.
+     *
+     * @param arena arena to destroy; NULL is ignored
+     *
+     * @note No ArenaScope of the arena may be alive or opened afterwards.
+     */
+    static void DeleteArena(Arena* arena);
+
+    /**
+     * Gets the statistics.
+     *
+     * @param outStats receives the statistics
+     *
+     * @note Only ReservedBytes is counted while the statistics are disabled.
+     */
+    void GetStats(Stats& outStats) const;
+
+    /**
+     * Gets the block size of a size class.
+     *
+     * @param sizeClass index of the size class
+     *
+     * @return block size in bytes
+     */
+    static csmSizeType GetSizeClassSize(csmInt32 sizeClass);
+
+private:
+    struct SpanHeader;
+    struct ThreadCache;
+
+    /**
+     * Free list of a size class shared by all threads.
+     */
+    struct SharedFreeList
+    {
+        std::mutex Mutex;       ///< Guards the list and the spans of the class
+        void* Head;             ///< First free block
+        SpanHeader* Spans;      ///< Spans carved for the class
+    };
+
+    // Prevention of copy Constructor
+    CubismPoolAllocator(const CubismPoolAllocator&);
+    CubismPoolAllocator& operator=(const CubismPoolAllocator&);
+
+    /**
+     * Gets the size class that serves a request.
+     *
+     * @param size requested size in bytes; not greater than MaxSmallSize
+     *
+     * @return index of the size class
+     */
+    static csmInt32 GetSizeClass(csmSizeType size);
+
+    /**
+     * Binds the cache of the calling thread to this allocator.
+     *
+     * @return cache of the calling thread
+     */
+    ThreadCache& GetThreadCache();
+
+    /**
+     * Moves blocks from the shared free list to the cache of the calling thread.
+     *
+     * @param cache cache of the calling thread
+     * @param sizeClass index of the size class
+     *
+     * @return true if at least one block was moved
+     */
+    csmBool RefillThreadCache(ThreadCache& cache, csmInt32 sizeClass);
+
+    /**
+     * Moves blocks from the cache of the calling thread to the shared free list.
+     *
+     * @param cache cache of the calling thread
+     * @param sizeClass index of the size class
+     * @param count number of blocks to move
+     */
+    void ReleaseThreadCache(ThreadCache& cache, csmInt32 sizeClass, csmUint32 count);
+
+    /**
+     * Serves a request from a size class.
+     */
+    void* AllocateSmall(csmSizeType size);
+
+    /**
+     * Serves a request with a dedicated span.
+     */
+    void* AllocateLarge(csmSizeType size, csmUint32 alignment);
+
+    /**
+     * Serves a request from an arena.
+     *
+     * @return block; NULL if the arena is closed or out of memory
+     */
+    void* AllocateFromArena(Arena& arena, csmSizeType size);
+
+    /**
+     * Carves a run of pages of the arena into blocks of a size class.
+     *
+     * @param arena arena; its mutex is held by the caller
+     * @param sizeClass index of the size class
+     *
+     * @return true if the free list of the class was filled
+     */
+    csmBool CarveArenaRun(Arena& arena, csmInt32 sizeClass);
+
+    /**
+     * Returns a block to whoever handed it out.
+     */
+    void DeallocateBlock(void* memory);
+
+    /**
+     * Returns a block to the arena that owns its span.
+     */
+    void DeallocateToArena(SpanHeader* span, void* memory);
+
+    /**
+     * Takes a span from the system.
+     *
+     * @param size size in bytes; a multiple of PageSize
+     *
+     * @return span; NULL on failure
+     */
+    SpanHeader* AllocateSpan(csmSizeType size);
+
+    /**
+     * Returns a span to the system.
+     *
+     * @param span span to return
+     */
+    void DeallocateSpan(SpanHeader* span);
+
+    /**
+     * Records an allocation in the statistics.
+     */
+    void RecordAllocation(csmSizeType size, std::atomic<csmUint64>& counter);
+
+    /**
+     * Records a deallocation in the statistics.
+     */
+    void RecordDeallocation(csmSizeType size);
+
+    csmUint64 _id;                                          ///< Identifies the allocator to the thread caches
+    CubismPoolAllocator* _nextLive;                         ///< Next allocator in the list of live allocators
+    csmBool _isStatsEnabled;                                ///< True to collect the statistics
+    SharedFreeList _sharedLists[SizeClassCount];            ///< Free lists shared by all threads
+    std::atomic<csmSizeType> _liveBytes;                    ///< Bytes handed out and not released yet
+    std::atomic<csmSizeType> _peakBytes;                    ///< Largest value of _liveBytes
+    std::atomic<csmSizeType> _reservedBytes;                ///< Bytes currently taken from the system
+    std::atomic<csmUint64> _deallocationCount;              ///< Number of deallocations
+    std::atomic<csmUint64> _sizeClassCounts[SizeClassCount];///< Number of allocations of each size class
+    std::atomic<csmUint64> _largeCount;                     ///< Number of allocations with a dedicated span
+    std::atomic<csmUint64> _arenaCount;                     ///< Number of allocations served by arenas
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,482 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismProfiler.hpp"
+#include "CubismDebug.hpp"
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+thread_local CubismProfile* s_currentProfile = NULL;
+
+const csmChar* StageNames[CubismProfileStage_Count] =
+{
+    "Motion",
+    "Expression",
+    "Physics",
+    "Pose",
+    "ModelUpdate",
+    "ClippingSetup",
+    "Draw",
+};
+
+const csmChar* CounterNames[CubismProfileCounter_Count] =
+{
+    "CurvesEvaluated",
+    "DrawablesDrawn",
+    "BytesUploaded",
+    "MasksRendered",
+};
+
+/**
+ * Appends JSON text to a growing buffer.
+ *
+ * csmString copies itself on every append, so the text is built here and converted once.
+ */
+class JsonWriter
+{
+public:
+    void Write(const csmChar* text)
+    {
+        const csmInt32 length = static_cast<csmInt32>(strlen(text));
+        for (csmInt32 i = 0; i < length; ++i)
+        {
+            _buffer.PushBack(text[i]);
+        }
+    }
+
+    void WriteFormat(const csmChar* format, ...)
+    {
+        csmChar text[128];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        Write(text);
+    }
+
+    void WriteString(const csmChar* text)
+    {
+        _buffer.PushBack('"');
+        for (const csmChar* c = text; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                _buffer.PushBack('\\');
+                _buffer.PushBack(*c);
+            }
+            else if (static_cast<csmUint8>(*c) < 0x20)
+            {
+                WriteFormat("\\u%04x", static_cast<csmUint8>(*c));
+            }
+            else
+            {
+                _buffer.PushBack(*c);
+            }
+        }
+        _buffer.PushBack('"');
+    }
+
+    // Chrome のトレースはマイクロ秒
+    void WriteMicroseconds(csmUint64 nanoseconds)
+    {
+        WriteFormat("%llu.%03u", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<csmUint32>(nanoseconds % 1000));
+    }
+
+    void ToString(csmString& outJson)
+    {
+        outJson = csmString(_buffer.GetPtr(), static_cast<csmInt32>(_buffer.GetSize()));
+    }
+
+private:
+    csmVector<csmChar> _buffer;
+};
+
+void ClearFrame(CubismProfileFrame& frame)
+{
+    memset(&frame, 0, sizeof(frame));
+}
+
+}
+
+CubismProfile* CubismProfile::Create(csmInt32 frameCapacity, csmInt32 eventCapacity)
+{
+    return CSM_NEW CubismProfile(frameCapacity, eventCapacity);
+}
+
+void CubismProfile::Delete(CubismProfile* profile)
+{
+    CSM_DELETE_SELF(CubismProfile, profile);
+}
+
+csmBool CubismProfile::IsProfilingEnabled()
+{
+#ifdef CSM_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+const csmChar* CubismProfile::GetStageName(CubismProfileStage stage)
+{
+    if (stage < 0 || stage >= CubismProfileStage_Count)
+    {
+        return "";
+    }
+    return StageNames[stage];
+}
+
+const csmChar* CubismProfile::GetCounterName(CubismProfileCounter counter)
+{
+    if (counter < 0 || counter >= CubismProfileCounter_Count)
+    {
+        return "";
+    }
+    return CounterNames[counter];
+}
+
+csmUint64 CubismProfile::GetTimeNanoseconds()
+{
+    return static_cast<csmUint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+CubismProfile* CubismProfile::GetCurrent()
+{
+    return s_currentProfile;
+}
+
+void CubismProfile::AddCurrentCounter(CubismProfileCounter counter, csmUint64 value)
+{
+    if (s_currentProfile != NULL)
+    {
+        s_currentProfile->AddCounter(counter, value);
+    }
+}
+
+CubismProfile::CubismProfile(csmInt32 frameCapacity, csmInt32 eventCapacity)
+    : _name("Model")
+    , _sink(NULL)
+    , _isInFrame(false)
+    , _endedFrameCount(0)
+    , _frameHead(0)
+    , _frameCount(0)
+    , _eventHead(0)
+    , _eventCount(0)
+{
+    CubismProfileFrame emptyFrame;
+    CubismProfileEvent emptyEvent;
+
+    ClearFrame(emptyFrame);
+    memset(&emptyEvent, 0, sizeof(emptyEvent));
+    ClearFrame(_currentFrame);
+
+    // 記録中に確保しないよう、リングバッファは最初に確保しておく
+    _frames.UpdateSize((frameCapacity > 0) ? frameCapacity : 1, emptyFrame);
+    _events.UpdateSize((eventCapacity > 0) ? eventCapacity : 1, emptyEvent);
+}
+
+CubismProfile::~CubismProfile()
+{
+    if (s_currentProfile == this)
+    {
+        s_currentProfile = NULL;
+    }
+}
+
+void CubismProfile::SetName(const csmChar* name)
+{
+    _name = (name != NULL) ? name : "";
+}
+
+const csmChar* CubismProfile::GetName() const
+{
+    return _name.GetRawString();
+}
+
+void CubismProfile::SetSink(ICubismProfileSink* sink)
+{
+    _sink = sink;
+}
+
+void CubismProfile::BeginFrame()
+{
+    if (_isInFrame)
+    {
+        EndFrame();
+    }
+
+    ClearFrame(_currentFrame);
+    _currentFrame.FrameIndex = _endedFrameCount;
+    _currentFrame.BeginNanoseconds = GetTimeNanoseconds();
+    _isInFrame = true;
+}
+
+void CubismProfile::EndFrame()
+{
+    if (!_isInFrame)
+    {
+        return;
+    }
+
+    _currentFrame.EndNanoseconds = GetTimeNanoseconds();
+    _isInFrame = false;
+    ++_endedFrameCount;
+
+    const csmInt32 capacity = static_cast<csmInt32>(_frames.GetSize());
+    const csmInt32 index = (_frameHead + _frameCount) % capacity;
+
+    _frames[index] = _currentFrame;
+
+    if (_frameCount < capacity)
+    {
+        ++_frameCount;
+    }
+    else
+    {
+        _frameHead = (_frameHead + 1) % capacity;
+    }
+
+    if (_sink != NULL)
+    {
+        _sink->OnFrameEnded(*this, _frames[index]);
+    }
+}
+
+void CubismProfile::RecordStage(CubismProfileStage stage, csmUint64 beginNanoseconds, csmUint64 endNanoseconds)
+{
+    const csmUint64 duration = (endNanoseconds > beginNanoseconds) ? endNanoseconds - beginNanoseconds : 0;
+
+    if (_isInFrame)
+    {
+        _currentFrame.StageNanoseconds[stage] += duration;
+        ++_currentFrame.StageCalls[stage];
+    }
+
+    const csmInt32 capacity = static_cast<csmInt32>(_events.GetSize());
+    CubismProfileEvent& event = _events[(_eventHead + _eventCount) % capacity];
+
+    event.Stage = stage;
+    event.BeginNanoseconds = beginNanoseconds;
+    event.DurationNanoseconds = duration;
+
+    if (_eventCount < capacity)
+    {
+        ++_eventCount;
+    }
+    else
+    {
+        _eventHead = (_eventHead + 1) % capacity;
+    }
+}
+
+void CubismProfile::AddCounter(CubismProfileCounter counter, csmUint64 value)
+{
+    if (_isInFrame)
+    {
+        _currentFrame.Counters[counter] += value;
+    }
+}
+
+csmInt32 CubismProfile::GetFrameCount() const
+{
+    return _frameCount;
+}
+
+const CubismProfileFrame& CubismProfile::GetFrame(csmInt32 index) const
+{
+    CSM_ASSERT(0 <= index && index < _frameCount);
+    return _frames[(_frameHead + index) % static_cast<csmInt32>(_frames.GetSize())];
+}
+
+void CubismProfile::GetAverage(CubismProfileFrame& outAverage) const
+{
+    ClearFrame(outAverage);
+    outAverage.FrameIndex = _frameCount;
+
+    if (_frameCount == 0)
+    {
+        return;
+    }
+
+    csmUint64 calls[CubismProfileStage_Count] = {};
+
+    for (csmInt32 i = 0; i < _frameCount; ++i)
+    {
+        const CubismProfileFrame& frame = GetFrame(i);
+
+        if (i == 0)
+        {
+            outAverage.BeginNanoseconds = frame.BeginNanoseconds;
+        }
+        outAverage.EndNanoseconds = frame.EndNanoseconds;
+
+        for (csmInt32 s = 0; s < CubismProfileStage_Count; ++s)
+        {
+            outAverage.StageNanoseconds[s] += frame.StageNanoseconds[s];
+            calls[s] += frame.StageCalls[s];
+        }
+        for (csmInt32 c = 0; c < CubismProfileCounter_Count; ++c)
+        {
+            outAverage.Counters[c] += frame.Counters[c];
+        }
+    }
+
+    for (csmInt32 s = 0; s < CubismProfileStage_Count; ++s)
+    {
+        outAverage.StageNanoseconds[s] /= _frameCount;
+        outAverage.StageCalls[s] = static_cast<csmUint32>(calls[s] / _frameCount);
+    }
+    for (csmInt32 c = 0; c < CubismProfileCounter_Count; ++c)
+    {
+        outAverage.Counters[c] /= _frameCount;
+    }
+}
+
+csmInt32 CubismProfile::GetEventCount() const
+{
+    return _eventCount;
+}
+
+const CubismProfileEvent& CubismProfile::GetEvent(csmInt32 index) const
+{
+    CSM_ASSERT(0 <= index && index < _eventCount);
+    return _events[(_eventHead + index) % static_cast<csmInt32>(_events.GetSize())];
+}
+
+void CubismProfile::Clear()
+{
+    _frameHead = 0;
+    _frameCount = 0;
+    _eventHead = 0;
+    _eventCount = 0;
+}
+
+void CubismProfile::WriteChromeTrace(csmString& outJson) const
+{
+    const CubismProfile* profile = this;
+    WriteChromeTrace(&profile, 1, outJson);
+}
+
+void CubismProfile::WriteChromeTrace(const CubismProfile* const* profiles, csmInt32 profileCount, csmString& outJson)
+{
+    // 時刻は最も古い記録からの相対値にする
+    csmUint64 origin = 0;
+    csmBool hasOrigin = false;
+
+    for (csmInt32 p = 0; p < profileCount; ++p)
+    {
+        const CubismProfile* profile = profiles[p];
+
+        if (profile->_eventCount > 0 && (!hasOrigin || profile->GetEvent(0).BeginNanoseconds < origin))
+        {
+            origin = profile->GetEvent(0).BeginNanoseconds;
+            hasOrigin = true;
+        }
+        if (profile->_frameCount > 0 && (!hasOrigin || profile->GetFrame(0).BeginNanoseconds < origin))
+        {
+            origin = profile->GetFrame(0).BeginNanoseconds;
+            hasOrigin = true;
+        }
+    }
+
+    JsonWriter writer;
+    csmBool isFirst = true;
+
+    writer.Write("{\"traceEvents\":[");
+
+    for (csmInt32 p = 0; p < profileCount; ++p)
+    {
+        const CubismProfile* profile = profiles[p];
+        const csmInt32 threadId = p + 1;
+
+        // プロファイルごとにスレッドとして並べる
+        writer.Write(isFirst ? "\n" : ",\n");
+        isFirst = false;
+        writer.WriteFormat("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", threadId);
+        writer.WriteString(profile->GetName());
+        writer.Write("}}");
+
+        for (csmInt32 i = 0; i < profile->_frameCount; ++i)
+        {
+            const CubismProfileFrame& frame = profile->GetFrame(i);
+
+            writer.Write(",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":");
+            writer.WriteMicroseconds(frame.BeginNanoseconds - origin);
+            writer.Write(",\"dur\":");
+            writer.WriteMicroseconds(frame.EndNanoseconds - frame.BeginNanoseconds);
+            writer.WriteFormat(",\"pid\":1,\"tid\":%d,\"args\":{\"index\":%llu}}", threadId, static_cast<unsigned long long>(frame.FrameIndex));
+
+            writer.Write(",\n{\"name\":");
+            writer.WriteString(profile->GetName());
+            writer.Write(",\"cat\":\"counters\",\"ph\":\"C\",\"ts\":");
+            writer.WriteMicroseconds(frame.EndNanoseconds - origin);
+            writer.WriteFormat(",\"pid\":1,\"tid\":%d,\"args\":{", threadId);
+            for (csmInt32 c = 0; c < CubismProfileCounter_Count; ++c)
+            {
+                writer.WriteFormat("%s\"%s\":%llu", (c > 0) ? "," : "", CounterNames[c], static_cast<unsigned long long>(frame.Counters[c]));
+            }
+            writer.Write("}}");
+        }
+
+        for (csmInt32 i = 0; i < profile->_eventCount; ++i)
+        {
+            const CubismProfileEvent& event = profile->GetEvent(i);
+
+            writer.Write(",\n{\"name\":");
+            writer.WriteString(StageNames[event.Stage]);
+            writer.Write(",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":");
+            writer.WriteMicroseconds(event.BeginNanoseconds - origin);
+            writer.Write(",\"dur\":");
+            writer.WriteMicroseconds(event.DurationNanoseconds);
+            writer.WriteFormat(",\"pid\":1,\"tid\":%d}", threadId);
+        }
+    }
+
+    writer.Write("\n],\"displayTimeUnit\":\"ms\"}\n");
+    writer.ToString(outJson);
+}
+
+CubismProfileScope::CubismProfileScope(CubismProfile* profile)
+    : _previousProfile(s_currentProfile)
+{
+    s_currentProfile = profile;
+}
+
+CubismProfileScope::~CubismProfileScope()
+{
+    s_currentProfile = _previousProfile;
+}
+
+CubismProfileStageScope::CubismProfileStageScope(CubismProfileStage stage)
+    : _profile(s_currentProfile)
+    , _stage(stage)
+    , _beginNanoseconds(0)
+{
+    if (_profile != NULL)
+    {
+        _beginNanoseconds = CubismProfile::GetTimeNanoseconds();
+    }
+}
+
+CubismProfileStageScope::~CubismProfileStageScope()
+{
+    if (_profile != NULL)
+    {
+        _profile->RecordStage(_stage, _beginNanoseconds, CubismProfile::GetTimeNanoseconds());
+    }
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,380 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmString.hpp"
+#include "Type/csmVector.hpp"
+
+#ifdef CSM_PROFILING
+#define CSM_PROFILE_STAGE(stage)            Live2D::Cubism::Framework::CubismProfileStageScope csmProfileStageScope(stage)
+#define CSM_PROFILE_COUNT(counter, value)   Live2D::Cubism::Framework::CubismProfile::AddCurrentCounter(counter, value)
+#else
+#define CSM_PROFILE_STAGE(stage)
+#define CSM_PROFILE_COUNT(counter, value)
+#endif
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Stages of the update and render pipeline that are timed.
+ */
+enum CubismProfileStage
+{
+    CubismProfileStage_Motion = 0,      ///< CubismMotionQueueManager::DoUpdateMotion()
+    CubismProfileStage_Expression,      ///< CubismExpressionMotionManager::UpdateMotion()
+    CubismProfileStage_Physics,         ///< CubismPhysics::Evaluate()
+    CubismProfileStage_Pose,            ///< CubismPose::UpdateParameters()
+    CubismProfileStage_ModelUpdate,     ///< CubismModel::Update(), mostly the Core
+    CubismProfileStage_ClippingSetup,   ///< SetupClippingContext() of the renderer
+    CubismProfileStage_Draw,            ///< CubismRenderer::DrawModel(), including the clipping setup
+    CubismProfileStage_Count            ///< Number of stages
+};
+
+/**
+ * Counters accumulated over a frame.
+ */
+enum CubismProfileCounter
+{
+    CubismProfileCounter_CurvesEvaluated = 0,   ///< Motion curves processed by CubismMotion
+    CubismProfileCounter_DrawablesDrawn,        ///< Drawables submitted by the renderer
+    CubismProfileCounter_BytesUploaded,         ///< Vertex, UV and index bytes copied to GPU buffers
+    CubismProfileCounter_MasksRendered,         ///< Clipping masks drawn into mask buffers
+    CubismProfileCounter_Count                  ///< Number of counters
+};
+
+/**
+ * Timings and counters of one frame.
+ */
+struct CubismProfileFrame
+{
+    csmUint64 FrameIndex;                                   ///< Number of frames ended before this one
+    csmUint64 BeginNanoseconds;                             ///< CubismProfile::GetTimeNanoseconds() at BeginFrame()
+    csmUint64 EndNanoseconds;                               ///< CubismProfile::GetTimeNanoseconds() at EndFrame()
+    csmUint64 StageNanoseconds[CubismProfileStage_Count];   ///< Time of each stage; nested stages are included in the enclosing one
+    csmUint32 StageCalls[CubismProfileStage_Count];         ///< Number of times each stage ran
+    csmUint64 Counters[CubismProfileCounter_Count];         ///< Value of each counter
+};
+
+/**
+ * One timed run of a stage.
+ */
+struct CubismProfileEvent
+{
+    CubismProfileStage Stage;       ///< Stage
+    csmUint64 BeginNanoseconds;     ///< Start time
+    csmUint64 DurationNanoseconds;  ///< Duration
+};
+
+class CubismProfile;
+
+/**
+ * Receives the frames of a profile as they end.
+ */
+class ICubismProfileSink
+{
+public:
+    /**
+     * Destructor
+     */
+    virtual ~ICubismProfileSink() {}
+
+    /**
+     * Called by CubismProfile::EndFrame() on the thread that ends the frame.
+     *
+     * @param profile profile the frame belongs to
+     * @param frame ended frame
+     */
+    virtual void OnFrameEnded(const CubismProfile& profile, const CubismProfileFrame& frame) = 0;
+};
+
+/**
+ * Stage timings and counters of an owner such as a model, kept in ring buffers.
+ *
+ * Stages are timed with CSM_PROFILE_STAGE() and counted with CSM_PROFILE_COUNT() while a CubismProfileScope<br>
+ * of the profile is active on the calling thread. Frames are delimited by BeginFrame() and EndFrame().
+ *
+ * @note Timing needs CSM_PROFILING to be defined in CubismFrameworkConfig.hpp. Without it, the macros<br>
+ *       expand to nothing and frames only have their begin and end times.
+ * @note A profile is not thread-safe; record into it from one thread at a time.<br>
+ *       Stages that run on the workers of CubismThreadPool are included in the stage that started the loop.
+ */
+class CubismProfile
+{
+public:
+    /**
+     * Makes a profile.
+     *
+     * @param frameCapacity number of frames kept; older frames are overwritten
+     * @param eventCapacity number of stage events kept for the trace; older events are overwritten
+     *
+     * @return Made profile
+     */
+    static CubismProfile* Create(csmInt32 frameCapacity = 120, csmInt32 eventCapacity = 2048);
+
+    /**
+     * Destroys a profile.
+     *
+     * @param profile profile to destroy
+     */
+    static void Delete(CubismProfile* profile);
+
+    /**
+     * Returns whether stages are timed in this build.
+     *
+     * @return true if CSM_PROFILING is defined
+     */
+    static csmBool IsProfilingEnabled();
+
+    /**
+     * Returns the name of a stage.
+     *
+     * @param stage stage
+     *
+     * @return name of the stage
+     */
+    static const csmChar* GetStageName(CubismProfileStage stage);
+
+    /**
+     * Returns the name of a counter.
+     *
+     * @param counter counter
+     *
+     * @return name of the counter
+     */
+    static const csmChar* GetCounterName(CubismProfileCounter counter);
+
+    /**
+     * Returns the time of a monotonic clock.
+     *
+     * @return nanoseconds from an unspecified origin
+     */
+    static csmUint64 GetTimeNanoseconds();
+
+    /**
+     * Returns the profile of the innermost CubismProfileScope of the calling thread.
+     *
+     * @return profile; NULL if no scope is active
+     */
+    static CubismProfile* GetCurrent();
+
+    /**
+     * Adds to a counter of the current profile. Does nothing if no scope is active.
+     *
+     * @param counter counter
+     * @param value value to add
+     */
+    static void AddCurrentCounter(CubismProfileCounter counter, csmUint64 value);
+
+    /**
+     * Writes the events and frames of profiles as Chrome trace-event JSON.
+     *
+     * Each profile becomes a thread named after it, so that the models of a scene can be compared on one timeline.<br>
+     * The file can be opened with chrome://tracing or Perfetto.
+     *
+     * @param profiles profiles to write
+     * @param profileCount number of profiles
+     * @param outJson receives the JSON
+     */
+    static void WriteChromeTrace(const CubismProfile* const* profiles, csmInt32 profileCount, csmString& outJson);
+
+    /**
+     * Sets the name used in the trace.
+     *
+     * @param name name of the owner
+     */
+    void SetName(const csmChar* name);
+
+    /**
+     * Returns the name used in the trace.
+     *
+     * @return name of the owner
+     */
+    const csmChar* GetName() const;
+
+    /**
+     * Sets the sink that receives the ended frames.
+     *
+     * @param sink sink; NULL to remove it. The profile does not own the sink.
+     */
+    void SetSink(ICubismProfileSink* sink);
+
+    /**
+     * Starts a frame. Ends the open frame first, if any.
+     */
+    void BeginFrame();
+
+    /**
+     * Ends the open frame, stores it and passes it to the sink. Does nothing if no frame is open.
+     */
+    void EndFrame();
+
+    /**
+     * Records a run of a stage.
+     *
+     * @param stage stage
+     * @param beginNanoseconds start time
+     * @param endNanoseconds end time
+     *
+     * @note Runs outside a frame appear in the trace but in no frame.
+     */
+    void RecordStage(CubismProfileStage stage, csmUint64 beginNanoseconds, csmUint64 endNanoseconds);
+
+    /**
+     * Adds to a counter of the open frame.
+     *
+     * @param counter counter
+     * @param value value to add
+     */
+    void AddCounter(CubismProfileCounter counter, csmUint64 value);
+
+    /**
+     * Returns the number of stored frames.
+     *
+     * @return number of frames, up to the frame capacity
+     */
+    csmInt32 GetFrameCount() const;
+
+    /**
+     * Returns a stored frame.
+     *
+     * @param index 0 for the oldest frame, GetFrameCount() - 1 for the latest
+     *
+     * @return frame
+     */
+    const CubismProfileFrame& GetFrame(csmInt32 index) const;
+
+    /**
+     * Averages the stored frames.
+     *
+     * @param outAverage receives the average of the stage times, calls and counters, rounded down; FrameIndex is the number of frames averaged
+     */
+    void GetAverage(CubismProfileFrame& outAverage) const;
+
+    /**
+     * Returns the number of stored events.
+     *
+     * @return number of events, up to the event capacity
+     */
+    csmInt32 GetEventCount() const;
+
+    /**
+     * Returns a stored event.
+     *
+     * @param index 0 for the oldest event, GetEventCount() - 1 for the latest
+     *
+     * @return event
+     */
+    const CubismProfileEvent& GetEvent(csmInt32 index) const;
+
+    /**
+     * Removes the stored frames and events.
+     */
+    void Clear();
+
+    /**
+     * Writes the events and frames of the profile as Chrome trace-event JSON.
+     *
+     * @param outJson receives the JSON
+     */
+    void WriteChromeTrace(csmString& outJson) const;
+
+private:
+    /**
+     * Constructor
+     *
+     * @param frameCapacity number of frames kept
+     * @param eventCapacity number of events kept
+     */
+    CubismProfile(csmInt32 frameCapacity, csmInt32 eventCapacity);
+
+    /**
+     * Destructor
+     */
+    virtual ~CubismProfile();
+
+    // Prevention of copy Constructor
+    CubismProfile(const CubismProfile&);
+    CubismProfile& operator=(const CubismProfile&);
+
+    csmString _name;                            ///< Name used in the trace
+    ICubismProfileSink* _sink;                  ///< Receives the ended frames
+    CubismProfileFrame _currentFrame;           ///< Frame being recorded
+    csmBool _isInFrame;                         ///< true between BeginFrame() and EndFrame()
+    csmUint64 _endedFrameCount;                 ///< Number of frames ended
+    csmVector<CubismProfileFrame> _frames;      ///< Ring buffer of the ended frames
+    csmInt32 _frameHead;                        ///< Index of the oldest frame
+    csmInt32 _frameCount;                       ///< Number of stored frames
+    csmVector<CubismProfileEvent> _events;      ///< Ring buffer of the stage events
+    csmInt32 _eventHead;                        ///< Index of the oldest event
+    csmInt32 _eventCount;                       ///< Number of stored events
+};
+
+/**
+ * Makes a profile current on the calling thread while the scope is alive.
+ *
+ * @note Scopes nest; the innermost one wins and the enclosing one is restored on destruction.
+ */
+class CubismProfileScope
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param profile profile to record into; NULL stops recording inside the scope
+     */
+    CubismProfileScope(CubismProfile* profile);
+
+    /**
+     * Destructor
+     *
+     * Restores the profile that was current before.
+     */
+    ~CubismProfileScope();
+
+private:
+    // Prevention of copy Constructor
+    CubismProfileScope(const CubismProfileScope&);
+    CubismProfileScope& operator=(const CubismProfileScope&);
+
+    CubismProfile* _previousProfile;    ///< Profile of the enclosing scope
+};
+
+/**
+ * Times a stage into the current profile while the scope is alive. Used through CSM_PROFILE_STAGE().
+ */
+class CubismProfileStageScope
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param stage stage to time
+     */
+    CubismProfileStageScope(CubismProfileStage stage);
+
+    /**
+     * Destructor
+     *
+     * Records the stage into the profile that was current at construction.
+     */
+    ~CubismProfileStageScope();
+
+private:
+    // Prevention of copy Constructor
+    CubismProfileStageScope(const CubismProfileStageScope&);
+    CubismProfileStageScope& operator=(const CubismProfileStageScope&);
+
+    CubismProfile* _profile;        ///< Profile to record into; NULL if none was current
+    CubismProfileStage _stage;      ///< Stage being timed
+    csmUint64 _beginNanoseconds;    ///< Start time
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
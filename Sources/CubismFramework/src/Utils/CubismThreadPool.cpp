@@ -0,0 +1,150 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismThreadPool.hpp"
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismThreadPool* CubismThreadPool::Create(csmInt32 workerCount)
+{
+    return CSM_NEW CubismThreadPool(workerCount);
+}
+
+void CubismThreadPool::Delete(CubismThreadPool* threadPool)
+{
+    CSM_DELETE_SELF(CubismThreadPool, threadPool);
+}
+
+CubismThreadPool::CubismThreadPool(csmInt32 workerCount)
+    : _function(NULL)
+    , _userData(NULL)
+    , _count(0)
+    , _nextIndex(0)
+    , _busyWorkerCount(0)
+    , _generation(0)
+    , _isStopping(false)
+{
+    for (csmInt32 i = 0; i < workerCount; ++i)
+    {
+        _workers.PushBack(CSM_NEW std::thread(&CubismThreadPool::WorkerMain, this));
+    }
+}
+
+CubismThreadPool::~CubismThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _wakeCondition.notify_all();
+
+    for (csmUint32 i = 0; i < _workers.GetSize(); ++i)
+    {
+        _workers[i]->join();
+        CSM_DELETE(_workers[i]);
+    }
+    _workers.Clear();
+}
+
+csmInt32 CubismThreadPool::GetWorkerCount() const
+{
+    return static_cast<csmInt32>(_workers.GetSize());
+}
+
+void CubismThreadPool::ParallelFor(csmInt32 count, TaskFunction function, void* userData)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // ワーカーが無い、または他のループが実行中の場合は呼び出しスレッドで順に処理する
+    if (_workers.GetSize() == 0 || count == 1 || !_dispatchMutex.try_lock())
+    {
+        for (csmInt32 i = 0; i < count; ++i)
+        {
+            function(i, userData);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _function = function;
+        _userData = userData;
+        _count = count;
+        _nextIndex.store(0);
+        _busyWorkerCount = static_cast<csmInt32>(_workers.GetSize());
+        ++_generation;
+    }
+    _wakeCondition.notify_all();
+
+    RunTasks();
+
+    // 全ワーカーがループを抜けるまで待ち、次のループの状態を書き換えられるようにする
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_busyWorkerCount > 0)
+        {
+            _doneCondition.wait(lock);
+        }
+    }
+
+    _dispatchMutex.unlock();
+}
+
+void CubismThreadPool::WorkerMain()
+{
+    csmUint64 generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_isStopping && _generation == generation)
+            {
+                _wakeCondition.wait(lock);
+            }
+
+            if (_isStopping)
+            {
+                return;
+            }
+
+            generation = _generation;
+        }
+
+        RunTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_busyWorkerCount;
+            if (_busyWorkerCount == 0)
+            {
+                _doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+void CubismThreadPool::RunTasks()
+{
+    for (;;)
+    {
+        const csmInt32 index = _nextIndex.fetch_add(1);
+        if (index >= _count)
+        {
+            break;
+        }
+
+        _function(index, _userData);
+    }
+}
+
+}}}
+//--------- LIVE2D NAMESPACE ------------
@@ -0,0 +1,114 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * Fixed set of worker threads that runs data-parallel loops.
+ *
+ * @note The calling thread takes part in every loop, so a pool with no workers runs loops serially.<br>
+ *       Only one loop runs at a time. A loop requested while another is running, including from inside a task,<br>
+ *       runs serially on the calling thread instead of waiting.
+ */
+class CubismThreadPool
+{
+public:
+    /**
+     * Function executed for each index of a loop.
+     *
+     * @param index index of the iteration
+     * @param userData pointer passed to ParallelFor()
+     */
+    typedef void (*TaskFunction)(csmInt32 index, void* userData);
+
+    /**
+     * Makes an instance and starts its workers.
+     *
+     * @param workerCount number of worker threads besides the calling thread
+     *
+     * @return Made instance
+     */
+    static CubismThreadPool* Create(csmInt32 workerCount);
+
+    /**
+     * Stops the workers and destroys the instance.
+     *
+     * @param threadPool instance to destroy
+     */
+    static void Delete(CubismThreadPool* threadPool);
+
+    /**
+     * Returns the number of worker threads.
+     *
+     * @return number of worker threads
+     */
+    csmInt32 GetWorkerCount() const;
+
+    /**
+     * Runs the function for every index in [0, count) and waits for all of them.
+     *
+     * @param count number of iterations
+     * @param function function executed for each index
+     * @param userData pointer passed to the function
+     *
+     * @note Indices are distributed dynamically, so the function must not depend on execution order.
+     */
+    void ParallelFor(csmInt32 count, TaskFunction function, void* userData);
+
+private:
+    /**
+     * Constructor
+     *
+     * @param workerCount number of worker threads
+     */
+    CubismThreadPool(csmInt32 workerCount);
+
+    /**
+     * Destructor
+     */
+    virtual ~CubismThreadPool();
+
+    // Prevention of copy Constructor
+    CubismThreadPool(const CubismThreadPool&);
+    CubismThreadPool& operator=(const CubismThreadPool&);
+
+    /**
+     * Loop of a worker thread.
+     */
+    void WorkerMain();
+
+    /**
+     * Takes indices of the current loop until none remain.
+     */
+    void RunTasks();
+
+    csmVector<std::thread*> _workers;       ///< Worker threads
+    std::mutex _dispatchMutex;              ///< Held while a loop is running
+    std::mutex _mutex;                      ///< Guards the loop state below
+    std::condition_variable _wakeCondition; ///< Signals workers that a loop started or the pool stops
+    std::condition_variable _doneCondition; ///< Signals the caller that every worker left the loop
+    TaskFunction _function;                 ///< Function of the current loop
+    void* _userData;                        ///< User data of the current loop
+    csmInt32 _count;                        ///< Number of iterations of the current loop
+    std::atomic<csmInt32> _nextIndex;       ///< Next index to be taken
+    csmInt32 _busyWorkerCount;              ///< Number of workers still inside the current loop
+    csmUint64 _generation;                  ///< Incremented each time a loop starts
+    csmBool _isStopping;                    ///< True while the pool shuts down
+};
+
+}}}
+//--------- LIVE2D NAMESPACE ------------